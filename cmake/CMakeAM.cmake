@@ -98,7 +98,7 @@ function(parse_automake AM_FILE_NAME)
 
   set(AM_TARGETS)
   foreach(AM_FILE ${noinst_LTLIBRARIES})
-    string(REPLACE "." "_" AM_NAME "${AM_FILE}")
+    string(REGEX REPLACE "[^A-Za-z0-9_]" "_" AM_NAME "${AM_FILE}")
     am_add_target(lib ${AM_FOLDER} ${AM_FILE} "${${AM_NAME}_SOURCES}" "${${AM_NAME}_LIBADD}")
 
     am_target_name(${AM_FOLDER} ${AM_FILE} AM_TARGET)
@@ -106,8 +106,8 @@ function(parse_automake AM_FILE_NAME)
     list(APPEND AM_TARGETS ${AM_TARGET})
   endforeach()
 
-  foreach(AM_FILE ${bin_PROGRAMS})
-    string(REPLACE "." "_" AM_NAME "${AM_FILE}")
+  foreach(AM_FILE ${bin_PROGRAMS} ${noinst_PROGRAMS})
+    string(REGEX REPLACE "[^A-Za-z0-9_]" "_" AM_NAME "${AM_FILE}")
     am_add_target(bin ${AM_FOLDER} ${AM_FILE} "${${AM_NAME}_SOURCES}" "${${AM_NAME}_LDADD}")
 
     am_target_name(${AM_FOLDER} ${AM_FILE} AM_TARGET)
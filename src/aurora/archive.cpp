@@ -22,7 +22,11 @@
  *  Handling various archive files.
  */
 
+#include <boost/bind.hpp>
+
 #include "src/common/system.h"
+#include "src/common/readstream.h"
+#include "src/common/workerpool.h"
 
 #include "src/aurora/archive.h"
 
@@ -41,6 +45,48 @@ uint32 Archive::getResourceSize(uint32 UNUSED(index)) const {
 	return 0xFFFFFFFF;
 }
 
+uint32 Archive::getResourceOffset(uint32 UNUSED(index)) const {
+	return 0xFFFFFFFF;
+}
+
+static void getResourceJob(const Archive *archive, uint32 index, Common::SeekableReadStream **stream) {
+	*stream = archive->getResource(index);
+}
+
+void Archive::getResources(const std::vector<uint32> &indices,
+                           std::vector<Common::SeekableReadStream *> &streams) const {
+
+	streams.clear();
+	streams.resize(indices.size(), 0);
+
+	try {
+
+		if ((indices.size() > 1) && canGetResourcesConcurrently()) {
+			std::vector<Common::WorkerPool::Job> jobs;
+			jobs.reserve(indices.size());
+
+			for (size_t i = 0; i < indices.size(); i++)
+				jobs.push_back(boost::bind(&getResourceJob, this, indices[i], &streams[i]));
+
+			WorkerPoolMan.run(jobs);
+
+		} else
+			for (size_t i = 0; i < indices.size(); i++)
+				streams[i] = getResource(indices[i]);
+
+	} catch (...) {
+		for (std::vector<Common::SeekableReadStream *>::iterator s = streams.begin(); s != streams.end(); ++s)
+			delete *s;
+
+		streams.clear();
+		throw;
+	}
+}
+
+bool Archive::canGetResourcesConcurrently() const {
+	return false;
+}
+
 Common::HashAlgo Archive::getNameHashAlgo() const {
 	return Common::kHashNone;
 }
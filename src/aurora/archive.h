@@ -26,6 +26,7 @@
 #define AURORA_ARCHIVE_H
 
 #include <list>
+#include <vector>
 
 #include "src/common/types.h"
 #include "src/common/ustring.h"
@@ -63,6 +64,13 @@ public:
 	/** Return the size of a resource. */
 	virtual uint32 getResourceSize(uint32 index) const;
 
+	/** Return the offset of a resource's data within the archive.
+	 *
+	 *  This is only a hint for ordering reads. Archives that don't store
+	 *  their resources at fixed offsets return 0xFFFFFFFF.
+	 */
+	virtual uint32 getResourceOffset(uint32 index) const;
+
 	/** Return a stream of the resource's contents.
 	 *
 	 *  @param  index The index of the resource we want.
@@ -71,6 +79,23 @@ public:
 	 */
 	virtual Common::SeekableReadStream *getResource(uint32 index, bool tryNoCopy = false) const = 0;
 
+	/** Return streams of several resources' contents at once.
+	 *
+	 *  If the archive allows it, the resources are read and decompressed
+	 *  concurrently, on the worker pool. Otherwise, they are read one by one.
+	 *
+	 *  If getting any of the resources fails, all streams are deleted again
+	 *  and the exception is thrown on.
+	 *
+	 *  @param indices The indices of the resources we want.
+	 *  @param streams Receives the streams, in the same order as the indices.
+	 */
+	void getResources(const std::vector<uint32> &indices,
+	                  std::vector<Common::SeekableReadStream *> &streams) const;
+
+	/** Can getResource() be called from several threads at the same time? */
+	virtual bool canGetResourcesConcurrently() const;
+
 	/** Return with which algorithm the name is hashed. */
 	virtual Common::HashAlgo getNameHashAlgo() const;
 };
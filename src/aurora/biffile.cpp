@@ -35,6 +35,7 @@
 
 #include "src/aurora/biffile.h"
 #include "src/aurora/keyfile.h"
+#include "src/aurora/util.h"
 
 static const uint32 kBIFID     = MKTAG('B', 'I', 'F', 'F');
 static const uint32 kVersion1  = MKTAG('V', '1', ' ', ' ');
@@ -42,7 +43,7 @@ static const uint32 kVersion11 = MKTAG('V', '1', '.', '1');
 
 namespace Aurora {
 
-BIFFile::BIFFile(Common::SeekableReadStream *bif) : _bif(bif) {
+BIFFile::BIFFile(Common::SeekableReadStream *bif) : _bif(bif), _hashAlgo(Common::kHashNone) {
 	assert(_bif);
 
 	try {
@@ -103,30 +104,38 @@ void BIFFile::readVarResTable(Common::SeekableReadStream &bif, uint32 offset) {
 }
 
 void BIFFile::mergeKEY(const KEYFile &key, uint32 bifIndex) {
-	const KEYFile::ResourceList &keyResList = key.getResources();
-
-	for (KEYFile::ResourceList::const_iterator keyRes = keyResList.begin(); keyRes != keyResList.end(); ++keyRes) {
-		if (keyRes->bifIndex != bifIndex)
-			continue;
+	KEYFile::ResourceList::const_iterator keyBegin, keyEnd;
+	key.getResources(bifIndex, keyBegin, keyEnd);
 
+	for (KEYFile::ResourceList::const_iterator keyRes = keyBegin; keyRes != keyEnd; ++keyRes) {
 		if (keyRes->resIndex >= _iResources.size()) {
 			warning("Resource index out of range (%d/%d)", keyRes->resIndex, (int) _iResources.size());
 			continue;
 		}
 
-		if (keyRes->type != _iResources[keyRes->resIndex].type)
+		const FileType type = _iResources[keyRes->resIndex].type;
+
+		uint64 hash = keyRes->hash;
+		if (keyRes->type != type) {
 			warning("KEY and BIF disagree on the type of the resource \"%s\" (%d, %d). Trusting the BIF",
-			        keyRes->name.c_str(), keyRes->type, _iResources[keyRes->resIndex].type);
+			        key.getName(*keyRes), keyRes->type, type);
 
-		Resource res;
+			// The KEY hashed the name together with the wrong type
+			if (key.getNameHashAlgo() != Common::kHashNone)
+				hash = Common::hashString(TypeMan.setFileType(key.getName(*keyRes), type).toLower(),
+				                          key.getNameHashAlgo());
+		}
 
-		res.name  = keyRes->name;
-		res.type  = _iResources[keyRes->resIndex].type;
-		res.index = keyRes->resIndex;
+		_resources.push_back(Resource());
+		Resource &res = _resources.back();
 
-		_resources.push_back(res);
+		res.name  = key.getName(*keyRes);
+		res.hash  = hash;
+		res.type  = type;
+		res.index = keyRes->resIndex;
 	}
 
+	_hashAlgo = key.getNameHashAlgo();
 }
 
 const Archive::ResourceList &BIFFile::getResources() const {
@@ -144,15 +153,25 @@ uint32 BIFFile::getResourceSize(uint32 index) const {
 	return getIResource(index).size;
 }
 
+uint32 BIFFile::getResourceOffset(uint32 index) const {
+	return getIResource(index).offset;
+}
+
 Common::SeekableReadStream *BIFFile::getResource(uint32 index, bool tryNoCopy) const {
 	const IResource &res = getIResource(index);
 
 	if (tryNoCopy)
-		return new Common::SeekableSubReadStream(_bif, res.offset, res.offset + res.size);
+		return new Common::PositionalSubReadStream(_bif, res.offset, res.offset + res.size);
 
-	_bif->seek(res.offset);
+	return _bif->readStreamAt(res.offset, res.size);
+}
+
+Common::HashAlgo BIFFile::getNameHashAlgo() const {
+	return _hashAlgo;
+}
 
-	return _bif->readStream(res.size);
+bool BIFFile::canGetResourcesConcurrently() const {
+	return _bif->canReadAtConcurrently();
 }
 
 } // End of namespace Aurora
@@ -53,9 +53,18 @@ public:
 	/** Return the size of a resource. */
 	uint32 getResourceSize(uint32 index) const;
 
+	/** Return the offset of a resource's data within the archive. */
+	uint32 getResourceOffset(uint32 index) const;
+
 	/** Return a stream of the resource's contents. */
 	Common::SeekableReadStream *getResource(uint32 index, bool tryNoCopy = false) const;
 
+	/** Can resources be read from several threads at the same time? */
+	bool canGetResourcesConcurrently() const;
+
+	/** Return with which algorithm the name is hashed. */
+	Common::HashAlgo getNameHashAlgo() const;
+
 	/** Merge information from the KEY into the BIF. */
 	void mergeKEY(const KEYFile &key, uint32 bifIndex);
 
@@ -72,6 +81,9 @@ private:
 
 	Common::SeekableReadStream *_bif;
 
+	/** The algorithm the KEY hashed the resource names with. */
+	Common::HashAlgo _hashAlgo;
+
 	/** External list of resource names and types. */
 	ResourceList _resources;
 
@@ -36,13 +36,14 @@
 
 #include "src/aurora/bzffile.h"
 #include "src/aurora/keyfile.h"
+#include "src/aurora/util.h"
 
 static const uint32 kBZFID     = MKTAG('B', 'I', 'F', 'F');
 static const uint32 kVersion1  = MKTAG('V', '1', ' ', ' ');
 
 namespace Aurora {
 
-BZFFile::BZFFile(Common::SeekableReadStream *bzf) : _bzf(bzf) {
+BZFFile::BZFFile(Common::SeekableReadStream *bzf) : _bzf(bzf), _hashAlgo(Common::kHashNone) {
 	assert(_bzf);
 
 	try {
@@ -106,30 +107,38 @@ void BZFFile::readVarResTable(Common::SeekableReadStream &bzf, uint32 offset) {
 }
 
 void BZFFile::mergeKEY(const KEYFile &key, uint32 bifIndex) {
-	const KEYFile::ResourceList &keyResList = key.getResources();
-
-	for (KEYFile::ResourceList::const_iterator keyRes = keyResList.begin(); keyRes != keyResList.end(); ++keyRes) {
-		if (keyRes->bifIndex != bifIndex)
-			continue;
+	KEYFile::ResourceList::const_iterator keyBegin, keyEnd;
+	key.getResources(bifIndex, keyBegin, keyEnd);
 
+	for (KEYFile::ResourceList::const_iterator keyRes = keyBegin; keyRes != keyEnd; ++keyRes) {
 		if (keyRes->resIndex >= _iResources.size()) {
 			warning("Resource index out of range (%d/%d)", keyRes->resIndex, (int) _iResources.size());
 			continue;
 		}
 
-		if (keyRes->type != _iResources[keyRes->resIndex].type)
+		const FileType type = _iResources[keyRes->resIndex].type;
+
+		uint64 hash = keyRes->hash;
+		if (keyRes->type != type) {
 			warning("KEY and BZF disagree on the type of the resource \"%s\" (%d, %d). Trusting the BZF",
-			        keyRes->name.c_str(), keyRes->type, _iResources[keyRes->resIndex].type);
+			        key.getName(*keyRes), keyRes->type, type);
 
-		Resource res;
+			// The KEY hashed the name together with the wrong type
+			if (key.getNameHashAlgo() != Common::kHashNone)
+				hash = Common::hashString(TypeMan.setFileType(key.getName(*keyRes), type).toLower(),
+				                          key.getNameHashAlgo());
+		}
 
-		res.name  = keyRes->name;
-		res.type  = _iResources[keyRes->resIndex].type;
-		res.index = keyRes->resIndex;
+		_resources.push_back(Resource());
+		Resource &res = _resources.back();
 
-		_resources.push_back(res);
+		res.name  = key.getName(*keyRes);
+		res.hash  = hash;
+		res.type  = type;
+		res.index = keyRes->resIndex;
 	}
 
+	_hashAlgo = key.getNameHashAlgo();
 }
 
 const Archive::ResourceList &BZFFile::getResources() const {
@@ -147,12 +156,14 @@ uint32 BZFFile::getResourceSize(uint32 index) const {
 	return getIResource(index).size;
 }
 
+uint32 BZFFile::getResourceOffset(uint32 index) const {
+	return getIResource(index).offset;
+}
+
 Common::SeekableReadStream *BZFFile::getResource(uint32 index, bool UNUSED(tryNoCopy)) const {
 	const IResource &res = getIResource(index);
 
-	_bzf->seek(res.offset);
-
-	Common::MemoryReadStream   *packedStream = _bzf->readStream(res.packedSize);
+	Common::MemoryReadStream   *packedStream = _bzf->readStreamAt(res.offset, res.packedSize);
 	Common::SeekableReadStream *resStream    = 0;
 
 	try {
@@ -166,6 +177,14 @@ Common::SeekableReadStream *BZFFile::getResource(uint32 index, bool UNUSED(tryNo
 	return resStream;
 }
 
+Common::HashAlgo BZFFile::getNameHashAlgo() const {
+	return _hashAlgo;
+}
+
+bool BZFFile::canGetResourcesConcurrently() const {
+	return _bzf->canReadAtConcurrently();
+}
+
 Common::SeekableReadStream *BZFFile::decompress(Common::MemoryReadStream &packedStream,
                                                 uint32 unpackedSize) const {
 	lzma_filter filters[2];
@@ -29,6 +29,7 @@
 #include <cassert>
 
 #include "src/common/memreadstream.h"
+#include "src/common/inflatestream.h"
 #include "src/common/readfile.h"
 #include "src/common/util.h"
 #include "src/common/strutil.h"
@@ -379,15 +380,21 @@ uint32 ERFFile::getResourceSize(uint32 index) const {
 	return getIResource(index).unpackedSize;
 }
 
+uint32 ERFFile::getResourceOffset(uint32 index) const {
+	return getIResource(index).offset;
+}
+
 Common::SeekableReadStream *ERFFile::getResource(uint32 index, bool tryNoCopy) const {
 	const IResource &res = getIResource(index);
 
 	if (tryNoCopy && (getCompressionType() == 0))
-		return new Common::SeekableSubReadStream(_erf, res.offset, res.offset + res.packedSize);
+		return new Common::PositionalSubReadStream(_erf, res.offset, res.offset + res.packedSize);
 
-	_erf->seek(res.offset);
+	return decompress(_erf->readStreamAt(res.offset, res.packedSize), res.unpackedSize);
+}
 
-	return decompress(_erf->readStream(res.packedSize), res.unpackedSize);
+bool ERFFile::canGetResourcesConcurrently() const {
+	return _erf->canReadAtConcurrently();
 }
 
 uint32 ERFFile::getCompressionType() const {
@@ -428,6 +435,20 @@ Common::SeekableReadStream *ERFFile::decompressBiowareZlib(Common::MemoryReadStr
 	byte *compressedData = const_cast<byte *>(packedStream->getData());
 	uint32 packedSize = packedStream->size();
 
+	if (packedSize < 1) {
+		delete packedStream;
+		throw Common::Exception(Common::kReadError);
+	}
+
+	// Inflate big resources on demand, to keep the memory footprint down
+	if (unpackedSize >= Common::InflateReadStream::kStreamingThreshold) {
+		const int windowBits = *compressedData >> 4;
+
+		return new Common::InflateReadStream(
+			new Common::PositionalSubReadStream(packedStream, 1, packedSize, true),
+			unpackedSize, windowBits, true);
+	}
+
 	Common::SeekableReadStream *stream = 0;
 	try {
 		stream = decompressZlib(compressedData + 1, packedSize - 1, unpackedSize, *compressedData >> 4);
@@ -450,6 +471,10 @@ Common::SeekableReadStream *ERFFile::decompressHeaderlessZlib(Common::MemoryRead
 	byte *compressedData = const_cast<byte *>(packedStream->getData());
 	uint32 packedSize = packedStream->size();
 
+	// Inflate big resources on demand, to keep the memory footprint down
+	if (unpackedSize >= Common::InflateReadStream::kStreamingThreshold)
+		return new Common::InflateReadStream(packedStream, unpackedSize, MAX_WBITS, true);
+
 	Common::SeekableReadStream *stream = 0;
 	try {
 		stream = decompressZlib(compressedData, packedSize, unpackedSize, MAX_WBITS);
@@ -53,9 +53,15 @@ public:
 	/** Return the size of a resource. */
 	uint32 getResourceSize(uint32 index) const;
 
+	/** Return the offset of a resource's data within the archive. */
+	uint32 getResourceOffset(uint32 index) const;
+
 	/** Return a stream of the resource's contents. */
 	Common::SeekableReadStream *getResource(uint32 index, bool tryNoCopy = false) const;
 
+	/** Can resources be read from several threads at the same time? */
+	bool canGetResourcesConcurrently() const;
+
 	/** Return the year the ERF was built. */
 	uint32 getBuildYear() const;
 	/** Return the day of year the ERF was built. */
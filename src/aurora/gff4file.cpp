@@ -27,9 +27,14 @@
  */
 
 #include <cassert>
+#include <cstring>
 
+#include <algorithm>
+
+#include "src/common/util.h"
 #include "src/common/error.h"
 #include "src/common/readstream.h"
+#include "src/common/memreadstream.h"
 #include "src/common/encoding.h"
 #include "src/common/strutil.h"
 
@@ -63,14 +68,26 @@ void GFF4File::Header::read(Common::SeekableReadStream &gff4, uint32 version) {
 }
 
 
+size_t GFF4File::StructTemplate::findField(uint32 fieldLabel) const {
+	// Find the last field with this label, which is the one taking precedence
+	std::vector< std::pair<uint32, uint32> >::const_iterator f =
+		std::upper_bound(sortedFields.begin(), sortedFields.end(), std::make_pair(fieldLabel, 0xFFFFFFFFU));
+
+	if ((f == sortedFields.begin()) || ((--f)->first != fieldLabel))
+		return fields.size();
+
+	return f->second;
+}
+
+
 GFF4File::GFF4File(Common::SeekableReadStream *gff4, uint32 type) :
-	_stream(gff4), _topLevelStruct(0) {
+	_stream(gff4), _data(0), _size(0), _topLevelStruct(0) {
 
 	load(type);
 }
 
 GFF4File::GFF4File(const Common::UString &gff4, FileType fileType, uint32 type) :
-	_stream(0), _topLevelStruct(0) {
+	_stream(0), _data(0), _size(0), _topLevelStruct(0) {
 
 	_stream = ResMan.getResource(gff4, fileType);
 	if (!_stream)
@@ -87,6 +104,9 @@ void GFF4File::clear() {
 	delete _stream;
 	_stream = 0;
 
+	_data = 0;
+	_size = 0;
+
 	for (StructMap::iterator s = _structs.begin(); s != _structs.end(); ++s)
 		delete s->second;
 
@@ -113,6 +133,7 @@ const GFF4Struct &GFF4File::getTopLevel() const {
 void GFF4File::load(uint32 type) {
 	try {
 
+		loadData();
 		loadHeader(type);
 		loadStructs();
 		loadStrings();
@@ -125,6 +146,21 @@ void GFF4File::load(uint32 type) {
 	}
 }
 
+void GFF4File::loadData() {
+	// Make sure the whole file is in memory, so that we can read values directly out of it
+	if (!dynamic_cast<Common::MemoryReadStream *>(_stream)) {
+		_stream->seek(0);
+
+		Common::SeekableReadStream *memStream = _stream->readStream(_stream->size());
+
+		delete _stream;
+		_stream = memStream;
+	}
+
+	_data = static_cast<Common::MemoryReadStream *>(_stream)->getData();
+	_size = _stream->size();
+}
+
 void GFF4File::loadHeader(uint32 type) {
 	readHeader(*_stream);
 
@@ -145,22 +181,27 @@ void GFF4File::loadStructs() {
 	// Load the struct templates
 
 	static const uint32 kStructTemplateSize = 16;
-	const uint32 structTemplateStart = _stream->pos();
+	static const uint32 kFieldSize          = 12;
+
+	if (_header.structCount == 0)
+		throw Common::Exception("GFF4: No struct templates");
+
+	const byte *structTemplates = getData(_stream->pos(), kStructTemplateSize, _header.structCount);
 
 	_structTemplates.resize(_header.structCount);
 	for (uint32 i = 0; i < _header.structCount; i++) {
-		_stream->seek(structTemplateStart + i * kStructTemplateSize);
+		const byte *structTemplate = structTemplates + i * kStructTemplateSize;
 
 		StructTemplate &strct = _structTemplates[i];
 
 		// Read struct properties
 
-		strct.label = _stream->readUint32BE();
+		strct.label = READ_BE_UINT32(structTemplate);
 
-		const uint32 fieldCount  = _stream->readUint32LE();
-		const uint32 fieldOffset = _stream->readUint32LE();
+		const uint32 fieldCount  = READ_LE_UINT32(structTemplate + 4);
+		const uint32 fieldOffset = READ_LE_UINT32(structTemplate + 8);
 
-		strct.size = _stream->readUint32LE();
+		strct.size = READ_LE_UINT32(structTemplate + 12);
 
 		// Check if we need to read fields
 		if (fieldOffset == 0xFFFFFFFF) {
@@ -170,19 +211,24 @@ void GFF4File::loadStructs() {
 			continue;
 		}
 
-		_stream->seek(fieldOffset);
-
 		// Read the field declarations
 
+		const byte *fields = getData(fieldOffset, kFieldSize, fieldCount);
+
 		strct.fields.resize(fieldCount);
+		strct.sortedFields.resize(fieldCount);
 		for (uint32 j = 0; j < fieldCount; j++) {
 			StructTemplate::Field &field = strct.fields[j];
 
-			field.label  = _stream->readUint32LE();
-			field.type   = _stream->readUint16LE();
-			field.flags  = _stream->readUint16LE();
-			field.offset = _stream->readUint32LE();
+			field.label  = READ_LE_UINT32(fields + j * kFieldSize);
+			field.type   = READ_LE_UINT16(fields + j * kFieldSize + 4);
+			field.flags  = READ_LE_UINT16(fields + j * kFieldSize + 6);
+			field.offset = READ_LE_UINT32(fields + j * kFieldSize + 8);
+
+			strct.sortedFields[j] = std::make_pair(field.label, j);
 		}
+
+		std::sort(strct.sortedFields.begin(), strct.sortedFields.end());
 	}
 
 	// And load the top level struct, which itself recurses into field structs
@@ -193,11 +239,22 @@ void GFF4File::loadStrings() {
 	if (!_header.hasSharedStrings)
 		return;
 
+	/* Only find where each string starts. The strings themselves are
+	 * decoded when they're first requested, since most of them usually
+	 * never are. */
+
 	_sharedStrings.resize(_header.stringCount);
+	_sharedStringDecoded.resize(_header.stringCount, false);
+	_sharedStringOffsets.resize(_header.stringCount);
+
+	size_t offset = MIN<size_t>(_header.stringOffset, _size);
+	for (uint32 i = 0; i < _header.stringCount; i++) {
+		_sharedStringOffsets[i] = offset;
 
-	_stream->seek(_header.stringOffset);
-	for (uint32 i = 0; i < _header.stringCount; i++)
-		_sharedStrings[i] = Common::readString(*_stream, Common::kEncodingUTF8);
+		const byte *end = (const byte *) std::memchr(_data + offset, 0, _size - offset);
+
+		offset = end ? (end - _data + 1) : _size;
+	}
 }
 
 // --- Helpers for GFF4Struct ---
@@ -222,10 +279,12 @@ GFF4Struct *GFF4File::findStruct(uint32 offset) {
 	return s->second;
 }
 
-Common::SeekableReadStream &GFF4File::getStream(uint32 offset) const {
-	_stream->seek(offset);
+const byte *GFF4File::getData(uint32 offset, uint32 size, uint32 count) const {
+	if ((offset > _size) || ((size > 0) && (count > ((_size - offset) / size))))
+		throw Common::Exception("GFF4: Data out of range (%u + %u * %u > %u)",
+		                        offset, count, size, (uint) _size);
 
-	return *_stream;
+	return _data + offset;
 }
 
 uint32 GFF4File::getDataOffset() const {
@@ -233,7 +292,8 @@ uint32 GFF4File::getDataOffset() const {
 }
 
 const GFF4File::StructTemplate &GFF4File::getStructTemplate(uint32 i) const {
-	assert(i < _structTemplates.size());
+	if (i >= _structTemplates.size())
+		throw Common::Exception("GFF4: Invalid struct template %u", i);
 
 	return _structTemplates[i];
 }
@@ -242,8 +302,18 @@ bool GFF4File::hasSharedStrings() const {
 	return _header.hasSharedStrings;
 }
 
-Common::UString GFF4File::getSharedString(uint32 i) const {
-	assert(i < _sharedStrings.size());
+const Common::UString &GFF4File::getSharedString(uint32 i) const {
+	if (i >= _sharedStrings.size())
+		throw Common::Exception("GFF4: Invalid shared string %u", i);
+
+	if (!_sharedStringDecoded[i]) {
+		const size_t offset = _sharedStringOffsets[i];
+
+		Common::MemoryReadStream stream(_data + offset, _size - offset);
+		_sharedStrings[i] = Common::readString(stream, Common::kEncodingUTF8);
+
+		_sharedStringDecoded[i] = true;
+	}
 
 	return _sharedStrings[i];
 }
@@ -280,7 +350,7 @@ GFF4Struct::Field::~Field() {
 
 
 GFF4Struct::GFF4Struct(GFF4File &parent, uint32 offset, const GFF4File::StructTemplate &tmplt) :
-	_parent(&parent), _label(tmplt.label), _id(offset), _refCount(0), _fieldCount(0) {
+	_parent(&parent), _label(tmplt.label), _id(offset), _refCount(0), _fieldCount(0), _template(&tmplt) {
 
 	parent.registerStruct(offset, this);
 
@@ -293,7 +363,7 @@ GFF4Struct::GFF4Struct(GFF4File &parent, uint32 offset, const GFF4File::StructTe
 }
 
 GFF4Struct::GFF4Struct(GFF4File &parent, const Field &genericParent) :
-	_parent(&parent), _label(0), _id(genericParent.offset), _refCount(0), _fieldCount(0) {
+	_parent(&parent), _label(0), _id(genericParent.offset), _refCount(0), _fieldCount(0), _template(0) {
 
 	parent.registerStruct(genericParent.offset, this);
 
@@ -315,6 +385,8 @@ uint32 GFF4Struct::getLabel() const {
 // --- Loader ---
 
 void GFF4Struct::load(GFF4File &parent, uint32 offset, const GFF4File::StructTemplate &tmplt) {
+	_fields.resize(tmplt.fields.size());
+
 	for (size_t i = 0; i < tmplt.fields.size(); i++) {
 		const GFF4File::StructTemplate::Field &field = tmplt.fields[i];
 
@@ -324,7 +396,7 @@ void GFF4Struct::load(GFF4File &parent, uint32 offset, const GFF4File::StructTem
 			fieldOffset = 0xFFFFFFFF;
 
 		// Load the field and its struct(s), if any
-		Field &f = _fields[field.label] = Field(field.label, field.type, field.flags, fieldOffset);
+		Field &f = _fields[i] = Field(field.label, field.type, field.flags, fieldOffset);
 		if (f.type == kIFieldTypeStruct)
 			loadStructs(parent, f);
 		if (f.type == kIFieldTypeGeneric)
@@ -340,11 +412,10 @@ void GFF4Struct::loadStructs(GFF4File &parent, Field &field) {
 
 	const GFF4File::StructTemplate &tmplt = parent.getStructTemplate(field.structIndex);
 
-	Common::SeekableReadStream &data = parent.getStream(field.offset);
+	const uint32 structSize = field.isReference ? 4 : tmplt.size;
 
-	const uint32 structCount = getListCount(data, field);
-	const uint32 structSize  = field.isReference ? 4 : tmplt.size;
-	const uint32 structStart = data.pos();
+	uint32 structStart = field.offset;
+	const uint32 structCount = getListCount(structStart, field, structSize);
 
 	field.structs.resize(structCount, 0);
 	for (uint32 i = 0; i < structCount; i++) {
@@ -379,19 +450,24 @@ void GFF4Struct::loadGeneric(GFF4File &parent, Field &field) {
 void GFF4Struct::load(GFF4File &parent, const Field &genericParent) {
 	static const uint32 kGenericSize = 8;
 
-	Common::SeekableReadStream &data = parent.getStream(genericParent.offset);
+	uint32 genericStart = genericParent.offset;
 
-	const uint32 genericCount = genericParent.isList ? data.readUint32LE() : 1;
-	const uint32 genericStart = data.pos();
+	uint32 genericCount = 1;
+	if (genericParent.isList) {
+		genericCount = READ_LE_UINT32(parent.getData(genericStart, 4));
+		genericStart += 4;
+	}
 
-	for (uint32 i = 0; i < genericCount; i++) {
-		data.seek(genericStart + i * kGenericSize);
+	const byte *generics = parent.getData(genericStart, kGenericSize, genericCount);
 
-		const uint16 fieldType   = data.readUint16LE();
-		const uint16 fieldFlags  = data.readUint16LE();
+	_fields.resize(genericCount);
+	for (uint32 i = 0; i < genericCount; i++) {
+		const uint16 fieldType   = READ_LE_UINT16(generics + i * kGenericSize);
+		const uint16 fieldFlags  = READ_LE_UINT16(generics + i * kGenericSize + 2);
 
-		const uint32 fieldOffset = getDataOffset(genericParent.isReference, data.pos());
+		const uint32 fieldOffset = getDataOffset(genericParent.isReference, genericStart + i * kGenericSize + 4);
 
+		// Fields without data stay of type kIFieldTypeNone, and so don't exist
 		if (fieldOffset == 0xFFFFFFFF)
 			continue;
 
@@ -432,20 +508,26 @@ GFF4Struct::FieldType GFF4Struct::getFieldType(uint32 field, bool &isList) const
 // --- Field value reader helpers ---
 
 const GFF4Struct::Field *GFF4Struct::getField(uint32 field) const {
-	FieldMap::const_iterator f = _fields.find(field);
-	if (f == _fields.end())
+	// Generics index their fields directly by ID
+	if (!_template) {
+		if ((field >= _fields.size()) || (_fields[field].type == kIFieldTypeNone))
+			return 0;
+
+		return &_fields[field];
+	}
+
+	const size_t index = _template->findField(field);
+	if (index >= _fields.size())
 		return 0;
 
-	return &f->second;
+	return &_fields[index];
 }
 
 uint32 GFF4Struct::getDataOffset(bool isReference, uint32 offset) const {
 	if (!isReference || (offset == 0xFFFFFFFF))
 		return offset;
 
-	Common::SeekableReadStream &data = _parent->getStream(offset);
-
-	offset = data.readUint32LE();
+	offset = READ_LE_UINT32(_parent->getData(offset, 4));
 	if (offset == 0xFFFFFFFF)
 		return offset;
 
@@ -459,19 +541,11 @@ uint32 GFF4Struct::getDataOffset(const Field &field) const {
 	return getDataOffset(field.isReference, field.offset);
 }
 
-Common::SeekableReadStream *GFF4Struct::getData(const Field &field) const {
-	const uint32 offset = getDataOffset(field);
-	if (offset == 0xFFFFFFFF)
-		return 0;
-
-	return &_parent->getStream(offset);
-}
-
-Common::SeekableReadStream *GFF4Struct::getField(uint32 fieldID, const Field *&field) const {
+uint32 GFF4Struct::getField(uint32 fieldID, const Field *&field) const {
 	if (!(field = getField(fieldID)))
-		return 0;
+		return 0xFFFFFFFF;
 
-	return getData(*field);
+	return getDataOffset(*field);
 }
 
 GFF4Struct::FieldType GFF4Struct::convertFieldType(IFieldType type) const {
@@ -542,17 +616,24 @@ uint32 GFF4Struct::getVectorMatrixLength(const Field &field, uint32 maxLength) c
 	return length;
 }
 
-uint32 GFF4Struct::getListCount(Common::SeekableReadStream &data, const Field &field) const {
-	if (!field.isList)
-		return 1;
+uint32 GFF4Struct::getListCount(uint32 &offset, const Field &field, uint32 elementSize) const {
+	uint32 count = 1;
 
-	const uint32 listOffset = data.readUint32LE();
-	if (listOffset == 0xFFFFFFFF)
-		return 0;
+	if (field.isList) {
+		const uint32 listOffset = READ_LE_UINT32(_parent->getData(offset, 4));
+		if (listOffset == 0xFFFFFFFF)
+			return 0;
+
+		offset = _parent->getDataOffset() + listOffset;
+
+		count   = READ_LE_UINT32(_parent->getData(offset, 4));
+		offset += 4;
+	}
 
-	data.seek(_parent->getDataOffset() + listOffset);
+	// Make sure all elements are within the file
+	_parent->getData(offset, elementSize, count);
 
-	return data.readUint32LE();
+	return count;
 }
 
 uint32 GFF4Struct::getFieldSize(IFieldType type) const {
@@ -568,6 +649,7 @@ uint32 GFF4Struct::getFieldSize(IFieldType type) const {
 		case kIFieldTypeUint32:
 		case kIFieldTypeSint32:
 		case kIFieldTypeFloat32:
+		case kIFieldTypeNDSFixed:
 			return 4;
 
 		case kIFieldTypeUint64:
@@ -606,31 +688,29 @@ uint32 GFF4Struct::getFieldSize(IFieldType type) const {
 
 // --- Low-level value readers ---
 
-uint64 GFF4Struct::getUint(Common::SeekableReadStream &data, IFieldType type) const {
+uint64 GFF4Struct::getUint(const byte *data, IFieldType type) const {
 	switch (type) {
 		case kIFieldTypeUint8:
-			return (uint64) data.readByte();
+			return (uint64) *data;
 
 		case kIFieldTypeSint8:
-			return (uint64) ((int64) data.readSByte());
+			return (uint64) ((int64) ((int8) *data));
 
 		case kIFieldTypeUint16:
-			return (uint64) data.readUint16LE();
+			return (uint64) READ_LE_UINT16(data);
 
 		case kIFieldTypeSint16:
-			return (uint64) ((int64) data.readSint16LE());
+			return (uint64) ((int64) ((int16) READ_LE_UINT16(data)));
 
 		case kIFieldTypeUint32:
-			return (uint64) data.readUint32LE();
+			return (uint64) READ_LE_UINT32(data);
 
 		case kIFieldTypeSint32:
-			return (uint64) ((int64) data.readSint32LE());
+			return (uint64) ((int64) ((int32) READ_LE_UINT32(data)));
 
 		case kIFieldTypeUint64:
-			return (uint64) data.readUint64LE();
-
 		case kIFieldTypeSint64:
-			return (uint64) ((int64) data.readSint64LE());
+			return (uint64) READ_LE_UINT64(data);
 
 		default:
 			break;
@@ -639,31 +719,29 @@ uint64 GFF4Struct::getUint(Common::SeekableReadStream &data, IFieldType type) co
 	throw Common::Exception("GFF4: Field is not an int type");
 }
 
-int64 GFF4Struct::getSint(Common::SeekableReadStream &data, IFieldType type) const {
+int64 GFF4Struct::getSint(const byte *data, IFieldType type) const {
 	switch (type) {
 		case kIFieldTypeUint8:
-			return (int64) ((uint64) data.readByte());
+			return (int64) ((uint64) *data);
 
 		case kIFieldTypeSint8:
-			return (int64) data.readSByte();
+			return (int64) ((int8) *data);
 
 		case kIFieldTypeUint16:
-			return (int64) ((uint64) data.readUint16LE());
+			return (int64) ((uint64) READ_LE_UINT16(data));
 
 		case kIFieldTypeSint16:
-			return (int64) data.readSint16LE();
+			return (int64) ((int16) READ_LE_UINT16(data));
 
 		case kIFieldTypeUint32:
-			return (int64) ((uint64) data.readUint32LE());
+			return (int64) ((uint64) READ_LE_UINT32(data));
 
 		case kIFieldTypeSint32:
-			return (int64) data.readSint32LE();
+			return (int64) ((int32) READ_LE_UINT32(data));
 
 		case kIFieldTypeUint64:
-			return (int64) ((uint64) data.readUint64LE());
-
 		case kIFieldTypeSint64:
-			return (int64) data.readSint64LE();
+			return (int64) READ_LE_UINT64(data);
 
 		default:
 			break;
@@ -672,16 +750,16 @@ int64 GFF4Struct::getSint(Common::SeekableReadStream &data, IFieldType type) con
 	throw Common::Exception("GFF4: Field is not an int type");
 }
 
-double GFF4Struct::getDouble(Common::SeekableReadStream &data, IFieldType type) const {
+double GFF4Struct::getDouble(const byte *data, IFieldType type) const {
 	switch (type) {
 		case kIFieldTypeFloat32:
-			return (double) data.readIEEEFloatLE();
+			return (double) convertIEEEFloat(READ_LE_UINT32(data));
 
 		case kIFieldTypeFloat64:
-			return (double) data.readIEEEDoubleLE();
+			return convertIEEEDouble(READ_LE_UINT64(data));
 
 		case kIFieldTypeNDSFixed:
-			return readNintendoFixedPoint(data.readUint32LE(), true, 19, 12);
+			return readNintendoFixedPoint(READ_LE_UINT32(data), true, 19, 12);
 
 		default:
 			break;
@@ -690,17 +768,20 @@ double GFF4Struct::getDouble(Common::SeekableReadStream &data, IFieldType type)
 	throw Common::Exception("GFF4: Field is not a float type");
 }
 
-Common::UString GFF4Struct::getString(Common::SeekableReadStream &data, Common::Encoding encoding) const {
+Common::UString GFF4Struct::getStringAt(uint32 offset, Common::Encoding encoding) const {
+	if (_parent->hasSharedStrings())
+		return _parent->getSharedString(offset);
+
 	/* When the string is encoded in UTF-8, then length field specifies the length in bytes.
 	 * Otherwise, it's the length in characters. */
 	const size_t lengthMult = encoding == Common::kEncodingUTF8 ? 1 : Common::getBytesPerCodepoint(encoding);
 
-	const size_t offset = data.pos();
-
-	const uint32 length = data.readUint32LE();
+	const uint32 length = READ_LE_UINT32(_parent->getData(offset, 4));
 	const size_t size   = length * lengthMult;
 
 	try {
+		Common::MemoryReadStream data(_parent->getData(offset + 4, lengthMult, length), size);
+
 		return readStringFixed(data, encoding, size);
 	} catch (...) {
 	}
@@ -708,39 +789,24 @@ Common::UString GFF4Struct::getString(Common::SeekableReadStream &data, Common::
 	return Common::UString::format("GFF4: Invalid string encoding (0x%08X)", (uint) offset);
 }
 
-Common::UString GFF4Struct::getString(Common::SeekableReadStream &data, Common::Encoding encoding,
-                                      uint32 offset) const {
-
-	if (_parent->hasSharedStrings())
-		return _parent->getSharedString(offset);
-
-	const uint32 pos = data.seek(offset);
-
-	Common::UString str = getString(data, encoding);
-
-	data.seek(pos);
-
-	return str;
-}
-
-Common::UString GFF4Struct::getString(Common::SeekableReadStream &data, const Field &field,
-                                      Common::Encoding encoding) const {
-
+Common::UString GFF4Struct::getStringAt(uint32 offset, const Field &field, Common::Encoding encoding) const {
 	if (field.type == kIFieldTypeString) {
-		uint32 offset = data.pos();
 		if (!field.isGeneric) {
-			offset = data.readUint32LE();
-			if (offset == 0xFFFFFFFF)
+			const uint32 stringOffset = READ_LE_UINT32(_parent->getData(offset, 4));
+			if (stringOffset == 0xFFFFFFFF)
 				return "";
 
-			offset += _parent->getDataOffset();
+			// With shared strings, this is an index into the shared string table
+			offset = stringOffset;
+			if (!_parent->hasSharedStrings())
+				offset += _parent->getDataOffset();
 		}
 
-		return getString(data, encoding, offset);
+		return getStringAt(offset, encoding);
 	}
 
 	if (field.type == kIFieldTypeASCIIString)
-		return getString(data, Common::kEncodingASCII, data.pos());
+		return getStringAt(offset, Common::kEncodingASCII);
 
 	throw Common::Exception("GFF4: Field is not a string type");
 }
@@ -749,26 +815,26 @@ Common::UString GFF4Struct::getString(Common::SeekableReadStream &data, const Fi
 
 uint64 GFF4Struct::getUint(uint32 field, uint64 def) const {
 	const Field *f;
-	Common::SeekableReadStream *data = getField(field, f);
-	if (!data)
+	const uint32 offset = getField(field, f);
+	if (offset == 0xFFFFFFFF)
 		return def;
 
 	if (f->isList)
 		throw Common::Exception("GFF4: Tried reading list as singular value");
 
-	return getUint(*data, f->type);
+	return getUint(_parent->getData(offset, getFieldSize(f->type)), f->type);
 }
 
 int64 GFF4Struct::getSint(uint32 field, int64 def) const {
 	const Field *f;
-	Common::SeekableReadStream *data = getField(field, f);
-	if (!data)
+	const uint32 offset = getField(field, f);
+	if (offset == 0xFFFFFFFF)
 		return def;
 
 	if (f->isList)
 		throw Common::Exception("GFF4: Tried reading list as singular value");
 
-	return getSint(*data, f->type);
+	return getSint(_parent->getData(offset, getFieldSize(f->type)), f->type);
 }
 
 bool GFF4Struct::getBool(uint32 field, bool def) const {
@@ -777,28 +843,28 @@ bool GFF4Struct::getBool(uint32 field, bool def) const {
 
 double GFF4Struct::getDouble(uint32 field, double def) const {
 	const Field *f;
-	Common::SeekableReadStream *data = getField(field, f);
-	if (!data)
+	const uint32 offset = getField(field, f);
+	if (offset == 0xFFFFFFFF)
 		return def;
 
 	if (f->isList)
 		throw Common::Exception("GFF4: Tried reading list as singular value");
 
-	return getDouble(*data, f->type);
+	return getDouble(_parent->getData(offset, getFieldSize(f->type)), f->type);
 }
 
 Common::UString GFF4Struct::getString(uint32 field, Common::Encoding encoding,
                                       const Common::UString &def) const {
 
 	const Field *f;
-	Common::SeekableReadStream *data = getField(field, f);
-	if (!data)
+	const uint32 offset = getField(field, f);
+	if (offset == 0xFFFFFFFF)
 		return def;
 
 	if (f->isList)
 		throw Common::Exception("GFF4: Tried reading list as singular value");
 
-	return getString(*data, *f, encoding);
+	return getStringAt(offset, *f, encoding);
 }
 
 Common::UString GFF4Struct::getString(uint32 field, const Common::UString &def) const {
@@ -809,8 +875,8 @@ bool GFF4Struct::getTalkString(uint32 field, Common::Encoding encoding,
                                uint32 &strRef, Common::UString &str) const {
 
 	const Field *f;
-	Common::SeekableReadStream *data = getField(field, f);
-	if (!data)
+	const uint32 offset = getField(field, f);
+	if (offset == 0xFFFFFFFF)
 		return false;
 
 	if (f->type != kIFieldTypeTlkString)
@@ -818,13 +884,15 @@ bool GFF4Struct::getTalkString(uint32 field, Common::Encoding encoding,
 	if (f->isList)
 		throw Common::Exception("GFF4: Tried reading list as singular value");
 
-	strRef = getUint(*data, kIFieldTypeUint32);
+	const byte *data = _parent->getData(offset, getFieldSize(f->type));
 
-	const uint32 offset = getUint(*data, kIFieldTypeUint32);
+	strRef = READ_LE_UINT32(data);
+
+	const uint32 stringOffset = READ_LE_UINT32(data + 4);
 
 	str.clear();
-	if ((offset != 0xFFFFFFFF) && (offset != 0))
-		str = getString(*data, encoding, _parent->getDataOffset() + offset);
+	if ((stringOffset != 0xFFFFFFFF) && (stringOffset != 0))
+		str = getStringAt(_parent->getDataOffset() + stringOffset, encoding);
 
 	return true;
 }
@@ -835,8 +903,8 @@ bool GFF4Struct::getTalkString(uint32 field, uint32 &strRef, Common::UString &st
 
 bool GFF4Struct::getVector3(uint32 field, double &v1, double &v2, double &v3) const {
 	const Field *f;
-	Common::SeekableReadStream *data = getField(field, f);
-	if (!data)
+	const uint32 offset = getField(field, f);
+	if (offset == 0xFFFFFFFF)
 		return false;
 
 	if (f->isList)
@@ -844,17 +912,19 @@ bool GFF4Struct::getVector3(uint32 field, double &v1, double &v2, double &v3) co
 
 	getVectorMatrixLength(*f, 3);
 
-	v1 = getDouble(*data, kIFieldTypeFloat32);
-	v2 = getDouble(*data, kIFieldTypeFloat32);
-	v3 = getDouble(*data, kIFieldTypeFloat32);
+	const byte *data = _parent->getData(offset, 4, 3);
+
+	v1 = getDouble(data    , kIFieldTypeFloat32);
+	v2 = getDouble(data + 4, kIFieldTypeFloat32);
+	v3 = getDouble(data + 8, kIFieldTypeFloat32);
 
 	return true;
 }
 
 bool GFF4Struct::getVector4(uint32 field, double &v1, double &v2, double &v3, double &v4) const {
 	const Field *f;
-	Common::SeekableReadStream *data = getField(field, f);
-	if (!data)
+	const uint32 offset = getField(field, f);
+	if (offset == 0xFFFFFFFF)
 		return false;
 
 	if (f->isList)
@@ -862,34 +932,38 @@ bool GFF4Struct::getVector4(uint32 field, double &v1, double &v2, double &v3, do
 
 	getVectorMatrixLength(*f, 4);
 
-	v1 = getDouble(*data, kIFieldTypeFloat32);
-	v2 = getDouble(*data, kIFieldTypeFloat32);
-	v3 = getDouble(*data, kIFieldTypeFloat32);
-	v4 = getDouble(*data, kIFieldTypeFloat32);
+	const byte *data = _parent->getData(offset, 4, 4);
+
+	v1 = getDouble(data     , kIFieldTypeFloat32);
+	v2 = getDouble(data +  4, kIFieldTypeFloat32);
+	v3 = getDouble(data +  8, kIFieldTypeFloat32);
+	v4 = getDouble(data + 12, kIFieldTypeFloat32);
 
 	return true;
 }
 
 bool GFF4Struct::getMatrix4x4(uint32 field, double (&m)[16]) const {
 	const Field *f;
-	Common::SeekableReadStream *data = getField(field, f);
-	if (!data)
+	const uint32 offset = getField(field, f);
+	if (offset == 0xFFFFFFFF)
 		return false;
 
 	if (f->isList)
 		throw Common::Exception("GFF4: Tried reading list as singular value");
 
 	const uint32 length = getVectorMatrixLength(*f, 16);
+
+	const byte *data = _parent->getData(offset, 4, length);
 	for (uint32 i = 0; i < length; i++)
-		m[i] = getDouble(*data, kIFieldTypeFloat32);
+		m[i] = getDouble(data + i * 4, kIFieldTypeFloat32);
 
 	return true;
 }
 
 bool GFF4Struct::getVectorMatrix(uint32 field, std::vector<double> &vectorMatrix) const {
 	const Field *f;
-	Common::SeekableReadStream *data = getField(field, f);
-	if (!data)
+	const uint32 offset = getField(field, f);
+	if (offset == 0xFFFFFFFF)
 		return false;
 
 	if (f->isList)
@@ -897,9 +971,11 @@ bool GFF4Struct::getVectorMatrix(uint32 field, std::vector<double> &vectorMatrix
 
 	const uint32 length = getVectorMatrixLength(*f, 16);
 
+	const byte *data = _parent->getData(offset, 4, length);
+
 	vectorMatrix.resize(length);
 	for (uint32 i = 0; i < length; i++)
-		vectorMatrix[i] = getDouble(*data, kIFieldTypeFloat32);
+		vectorMatrix[i] = getDouble(data + i * 4, kIFieldTypeFloat32);
 
 	return true;
 }
@@ -908,60 +984,72 @@ bool GFF4Struct::getVectorMatrix(uint32 field, std::vector<double> &vectorMatrix
 
 bool GFF4Struct::getUint(uint32 field, std::vector<uint64> &list) const {
 	const Field *f;
-	Common::SeekableReadStream *data = getField(field, f);
-	if (!data)
+	uint32 offset = getField(field, f);
+	if (offset == 0xFFFFFFFF)
 		return false;
 
-	const uint32 count = getListCount(*data, *f);
+	const uint32 size  = getFieldSize(f->type);
+	const uint32 count = getListCount(offset, *f, size);
+
+	const byte *data = _parent->getData(offset, size, count);
 
 	list.resize(count);
 	for (uint32 i = 0; i < count; i++)
-		list[i] = getUint(*data, f->type);
+		list[i] = getUint(data + i * size, f->type);
 
 	return true;
 }
 
 bool GFF4Struct::getSint(uint32 field, std::vector<int64> &list) const {
 	const Field *f;
-	Common::SeekableReadStream *data = getField(field, f);
-	if (!data)
+	uint32 offset = getField(field, f);
+	if (offset == 0xFFFFFFFF)
 		return false;
 
-	const uint32 count = getListCount(*data, *f);
+	const uint32 size  = getFieldSize(f->type);
+	const uint32 count = getListCount(offset, *f, size);
+
+	const byte *data = _parent->getData(offset, size, count);
 
 	list.resize(count);
 	for (uint32 i = 0; i < count; i++)
-		list[i] = getSint(*data, f->type);
+		list[i] = getSint(data + i * size, f->type);
 
 	return true;
 }
 
 bool GFF4Struct::getBool(uint32 field, std::vector<bool> &list) const {
 	const Field *f;
-	Common::SeekableReadStream *data = getField(field, f);
-	if (!data)
+	uint32 offset = getField(field, f);
+	if (offset == 0xFFFFFFFF)
 		return false;
 
-	const uint32 count = getListCount(*data, *f);
+	const uint32 size  = getFieldSize(f->type);
+	const uint32 count = getListCount(offset, *f, size);
+
+	const byte *data = _parent->getData(offset, size, count);
 
 	list.resize(count);
 	for (uint32 i = 0; i < count; i++)
-		list[i] = getUint(*data, f->type) != 0;
+		list[i] = getUint(data + i * size, f->type) != 0;
 
 	return true;
 }
 
 bool GFF4Struct::getDouble(uint32 field, std::vector<double> &list) const {
 	const Field *f;
-	Common::SeekableReadStream *data = getField(field, f);
-	if (!data)
+	uint32 offset = getField(field, f);
+	if (offset == 0xFFFFFFFF)
 		return false;
 
-	const uint32 count = getListCount(*data, *f);
+	const uint32 size  = getFieldSize(f->type);
+	const uint32 count = getListCount(offset, *f, size);
+
+	const byte *data = _parent->getData(offset, size, count);
 
 	list.resize(count);
 	for (uint32 i = 0; i < count; i++)
-		list[i] = getDouble(*data, f->type);
+		list[i] = getDouble(data + i * size, f->type);
 
 	return true;
 }
@@ -970,8 +1058,8 @@ bool GFF4Struct::getString(uint32 field, Common::Encoding encoding,
                            std::vector<Common::UString> &list) const {
 
 	const Field *f;
-	Common::SeekableReadStream *data = getField(field, f);
-	if (!data) {
+	uint32 offset = getField(field, f);
+	if (offset == 0xFFFFFFFF) {
 		if (f && !f->isList) {
 			list.push_back("");
 			return true;
@@ -980,11 +1068,12 @@ bool GFF4Struct::getString(uint32 field, Common::Encoding encoding,
 		return false;
 	}
 
-	const uint32 count = getListCount(*data, *f);
+	const uint32 size  = getFieldSize(f->type);
+	const uint32 count = getListCount(offset, *f, size);
 
 	list.resize(count);
 	for (uint32 i = 0; i < count; i++)
-		list[i] = getString(*data, *f, encoding);
+		list[i] = getStringAt(offset + i * size, *f, encoding);
 
 	return true;
 }
@@ -998,27 +1087,27 @@ bool GFF4Struct::getTalkString(uint32 field, Common::Encoding encoding,
 
 
 	const Field *f;
-	Common::SeekableReadStream *data = getField(field, f);
-	if (!data)
+	uint32 offset = getField(field, f);
+	if (offset == 0xFFFFFFFF)
 		return false;
 
 	if (f->type != kIFieldTypeTlkString)
 		throw Common::Exception("GFF4: Field is not of TalkString type");
 
-	const uint32 count = getListCount(*data, *f);
+	const uint32 size  = getFieldSize(f->type);
+	const uint32 count = getListCount(offset, *f, size);
+
+	const byte *data = _parent->getData(offset, size, count);
 
 	strRefs.resize(count);
 	strs.resize(count);
 
-	std::vector<uint32> offsets;
-	offsets.resize(count);
-
 	for (uint32 i = 0; i < count; i++) {
-		strRefs[i] = getUint(*data, kIFieldTypeUint32);
+		strRefs[i] = READ_LE_UINT32(data + i * size);
 
-		const uint32 offset = getUint(*data, kIFieldTypeUint32);
-		if ((offset != 0xFFFFFFFF) && (offset != 0))
-			strs[i] = getString(*data, encoding, _parent->getDataOffset() + offset);
+		const uint32 stringOffset = READ_LE_UINT32(data + i * size + 4);
+		if ((stringOffset != 0xFFFFFFFF) && (stringOffset != 0))
+			strs[i] = getStringAt(_parent->getDataOffset() + stringOffset, encoding);
 	}
 
 	return true;
@@ -1032,24 +1121,108 @@ bool GFF4Struct::getTalkString(uint32 field,
 
 bool GFF4Struct::getVectorMatrix(uint32 field, std::vector< std::vector<double> > &list) const {
 	const Field *f;
-	Common::SeekableReadStream *data = getField(field, f);
-	if (!data)
+	uint32 offset = getField(field, f);
+	if (offset == 0xFFFFFFFF)
 		return false;
 
 	const uint32 length = getVectorMatrixLength(*f, 16);
-	const uint32 count  = getListCount(*data, *f);
+	const uint32 size   = getFieldSize(f->type);
+	const uint32 count  = getListCount(offset, *f, size);
+
+	const byte *data = _parent->getData(offset, size, count);
 
 	list.resize(count);
 	for (uint32 i = 0; i < count; i++) {
 
 		list[i].resize(length);
 		for (uint32 j = 0; j < length; j++)
-			list[i][j] = getDouble(*data, kIFieldTypeFloat32);
+			list[i][j] = getDouble(data + i * size + j * 4, kIFieldTypeFloat32);
 	}
 
 	return true;
 }
 
+// --- Bulk list value readers ---
+
+bool GFF4Struct::getUint(uint32 field, std::vector<uint32> &list) const {
+	const Field *f;
+	uint32 offset = getField(field, f);
+	if (offset == 0xFFFFFFFF)
+		return false;
+
+	const uint32 size = getFieldSize(f->type);
+	if ((size > 4) || (convertFieldType(f->type) != kFieldTypeUint))
+		throw Common::Exception("GFF4: Field is not an unsigned int type of up to 32 bits");
+
+	const uint32 count = getListCount(offset, *f, size);
+
+	list.resize(count);
+	if (count == 0)
+		return true;
+
+	Common::MemoryReadStream data(_parent->getData(offset, size, count), count * size);
+
+	if (f->type == kIFieldTypeUint32) {
+		data.readUint32LE(&list[0], count);
+		return true;
+	}
+
+	for (uint32 i = 0; i < count; i++)
+		list[i] = (size == 1) ? data.readByte() : data.readUint16LE();
+
+	return true;
+}
+
+bool GFF4Struct::getSint(uint32 field, std::vector<int32> &list) const {
+	const Field *f;
+	uint32 offset = getField(field, f);
+	if (offset == 0xFFFFFFFF)
+		return false;
+
+	const uint32 size = getFieldSize(f->type);
+	if ((size > 4) || (convertFieldType(f->type) != kFieldTypeSint))
+		throw Common::Exception("GFF4: Field is not a signed int type of up to 32 bits");
+
+	const uint32 count = getListCount(offset, *f, size);
+
+	list.resize(count);
+	if (count == 0)
+		return true;
+
+	Common::MemoryReadStream data(_parent->getData(offset, size, count), count * size);
+
+	if (f->type == kIFieldTypeSint32) {
+		data.readUint32LE((uint32 *) &list[0], count);
+		return true;
+	}
+
+	for (uint32 i = 0; i < count; i++)
+		list[i] = (size == 1) ? data.readSByte() : data.readSint16LE();
+
+	return true;
+}
+
+bool GFF4Struct::getFloat(uint32 field, std::vector<float> &list) const {
+	const Field *f;
+	uint32 offset = getField(field, f);
+	if (offset == 0xFFFFFFFF)
+		return false;
+
+	// Vectors and matrices are just several floats in a row
+	const uint32 length = (f->type == kIFieldTypeFloat32) ? 1 : getVectorMatrixLength(*f, 16);
+	const uint32 size   = getFieldSize(f->type);
+	const uint32 count  = getListCount(offset, *f, size);
+
+	list.resize(count * length);
+	if (count == 0)
+		return true;
+
+	Common::MemoryReadStream data(_parent->getData(offset, size, count), count * size);
+	data.readIEEEFloatLE(&list[0], count * length);
+
+	return true;
+}
+
 // --- Struct reader ---
 
 const GFF4Struct *GFF4Struct::getStruct(uint32 field) const {
@@ -1101,20 +1274,18 @@ const GFF4List &GFF4Struct::getList(uint32 field) const {
 
 Common::SeekableReadStream *GFF4Struct::getData(uint32 field) const {
 	const Field *f;
-	Common::SeekableReadStream *data = getField(field, f);
-	if (!data)
+	uint32 offset = getField(field, f);
+	if (offset == 0xFFFFFFFF)
 		return 0;
 
-	const uint32 count = getListCount(*data, *f);
 	const uint32 size  = getFieldSize(f->type);
+	const uint32 count = getListCount(offset, *f, size);
 
 	if ((size == 0) || (count == 0))
 		return 0;
 
-	const uint32 dataBegin = data->pos();
-	const uint32 dataEnd   = data->pos() + (count * size);
-
-	return new Common::SeekableSubReadStream(data, dataBegin, dataEnd);
+	// The data stays in the GFF4's buffer, so no copy is necessary
+	return new Common::MemoryReadStream(_parent->getData(offset, size, count), count * size);
 }
 
 } // End of namespace Aurora
@@ -26,7 +26,8 @@
 #define AURORA_GFF4FILE_H
 
 #include <vector>
-#include <map>
+
+#include <boost/unordered/unordered_map.hpp>
 
 #include "src/common/types.h"
 #include "src/common/ustring.h"
@@ -54,6 +55,10 @@ class GFF4Struct;
  *    in Sonic, which have strings in a language-specific encoding. For example,
  *    the English, French, Italian, German and Spanish (EFIGS) versions have
  *    the strings in TLK files encoded in Windows CP-1252.
+ *  - The whole file is held in memory, and all values are read directly out
+ *    of that buffer. If the stream given to the constructor already is a
+ *    MemoryReadStream, its buffer is used as-is.
+ *  - The shared strings of V4.1 files are only decoded when first accessed.
  */
 class GFF4File : public AuroraBase {
 public:
@@ -99,23 +104,39 @@ private:
 		uint32 size;
 
 		std::vector<Field> fields;
+
+		/** The fields' labels and indices, sorted by label. */
+		std::vector< std::pair<uint32, uint32> > sortedFields;
+
+		/** Return the index of the field with this label, or fields.size() if there is none. */
+		size_t findField(uint32 fieldLabel) const;
 	};
 
 	typedef std::vector<StructTemplate> StructTemplates;
 	typedef std::vector<Common::UString> SharedStrings;
-	typedef std::map<uint32, GFF4Struct *> StructMap;
+	typedef boost::unordered_map<uint32, GFF4Struct *> StructMap;
 
 
 
+	/** The GFF4 file, always a MemoryReadStream. */
 	Common::SeekableReadStream *_stream;
 
+	/** The data of the whole GFF4 file. */
+	const byte *_data;
+	/** The size of the whole GFF4 file. */
+	size_t _size;
+
 	/** This GFF4's header. */
 	Header          _header;
 	/** All struct templates in this GFF4. */
 	StructTemplates _structTemplates;
 
-	/** The shared strings used in V4.1. */
-	SharedStrings _sharedStrings;
+	/** The shared strings used in V4.1, decoded on demand. */
+	mutable SharedStrings _sharedStrings;
+	/** Has this shared string already been decoded? */
+	mutable std::vector<bool> _sharedStringDecoded;
+	/** The offsets of the shared strings. */
+	std::vector<uint32> _sharedStringOffsets;
 
 	/** All actual structs in this GFF4. */
 	StructMap   _structs;
@@ -125,6 +146,7 @@ private:
 
 	// .--- Loading helpers
 	void load(uint32 type);
+	void loadData();
 	void loadHeader(uint32 type);
 	void loadStructs();
 	void loadStrings();
@@ -137,12 +159,14 @@ private:
 	void unregisterStruct(uint32 offset);
 	GFF4Struct *findStruct(uint32 offset);
 
-	Common::SeekableReadStream &getStream(uint32 offset) const;
+	/** Return a pointer to count elements of size bytes at offset, making sure they're within the file. */
+	const byte *getData(uint32 offset, uint32 size, uint32 count = 1) const;
+
 	const StructTemplate &getStructTemplate(uint32 i) const;
 	uint32 getDataOffset() const;
 
 	bool hasSharedStrings() const;
-	Common::UString getSharedString(uint32 i) const;
+	const Common::UString &getSharedString(uint32 i) const;
 	// '---
 
 	friend class GFF4Struct;
@@ -232,6 +256,20 @@ public:
 	bool getVectorMatrix(uint32 field, std::vector< std::vector<double> > &list) const;
 	// '---
 
+	// .--- Bulk lists of values
+	/** Return a list of integers of up to 32 bits, in one go. */
+	bool getUint(uint32 field, std::vector<uint32> &list) const;
+	/** Return a list of integers of up to 32 bits, in one go. */
+	bool getSint(uint32 field, std::vector< int32> &list) const;
+
+	/** Return a list of 32-bit floats, in one go.
+	 *
+	 *  Lists of vectors and matrices are returned flattened, with all their
+	 *  components one after the other.
+	 */
+	bool getFloat(uint32 field, std::vector<float> &list) const;
+	// '---
+
 	// .--- Structs and lists of structs
 	const GFF4Struct *getStruct (uint32 field) const;
 	const GFF4Struct *getGeneric(uint32 field) const;
@@ -288,7 +326,7 @@ private:
 		~Field();
 	};
 
-	typedef std::map<uint32, Field> FieldMap;
+	typedef std::vector<Field> Fields;
 
 
 	const GFF4File *_parent;
@@ -300,7 +338,11 @@ private:
 
 	size_t _fieldCount;
 
-	FieldMap _fields;
+	/** The template this struct was loaded from, or 0 for a generic. */
+	const GFF4File::StructTemplate *_template;
+
+	/** The fields, in the order of the template, or indexed by ID for a generic. */
+	Fields _fields;
 
 
 	// .--- Loader
@@ -323,26 +365,24 @@ private:
 	uint32 getDataOffset(bool isReference, uint32 offset) const;
 	uint32 getDataOffset(const Field &field) const;
 
-	Common::SeekableReadStream *getData(const Field &field) const;
-	Common::SeekableReadStream *getField(uint32 fieldID, const Field *&field) const;
+	/** Return the offset of the field's data, or 0xFFFFFFFF if there is none. */
+	uint32 getField(uint32 fieldID, const Field *&field) const;
 	// '---
 
 	// .--- Field reader helpers
 	FieldType convertFieldType(IFieldType type) const;
 
-	uint32 getListCount(Common::SeekableReadStream &data, const Field &field) const;
+	/** Return the number of elements in a field, and move offset to the first one. */
+	uint32 getListCount(uint32 &offset, const Field &field, uint32 elementSize) const;
 	uint32 getFieldSize(IFieldType type) const;
 
-	uint64 getUint(Common::SeekableReadStream &data, IFieldType type) const;
-	 int64 getSint(Common::SeekableReadStream &data, IFieldType type) const;
+	uint64 getUint(const byte *data, IFieldType type) const;
+	 int64 getSint(const byte *data, IFieldType type) const;
 
-	double getDouble(Common::SeekableReadStream &data, IFieldType type) const;
+	double getDouble(const byte *data, IFieldType type) const;
 
-	Common::UString getString(Common::SeekableReadStream &data, Common::Encoding encoding) const;
-	Common::UString getString(Common::SeekableReadStream &data, Common::Encoding encoding,
-	                          uint32 offset) const;
-	Common::UString getString(Common::SeekableReadStream &data, const Field &field,
-	                          Common::Encoding encoding) const;
+	Common::UString getStringAt(uint32 offset, Common::Encoding encoding) const;
+	Common::UString getStringAt(uint32 offset, const Field &field, Common::Encoding encoding) const;
 
 	uint32 getVectorMatrixLength(const Field &field, uint32 maxLength) const;
 	// '---
@@ -157,15 +157,21 @@ uint32 HERFFile::getResourceSize(uint32 index) const {
 	return getIResource(index).size;
 }
 
+uint32 HERFFile::getResourceOffset(uint32 index) const {
+	return getIResource(index).offset;
+}
+
 Common::SeekableReadStream *HERFFile::getResource(uint32 index, bool tryNoCopy) const {
 	const IResource &res = getIResource(index);
 
 	if (tryNoCopy)
-		return new Common::SeekableSubReadStream(_herf, res.offset, res.offset + res.size);
+		return new Common::PositionalSubReadStream(_herf, res.offset, res.offset + res.size);
 
-	_herf->seek(res.offset);
+	return _herf->readStreamAt(res.offset, res.size);
+}
 
-	return _herf->readStream(res.size);
+bool HERFFile::canGetResourcesConcurrently() const {
+	return _herf->canReadAtConcurrently();
 }
 
 Common::HashAlgo HERFFile::getNameHashAlgo() const {
@@ -26,6 +26,8 @@
  * (<https://github.com/xoreos/xoreos-docs/tree/master/specs/bioware>)
  */
 
+#include <cstring>
+
 #include "src/common/util.h"
 #include "src/common/strutil.h"
 #include "src/common/error.h"
@@ -33,6 +35,7 @@
 #include "src/common/encoding.h"
 
 #include "src/aurora/keyfile.h"
+#include "src/aurora/util.h"
 
 static const uint32 kKEYID     = MKTAG('K', 'E', 'Y', ' ');
 static const uint32 kVersion1  = MKTAG('V', '1', ' ', ' ');
@@ -40,7 +43,7 @@ static const uint32 kVersion11 = MKTAG('V', '1', '.', '1');
 
 namespace Aurora {
 
-KEYFile::KEYFile(Common::SeekableReadStream &key) {
+KEYFile::KEYFile(Common::SeekableReadStream &key, Common::HashAlgo hashAlgo) : _hashAlgo(hashAlgo) {
 	load(key);
 }
 
@@ -59,9 +62,6 @@ void KEYFile::load(Common::SeekableReadStream &key) {
 	uint32 bifCount = key.readUint32LE();
 	uint32 resCount = key.readUint32LE();
 
-	_bifs.reserve(bifCount);
-	_resources.reserve(resCount);
-
 	// Version 1.1 has some NULL bytes here
 	if (_version == kVersion11)
 		key.skip(4);
@@ -77,8 +77,7 @@ void KEYFile::load(Common::SeekableReadStream &key) {
 		_bifs.resize(bifCount);
 		readBIFList(key, offFileTable);
 
-		_resources.resize(resCount);
-		readResList(key, offResTable);
+		readResList(key, offResTable, resCount);
 
 	} catch (Common::Exception &e) {
 		e.add("Failed reading KEY file");
@@ -116,28 +115,115 @@ void KEYFile::readBIFList(Common::SeekableReadStream &key, uint32 offset) {
 	}
 }
 
-void KEYFile::readResList(Common::SeekableReadStream &key, uint32 offset) {
+uint32 KEYFile::getBIFIndex(const byte *entry) const {
+	// The new flags field holds the bifIndex now. The rest contains fixed
+	// resource info.
+	if (_version == kVersion11)
+		return (READ_LE_UINT32(entry + 22) & 0xFFF00000) >> 20;
+
+	return READ_LE_UINT32(entry + 18) >> 20;
+}
+
+void KEYFile::readResList(Common::SeekableReadStream &key, uint32 offset, uint32 count) {
+	const size_t entrySize = (_version == kVersion11) ? 26 : 22;
+
+	if ((offset > key.size()) || (count > ((key.size() - offset) / entrySize)))
+		throw Common::Exception("Resource table out of range");
+
+	// Read the whole resource table in one go
+	std::vector<byte> table(count * entrySize);
+
 	key.seek(offset);
+	if (!table.empty() && (key.read(&table[0], table.size()) != table.size()))
+		throw Common::Exception(Common::kReadError);
 
-	for (ResourceList::iterator res = _resources.begin(); res != _resources.end(); ++res) {
-		res->name = Common::readStringFixed(key, Common::kEncodingASCII, 16);
-		res->type = (FileType) key.readUint16LE();
+	/* Count the resources in each bif and the space their names take up,
+	 * so that we can group the resources by bif and fill the name pool
+	 * without any further reallocations. */
 
-		uint32 id = key.readUint32LE();
+	_bifStarts.resize(_bifs.size() + 1, 0);
 
-		// The new flags field holds the bifIndex now. The rest contains fixed
-		// resource info.
-		if (_version == kVersion11) {
-			uint32 flags = key.readUint32LE();
-			res->bifIndex = (flags & 0xFFF00000) >> 20;
-		} else
-			res->bifIndex = id >> 20;
+	size_t namesSize = 0;
+	for (uint32 i = 0; i < count; i++) {
+		const byte *entry = &table[i * entrySize];
+
+		const uint32 bifIndex = getBIFIndex(entry);
+		if (bifIndex >= _bifs.size())
+			continue;
+
+		const byte *nameEnd = (const byte *) std::memchr(entry, '\0', 16);
+		namesSize += (nameEnd ? (nameEnd - entry) : 16) + 1;
+
+		_bifStarts[bifIndex + 1]++;
+	}
+
+	for (size_t i = 1; i < _bifStarts.size(); i++)
+		_bifStarts[i] += _bifStarts[i - 1];
+
+	_resources.resize(_bifStarts.back());
+	_names.reserve(namesSize);
+
+	std::vector<uint32> bifPositions(_bifStarts.begin(), _bifStarts.end() - 1);
+
+	for (uint32 i = 0; i < count; i++) {
+		const byte *entry = &table[i * entrySize];
+
+		const uint32 bifIndex = getBIFIndex(entry);
+		if (bifIndex >= _bifs.size())
+			continue;
+
+		Resource &res = _resources[bifPositions[bifIndex]++];
+
+		const char  *name       = (const char *) entry;
+		const char  *nameEnd    = (const char *) std::memchr(name, '\0', 16);
+		const size_t nameLength = nameEnd ? (nameEnd - name) : 16;
+
+		res.nameOffset = _names.size();
+		_names.insert(_names.end(), name, name + nameLength);
+		_names.push_back('\0');
+
+		res.type     = (FileType) READ_LE_UINT16(entry + 16);
+		res.bifIndex = bifIndex;
 
 		// TODO: Fixed resources?
-		res->resIndex = id & 0xFFFFF;
+		res.resIndex = READ_LE_UINT32(entry + 18) & 0xFFFFF;
+
+		res.hash = hashName(&_names[res.nameOffset], nameLength, res.type);
 	}
 }
 
+uint64 KEYFile::hashName(const char *name, size_t length, FileType type) const {
+	if (_hashAlgo == Common::kHashNone)
+		return 0;
+
+	/* Hash the lowercased name with the type's extension, like the ResourceManager
+	 * does. As long as the name is plain ASCII and doesn't contain anything that
+	 * looks like an extension or a path, we can do that without creating any
+	 * temporary strings. */
+
+	const char  *ext       = TypeMan.getExtension(type);
+	const size_t extLength = std::strlen(ext);
+
+	char buffer[64];
+	bool plain = (length + extLength) <= sizeof(buffer);
+
+	for (size_t i = 0; plain && (i < length); i++) {
+		const byte c = name[i];
+		if (!Common::UString::isASCII(c) || (c == '.') || (c == '/') || (c == '\\'))
+			plain = false;
+
+		buffer[i] = Common::UString::toLower(c);
+	}
+
+	for (size_t i = 0; plain && (i < extLength); i++)
+		buffer[length + i] = Common::UString::toLower((byte) ext[i]);
+
+	if (!plain)
+		return Common::hashString(TypeMan.setFileType(name, type).toLower(), _hashAlgo);
+
+	return Common::hashString(buffer, length + extLength, _hashAlgo);
+}
+
 const KEYFile::BIFList &KEYFile::getBIFs() const {
 	return _bifs;
 }
@@ -146,4 +232,24 @@ const KEYFile::ResourceList &KEYFile::getResources() const {
 	return _resources;
 }
 
+void KEYFile::getResources(uint32 bifIndex, ResourceList::const_iterator &begin,
+                           ResourceList::const_iterator &end) const {
+
+	if (bifIndex >= _bifs.size()) {
+		begin = end = _resources.end();
+		return;
+	}
+
+	begin = _resources.begin() + _bifStarts[bifIndex];
+	end   = _resources.begin() + _bifStarts[bifIndex + 1];
+}
+
+const char *KEYFile::getName(const Resource &resource) const {
+	return &_names[resource.nameOffset];
+}
+
+Common::HashAlgo KEYFile::getNameHashAlgo() const {
+	return _hashAlgo;
+}
+
 } // End of namespace Aurora
@@ -29,6 +29,7 @@
 
 #include "src/common/types.h"
 #include "src/common/ustring.h"
+#include "src/common/hash.h"
 
 #include "src/aurora/types.h"
 #include "src/aurora/aurorafile.h"
@@ -40,13 +41,20 @@ namespace Common {
 
 namespace Aurora {
 
-/** Class to hold resource index information of a key file. */
+/** Class to hold resource index information of a key file.
+ *
+ *  The names of all resources are kept together in one pool, which the
+ *  resources refer to by offset. Optionally, each resource's name is
+ *  also hashed together with its type once while reading the KEY file,
+ *  in the same way the ResourceManager hashes resource names.
+ */
 class KEYFile : public AuroraBase {
 public:
 	/** A key resource index. */
 	struct Resource {
-		Common::UString name; ///< The resource's name.
-		FileType        type; ///< The resource's type.
+		uint32   nameOffset; ///< Offset of the resource's name within the name pool.
+		uint64   hash;       ///< The resource's hashed name and type.
+		FileType type;       ///< The resource's type.
 
 		uint32 bifIndex; ///< Index into the bif list.
 		uint32 resIndex; ///< Index into the bif's resource table.
@@ -55,23 +63,45 @@ public:
 	typedef std::vector<Resource> ResourceList;
 	typedef std::vector<Common::UString> BIFList;
 
-	KEYFile(Common::SeekableReadStream &key);
+	/** Read a KEY file, optionally hashing the resource names with this algorithm. */
+	KEYFile(Common::SeekableReadStream &key, Common::HashAlgo hashAlgo = Common::kHashNone);
 	~KEYFile();
 
 	/** Return a list of all managed bifs. */
 	const BIFList &getBIFs() const;
 
-	/** Return a list of all containing resources. */
+	/** Return a list of all containing resources, grouped by bif. */
 	const ResourceList &getResources() const;
 
+	/** Return the range of resources that are found in this bif. */
+	void getResources(uint32 bifIndex, ResourceList::const_iterator &begin,
+	                  ResourceList::const_iterator &end) const;
+
+	/** Return the name of this resource. */
+	const char *getName(const Resource &resource) const;
+
+	/** Return the algorithm the resource names have been hashed with. */
+	Common::HashAlgo getNameHashAlgo() const;
+
 private:
+	Common::HashAlgo _hashAlgo;
+
 	BIFList      _bifs;      ///< All managed bifs.
 	ResourceList _resources; ///< All containing resources.
 
+	/** Index of the first resource of each bif, plus the number of resources. */
+	std::vector<uint32> _bifStarts;
+
+	/** The names of all resources, each terminated by a '\0'. */
+	std::vector<char> _names;
+
 	void load(Common::SeekableReadStream &key);
 
 	void readBIFList(Common::SeekableReadStream &key, uint32 offset);
-	void readResList(Common::SeekableReadStream &key, uint32 offset);
+	void readResList(Common::SeekableReadStream &key, uint32 offset, uint32 count);
+
+	uint32 getBIFIndex(const byte *entry) const;
+	uint64 hashName(const char *name, size_t length, FileType type) const;
 };
 
 } // End of namespace Aurora
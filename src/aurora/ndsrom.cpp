@@ -172,17 +172,21 @@ uint32 NDSFile::getResourceSize(uint32 index) const {
 	return getIResource(index).size;
 }
 
+uint32 NDSFile::getResourceOffset(uint32 index) const {
+	return getIResource(index).offset;
+}
+
 Common::SeekableReadStream *NDSFile::getResource(uint32 index, bool tryNoCopy) const {
 	const IResource &res = getIResource(index);
 
-	_nds->seek(res.offset);
-
 	if (tryNoCopy)
-		return new Common::SeekableSubReadStream(_nds, res.offset, res.offset + res.size);
+		return new Common::PositionalSubReadStream(_nds, res.offset, res.offset + res.size);
 
-	_nds->seek(res.offset);
+	return _nds->readStreamAt(res.offset, res.size);
+}
 
-	return _nds->readStream(res.size);
+bool NDSFile::canGetResourcesConcurrently() const {
+	return _nds->canReadAtConcurrently();
 }
 
 } // End of namespace Aurora
@@ -56,9 +56,15 @@ public:
 	/** Return the size of a resource. */
 	uint32 getResourceSize(uint32 index) const;
 
+	/** Return the offset of a resource's data within the archive. */
+	uint32 getResourceOffset(uint32 index) const;
+
 	/** Return a stream of the resource's contents. */
 	Common::SeekableReadStream *getResource(uint32 index, bool tryNoCopy = false) const;
 
+	/** Can resources be read from several threads at the same time? */
+	bool canGetResourcesConcurrently() const;
+
 	/** Return the game title string stored in the NDS header. */
 	const Common::UString &getTitle() const;
 	/** Return the game code string stored in the NDS header. */
@@ -271,6 +271,7 @@ NCSFile::NCSFile(Common::SeekableReadStream *ncs) : _owner(0), _triggerer(0) {
 		load();
 	} catch (...) {
 		delete _script;
+		throw;
 	}
 }
 
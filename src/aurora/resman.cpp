@@ -23,13 +23,21 @@
  */
 
 #include <cassert>
+#include <algorithm>
+
+#include <boost/bind.hpp>
+
+#include <SDL_timer.h>
 
 #include "src/common/util.h"
 #include "src/common/error.h"
 #include "src/common/readstream.h"
+#include "src/common/memreadstream.h"
 #include "src/common/filepath.h"
 #include "src/common/readfile.h"
 #include "src/common/writefile.h"
+#include "src/common/workerpool.h"
+#include "src/common/encoding.h"
 
 #include "src/aurora/resman.h"
 #include "src/aurora/util.h"
@@ -48,6 +56,9 @@
 // Check for hash collisions (if possible)
 #define CHECK_HASH_COLLISION 1
 
+/** Never prefetch more than this many bytes for one load. */
+static const size_t kMaxPrefetchSize = 256 * 1024 * 1024;
+
 DECLARE_SINGLETON(Aurora::ResourceManager)
 
 namespace Aurora {
@@ -102,7 +113,7 @@ bool ResourceManager::Resource::operator<(const Resource &right) const {
 
 
 ResourceManager::ResourceManager() : _hasSmall(false),
-	_hashAlgo(Common::kHashFNV64) {
+	_hashAlgo(Common::kHashFNV64), _trace(0), _traceStart(0) {
 
 	// These file types are archives
 
@@ -165,6 +176,8 @@ ResourceManager::ResourceManager() : _hasSmall(false),
 }
 
 ResourceManager::~ResourceManager() {
+	stopTrace();
+
 	clearResources();
 }
 
@@ -179,6 +192,8 @@ void ResourceManager::clear() {
 }
 
 void ResourceManager::clearResources() {
+	clearPrefetched();
+
 	_cursorRemap.clear();
 
 	_baseDir.clear();
@@ -355,7 +370,8 @@ uint32 ResourceManager::openKEYBIFs(Common::SeekableReadStream *keyStream,
                                     std::vector<BIFFile *> &bifs) {
 	try {
 
-		KEYFile key(*keyStream);
+		// Let the KEY hash the resource names for us while reading them
+		KEYFile key(*keyStream, _hashAlgo);
 
 		const KEYFile::BIFList &keyBIFs = key.getBIFs();
 		archives.resize(keyBIFs.size(), 0);
@@ -431,7 +447,7 @@ void ResourceManager::indexArchive(KnownArchive &knownArchive, Archive *archive,
 		uint64 hash = (hashAlgo == Common::kHashNone) ? getHash(res.name, res.type) : resource->hash;
 
 		// Normalize the file types if we can and recalculate the hash
-		if ((res.name != "") && (res.type != kFileTypeNone))
+		if (!res.name.empty() && (res.type != kFileTypeNone))
 			if (normalizeType(res))
 				hash = getHash(res.name, res.type);
 
@@ -509,6 +525,9 @@ void ResourceManager::undo(Common::ChangeID &changeID) {
 	if (!change || (change->_change == _changes.end()))
 		return;
 
+	// The prefetched resources might be about to go away
+	clearPrefetched();
+
 	// Removing all changes in the opened archives list
 	for (OpenedArchiveChanges::iterator oaChange = change->_change->openedArchives.begin();
 	     oaChange != change->_change->openedArchives.end(); ++oaChange) {
@@ -711,6 +730,20 @@ Common::SeekableReadStream *ResourceManager::getResource(uint64 hash, FileType *
 }
 
 Common::SeekableReadStream *ResourceManager::getResource(const Resource &res, bool tryNoCopy) const {
+	const uint64 start = getTraceTime();
+
+	Common::SeekableReadStream *stream = takePrefetched(res);
+
+	const bool prefetched = stream != 0;
+	if (!prefetched)
+		stream = readResource(res, tryNoCopy);
+
+	traceAccess(res, start, stream->size(), prefetched);
+
+	return stream;
+}
+
+Common::SeekableReadStream *ResourceManager::readResource(const Resource &res, bool tryNoCopy) const {
 	Common::SeekableReadStream *stream = 0;
 
 	switch (res.source) {
@@ -754,6 +787,51 @@ Common::SeekableReadStream *ResourceManager::getResource(ResourceType resType,
 	return 0;
 }
 
+bool ResourceManager::canGetResourceConcurrently(const Resource &res) const {
+	if (res.source == kSourceFile)
+		return true;
+
+	if (res.source == kSourceArchive)
+		return res.archive && res.archive->archive && res.archive->archive->canGetResourcesConcurrently();
+
+	return false;
+}
+
+void ResourceManager::getResourceJob(const Resource *res, Common::SeekableReadStream **stream) const {
+	*stream = getResource(*res);
+}
+
+void ResourceManager::getResources(const std::vector<Common::UString> &names, FileType type,
+                                   std::vector<Common::SeekableReadStream *> &streams) const {
+
+	streams.clear();
+	streams.resize(names.size(), 0);
+
+	try {
+		std::vector<Common::WorkerPool::Job> jobs;
+
+		for (size_t i = 0; i < names.size(); i++) {
+			const Resource *res = getRes(names[i], type);
+			if (!res)
+				continue;
+
+			if (canGetResourceConcurrently(*res))
+				jobs.push_back(boost::bind(&ResourceManager::getResourceJob, this, res, &streams[i]));
+			else
+				streams[i] = getResource(*res);
+		}
+
+		WorkerPoolMan.run(jobs);
+
+	} catch (...) {
+		for (std::vector<Common::SeekableReadStream *>::iterator s = streams.begin(); s != streams.end(); ++s)
+			delete *s;
+
+		streams.clear();
+		throw;
+	}
+}
+
 void ResourceManager::getAvailableResources(FileType type,
 		std::list<ResourceID> &list) const {
 
@@ -1034,6 +1112,306 @@ void ResourceManager::dumpResourcesList(const Common::UString &fileName) const {
 	file.close();
 }
 
+void ResourceManager::startTrace(const Common::UString &fileName) {
+	stopTrace();
+
+	Common::WriteFile *trace = new Common::WriteFile;
+	if (!trace->open(fileName)) {
+		delete trace;
+		throw Common::Exception(Common::kOpenError);
+	}
+
+	trace->writeString("# xoreos resource trace\n");
+	trace->writeString("# time (ms)\tevent\tname\tarchive\toffset\tsize\tduration (us)\tprefetched\n");
+
+	Common::StackLock lock(_traceMutex);
+
+	_trace      = trace;
+	_traceStart = getTraceTime();
+}
+
+void ResourceManager::stopTrace() {
+	Common::StackLock lock(_traceMutex);
+
+	if (!_trace)
+		return;
+
+	try {
+		_trace->flush();
+	} catch (...) {
+	}
+
+	delete _trace;
+	_trace = 0;
+}
+
+void ResourceManager::setPrefetchDirectory(const Common::UString &dir) {
+	_prefetchDir = dir;
+}
+
+void ResourceManager::beginLoad(const Common::UString &label) {
+	endLoad();
+
+	_traceLoad = label;
+	traceLine("load\t" + label);
+
+	if (_prefetchDir.empty())
+		return;
+
+	const Common::UString manifestPath = getManifestPath(_prefetchDir, label);
+	if (!Common::FilePath::isRegularFile(manifestPath))
+		return;
+
+	std::vector<Common::UString> names;
+
+	try {
+		Common::ReadFile manifest(manifestPath);
+
+		while (!manifest.eos()) {
+			Common::UString name = Common::readStringLine(manifest, Common::kEncodingUTF8);
+			name.trim();
+
+			if (!name.empty() && (*name.begin() != '#'))
+				names.push_back(name);
+		}
+
+	} catch (Common::Exception &e) {
+		e.add("Failed reading prefetch manifest \"%s\"", manifestPath.c_str());
+
+		Common::printException(e, "WARNING: ");
+		return;
+	}
+
+	prefetch(names);
+}
+
+void ResourceManager::endLoad() {
+	clearPrefetched();
+
+	if (_traceLoad.empty())
+		return;
+
+	traceLine("end\t" + _traceLoad);
+	_traceLoad.clear();
+}
+
+/** A resource to prefetch, with where to find it. */
+struct PrefetchEntry {
+	const void     *archive;  ///< The archive the resource is in, if any.
+	Common::UString path;     ///< The path of the file the resource is, if any.
+	uint32          offset;   ///< The offset of the resource within its archive.
+	uint32          index;    ///< The index of the resource within its archive.
+	const void     *resource; ///< The resource itself.
+
+	bool operator<(const PrefetchEntry &right) const {
+		if (archive != right.archive)
+			return archive < right.archive;
+		if (offset != right.offset)
+			return offset < right.offset;
+		if (index != right.index)
+			return index < right.index;
+
+		return path < right.path;
+	}
+};
+
+void ResourceManager::prefetch(const std::vector<Common::UString> &names) {
+	std::vector<PrefetchEntry> entries;
+	entries.reserve(names.size());
+
+	for (std::vector<Common::UString>::const_iterator n = names.begin(); n != names.end(); ++n) {
+		const Resource *res = getRes(TypeMan.setFileType(*n, kFileTypeNone), TypeMan.getFileType(*n));
+		if (!res || ((res->source != kSourceFile) && (res->source != kSourceArchive)))
+			continue;
+
+		PrefetchEntry entry;
+
+		entry.archive  = 0;
+		entry.offset   = 0xFFFFFFFF;
+		entry.index    = 0xFFFFFFFF;
+		entry.resource = res;
+
+		if (res->source == kSourceArchive) {
+			if (!res->archive || !res->archive->archive)
+				continue;
+
+			entry.archive = res->archive->archive;
+			entry.offset  = res->archive->archive->getResourceOffset(res->archiveIndex);
+			entry.index   = res->archiveIndex;
+		} else
+			entry.path = res->path;
+
+		entries.push_back(entry);
+	}
+
+	// Read archive by archive, front to back, so that the reads stream instead of seek
+	std::sort(entries.begin(), entries.end());
+
+	size_t prefetchedSize = 0;
+	for (std::vector<PrefetchEntry>::const_iterator e = entries.begin(); e != entries.end(); ++e) {
+		const Resource &res = *static_cast<const Resource *>(e->resource);
+
+		{
+			Common::StackLock lock(_prefetchedMutex);
+			if (_prefetched.find(&res) != _prefetched.end())
+				continue;
+		}
+
+		Common::SeekableReadStream *stream = 0;
+
+		try {
+			stream = readResource(res);
+
+			// Make sure it's all in memory now
+			if (!dynamic_cast<Common::MemoryReadStream *>(stream)) {
+				Common::SeekableReadStream *memStream = stream->readStream(stream->size());
+
+				delete stream;
+				stream = memStream;
+			}
+
+		} catch (...) {
+			// Ignore it for now. Should it be requested, the error will show up then
+			delete stream;
+			continue;
+		}
+
+		prefetchedSize += stream->size();
+
+		Common::StackLock lock(_prefetchedMutex);
+		_prefetched.insert(std::make_pair(&res, stream));
+
+		if (prefetchedSize >= kMaxPrefetchSize)
+			break;
+	}
+}
+
+void ResourceManager::clearPrefetched() {
+	Common::StackLock lock(_prefetchedMutex);
+
+	for (PrefetchedMap::iterator p = _prefetched.begin(); p != _prefetched.end(); ++p)
+		delete p->second;
+
+	_prefetched.clear();
+}
+
+Common::SeekableReadStream *ResourceManager::takePrefetched(const Resource &res) const {
+	Common::StackLock lock(_prefetchedMutex);
+
+	PrefetchedMap::iterator p = _prefetched.find(&res);
+	if (p == _prefetched.end())
+		return 0;
+
+	Common::SeekableReadStream *stream = p->second;
+	_prefetched.erase(p);
+
+	return stream;
+}
+
+void ResourceManager::traceAccess(const Resource &res, uint64 start, uint32 size, bool prefetched) const {
+	Common::StackLock lock(_traceMutex);
+
+	// stopTrace() might delete the trace from another thread at any time
+	if (!_trace)
+		return;
+
+	const uint64 duration = ((getTraceTime() - start) * 1000000) / SDL_GetPerformanceFrequency();
+
+	Common::UString archive = "-";
+	uint32 offset = 0xFFFFFFFF;
+
+	if (res.source == kSourceArchive) {
+		if (res.archive && res.archive->known)
+			archive = res.archive->known->name;
+		if (res.archive && res.archive->archive)
+			offset = res.archive->archive->getResourceOffset(res.archiveIndex);
+	} else if (res.source == kSourceFile)
+		archive = res.path;
+
+	traceLine(Common::UString::format("get\t%s\t%s\t%u\t%u\t%u\t%s",
+	          TypeMan.setFileType(res.name, res.type).c_str(), archive.c_str(),
+	          (uint) offset, (uint) size, (uint) duration, prefetched ? "yes" : "no"));
+}
+
+void ResourceManager::traceLine(const Common::UString &line) const {
+	Common::StackLock lock(_traceMutex);
+
+	if (!_trace)
+		return;
+
+	const double time = ((getTraceTime() - _traceStart) * 1000.0) / SDL_GetPerformanceFrequency();
+
+	try {
+		_trace->writeString(Common::UString::format("%.3f\t", time));
+		_trace->writeString(line);
+		_trace->writeString("\n");
+	} catch (...) {
+		// Tracing should never break getting resources
+	}
+}
+
+uint64 ResourceManager::getTraceTime() {
+	return SDL_GetPerformanceCounter();
+}
+
+Common::UString ResourceManager::getManifestPath(const Common::UString &dir, const Common::UString &label) {
+	// Only keep characters that are safe in file names
+	Common::UString fileName;
+	for (Common::UString::iterator c = label.begin(); c != label.end(); ++c)
+		fileName += (Common::UString::isAlNum(*c) || (*c == '-') || (*c == '.')) ? *c : '_';
+
+	return dir + "/" + fileName + ".pfm";
+}
+
+size_t ResourceManager::writePrefetchManifests(const Common::UString &traceFile, const Common::UString &dir) {
+	Common::ReadFile trace(traceFile);
+
+	size_t count = 0;
+
+	Common::UString load;
+	std::vector<Common::UString> names;
+	std::set<Common::UString> seen;
+
+	while (!trace.eos()) {
+		const Common::UString line = Common::readStringLine(trace, Common::kEncodingUTF8);
+		if (line.empty() || (*line.begin() == '#'))
+			continue;
+
+		std::vector<Common::UString> fields;
+		Common::UString::split(line, '\t', fields);
+		if (fields.size() < 3)
+			continue;
+
+		if        (fields[1] == "load") {
+			load = fields[2];
+
+			names.clear();
+			seen.clear();
+
+		} else if ((fields[1] == "get") && !load.empty()) {
+			if (seen.insert(fields[2]).second)
+				names.push_back(fields[2]);
+
+		} else if ((fields[1] == "end") && (fields[2] == load)) {
+			Common::WriteFile manifest;
+			if (!manifest.open(getManifestPath(dir, load)))
+				throw Common::Exception(Common::kOpenError);
+
+			manifest.writeString("# xoreos prefetch manifest for \"" + load + "\"\n");
+			for (std::vector<Common::UString>::const_iterator n = names.begin(); n != names.end(); ++n)
+				manifest.writeString(*n + "\n");
+
+			manifest.flush();
+			manifest.close();
+
+			load.clear();
+			count++;
+		}
+	}
+
+	return count;
+}
+
 ResourceManager::Change *ResourceManager::newChangeSet(Common::ChangeID &changeID) {
 	// Does this change ID already have a change set attached? If so, use that
 	Change *change = dynamic_cast<Change *>(changeID.getContent());
@@ -36,11 +36,13 @@
 #include "src/common/filelist.h"
 #include "src/common/hash.h"
 #include "src/common/changeid.h"
+#include "src/common/mutex.h"
 
 #include "src/aurora/types.h"
 
 namespace Common {
 	class SeekableReadStream;
+	class WriteFile;
 }
 
 namespace Aurora {
@@ -276,6 +278,22 @@ public:
 	Common::SeekableReadStream *getResource(ResourceType resType,
 			const Common::UString &name, FileType *foundType = 0) const;
 
+	/** Return several resources of the same type at once.
+	 *
+	 *  The resources are looked up on the calling thread, but reading and
+	 *  decompressing them is spread over the worker pool, for all resources
+	 *  that are plain files or come from archives that allow it.
+	 *
+	 *  If getting any of the resources fails, all streams are deleted again
+	 *  and the exception is thrown on.
+	 *
+	 *  @param  names The names (ResRefs) of the resources.
+	 *  @param  type The resources' type.
+	 *  @param  streams Receives one stream per name, or 0 if that resource doesn't exist.
+	 */
+	void getResources(const std::vector<Common::UString> &names, FileType type,
+	                  std::vector<Common::SeekableReadStream *> &streams) const;
+
 	/** Return a list of all available resources of the specified type. */
 	void getAvailableResources(FileType type, std::list<ResourceID> &list) const;
 	/** Return a list of all available resources of the specified type. */
@@ -287,6 +305,58 @@ public:
 	/** Dump a list of all resources into a file. */
 	void dumpResourcesList(const Common::UString &fileName) const;
 
+	// .--- Access traces and prefetching
+	/** Start recording all resource accesses into a trace file.
+	 *
+	 *  Every access is written as one tab-separated line: the time since the
+	 *  trace started, the resource's name, the archive it was found in, its
+	 *  offset within that archive, its size, the time getting it took and
+	 *  whether it was served out of the prefetched resources.
+	 *
+	 *  Loads marked by beginLoad() and endLoad() are recorded as well.
+	 */
+	void startTrace(const Common::UString &fileName);
+	/** Stop recording resource accesses. */
+	void stopTrace();
+
+	/** Set the directory prefetch manifests are read from. Empty disables prefetching. */
+	void setPrefetchDirectory(const Common::UString &dir);
+
+	/** Mark the start of a load, like entering an area.
+	 *
+	 *  The start of the load is recorded into the trace. If a prefetch manifest
+	 *  for this load exists in the prefetch directory, all the resources listed
+	 *  in it are prefetched.
+	 *
+	 *  @param label A name identifying this load, the same on every run.
+	 */
+	void beginLoad(const Common::UString &label);
+	/** Mark the end of a load and drop all prefetched resources that were not used. */
+	void endLoad();
+
+	/** Read resources ahead of time.
+	 *
+	 *  The resources are read one after the other, sorted by their archives
+	 *  and their offsets within these archives. The next request for each of
+	 *  them is then answered out of memory.
+	 *
+	 *  @param names The names (with extension) of the resources.
+	 */
+	void prefetch(const std::vector<Common::UString> &names);
+	/** Drop all prefetched resources that haven't been requested yet. */
+	void clearPrefetched();
+
+	/** Turn the loads recorded in a trace into prefetch manifests.
+	 *
+	 *  For every load in the trace, a manifest named after the load's label is
+	 *  written into the directory. It lists each resource accessed during the
+	 *  load once, in the order they were first accessed.
+	 *
+	 *  @return The number of manifests written.
+	 */
+	static size_t writePrefetchManifests(const Common::UString &traceFile, const Common::UString &dir);
+	// '---
+
 
 private:
 	typedef std::vector<FileType> FileTypeList;
@@ -442,6 +512,20 @@ private:
 	FileTypeSet  _archiveTypeTypes [kArchiveMAX];  ///< All valid archive types file types.
 	FileTypeList _resourceTypeTypes[kResourceMAX]; ///< All valid resource type file types.
 
+	/** Resources read ahead of time, waiting to be requested. */
+	typedef std::map<const Resource *, Common::SeekableReadStream *> PrefetchedMap;
+
+	/** The directory prefetch manifests are read from. */
+	Common::UString _prefetchDir;
+
+	mutable PrefetchedMap _prefetched;      ///< Resources read ahead of time.
+	mutable Common::Mutex _prefetchedMutex; ///< Mutex protecting the prefetched resources.
+
+	Common::WriteFile    *_trace;      ///< The access trace we're recording, if any.
+	uint64                _traceStart; ///< The time the trace was started.
+	Common::UString       _traceLoad;  ///< The label of the load currently running.
+	mutable Common::Mutex _traceMutex; ///< Mutex protecting the access trace.
+
 
 	void clearResources();
 
@@ -479,6 +563,12 @@ private:
 	Common::SeekableReadStream *getResource(const Resource &res, bool tryNoCopy = false) const;
 
 	Common::SeekableReadStream *getArchiveResource(const Resource &res, bool tryNoCopy = false) const;
+	Common::SeekableReadStream *readResource(const Resource &res, bool tryNoCopy = false) const;
+
+	/** Can this resource be read concurrently with other resources? */
+	bool canGetResourceConcurrently(const Resource &res) const;
+	/** Worker pool job for getResources(). */
+	void getResourceJob(const Resource *res, Common::SeekableReadStream **stream) const;
 
 	uint32 getResourceSize(const Resource &res) const;
 	// '---
@@ -498,6 +588,16 @@ private:
 	Change *newChangeSet(Common::ChangeID &changeID);
 	// '---
 
+	// .--- Access traces and prefetching
+	Common::SeekableReadStream *takePrefetched(const Resource &res) const;
+
+	void traceAccess(const Resource &res, uint64 start, uint32 size, bool prefetched) const;
+	void traceLine(const Common::UString &line) const;
+
+	static uint64 getTraceTime();
+	static Common::UString getManifestPath(const Common::UString &dir, const Common::UString &label);
+	// '---
+
 };
 
 } // End of namespace Aurora
@@ -111,15 +111,21 @@ uint32 RIMFile::getResourceSize(uint32 index) const {
 	return getIResource(index).size;
 }
 
+uint32 RIMFile::getResourceOffset(uint32 index) const {
+	return getIResource(index).offset;
+}
+
 Common::SeekableReadStream *RIMFile::getResource(uint32 index, bool tryNoCopy) const {
 	const IResource &res = getIResource(index);
 
 	if (tryNoCopy)
-		return new Common::SeekableSubReadStream(_rim, res.offset, res.offset + res.size);
+		return new Common::PositionalSubReadStream(_rim, res.offset, res.offset + res.size);
 
-	_rim->seek(res.offset);
+	return _rim->readStreamAt(res.offset, res.size);
+}
 
-	return _rim->readStream(res.size);
+bool RIMFile::canGetResourcesConcurrently() const {
+	return _rim->canReadAtConcurrently();
 }
 
 } // End of namespace Aurora
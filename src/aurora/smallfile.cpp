@@ -22,9 +22,13 @@
  *  Decompressing "small" files, Nintendo DS LZSS (types 0x00 and 0x10), found in Sonic.
  */
 
+#include <cstring>
+
+#include "src/common/util.h"
 #include "src/common/error.h"
+#include "src/common/readstream.h"
 #include "src/common/memreadstream.h"
-#include "src/common/memwritestream.h"
+#include "src/common/writestream.h"
 
 #include "src/aurora/smallfile.h"
 
@@ -37,97 +41,329 @@ static void readSmallHeader(Common::SeekableReadStream &small, uint32 &type, uin
 	size = data >> 8;
 }
 
-static void decompress00(Common::SeekableReadStream &small, Common::WriteStream &out, uint32 size) {
-	out.writeStream(small, size);
+static void readSmallHeader(const byte *small, size_t smallSize, uint32 &type, uint32 &size) {
+	if (smallSize < 4)
+		throw Common::Exception(Common::kReadError);
+
+	uint32 data = READ_LE_UINT32(small);
+
+	type = data & 0x000000FF;
+	size = data >> 8;
 }
 
+/** The state of an LZSS decompression, so that it can be continued later. */
+struct LZSSState {
+	const byte *in;
+	size_t inSize;
+	size_t inPos;
+
+	byte  *out;
+	size_t outSize;
+	size_t outPos;
+
+	uint16 flags;
+
+	LZSSState(const byte *i, size_t iS, byte *o, size_t oS) :
+		in(i), inSize(iS), inPos(0), out(o), outSize(oS), outPos(0), flags(0xFF00) {
+	}
+};
+
 /* Simple LZSS decompression.
  *
  * Code loosely based on DSDecmp by Barubary, released under the terms of the MIT license.
  *
  * See <https://github.com/gravgun/dsdecmp/blob/master/CSharp/DSDecmp/Formats/Nitro/LZ10.cs#L121>
  * and <https://code.google.com/p/dsdecmp/>.
+ *
+ * Since the whole output buffer is available, back references are copied
+ * straight out of the already decompressed data, instead of out of a ring
+ * buffer. Decompression stops at the first block that reaches limit, so it
+ * can be continued later with the same state.
  */
-static void decompress10(Common::SeekableReadStream &small, Common::WriteStream &out, uint32 size) {
-	byte   buffer[0x10000];
-	uint32 bufferPos = 0;
+static void decompress10(LZSSState &s, size_t limit) {
+	limit = MIN(limit, s.outSize);
 
-	uint16 flags = 0xFF00;
-
-	uint32 outSize = 0;
-	while (outSize < size) {
+	while (s.outPos < limit) {
 		// Only our canaries left => Read flags for the next 8 blocks
-		if (flags == 0xFF00)
-			flags = (small.readByte() << 8) | 0x00FF;
+		if (s.flags == 0xFF00) {
+			if (s.inPos >= s.inSize)
+				throw Common::Exception(Common::kReadError);
 
-		if (flags & 0x8000) {
-			// Copy from buffer
+			const byte flags = s.in[s.inPos++];
 
-			const byte data1 = small.readByte();
-			const byte data2 = small.readByte();
+			// 8 literal bytes in a row => Copy them in one go
+			if ((flags == 0x00) && ((s.inSize - s.inPos) >= 8) && ((s.outSize - s.outPos) >= 8)) {
+				std::memcpy(s.out + s.outPos, s.in + s.inPos, 8);
 
-			// Copy how many bytes from where (relative) in the buffer?
-			const uint8  length = (data1 >> 4) + 3;
-			const uint16 offset = (((data1 & 0x0F) << 8) | data2) + 1;
+				s.inPos  += 8;
+				s.outPos += 8;
+				continue;
+			}
 
-			// Direct offset. Add size of the buffer once, to protect from overroll
-			uint32 copyOffset = bufferPos + sizeof(buffer) - offset;
+			s.flags = (flags << 8) | 0x00FF;
+		}
 
-			// Copy length bytes (and store each back into the buffer)
-			for (uint8 i = 0; i < length; i++, copyOffset++) {
-				if ((copyOffset % sizeof(buffer)) >= outSize)
-					throw Common::Exception("Tried to copy past the buffer");
+		if (s.flags & 0x8000) {
+			// Copy from the already decompressed data
 
-				const byte data = buffer[copyOffset % sizeof(buffer)];
+			if ((s.inSize - s.inPos) < 2)
+				throw Common::Exception(Common::kReadError);
 
-				out.writeByte(data);
-				outSize++;
+			const byte data1 = s.in[s.inPos++];
+			const byte data2 = s.in[s.inPos++];
 
-				buffer[bufferPos] = data;
-				bufferPos = (bufferPos + 1) % sizeof(buffer);
-			}
+			// Copy how many bytes from where (relative) in the output?
+			const size_t length = (data1 >> 4) + 3;
+			const size_t offset = (((data1 & 0x0F) << 8) | data2) + 1;
+
+			if (offset > s.outPos)
+				throw Common::Exception("Tried to copy past the buffer");
+			if (length > (s.outSize - s.outPos))
+				throw Common::Exception("Invalid \"small\" data");
+
+			byte       *dst = s.out + s.outPos;
+			const byte *src = dst - offset;
+
+			if      (offset >= length)
+				// Source and destination don't overlap
+				std::memcpy(dst, src, length);
+			else if (offset == 1)
+				// Run of a single byte
+				std::memset(dst, *src, length);
+			else
+				// Overlapping copy, repeating a pattern. Needs to go byte by byte
+				for (size_t i = 0; i < length; i++)
+					dst[i] = src[i];
+
+			s.outPos += length;
 
 		} else {
 			// Read literal byte
 
-			const byte data = small.readByte();
+			if (s.inPos >= s.inSize)
+				throw Common::Exception(Common::kReadError);
+
+			s.out[s.outPos++] = s.in[s.inPos++];
+		}
+
+		s.flags <<= 1;
+	}
+}
+
+static void decompress(const byte *small, size_t smallSize, byte *out, size_t outSize,
+                       uint32 type) {
+
+	if        (type == 0x00) {
+		if (smallSize < outSize)
+			throw Common::Exception(Common::kReadError);
+
+		std::memcpy(out, small, outSize);
+
+	} else if (type == 0x10) {
+		LZSSState state(small, smallSize, out, outSize);
+
+		decompress10(state, outSize);
+
+	} else
+		throw Common::Exception("Unsupported type 0x%08X", (uint) type);
+}
+
+/** Get the rest of a "small" stream in memory.
+ *
+ *  If the stream already is a memory stream, its data is used directly.
+ *  Otherwise, the data is read into a new buffer, returned in owned.
+ */
+static const byte *getSmallData(Common::SeekableReadStream &small, size_t &smallSize, byte *&owned) {
+	owned     = 0;
+	smallSize = small.size() - small.pos();
+
+	Common::MemoryReadStream *memSmall = dynamic_cast<Common::MemoryReadStream *>(&small);
+	if (memSmall) {
+		const byte *data = memSmall->getData() + memSmall->pos();
+
+		memSmall->seek(0, Common::SeekableReadStream::kOriginEnd);
+		return data;
+	}
+
+	owned = new byte[smallSize];
+
+	try {
+		if (small.read(owned, smallSize) != smallSize)
+			throw Common::Exception(Common::kReadError);
+	} catch (...) {
+		delete[] owned;
+		owned = 0;
+
+		throw;
+	}
+
+	return owned;
+}
+
+/** A stream decompressing an LZSS "small" file only as far as it is read. */
+class SmallReadStream : public Common::SeekableReadStream {
+public:
+	SmallReadStream(Common::SeekableReadStream *small, uint32 size) : _small(small),
+		_smallData(0), _out(0), _state(0, 0, 0, 0), _pos(0), _eos(false) {
+
+		/* If we throw here, the destructor is never called. Free what we allocated,
+		 * but leave the small stream itself to the caller, like Small::decompress()
+		 * does when decompressing fails. */
+
+		try {
+			size_t smallSize;
+			const byte *smallData = getSmallData(*_small, smallSize, _smallData);
+
+			_out = new byte[size];
+
+			_state = LZSSState(smallData, smallSize, _out, size);
+
+		} catch (...) {
+			delete[] _out;
+			delete[] _smallData;
+
+			throw;
+		}
+	}
+
+	~SmallReadStream() {
+		delete[] _out;
+		delete[] _smallData;
+		delete _small;
+	}
+
+	bool eos() const {
+		return _eos;
+	}
+
+	size_t pos() const {
+		return _pos;
+	}
+
+	size_t size() const {
+		return _state.outSize;
+	}
+
+	size_t seek(ptrdiff_t offset, Origin whence = kOriginBegin) {
+		const size_t oldPos = _pos;
+		const size_t newPos = evalSeek(offset, whence, _pos, 0, size());
+		if (newPos > size())
+			throw Common::Exception(Common::kSeekError);
 
-			out.writeByte(data);
-			outSize++;
+		_pos = newPos;
+		_eos = false;
+
+		return oldPos;
+	}
 
-			buffer[bufferPos] = data;
-			bufferPos = (bufferPos + 1) % sizeof(buffer);
+	size_t read(void *dataPtr, size_t dataSize) {
+		if (dataSize > (size() - _pos)) {
+			dataSize = size() - _pos;
+			_eos = true;
 		}
 
-		flags <<= 1;
+		if (dataSize == 0)
+			return 0;
+
+		if (_state.outPos < (_pos + dataSize)) {
+			try {
+				decompress10(_state, _pos + dataSize);
+			} catch (Common::Exception &e) {
+				e.add("Failed to decompress \"small\" file");
+				throw;
+			}
+
+			// Everything is decompressed => The compressed data isn't needed anymore
+			if (_state.outPos == _state.outSize) {
+				delete[] _smallData;
+				delete _small;
+
+				_smallData = 0;
+				_small     = 0;
+			}
+		}
+
+		std::memcpy(dataPtr, _out + _pos, dataSize);
+		_pos += dataSize;
+
+		return dataSize;
 	}
 
-	if (outSize != size)
-		throw Common::Exception("Invalid \"small\" data");
+private:
+	Common::SeekableReadStream *_small;
+	byte *_smallData;
+
+	byte *_out;
+
+	LZSSState _state;
+
+	size_t _pos;
+	bool   _eos;
+};
+
+size_t Small::getDecompressedSize(const byte *small, size_t smallSize) {
+	uint32 type, size;
+	readSmallHeader(small, smallSize, type, size);
+
+	return size;
 }
 
-static void decompress(Common::SeekableReadStream &small, Common::WriteStream &out,
-                       uint32 type, uint32 size) {
+void Small::decompress(const byte *small, size_t smallSize, byte *out, size_t outSize) {
+	uint32 type, size;
+	readSmallHeader(small, smallSize, type, size);
 
-	if      (type == 0x00)
-		decompress00(small, out, size);
-	else if (type == 0x10)
-		decompress10(small, out, size);
-	else
-		throw Common::Exception("Unsupported type 0x%08X", (uint) type);
+	if (outSize < size)
+		throw Common::Exception("Output buffer too small for \"small\" file (%u < %u)",
+		                        (uint) outSize, (uint) size);
+
+	try {
+		::Aurora::decompress(small + 4, smallSize - 4, out, size, type);
+	} catch (Common::Exception &e) {
+		e.add("Failed to decompress \"small\" file");
+		throw;
+	}
 }
 
 void Small::decompress(Common::SeekableReadStream &small, Common::WriteStream &out) {
 	uint32 type, size;
 	readSmallHeader(small, type, size);
 
+	if (type == 0x00) {
+		out.writeStream(small, size);
+		return;
+	}
+
+	byte *outData = decompress(small, type, size);
+
 	try {
-		::Aurora::decompress(small, out, type, size);
+		out.write(outData, size);
+	} catch (...) {
+		delete[] outData;
+		throw;
+	}
+
+	delete[] outData;
+}
+
+byte *Small::decompress(Common::SeekableReadStream &small, uint32 type, uint32 size) {
+	size_t smallSize;
+	byte  *smallOwned;
+	const byte *smallData = getSmallData(small, smallSize, smallOwned);
+
+	byte *out = new byte[size];
+
+	try {
+		::Aurora::decompress(smallData, smallSize, out, size, type);
 	} catch (Common::Exception &e) {
+		delete[] out;
+		delete[] smallOwned;
+
 		e.add("Failed to decompress \"small\" file");
-		throw e;
+		throw;
 	}
 
+	delete[] smallOwned;
+	return out;
 }
 
 Common::SeekableReadStream *Small::decompress(Common::SeekableReadStream *small) {
@@ -138,37 +374,22 @@ Common::SeekableReadStream *Small::decompress(Common::SeekableReadStream *small)
 		// Uncompressed. Just return a sub stream for the raw data
 		return new Common::SeekableSubReadStream(small, small->pos(), small->pos() + size, true);
 
-	Common::MemoryWriteStreamDynamic out(false, size);
+	if ((type == 0x10) && (size >= kLazyThreshold))
+		return new SmallReadStream(small, size);
 
-	try {
-		::Aurora::decompress(*small, out, type, size);
-	} catch (Common::Exception &e) {
-		out.dispose();
-
-		e.add("Failed to decompress \"small\" file");
-		throw e;
-	}
+	byte *out = decompress(*small, type, size);
 
 	delete small;
-	return new Common::MemoryReadStream(out.getData(), out.size(), true);
+	return new Common::MemoryReadStream(out, size, true);
 }
 
 Common::SeekableReadStream *Small::decompress(Common::SeekableReadStream &small) {
 	uint32 type, size;
 	readSmallHeader(small, type, size);
 
-	Common::MemoryWriteStreamDynamic out(false, size);
-
-	try {
-		::Aurora::decompress(small, out, type, size);
-	} catch (Common::Exception &e) {
-		out.dispose();
-
-		e.add("Failed to decompress \"small\" file");
-		throw e;
-	}
+	byte *out = decompress(small, type, size);
 
-	return new Common::MemoryReadStream(out.getData(), out.size(), true);
+	return new Common::MemoryReadStream(out, size, true);
 }
 
 } // End of namespace Aurora
@@ -25,6 +25,8 @@
 #ifndef AURORA_SMALLFILE_H
 #define AURORA_SMALLFILE_H
 
+#include "src/common/types.h"
+
 namespace Common {
 	class SeekableReadStream;
 	class WriteStream;
@@ -34,10 +36,27 @@ namespace Aurora {
 
 class Small {
 public:
+	/** LZSS files at least this big are decompressed on demand when read. */
+	static const size_t kLazyThreshold = 256 * 1024;
+
+	/** Return the decompressed size of a "small" file in memory. */
+	static size_t getDecompressedSize(const byte *small, size_t smallSize);
+
+	/** Decompress a "small" file in memory into a buffer of at least getDecompressedSize() bytes. */
+	static void decompress(const byte *small, size_t smallSize, byte *out, size_t outSize);
+
 	static void decompress(Common::SeekableReadStream &small, Common::WriteStream &out);
 
+	/** Decompress a "small" file, taking over the stream.
+	 *
+	 *  The stream is only taken over when decompressing succeeds. On failure,
+	 *  it still belongs to the caller.
+	 */
 	static Common::SeekableReadStream *decompress(Common::SeekableReadStream *small);
 	static Common::SeekableReadStream *decompress(Common::SeekableReadStream &small);
+
+private:
+	static byte *decompress(Common::SeekableReadStream &small, uint32 type, uint32 size);
 };
 
 } // End of namespace Aurora
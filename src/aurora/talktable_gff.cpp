@@ -117,6 +117,22 @@ void TalkTable_GFF::load05(const GFF4Struct &top) {
 	    !top.hasField(kGFF4HuffTalkStringBitStream))
 		return;
 
+	/* Read the Huffman tree and the encoded strings in one go. The tree nodes
+	 * are signed, but might be stored as unsigned values. */
+
+	if (top.getFieldType(kGFF4HuffTalkStringHuffTree) == GFF4Struct::kFieldTypeSint) {
+		top.getSint(kGFF4HuffTalkStringHuffTree, _huffTree);
+	} else {
+		std::vector<uint32> huffTree;
+		top.getUint(kGFF4HuffTalkStringHuffTree, huffTree);
+
+		_huffTree.resize(huffTree.size());
+		for (size_t i = 0; i < huffTree.size(); i++)
+			_huffTree[i] = (int32) huffTree[i];
+	}
+
+	top.getUint(kGFF4HuffTalkStringBitStream, _bitStream);
+
 	const GFF4List &strings = top.getList(kGFF4HuffTalkStringList);
 
 	for (GFF4List::const_iterator s = strings.begin(); s != strings.end(); ++s) {
@@ -151,19 +167,7 @@ void TalkTable_GFF::readString02(Entry &entry) const {
 }
 
 void TalkTable_GFF::readString05(Entry &entry) const {
-	Common::SeekableReadStream *huffTree  = _gff->getTopLevel().getData(kGFF4HuffTalkStringHuffTree);
-	Common::SeekableReadStream *bitStream = _gff->getTopLevel().getData(kGFF4HuffTalkStringBitStream);
-
-	readString05(huffTree, bitStream, entry);
-
-	delete huffTree;
-	delete bitStream;
-}
-
-void TalkTable_GFF::readString05(Common::SeekableReadStream *huffTree,
-                                 Common::SeekableReadStream *bitStream, Entry &entry) const {
-
-	if (!huffTree || !bitStream)
+	if (_huffTree.empty() || _bitStream.empty())
 		return;
 
 	/* Read a string encoded in a Huffman'd bitstream.
@@ -183,14 +187,19 @@ void TalkTable_GFF::readString05(Common::SeekableReadStream *huffTree,
 	uint32 shift = startOffset & 0x1F;
 
 	do {
-		ptrdiff_t e = (huffTree->size() / 8) - 1;
+		ptrdiff_t e = (_huffTree.size() / 2) - 1;
 
 		while (e >= 0) {
-			bitStream->seek(index * 4);
-			const ptrdiff_t offset = (bitStream->readUint32LE() >> shift) & 1;
+			if (index >= _bitStream.size())
+				throw Common::Exception(Common::kReadError);
+
+			const ptrdiff_t offset = (_bitStream[index] >> shift) & 1;
+
+			const size_t node = (e * 2) + offset;
+			if (node >= _huffTree.size())
+				throw Common::Exception(Common::kReadError);
 
-			huffTree->seek(((e * 2) + offset) * 4);
-			e = huffTree->readSint32LE();
+			e = _huffTree[node];
 
 			shift++;
 			index += (shift >> 5);
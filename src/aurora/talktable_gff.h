@@ -26,6 +26,7 @@
 #define AURORA_TALKTABLE_GFF_H
 
 #include <map>
+#include <vector>
 
 #include "src/common/types.h"
 #include "src/common/ustring.h"
@@ -63,6 +64,9 @@ private:
 
 	mutable Entries _entries;
 
+	std::vector<int32>  _huffTree;  ///< The Huffman tree of V0.5 talk tables.
+	std::vector<uint32> _bitStream; ///< The Huffman-encoded strings of V0.5 talk tables.
+
 	void load(Common::SeekableReadStream *tlk);
 	void load02(const GFF4Struct &top);
 	void load05(const GFF4Struct &top);
@@ -70,9 +74,6 @@ private:
 	void readString(Entry &entry) const;
 	void readString02(Entry &entry) const;
 	void readString05(Entry &entry) const;
-
-	void readString05(Common::SeekableReadStream *huffTree,
-	                  Common::SeekableReadStream *bitStream, Entry &entry) const;
 };
 
 } // End of namespace Aurora
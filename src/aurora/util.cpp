@@ -367,6 +367,16 @@ Common::UString FileTypeManager::setFileType(const Common::UString &path, FileTy
 	return Common::FilePath::changeExtension(path, ext);
 }
 
+const char *FileTypeManager::getExtension(FileType type) {
+	buildTypeLookup();
+
+	TypeLookup::const_iterator t = _typeLookup.find(type);
+	if (t != _typeLookup.end())
+		return t->second->extension;
+
+	return "";
+}
+
 FileType FileTypeManager::getFileType(Common::HashAlgo algo, uint64 hashedExtension) {
 	if ((algo < 0) || (algo >= Common::kHashMAX))
 		return kFileTypeNone;
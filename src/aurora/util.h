@@ -55,6 +55,9 @@ public:
 	/** Return the file name with a swapped extensions according to the specified file type. */
 	Common::UString setFileType(const Common::UString &path, FileType type);
 
+	/** Return the extension of this file type, including the dot, or "" if unknown. */
+	const char *getExtension(FileType type);
+
 
 private:
 	/** File type <-> extension mapping. */
@@ -52,6 +52,10 @@ Common::SeekableReadStream *ZIPFile::getResource(uint32 index, bool tryNoCopy) c
 	return _zipFile->getFile(index, tryNoCopy);
 }
 
+bool ZIPFile::canGetResourcesConcurrently() const {
+	return _zipFile->canGetFilesConcurrently();
+}
+
 void ZIPFile::load() {
 	const Common::ZipFile::FileList &files = _zipFile->getFiles();
 	for (Common::ZipFile::FileList::const_iterator file = files.begin(); file != files.end(); ++file) {
@@ -0,0 +1,202 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Timing and reporting for the headless benchmarks.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <new>
+
+#include <SDL_timer.h>
+
+#include "src/common/util.h"
+#include "src/common/error.h"
+#include "src/common/writefile.h"
+#include "src/common/atomic.h"
+
+#include "src/benchmark/benchmark.h"
+
+static boost::atomic<uint64> kHeapAllocations(0);
+static boost::atomic<uint64> kHeapBytes(0);
+
+void *operator new(std::size_t size) {
+	kHeapAllocations.fetch_add(1, boost::memory_order_relaxed);
+	kHeapBytes.fetch_add(size, boost::memory_order_relaxed);
+
+	void *ptr = std::malloc((size > 0) ? size : 1);
+	if (!ptr)
+		throw std::bad_alloc();
+
+	return ptr;
+}
+
+void *operator new[](std::size_t size) {
+	return operator new(size);
+}
+
+void operator delete(void *ptr) throw() {
+	std::free(ptr);
+}
+
+void operator delete[](void *ptr) throw() {
+	std::free(ptr);
+}
+
+namespace Benchmark {
+
+Timer::Timer() {
+	start();
+}
+
+void Timer::start() {
+	_start = SDL_GetPerformanceCounter();
+}
+
+double Timer::getSeconds() const {
+	return ((double) (SDL_GetPerformanceCounter() - _start)) / SDL_GetPerformanceFrequency();
+}
+
+
+HeapCounter::HeapCounter() {
+	start();
+}
+
+void HeapCounter::start() {
+	_allocations = kHeapAllocations.load(boost::memory_order_relaxed);
+	_bytes       = kHeapBytes.load(boost::memory_order_relaxed);
+}
+
+uint64 HeapCounter::getAllocations() const {
+	return kHeapAllocations.load(boost::memory_order_relaxed) - _allocations;
+}
+
+uint64 HeapCounter::getBytes() const {
+	return kHeapBytes.load(boost::memory_order_relaxed) - _bytes;
+}
+
+
+Result::Result(const Common::UString &n) : name(n), count(0), bytes(0), failed(0), seconds(0.0) {
+}
+
+void Result::addValue(const Common::UString &key, double value) {
+	values.push_back(std::make_pair(key, value));
+}
+
+
+Reporter::Reporter(const Common::UString &fileName) : _file(0), _count(0) {
+	if (fileName.empty())
+		return;
+
+	_file = new Common::WriteFile;
+	if (!_file->open(fileName)) {
+		delete _file;
+		throw Common::Exception("Can't open benchmark results file \"%s\"", fileName.c_str());
+	}
+}
+
+Reporter::~Reporter() {
+	if (_file) {
+		try {
+			_file->flush();
+		} catch (...) {
+		}
+	}
+
+	delete _file;
+}
+
+/** Format a number as a JSON value. JSON knows neither infinity nor NaN. */
+static Common::UString formatNumber(double value) {
+	if (!std::isfinite(value))
+		return "null";
+
+	return Common::UString::format("%.9g", value);
+}
+
+void Reporter::report(const Result &result) {
+	Common::UString line = "{\"benchmark\":\"" + result.name + "\"";
+
+	line += Common::UString::format(",\"count\":%llu,\"bytes\":%llu,\"failed\":%llu",
+	                                (unsigned long long) result.count, (unsigned long long) result.bytes,
+	                                (unsigned long long) result.failed);
+
+	line += ",\"seconds\":" + formatNumber(result.seconds);
+
+	if (result.seconds > 0.0) {
+		if (result.count > 0)
+			line += ",\"itemsPerSecond\":" + formatNumber(result.count / result.seconds);
+		if (result.bytes > 0)
+			line += ",\"megabytesPerSecond\":" + formatNumber(result.bytes / (result.seconds * 1024.0 * 1024.0));
+	}
+
+	for (std::vector< std::pair<Common::UString, double> >::const_iterator v = result.values.begin();
+	     v != result.values.end(); ++v)
+		line += ",\"" + v->first + "\":" + formatNumber(v->second);
+
+	line += "}\n";
+
+	write(line);
+
+	status("%s: %llu items, %llu failed, %.3fs", result.name.c_str(),
+	       (unsigned long long) result.count, (unsigned long long) result.failed, result.seconds);
+
+	_count++;
+}
+
+size_t Reporter::getCount() const {
+	return _count;
+}
+
+void Reporter::write(const Common::UString &line) {
+	if (_file) {
+		_file->writeString(line);
+		return;
+	}
+
+	std::fputs(line.c_str(), stdout);
+	std::fflush(stdout);
+}
+
+
+Random::Random(uint32 seed) : _state(seed) {
+}
+
+uint32 Random::next() {
+	// 64-bit linear congruential generator, returning the high bits
+	_state = _state * 6364136223846793005ULL + 1442695040888963407ULL;
+
+	return (uint32) (_state >> 32);
+}
+
+uint32 Random::next(uint32 max) {
+	if (max == 0)
+		return 0;
+
+	return (uint32) ((((uint64) next()) * max) >> 32);
+}
+
+float Random::nextFloat(float min, float max) {
+	return min + (max - min) * (next() / 4294967296.0f);
+}
+
+} // End of namespace Benchmark
@@ -0,0 +1,144 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Timing and reporting for the headless benchmarks.
+ */
+
+#ifndef BENCHMARK_BENCHMARK_H
+#define BENCHMARK_BENCHMARK_H
+
+#include <vector>
+#include <utility>
+
+#include "src/common/types.h"
+#include "src/common/ustring.h"
+#include "src/common/noncopyable.h"
+
+namespace Common {
+	class WriteFile;
+}
+
+namespace Benchmark {
+
+/** A wall-clock timer with sub-microsecond resolution. */
+class Timer {
+public:
+	/** Create a timer, already started. */
+	Timer();
+
+	/** (Re)start the timer. */
+	void start();
+
+	/** Return the number of seconds since the timer was started. */
+	double getSeconds() const;
+
+private:
+	uint64 _start;
+};
+
+/** Counts the heap allocations done through operator new.
+ *
+ *  The benchmark program replaces the global operator new to keep a
+ *  running count of all allocations and the number of bytes requested.
+ */
+class HeapCounter {
+public:
+	/** Create a heap counter, already started. */
+	HeapCounter();
+
+	/** (Re)start the heap counter. */
+	void start();
+
+	/** Return the number of allocations since the counter was started. */
+	uint64 getAllocations() const;
+	/** Return the number of bytes allocated since the counter was started. */
+	uint64 getBytes() const;
+
+private:
+	uint64 _allocations;
+	uint64 _bytes;
+};
+
+/** The result of one benchmark. */
+struct Result {
+	/** Dot-separated name of the benchmark, like "resources.gff3.parse". */
+	Common::UString name;
+
+	uint64 count;   ///< Number of items processed.
+	uint64 bytes;   ///< Number of bytes processed.
+	uint64 failed;  ///< Number of items that failed.
+	double seconds; ///< Wall-clock time spent.
+
+	/** Additional, benchmark-specific measurements. */
+	std::vector< std::pair<Common::UString, double> > values;
+
+	Result(const Common::UString &n);
+
+	/** Add a benchmark-specific measurement. */
+	void addValue(const Common::UString &key, double value);
+};
+
+/** Writes benchmark results as JSON, one result object per line.
+ *
+ *  Every line holds the benchmark's name, the number of items and bytes
+ *  processed, the number of failed items and the time taken, in seconds.
+ *  Throughput figures are derived from those and added as well. Additional
+ *  measurements are added as further numeric members.
+ */
+class Reporter : public Common::NonCopyable {
+public:
+	/** Write the results into a file, or to stdout if the file name is empty. */
+	Reporter(const Common::UString &fileName = "");
+	~Reporter();
+
+	/** Write a result. */
+	void report(const Result &result);
+
+	/** Return the number of results written so far. */
+	size_t getCount() const;
+
+private:
+	Common::WriteFile *_file;
+
+	size_t _count;
+
+	void write(const Common::UString &line);
+};
+
+/** Deterministic pseudo-random numbers, so that every run benchmarks the same data. */
+class Random {
+public:
+	Random(uint32 seed = 0x5EEDF00D);
+
+	/** Return a random 32-bit number. */
+	uint32 next();
+	/** Return a random number in the range [0, max). */
+	uint32 next(uint32 max);
+	/** Return a random float in the range [min, max). */
+	float nextFloat(float min, float max);
+
+private:
+	uint64 _state;
+};
+
+} // End of namespace Benchmark
+
+#endif // BENCHMARK_BENCHMARK_H
@@ -0,0 +1,659 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Benchmarks on synthetic data for the codecs and low-level readers.
+ */
+
+#include <cstring>
+
+#include <zlib.h>
+
+#include "src/common/util.h"
+#include "src/common/error.h"
+#include "src/common/memreadstream.h"
+#include "src/common/bitstream.h"
+#include "src/common/huffman.h"
+#include "src/common/inflatestream.h"
+
+#include "src/aurora/smallfile.h"
+
+#include "src/benchmark/benchmark.h"
+#include "src/benchmark/codecs.h"
+
+namespace Benchmark {
+
+static const char * const kWords[] = {
+	"the", "of", "and", "to", "a", "in", "is", "you", "that", "it", "he", "was", "for", "on",
+	"are", "as", "with", "his", "they", "at", "be", "this", "have", "from", "or", "one", "had",
+	"by", "word", "but", "not", "what", "all", "were", "we", "when", "your", "can", "said",
+	"creature", "placeable", "module", "area", "door", "trigger", "waypoint", "sound", "store",
+	"encounter", "dialog", "journal", "faction", "item", "script", "model", "texture", "walkmesh",
+	"animation", "Resref", "Tag", "LocName", "Comment", "Portrait"
+};
+
+/** Generate data that compresses somewhat like game data: words, numbers and a bit of noise. */
+static void generateData(Random &random, std::vector<byte> &data, size_t size) {
+	data.clear();
+	data.reserve(size + 32);
+
+	while (data.size() < size) {
+		const uint32 what = random.next(16);
+
+		if        (what < 11) {
+			const char *word = kWords[random.next(ARRAYSIZE(kWords))];
+
+			data.insert(data.end(), word, word + std::strlen(word));
+			data.push_back(' ');
+
+		} else if (what < 14) {
+			const uint32 number = random.next(100000);
+
+			for (int i = 0; i < 4; i++)
+				data.push_back((number >> (i * 8)) & 0xFF);
+
+		} else {
+			const size_t length = 1 + random.next(8);
+
+			for (size_t i = 0; i < length; i++)
+				data.push_back(random.next(256));
+		}
+	}
+
+	data.resize(size);
+}
+
+/** Take a checksum of a memory buffer. */
+static uint64 checksum(const byte *data, size_t size) {
+	// 64-bit FNV-1a
+	uint64 hash = 0xCBF29CE484222325ULL;
+
+	for (size_t i = 0; i < size; i++)
+		hash = (hash ^ data[i]) * 0x100000001B3ULL;
+
+	return hash;
+}
+
+
+// --- Nintendo DS LZSS ---
+
+void decompressSmallReference(const byte *small, size_t smallSize, std::vector<byte> &out) {
+	Common::MemoryReadStream stream(small, smallSize);
+
+	const uint32 header = stream.readUint32LE();
+	const uint32 type   = header & 0x000000FF;
+	const uint32 size   = header >> 8;
+
+	out.clear();
+	out.reserve(size);
+
+	if (type == 0x00) {
+		for (uint32 i = 0; i < size; i++)
+			out.push_back(stream.readByte());
+
+		return;
+	}
+
+	if (type != 0x10)
+		throw Common::Exception("Unsupported type 0x%08X", (uint) type);
+
+	std::vector<byte> buffer(0x10000);
+	uint32 bufferPos = 0;
+
+	uint16 flags = 0xFF00;
+
+	while (out.size() < size) {
+		if (flags == 0xFF00)
+			flags = (stream.readByte() << 8) | 0x00FF;
+
+		if (flags & 0x8000) {
+			const byte data1 = stream.readByte();
+			const byte data2 = stream.readByte();
+
+			const uint8  length = (data1 >> 4) + 3;
+			const uint16 offset = (((data1 & 0x0F) << 8) | data2) + 1;
+
+			uint32 copyOffset = bufferPos + buffer.size() - offset;
+
+			for (uint8 i = 0; i < length; i++, copyOffset++) {
+				if ((copyOffset % buffer.size()) >= out.size())
+					throw Common::Exception("Tried to copy past the buffer");
+
+				const byte data = buffer[copyOffset % buffer.size()];
+
+				out.push_back(data);
+
+				buffer[bufferPos] = data;
+				bufferPos = (bufferPos + 1) % buffer.size();
+			}
+
+		} else {
+			const byte data = stream.readByte();
+
+			out.push_back(data);
+
+			buffer[bufferPos] = data;
+			bufferPos = (bufferPos + 1) % buffer.size();
+		}
+
+		flags <<= 1;
+	}
+
+	if (out.size() != size)
+		throw Common::Exception("Invalid \"small\" data");
+}
+
+/** Compress data into a Nintendo DS LZSS "small" file, greedily matching through a hash table. */
+static void compressSmall(const std::vector<byte> &data, std::vector<byte> &small) {
+	assert(data.size() < 0x01000000);
+
+	small.clear();
+	small.reserve(data.size() + data.size() / 8 + 16);
+
+	small.push_back(0x10);
+	small.push_back( data.size()        & 0xFF);
+	small.push_back((data.size() >>  8) & 0xFF);
+	small.push_back((data.size() >> 16) & 0xFF);
+
+	static const size_t kHashSize = 0x10000;
+	std::vector<size_t> head(kHashSize, SIZE_MAX);
+
+	size_t pos = 0;
+	while (pos < data.size()) {
+		const size_t flagsPos = small.size();
+		small.push_back(0x00);
+
+		for (int bit = 0; (bit < 8) && (pos < data.size()); bit++) {
+			size_t length = 0, offset = 0;
+
+			if ((data.size() - pos) >= 3) {
+				const size_t hash = ((data[pos] << 8) ^ (data[pos + 1] << 4) ^ data[pos + 2]) & (kHashSize - 1);
+
+				const size_t candidate = head[hash];
+				head[hash] = pos;
+
+				if ((candidate != SIZE_MAX) && ((pos - candidate) <= 0x1000)) {
+					const size_t maxLength = MIN<size_t>(18, data.size() - pos);
+
+					while ((length < maxLength) && (data[candidate + length] == data[pos + length]))
+						length++;
+
+					offset = pos - candidate;
+				}
+			}
+
+			if (length >= 3) {
+				small[flagsPos] |= 0x80 >> bit;
+
+				small.push_back(((length - 3) << 4) | ((offset - 1) >> 8));
+				small.push_back( (offset - 1) & 0xFF);
+
+				pos += length;
+			} else
+				small.push_back(data[pos++]);
+		}
+	}
+}
+
+static void benchmarkSmall(Reporter &reporter, Random &random) {
+	std::vector<byte> data, small;
+	generateData(random, data, 8 * 1024 * 1024);
+	compressSmall(data, small);
+
+	const uint64 dataChecksum = checksum(&data[0], data.size());
+
+	static const int kRuns = 4;
+
+	Result current  ("codecs.small.decompress");
+	Result reference("codecs.small.decompress_reference");
+
+	std::vector<byte> out(data.size());
+	for (int i = 0; i < kRuns; i++) {
+		Timer timer;
+
+		Aurora::Small::decompress(&small[0], small.size(), &out[0], out.size());
+
+		current.seconds += timer.getSeconds();
+		current.count++;
+		current.bytes += out.size();
+
+		if (checksum(&out[0], out.size()) != dataChecksum)
+			current.failed++;
+	}
+
+	for (int i = 0; i < kRuns; i++) {
+		Timer timer;
+
+		decompressSmallReference(&small[0], small.size(), out);
+
+		reference.seconds += timer.getSeconds();
+		reference.count++;
+		reference.bytes += out.size();
+
+		if (checksum(&out[0], out.size()) != dataChecksum)
+			reference.failed++;
+	}
+
+	current.addValue("ratio", ((double) small.size()) / data.size());
+	if (current.seconds > 0.0)
+		current.addValue("speedup", reference.seconds / current.seconds);
+
+	reporter.report(current);
+	reporter.report(reference);
+}
+
+
+// --- Huffman ---
+
+/** Write bits, MSB first, into a byte buffer. */
+static void putBits(std::vector<byte> &data, uint64 &bitPos, uint32 value, uint8 length) {
+	for (int i = length - 1; i >= 0; i--, bitPos++) {
+		if ((bitPos % 8) == 0)
+			data.push_back(0x00);
+
+		if ((value >> i) & 1)
+			data.back() |= 0x80 >> (bitPos % 8);
+	}
+}
+
+template<class BitStreamType>
+static void decodeHuffman(const Common::Huffman &huffman, BitStreamType &bits, const std::vector<uint32> &symbols,
+                          Result &result) {
+
+	Timer timer;
+
+	uint64 failed = 0;
+	for (size_t i = 0; i < symbols.size(); i++)
+		if (huffman.getSymbol(bits) != symbols[i])
+			failed++;
+
+	result.seconds += timer.getSeconds();
+	result.count   += symbols.size();
+	result.failed  += failed;
+}
+
+static void benchmarkHuffman(Reporter &reporter, Random &random) {
+	/* A complete, skewed canonical code: 16 codes of length 5, 64 codes of
+	 * length 8 and 256 codes of length 10. Every group takes up as much of
+	 * the code space as all longer groups together. That's long enough that
+	 * some codes need a second lookup. */
+
+	static const size_t kCodeCount = 16 + 64 + 256;
+
+	std::vector<uint8>  lengths(kCodeCount);
+	std::vector<uint32> codes(kCodeCount);
+
+	uint32 code = 0;
+	uint8  lastLength = 0;
+	for (size_t i = 0; i < kCodeCount; i++) {
+		lengths[i] = (i < 16) ? 5 : ((i < 80) ? 8 : 10);
+
+		if (lastLength > 0)
+			code = (code + 1) << (lengths[i] - lastLength);
+
+		codes[i]   = code;
+		lastLength = lengths[i];
+	}
+
+	Common::Huffman huffman(0, kCodeCount, &codes[0], &lengths[0]);
+
+	// Encode random symbols, distributed according to their code lengths
+
+	static const size_t kSymbolCount = 8 * 1024 * 1024;
+
+	std::vector<uint32> symbols;
+	symbols.reserve(kSymbolCount);
+
+	std::vector<byte> data;
+	data.reserve(kSymbolCount);
+
+	uint64 bitPos = 0;
+	for (size_t i = 0; i < kSymbolCount; i++) {
+		const uint32 r = random.next(1024);
+
+		uint32 symbol;
+		if      (r < 512)
+			symbol = r / 32;
+		else if (r < 768)
+			symbol = 16 + (r - 512) / 4;
+		else
+			symbol = 80 + (r - 768);
+
+		symbols.push_back(symbol);
+		putBits(data, bitPos, codes[symbol], lengths[symbol]);
+	}
+
+	// Enough padding that the last code can always be peeked at completely
+	data.resize(data.size() + 8, 0x00);
+
+	Result memory("codecs.huffman.memory");
+	Result stream("codecs.huffman.stream");
+
+	{
+		Common::MemoryBitStream8MSB bits(&data[0], data.size());
+		decodeHuffman(huffman, bits, symbols, memory);
+	}
+
+	{
+		Common::MemoryReadStream dataStream(&data[0], data.size());
+		Common::BitStream8MSB bits(dataStream);
+		decodeHuffman(huffman, bits, symbols, stream);
+	}
+
+	memory.bytes = stream.bytes = bitPos / 8;
+
+	if (memory.seconds > 0.0)
+		memory.addValue("speedup", stream.seconds / memory.seconds);
+
+	reporter.report(memory);
+	reporter.report(stream);
+}
+
+
+// --- Bit streams ---
+
+template<class BitStreamType>
+static uint32 readBits(BitStreamType &bits, uint64 bitCount, Result &result) {
+	Timer timer;
+
+	uint32 sum = 0;
+
+	uint64 bitsRead = 0;
+	for (size_t n = 1; (bitsRead + n) <= bitCount; n = (n % 24) + 1) {
+		sum += bits.getBits(n);
+
+		bitsRead += n;
+		result.count++;
+	}
+
+	result.seconds += timer.getSeconds();
+	result.bytes   += bitsRead / 8;
+
+	return sum;
+}
+
+static void benchmarkBitStream(Reporter &reporter, Random &random) {
+	std::vector<byte> data(16 * 1024 * 1024);
+	for (size_t i = 0; i < data.size(); i++)
+		data[i] = random.next(256);
+
+	Result memory8MSB ("codecs.bitstream.memory8msb");
+	Result stream8MSB ("codecs.bitstream.stream8msb");
+	Result memory32LSB("codecs.bitstream.memory32lelsb");
+	Result stream32LSB("codecs.bitstream.stream32lelsb");
+
+	const uint64 bitCount = data.size() * 8;
+
+	uint32 sumMemory, sumStream;
+
+	{
+		Common::MemoryBitStream8MSB bits(&data[0], data.size());
+		sumMemory = readBits(bits, bitCount, memory8MSB);
+	}
+
+	{
+		Common::MemoryReadStream dataStream(&data[0], data.size());
+		Common::BitStream8MSB bits(dataStream);
+		sumStream = readBits(bits, bitCount, stream8MSB);
+	}
+
+	if (sumMemory != sumStream)
+		memory8MSB.failed++;
+
+	{
+		Common::MemoryBitStream32LELSB bits(&data[0], data.size());
+		sumMemory = readBits(bits, bitCount, memory32LSB);
+	}
+
+	{
+		Common::MemoryReadStream dataStream(&data[0], data.size());
+		Common::BitStream32LELSB bits(dataStream);
+		sumStream = readBits(bits, bitCount, stream32LSB);
+	}
+
+	if (sumMemory != sumStream)
+		memory32LSB.failed++;
+
+	if (memory8MSB.seconds > 0.0)
+		memory8MSB.addValue("speedup", stream8MSB.seconds / memory8MSB.seconds);
+	if (memory32LSB.seconds > 0.0)
+		memory32LSB.addValue("speedup", stream32LSB.seconds / memory32LSB.seconds);
+
+	reporter.report(memory8MSB);
+	reporter.report(stream8MSB);
+	reporter.report(memory32LSB);
+	reporter.report(stream32LSB);
+}
+
+
+// --- Inflate ---
+
+/** Compress data into raw deflate data, without a zlib header. */
+static void deflateData(const std::vector<byte> &data, std::vector<byte> &packed) {
+	z_stream zStream;
+	std::memset(&zStream, 0, sizeof(zStream));
+
+	if (deflateInit2(&zStream, 6, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+		throw Common::Exception("Could not initialize zlib deflate");
+
+	packed.resize(deflateBound(&zStream, data.size()));
+
+	zStream.next_in   = const_cast<byte *>(&data[0]);
+	zStream.avail_in  = data.size();
+	zStream.next_out  = &packed[0];
+	zStream.avail_out = packed.size();
+
+	const int zResult = deflate(&zStream, Z_FINISH);
+
+	packed.resize(zStream.total_out);
+	deflateEnd(&zStream);
+
+	if (zResult != Z_STREAM_END)
+		throw Common::Exception("Failed to deflate data: %d", zResult);
+}
+
+/** Inflate raw deflate data in one go. */
+static void inflateData(const std::vector<byte> &packed, byte *out, size_t outSize) {
+	z_stream zStream;
+	std::memset(&zStream, 0, sizeof(zStream));
+
+	if (inflateInit2(&zStream, -15) != Z_OK)
+		throw Common::Exception("Could not initialize zlib inflate");
+
+	zStream.next_in   = const_cast<byte *>(&packed[0]);
+	zStream.avail_in  = packed.size();
+	zStream.next_out  = out;
+	zStream.avail_out = outSize;
+
+	const int zResult = inflate(&zStream, Z_FINISH);
+
+	inflateEnd(&zStream);
+
+	if (zResult != Z_STREAM_END)
+		throw Common::Exception("Failed to inflate data: %d", zResult);
+}
+
+static void benchmarkInflate(Reporter &reporter, Random &random) {
+	std::vector<byte> data, packed;
+	generateData(random, data, 32 * 1024 * 1024);
+	deflateData(data, packed);
+
+	const uint64 dataChecksum = checksum(&data[0], data.size());
+
+	Result full      ("codecs.inflate.full");
+	Result sequential("codecs.inflate.stream_sequential");
+	Result seeking   ("codecs.inflate.stream_seeking");
+
+	std::vector<byte> out(data.size());
+
+	// Everything in one go, into a buffer of the full size
+
+	{
+		Timer timer;
+
+		inflateData(packed, &out[0], out.size());
+
+		full.seconds = timer.getSeconds();
+		full.count   = 1;
+		full.bytes   = out.size();
+
+		if (checksum(&out[0], out.size()) != dataChecksum)
+			full.failed++;
+	}
+
+	// Sequentially, in small chunks, like a music or video decoder would
+
+	{
+		std::memset(&out[0], 0, out.size());
+
+		Timer timer;
+
+		Common::InflateReadStream stream(new Common::MemoryReadStream(&packed[0], packed.size()),
+		                                 data.size(), 15, true);
+
+		static const size_t kChunkSize = 16 * 1024;
+
+		size_t pos = 0;
+		while (pos < out.size()) {
+			const size_t n = stream.read(&out[pos], MIN(kChunkSize, out.size() - pos));
+			if (n == 0)
+				break;
+
+			pos += n;
+			sequential.count++;
+		}
+
+		sequential.seconds = timer.getSeconds();
+		sequential.bytes   = pos;
+
+		if (checksum(&out[0], out.size()) != dataChecksum)
+			sequential.failed++;
+	}
+
+	// Random seeks, forwards and backwards
+
+	{
+		Timer timer;
+
+		Common::InflateReadStream stream(new Common::MemoryReadStream(&packed[0], packed.size()),
+		                                 data.size(), 15, true);
+
+		static const size_t kReadSize = 4096;
+
+		byte buffer[kReadSize];
+		for (int i = 0; i < 256; i++) {
+			const size_t pos = random.next(data.size() - kReadSize);
+
+			stream.seek(pos);
+			const size_t n = stream.read(buffer, kReadSize);
+
+			seeking.count++;
+			seeking.bytes += n;
+
+			if ((n != kReadSize) || std::memcmp(buffer, &data[pos], kReadSize))
+				seeking.failed++;
+		}
+
+		seeking.seconds = timer.getSeconds();
+	}
+
+	full.addValue("ratio", ((double) packed.size()) / data.size());
+
+	reporter.report(full);
+	reporter.report(sequential);
+	reporter.report(seeking);
+}
+
+
+// --- Bulk stream reads ---
+
+static void benchmarkBulkReads(Reporter &reporter, Random &random) {
+	static const size_t kFloatCount = 8 * 1024 * 1024;
+
+	std::vector<byte> data(kFloatCount * 4);
+	for (size_t i = 0; i < kFloatCount; i++) {
+		const float value = random.nextFloat(-1000.0f, 1000.0f);
+
+		uint32 bits;
+		std::memcpy(&bits, &value, 4);
+
+		WRITE_LE_UINT32(&data[i * 4], bits);
+	}
+
+	std::vector<float> values(kFloatCount);
+
+	Result single("codecs.readfloats.single");
+	Result bulk  ("codecs.readfloats.bulk");
+
+	{
+		Common::MemoryReadStream stream(&data[0], data.size());
+
+		Timer timer;
+
+		for (size_t i = 0; i < kFloatCount; i++)
+			values[i] = stream.readIEEEFloatLE();
+
+		single.seconds = timer.getSeconds();
+		single.count   = kFloatCount;
+		single.bytes   = data.size();
+	}
+
+	const uint64 singleChecksum = checksum((const byte *) &values[0], values.size() * sizeof(float));
+
+	std::memset(&values[0], 0, values.size() * sizeof(float));
+
+	{
+		Common::MemoryReadStream stream(&data[0], data.size());
+
+		Timer timer;
+
+		// Read in chunks of a typical vertex buffer's size
+		static const size_t kChunkSize = 3 * 4096;
+
+		for (size_t i = 0; i < kFloatCount; i += kChunkSize)
+			stream.readIEEEFloatLE(&values[i], MIN(kChunkSize, kFloatCount - i));
+
+		bulk.seconds = timer.getSeconds();
+		bulk.count   = kFloatCount;
+		bulk.bytes   = data.size();
+	}
+
+	if (checksum((const byte *) &values[0], values.size() * sizeof(float)) != singleChecksum)
+		bulk.failed++;
+
+	if (bulk.seconds > 0.0)
+		bulk.addValue("speedup", single.seconds / bulk.seconds);
+
+	reporter.report(single);
+	reporter.report(bulk);
+}
+
+
+void benchmarkCodecs(Reporter &reporter) {
+	Random random;
+
+	benchmarkSmall(reporter, random);
+	benchmarkHuffman(reporter, random);
+	benchmarkBitStream(reporter, random);
+	benchmarkInflate(reporter, random);
+	benchmarkBulkReads(reporter, random);
+}
+
+} // End of namespace Benchmark
@@ -0,0 +1,51 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Benchmarks on synthetic data for the codecs and low-level readers.
+ */
+
+#ifndef BENCHMARK_CODECS_H
+#define BENCHMARK_CODECS_H
+
+#include <vector>
+
+#include "src/common/types.h"
+
+namespace Benchmark {
+
+class Reporter;
+
+/** Benchmark Huffman decoding, bit streams, inflating, LZSS decompression and bulk stream reads.
+ *
+ *  All benchmarks run on deterministic synthetic data, and compare the
+ *  optimized code paths against the plain ones they replace.
+ */
+void benchmarkCodecs(Reporter &reporter);
+
+/** Decompress a Nintendo DS LZSS "small" file the plain way, byte by byte through a ring buffer.
+ *
+ *  This is the reference Aurora::Small::decompress() is measured and verified against.
+ */
+void decompressSmallReference(const byte *small, size_t smallSize, std::vector<byte> &out);
+
+} // End of namespace Benchmark
+
+#endif // BENCHMARK_CODECS_H
@@ -0,0 +1,1087 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Generator for a synthetic corpus of Aurora files.
+ */
+
+#include <cstring>
+#include <map>
+
+#include "src/common/util.h"
+#include "src/common/error.h"
+#include "src/common/noncopyable.h"
+#include "src/common/writestream.h"
+#include "src/common/memwritestream.h"
+#include "src/common/writefile.h"
+#include "src/common/filepath.h"
+
+#include "src/aurora/types.h"
+#include "src/aurora/util.h"
+
+#include "src/benchmark/benchmark.h"
+#include "src/benchmark/corpus.h"
+
+namespace Benchmark {
+
+CorpusOptions::CorpusOptions() : seed(0xC0FFEE),
+	bifCount(4), resourcesPerBIF(250), moduleCount(4), resourcesPerModule(100),
+	rimCount(2), resourcesPerRIM(100), overrideCount(50),
+	talkStrings(20000), listLength(32), tableRows(200), tableColumns(12), scriptBlocks(256) {
+
+}
+
+void CorpusOptions::scale(size_t factor) {
+	bifCount      *= factor;
+	moduleCount   *= factor;
+	rimCount      *= factor;
+	overrideCount *= factor;
+	talkStrings   *= factor;
+}
+
+
+static const char * const kNameParts[] = {
+	"bandit", "guard", "merchant", "wolf", "spider", "door", "chest", "lever", "statue", "torch",
+	"sword", "shield", "potion", "scroll", "ring", "amulet", "bridge", "cave", "tower", "crypt",
+	"north", "south", "old", "dark", "iron", "silver", "red", "great", "lost", "hidden"
+};
+
+/** Return a random, game-ish name, like "dark_wolf". */
+static Common::UString randomName(Random &random) {
+	return Common::UString(kNameParts[random.next(ARRAYSIZE(kNameParts))]) + "_" +
+	       kNameParts[random.next(ARRAYSIZE(kNameParts))];
+}
+
+/** Return a random sentence with about this many words. */
+static Common::UString randomSentence(Random &random, size_t words) {
+	Common::UString sentence = "The";
+
+	for (size_t i = 0; i < words; i++)
+		sentence += Common::UString(" ") + kNameParts[random.next(ARRAYSIZE(kNameParts))];
+
+	return sentence + ".";
+}
+
+/** Write a string into a fixed-size field, padded with 0 bytes. */
+static void writeFixedString(Common::WriteStream &out, const Common::UString &str, size_t size) {
+	const size_t length = MIN(std::strlen(str.c_str()), size);
+
+	out.write(str.c_str(), length);
+	for (size_t i = length; i < size; i++)
+		out.writeByte(0);
+}
+
+
+// --- Resources ---
+
+/** A generated resource, waiting to be written into an archive or a file. */
+struct CorpusResource {
+	Common::UString name;
+	Aurora::FileType type;
+
+	std::vector<byte> data;
+};
+
+typedef std::vector<CorpusResource> CorpusResources;
+
+/** Take over the data written into a memory stream as a new resource. */
+static void addResource(CorpusResources &resources, const Common::UString &name, Aurora::FileType type,
+                        Common::MemoryWriteStreamDynamic &data) {
+
+	resources.push_back(CorpusResource());
+
+	CorpusResource &resource = resources.back();
+
+	resource.name = name;
+	resource.type = type;
+
+	if (data.size() > 0)
+		resource.data.assign(data.getData(), data.getData() + data.size());
+}
+
+
+// --- GFF3 ---
+
+/** Builds a GFF3 file in memory, struct by struct and field by field. */
+class GFF3Writer : public Common::NonCopyable {
+public:
+	GFF3Writer(uint32 id) : _id(id), _fieldData(true), _listIndices(true) {
+	}
+
+	/** Add a struct, returning its index. The first struct is the top-level struct. */
+	uint32 addStruct(uint32 id) {
+		_structs.push_back(Struct());
+		_structs.back().id = id;
+
+		return _structs.size() - 1;
+	}
+
+	void addByte(uint32 strct, const char *label, byte value) {
+		addField(strct, 0, label, value);
+	}
+
+	void addUint16(uint32 strct, const char *label, uint16 value) {
+		addField(strct, 2, label, value);
+	}
+
+	void addSint16(uint32 strct, const char *label, int16 value) {
+		addField(strct, 3, label, (uint16) value);
+	}
+
+	void addUint32(uint32 strct, const char *label, uint32 value) {
+		addField(strct, 4, label, value);
+	}
+
+	void addSint32(uint32 strct, const char *label, int32 value) {
+		addField(strct, 5, label, (uint32) value);
+	}
+
+	void addFloat(uint32 strct, const char *label, float value) {
+		addField(strct, 8, label, convertIEEEFloat(value));
+	}
+
+	void addExoString(uint32 strct, const char *label, const Common::UString &value) {
+		addField(strct, 10, label, _fieldData.size());
+
+		_fieldData.writeUint32LE(std::strlen(value.c_str()));
+		_fieldData.writeString(value);
+	}
+
+	void addResRef(uint32 strct, const char *label, const Common::UString &value) {
+		addField(strct, 11, label, _fieldData.size());
+
+		const size_t length = MIN<size_t>(std::strlen(value.c_str()), 16);
+
+		_fieldData.writeByte(length);
+		_fieldData.write(value.c_str(), length);
+	}
+
+	void addLocString(uint32 strct, const char *label, uint32 strRef, const Common::UString &value) {
+		addField(strct, 12, label, _fieldData.size());
+
+		const uint32 length = std::strlen(value.c_str());
+
+		_fieldData.writeUint32LE(4 + 4 + 4 + 4 + length); // Total size, without this field
+		_fieldData.writeUint32LE(strRef);
+		_fieldData.writeUint32LE(1);                       // Number of substrings
+		_fieldData.writeUint32LE(0);                       // English, male
+		_fieldData.writeUint32LE(length);
+		_fieldData.writeString(value);
+	}
+
+	void addVector(uint32 strct, const char *label, float x, float y, float z) {
+		addField(strct, 17, label, _fieldData.size());
+
+		_fieldData.writeIEEEFloatLE(x);
+		_fieldData.writeIEEEFloatLE(y);
+		_fieldData.writeIEEEFloatLE(z);
+	}
+
+	void addStruct(uint32 strct, const char *label, uint32 child) {
+		addField(strct, 14, label, child);
+	}
+
+	void addList(uint32 strct, const char *label, const std::vector<uint32> &children) {
+		addField(strct, 15, label, _listIndices.size());
+
+		_listIndices.writeUint32LE(children.size());
+		for (std::vector<uint32>::const_iterator c = children.begin(); c != children.end(); ++c)
+			_listIndices.writeUint32LE(*c);
+	}
+
+	void write(Common::WriteStream &out) {
+		static const uint32 kHeaderSize = 56;
+
+		uint32 fieldIndicesSize = 0;
+		for (std::vector<Struct>::const_iterator s = _structs.begin(); s != _structs.end(); ++s)
+			if (s->fields.size() > 1)
+				fieldIndicesSize += s->fields.size() * 4;
+
+		const uint32 structOffset       = kHeaderSize;
+		const uint32 fieldOffset        = structOffset       + _structs.size() * 12;
+		const uint32 labelOffset        = fieldOffset        + _fields.size()  * 12;
+		const uint32 fieldDataOffset    = labelOffset        + _labels.size()  * 16;
+		const uint32 fieldIndicesOffset = fieldDataOffset    + _fieldData.size();
+		const uint32 listIndicesOffset  = fieldIndicesOffset + fieldIndicesSize;
+
+		out.writeUint32BE(_id);
+		out.writeUint32BE(MKTAG('V', '3', '.', '2'));
+
+		out.writeUint32LE(structOffset);
+		out.writeUint32LE(_structs.size());
+		out.writeUint32LE(fieldOffset);
+		out.writeUint32LE(_fields.size());
+		out.writeUint32LE(labelOffset);
+		out.writeUint32LE(_labels.size());
+		out.writeUint32LE(fieldDataOffset);
+		out.writeUint32LE(_fieldData.size());
+		out.writeUint32LE(fieldIndicesOffset);
+		out.writeUint32LE(fieldIndicesSize);
+		out.writeUint32LE(listIndicesOffset);
+		out.writeUint32LE(_listIndices.size());
+
+		uint32 fieldIndex = 0;
+		for (std::vector<Struct>::const_iterator s = _structs.begin(); s != _structs.end(); ++s) {
+			out.writeUint32LE(s->id);
+
+			if      (s->fields.empty())
+				out.writeUint32LE(0xFFFFFFFF);
+			else if (s->fields.size() == 1)
+				out.writeUint32LE(s->fields[0]);
+			else {
+				out.writeUint32LE(fieldIndex);
+				fieldIndex += s->fields.size() * 4;
+			}
+
+			out.writeUint32LE(s->fields.size());
+		}
+
+		for (std::vector<Field>::const_iterator f = _fields.begin(); f != _fields.end(); ++f) {
+			out.writeUint32LE(f->type);
+			out.writeUint32LE(f->label);
+			out.writeUint32LE(f->data);
+		}
+
+		for (std::vector<Common::UString>::const_iterator l = _labels.begin(); l != _labels.end(); ++l)
+			writeFixedString(out, *l, 16);
+
+		out.write(_fieldData.getData(), _fieldData.size());
+
+		for (std::vector<Struct>::const_iterator s = _structs.begin(); s != _structs.end(); ++s)
+			if (s->fields.size() > 1)
+				for (std::vector<uint32>::const_iterator f = s->fields.begin(); f != s->fields.end(); ++f)
+					out.writeUint32LE(*f);
+
+		out.write(_listIndices.getData(), _listIndices.size());
+	}
+
+private:
+	struct Field {
+		uint32 type;
+		uint32 label;
+		uint32 data;
+	};
+
+	struct Struct {
+		uint32 id;
+		std::vector<uint32> fields;
+	};
+
+	typedef std::map<Common::UString, uint32> LabelMap;
+
+	uint32 _id;
+
+	std::vector<Struct> _structs;
+	std::vector<Field>  _fields;
+
+	std::vector<Common::UString> _labels;
+	LabelMap _labelIndices;
+
+	Common::MemoryWriteStreamDynamic _fieldData;
+	Common::MemoryWriteStreamDynamic _listIndices;
+
+
+	uint32 getLabel(const char *label) {
+		LabelMap::const_iterator l = _labelIndices.find(label);
+		if (l != _labelIndices.end())
+			return l->second;
+
+		_labels.push_back(label);
+		_labelIndices.insert(std::make_pair(Common::UString(label), (uint32) (_labels.size() - 1)));
+
+		return _labels.size() - 1;
+	}
+
+	void addField(uint32 strct, uint32 type, const char *label, uint32 data) {
+		assert(strct < _structs.size());
+
+		Field field;
+		field.type  = type;
+		field.label = getLabel(label);
+		field.data  = data;
+
+		_fields.push_back(field);
+		_structs[strct].fields.push_back(_fields.size() - 1);
+	}
+};
+
+/** Write a GFF3 shaped like an area's object list or a blueprint with an inventory. */
+static void writeGFF3(Common::WriteStream &out, uint32 id, Random &random, const CorpusOptions &options) {
+	GFF3Writer gff3(id);
+
+	const uint32 top = gff3.addStruct(0xFFFFFFFF);
+
+	gff3.addExoString(top, "Tag"           , randomName(random));
+	gff3.addResRef   (top, "TemplateResRef", randomName(random));
+	gff3.addLocString(top, "LocName"       , random.next(), randomName(random));
+	gff3.addLocString(top, "Description"   , 0xFFFFFFFF, randomSentence(random, 24));
+	gff3.addExoString(top, "Comment"       , randomSentence(random, 8));
+	gff3.addUint16   (top, "Appearance"    , random.next(500));
+	gff3.addByte     (top, "Plot"          , random.next(2));
+	gff3.addSint16   (top, "HitPoints"     , random.next(200));
+	gff3.addUint32   (top, "Gold"          , random.next(10000));
+	gff3.addFloat    (top, "ChallengeRating", random.nextFloat(0.0f, 20.0f));
+	gff3.addVector   (top, "Position"      , random.nextFloat(0.0f, 100.0f),
+	                                         random.nextFloat(0.0f, 100.0f), random.nextFloat(0.0f, 10.0f));
+
+	// A list of placed objects, each with a few scripts
+
+	std::vector<uint32> objects;
+	for (size_t i = 0; i < options.listLength; i++) {
+		const uint32 object  = gff3.addStruct(i);
+		const uint32 scripts = gff3.addStruct(0);
+
+		gff3.addResRef(scripts, "OnSpawn"    , randomName(random));
+		gff3.addResRef(scripts, "OnDeath"    , randomName(random));
+		gff3.addResRef(scripts, "OnHeartbeat", randomName(random));
+
+		gff3.addExoString(object, "Tag"           , randomName(random));
+		gff3.addResRef   (object, "TemplateResRef", randomName(random));
+		gff3.addFloat    (object, "XPosition"     , random.nextFloat(0.0f, 100.0f));
+		gff3.addFloat    (object, "YPosition"     , random.nextFloat(0.0f, 100.0f));
+		gff3.addFloat    (object, "ZPosition"     , random.nextFloat(0.0f, 10.0f));
+		gff3.addFloat    (object, "Bearing"       , random.nextFloat(0.0f, 6.28f));
+		gff3.addUint16   (object, "Appearance"    , random.next(500));
+		gff3.addStruct   (object, "Scripts"       , scripts);
+
+		objects.push_back(object);
+	}
+
+	gff3.addList(top, "ObjectList", objects);
+
+	// A list of local variables
+
+	std::vector<uint32> variables;
+	for (size_t i = 0; i < (options.listLength / 4); i++) {
+		const uint32 variable = gff3.addStruct(0);
+
+		gff3.addExoString(variable, "Name" , randomName(random));
+		gff3.addUint32   (variable, "Type" , 1);
+		gff3.addSint32   (variable, "Value", random.next());
+
+		variables.push_back(variable);
+	}
+
+	gff3.addList(top, "VarTable", variables);
+
+	gff3.write(out);
+}
+
+
+// --- GFF4 ---
+
+/** Write a GFF4 shaped like a Dragon Age GDA table. */
+static void writeGDA(Common::WriteStream &out, Random &random, const CorpusOptions &options) {
+	static const uint32 kHeaderSize         = 28;
+	static const uint32 kStructTemplateSize = 16;
+	static const uint32 kFieldSize          = 12;
+
+	static const uint16 kFlagList   = 0x8000;
+	static const uint16 kFlagStruct = 0x4000;
+
+	static const uint16 kTypeUint8   =  0;
+	static const uint16 kTypeUint32  =  4;
+	static const uint16 kTypeSint32  =  5;
+	static const uint16 kTypeFloat32 =  8;
+	static const uint16 kTypeString  = 14;
+
+	const uint32 columns = options.tableColumns;
+	const uint32 rows    = options.tableRows;
+
+	// Column types: integers, floats and strings, in turn
+	std::vector<uint16> columnTypes(columns);
+	for (uint32 c = 0; c < columns; c++)
+		columnTypes[c] = (c % 3) == 0 ? kTypeSint32 : ((c % 3) == 1 ? kTypeFloat32 : kTypeString);
+
+	const uint32 fieldCount = 2 + 2 + columns;
+	const uint32 dataOffset = kHeaderSize + 3 * kStructTemplateSize + fieldCount * kFieldSize;
+
+	// The top-level struct holds the offsets of the column and row lists, which follow directly
+
+	const uint32 columnSize = 8;
+	const uint32 rowSize    = columns * 4;
+
+	const uint32 columnListOffset = 8;
+	const uint32 rowListOffset    = columnListOffset + 4 + columns * columnSize;
+	const uint32 stringsOffset    = rowListOffset    + 4 + rows    * rowSize;
+
+	out.writeUint32BE(MKTAG('G', 'F', 'F', ' '));
+	out.writeUint32BE(MKTAG('V', '4', '.', '0'));
+	out.writeUint32BE(MKTAG('P', 'C', ' ', ' '));
+	out.writeUint32BE(MKTAG('G', '2', 'D', 'A'));
+	out.writeUint32BE(MKTAG('V', '0', '.', '2'));
+	out.writeUint32LE(3);
+	out.writeUint32LE(dataOffset);
+
+	// Struct templates
+
+	const uint32 fieldsOffset = kHeaderSize + 3 * kStructTemplateSize;
+
+	out.writeUint32BE(MKTAG('g', 't', 'o', 'p'));
+	out.writeUint32LE(2);
+	out.writeUint32LE(fieldsOffset);
+	out.writeUint32LE(8);
+
+	out.writeUint32BE(MKTAG('g', 'c', 'o', 'l'));
+	out.writeUint32LE(2);
+	out.writeUint32LE(fieldsOffset + 2 * kFieldSize);
+	out.writeUint32LE(columnSize);
+
+	out.writeUint32BE(MKTAG('g', 'r', 'o', 'w'));
+	out.writeUint32LE(columns);
+	out.writeUint32LE(fieldsOffset + 4 * kFieldSize);
+	out.writeUint32LE(rowSize);
+
+	// Field declarations
+
+	out.writeUint32LE(10000);                 // Columns, a list of struct 1
+	out.writeUint16LE(1);
+	out.writeUint16LE(kFlagList | kFlagStruct);
+	out.writeUint32LE(0);
+
+	out.writeUint32LE(10001);                 // Rows, a list of struct 2
+	out.writeUint16LE(2);
+	out.writeUint16LE(kFlagList | kFlagStruct);
+	out.writeUint32LE(4);
+
+	out.writeUint32LE(10002);                 // Column hash
+	out.writeUint16LE(kTypeUint32);
+	out.writeUint16LE(0);
+	out.writeUint32LE(0);
+
+	out.writeUint32LE(10999);                 // Column type
+	out.writeUint16LE(kTypeUint8);
+	out.writeUint16LE(0);
+	out.writeUint32LE(4);
+
+	for (uint32 c = 0; c < columns; c++) {
+		out.writeUint32LE(c);
+		out.writeUint16LE(columnTypes[c]);
+		out.writeUint16LE(0);
+		out.writeUint32LE(c * 4);
+	}
+
+	// Data: the top-level struct, the columns, the rows, then the strings
+
+	out.writeUint32LE(columnListOffset);
+	out.writeUint32LE(rowListOffset);
+
+	out.writeUint32LE(columns);
+	for (uint32 c = 0; c < columns; c++) {
+		out.writeUint32LE(random.next());
+		out.writeByte(columnTypes[c] == kTypeString ? 0 : (columnTypes[c] == kTypeFloat32 ? 2 : 1));
+		out.writeByte(0);
+		out.writeUint16LE(0);
+	}
+
+	Common::MemoryWriteStreamDynamic strings(true);
+
+	out.writeUint32LE(rows);
+	for (uint32 r = 0; r < rows; r++) {
+		for (uint32 c = 0; c < columns; c++) {
+			if        (columnTypes[c] == kTypeSint32) {
+				out.writeSint32LE(random.next(1000));
+			} else if (columnTypes[c] == kTypeFloat32) {
+				out.writeIEEEFloatLE(random.nextFloat(0.0f, 100.0f));
+			} else {
+				out.writeUint32LE(stringsOffset + strings.size());
+
+				// UTF-16LE, prefixed with the length in characters
+				const Common::UString str = randomName(random);
+				const size_t length = std::strlen(str.c_str());
+
+				strings.writeUint32LE(length);
+				for (size_t i = 0; i < length; i++)
+					strings.writeUint16LE((byte) str.c_str()[i]);
+			}
+		}
+	}
+
+	out.write(strings.getData(), strings.size());
+}
+
+
+// --- 2DA ---
+
+/** Return the value of a 2DA cell. */
+static Common::UString randomCell(Random &random, uint32 column) {
+	if (random.next(8) == 0)
+		return "****";
+
+	if ((column % 3) == 0)
+		return Common::UString::format("%u", random.next(1000));
+	if ((column % 3) == 1)
+		return Common::UString::format("%.2f", random.nextFloat(0.0f, 100.0f));
+
+	return randomName(random);
+}
+
+/** Write a 2DA, in the text format. */
+static void write2DAText(Common::WriteStream &out, Random &random, const CorpusOptions &options) {
+	out.writeString("2DA V2.0\n\n");
+
+	out.writeString("   ");
+	for (size_t c = 0; c < options.tableColumns; c++)
+		out.writeString(Common::UString::format(" Column%u", (uint) c));
+	out.writeString("\n");
+
+	for (size_t r = 0; r < options.tableRows; r++) {
+		out.writeString(Common::UString::format("%u", (uint) r));
+
+		for (size_t c = 0; c < options.tableColumns; c++)
+			out.writeString(" " + randomCell(random, c));
+
+		out.writeString("\n");
+	}
+}
+
+/** Write a 2DA, in the binary format. */
+static void write2DABinary(Common::WriteStream &out, Random &random, const CorpusOptions &options) {
+	out.writeString("2DA V2.b\n");
+
+	for (size_t c = 0; c < options.tableColumns; c++)
+		out.writeString(Common::UString::format("Column%u\t", (uint) c));
+	out.writeByte(0);
+
+	out.writeUint32LE(options.tableRows);
+	for (size_t r = 0; r < options.tableRows; r++)
+		out.writeString(Common::UString::format("%u\t", (uint) r));
+
+	// Cells hold offsets into a pool of unique strings
+
+	typedef std::map<Common::UString, uint16> StringMap;
+
+	StringMap stringOffsets;
+	Common::MemoryWriteStreamDynamic stringPool(true);
+
+	for (size_t i = 0; i < (options.tableRows * options.tableColumns); i++) {
+		const Common::UString cell = randomCell(random, i % options.tableColumns);
+
+		StringMap::const_iterator s = stringOffsets.find(cell);
+		if (s == stringOffsets.end()) {
+			s = stringOffsets.insert(std::make_pair(cell, (uint16) stringPool.size())).first;
+
+			stringPool.writeString(cell);
+			stringPool.writeByte(0);
+
+			if (stringPool.size() > 0xFFFF)
+				throw Common::Exception("Binary 2DA string pool too big");
+		}
+
+		out.writeUint16LE(s->second);
+	}
+
+	out.writeUint16LE(stringPool.size());
+	out.write(stringPool.getData(), stringPool.size());
+}
+
+
+// --- NCS ---
+
+/** Write an NCS that adds up constants into a local variable. */
+static void writeNCS(Common::WriteStream &out, Random &random, const CorpusOptions &options) {
+	// Every block is CONSTI, CONSTI, ADDII, CPDOWNSP, MOVSP
+	static const uint32 kBlockSize = 6 + 6 + 2 + 8 + 6;
+
+	const uint32 size = 8 + 5 + 2 + options.scriptBlocks * kBlockSize + 6 + 2;
+
+	out.writeUint32BE(MKTAG('N', 'C', 'S', ' '));
+	out.writeUint32BE(MKTAG('V', '1', '.', '0'));
+
+	out.writeByte(0x42);
+	out.writeUint32BE(size);
+
+	// RSADDI: Reserve the local variable
+	out.writeByte(0x02);
+	out.writeByte(0x03);
+
+	for (size_t i = 0; i < options.scriptBlocks; i++) {
+		// CONSTI
+		out.writeByte(0x04);
+		out.writeByte(0x03);
+		out.writeUint32BE(random.next(1000));
+
+		// CONSTI
+		out.writeByte(0x04);
+		out.writeByte(0x03);
+		out.writeUint32BE(random.next(1000));
+
+		// ADDII
+		out.writeByte(0x14);
+		out.writeByte(0x20);
+
+		// CPDOWNSP: Copy the sum into the local variable
+		out.writeByte(0x01);
+		out.writeByte(0x01);
+		out.writeSint32BE(-8);
+		out.writeUint16BE(4);
+
+		// MOVSP: Pop the sum
+		out.writeByte(0x1B);
+		out.writeByte(0x00);
+		out.writeSint32BE(-4);
+	}
+
+	// MOVSP: Pop the local variable
+	out.writeByte(0x1B);
+	out.writeByte(0x00);
+	out.writeSint32BE(-4);
+
+	// RETN
+	out.writeByte(0x20);
+	out.writeByte(0x00);
+}
+
+
+// --- TGA ---
+
+/** Write an uncompressed 32-bit TGA with a noisy gradient. */
+static void writeTGA(Common::WriteStream &out, Random &random) {
+	const uint16 width  = 32 << random.next(4);
+	const uint16 height = 32 << random.next(4);
+
+	out.writeByte(0);         // ID length
+	out.writeByte(0);         // No color map
+	out.writeByte(2);         // Uncompressed true color
+	for (int i = 0; i < 5; i++)
+		out.writeByte(0);     // Color map specification
+	out.writeUint16LE(0);     // X origin
+	out.writeUint16LE(0);     // Y origin
+	out.writeUint16LE(width);
+	out.writeUint16LE(height);
+	out.writeByte(32);        // Bits per pixel
+	out.writeByte(0x08);      // 8 bits alpha
+
+	for (uint32 y = 0; y < height; y++) {
+		for (uint32 x = 0; x < width; x++) {
+			const uint32 noise = random.next(32);
+
+			out.writeByte(((x * 255) / width ) ^ noise);
+			out.writeByte(((y * 255) / height) ^ noise);
+			out.writeByte(noise * 8);
+			out.writeByte(0xFF);
+		}
+	}
+}
+
+
+// --- TLK ---
+
+/** Write a talk table of random sentences. */
+static void writeTLK(Common::WriteStream &out, Random &random, const CorpusOptions &options) {
+	static const uint32 kHeaderSize = 20;
+	static const uint32 kEntrySize  = 40;
+
+	static const uint32 kFlagTextPresent = 0x01;
+	static const uint32 kFlagSoundPresent = 0x02;
+
+	std::vector<Common::UString> strings;
+	strings.reserve(options.talkStrings);
+
+	for (size_t i = 0; i < options.talkStrings; i++)
+		strings.push_back(randomSentence(random, 1 + random.next(40)));
+
+	out.writeUint32BE(MKTAG('T', 'L', 'K', ' '));
+	out.writeUint32BE(MKTAG('V', '3', '.', '0'));
+
+	out.writeUint32LE(0); // English
+	out.writeUint32LE(strings.size());
+	out.writeUint32LE(kHeaderSize + strings.size() * kEntrySize);
+
+	uint32 offset = 0;
+	for (size_t i = 0; i < strings.size(); i++) {
+		const uint32 length   = std::strlen(strings[i].c_str());
+		const bool   hasSound = random.next(4) == 0;
+
+		out.writeUint32LE(kFlagTextPresent | (hasSound ? kFlagSoundPresent : 0));
+		writeFixedString(out, hasSound ? Common::UString::format("vo_%06u", (uint) i) : "", 16);
+		out.writeUint32LE(0); // Volume variance
+		out.writeUint32LE(0); // Pitch variance
+		out.writeUint32LE(offset);
+		out.writeUint32LE(length);
+		out.writeIEEEFloatLE(hasSound ? random.nextFloat(0.5f, 10.0f) : 0.0f);
+
+		offset += length;
+	}
+
+	for (size_t i = 0; i < strings.size(); i++)
+		out.writeString(strings[i]);
+}
+
+
+// --- Resource generation ---
+
+/** The kinds of GFF3 we generate, and their IDs. */
+static const struct {
+	Aurora::FileType type;
+	uint32 id;
+} kGFF3Types[] = {
+	{ Aurora::kFileTypeARE, MKTAG('A', 'R', 'E', ' ') },
+	{ Aurora::kFileTypeGIT, MKTAG('G', 'I', 'T', ' ') },
+	{ Aurora::kFileTypeIFO, MKTAG('I', 'F', 'O', ' ') },
+	{ Aurora::kFileTypeUTC, MKTAG('U', 'T', 'C', ' ') },
+	{ Aurora::kFileTypeUTI, MKTAG('U', 'T', 'I', ' ') },
+	{ Aurora::kFileTypeUTP, MKTAG('U', 'T', 'P', ' ') },
+	{ Aurora::kFileTypeDLG, MKTAG('D', 'L', 'G', ' ') }
+};
+
+/** Generate a resource of this type. */
+static void generateResource(CorpusResources &resources, const Common::UString &name, Aurora::FileType type,
+                             Random &random, const CorpusOptions &options) {
+
+	Common::MemoryWriteStreamDynamic data(true);
+
+	switch (type) {
+		case Aurora::kFileType2DA:
+			if (random.next(2) == 0)
+				write2DAText(data, random, options);
+			else
+				write2DABinary(data, random, options);
+			break;
+
+		case Aurora::kFileTypeGDA:
+			writeGDA(data, random, options);
+			break;
+
+		case Aurora::kFileTypeNCS:
+			writeNCS(data, random, options);
+			break;
+
+		case Aurora::kFileTypeTGA:
+			writeTGA(data, random);
+			break;
+
+		default:
+			for (size_t i = 0; i < ARRAYSIZE(kGFF3Types); i++)
+				if (kGFF3Types[i].type == type)
+					writeGFF3(data, kGFF3Types[i].id, random, options);
+
+			if (data.size() == 0)
+				throw Common::Exception("Can't generate resources of type %d", (int) type);
+			break;
+	}
+
+	addResource(resources, name, type, data);
+}
+
+/** Generate resources, picking their types from this list in turn. */
+static void generateResources(CorpusResources &resources, const char *prefix, size_t count,
+                              const Aurora::FileType *types, size_t typeCount,
+                              Random &random, const CorpusOptions &options) {
+
+	resources.reserve(resources.size() + count);
+
+	for (size_t i = 0; i < count; i++)
+		generateResource(resources, Common::UString::format("%s_%05u", prefix, (uint) i),
+		                 types[i % typeCount], random, options);
+}
+
+
+// --- Archives ---
+
+static void openFile(Common::WriteFile &file, const Common::UString &path) {
+	if (!file.open(path))
+		throw Common::Exception("Can't open file \"%s\" for writing", path.c_str());
+}
+
+/** Write a BIF V1. */
+static void writeBIF(const Common::UString &path, uint32 bifIndex, const CorpusResources &resources) {
+	static const uint32 kHeaderSize = 20;
+	static const uint32 kEntrySize  = 16;
+
+	Common::WriteFile bif;
+	openFile(bif, path);
+
+	bif.writeUint32BE(MKTAG('B', 'I', 'F', 'F'));
+	bif.writeUint32BE(MKTAG('V', '1', ' ', ' '));
+
+	bif.writeUint32LE(resources.size());
+	bif.writeUint32LE(0); // Fixed resources
+	bif.writeUint32LE(kHeaderSize);
+
+	uint32 offset = kHeaderSize + resources.size() * kEntrySize;
+	for (size_t i = 0; i < resources.size(); i++) {
+		bif.writeUint32LE((bifIndex << 20) | i);
+		bif.writeUint32LE(offset);
+		bif.writeUint32LE(resources[i].data.size());
+		bif.writeUint32LE(resources[i].type);
+
+		offset += resources[i].data.size();
+	}
+
+	for (size_t i = 0; i < resources.size(); i++)
+		if (!resources[i].data.empty())
+			bif.write(&resources[i].data[0], resources[i].data.size());
+
+	bif.flush();
+}
+
+/** Write a KEY V1, indexing these BIFs. */
+static void writeKEY(const Common::UString &path, const std::vector<Common::UString> &bifNames,
+                     const std::vector<CorpusResources> &bifs) {
+
+	static const uint32 kHeaderSize = 64;
+	static const uint32 kFileSize   = 12;
+
+	Common::WriteFile key;
+	openFile(key, path);
+
+	uint32 resourceCount = 0, nameSize = 0;
+	for (size_t i = 0; i < bifs.size(); i++) {
+		resourceCount += bifs[i].size();
+		nameSize      += std::strlen(bifNames[i].c_str()) + 1;
+	}
+
+	const uint32 fileTableOffset     = kHeaderSize;
+	const uint32 nameTableOffset     = fileTableOffset + bifs.size() * kFileSize;
+	const uint32 resourceTableOffset = nameTableOffset + nameSize;
+
+	key.writeUint32BE(MKTAG('K', 'E', 'Y', ' '));
+	key.writeUint32BE(MKTAG('V', '1', ' ', ' '));
+
+	key.writeUint32LE(bifs.size());
+	key.writeUint32LE(resourceCount);
+	key.writeUint32LE(fileTableOffset);
+	key.writeUint32LE(resourceTableOffset);
+	key.writeUint32LE(100); // Build year, since 1900
+	key.writeUint32LE(1);   // Build day
+
+	for (int i = 0; i < 32; i++)
+		key.writeByte(0);   // Reserved
+
+	uint32 nameOffset = nameTableOffset;
+	for (size_t i = 0; i < bifs.size(); i++) {
+		uint32 bifSize = 20 + bifs[i].size() * 16;
+		for (CorpusResources::const_iterator r = bifs[i].begin(); r != bifs[i].end(); ++r)
+			bifSize += r->data.size();
+
+		const uint32 length = std::strlen(bifNames[i].c_str()) + 1;
+
+		key.writeUint32LE(bifSize);
+		key.writeUint32LE(nameOffset);
+		key.writeUint16LE(length);
+		key.writeUint16LE(1);   // On the hard drive
+
+		nameOffset += length;
+	}
+
+	for (size_t i = 0; i < bifs.size(); i++) {
+		key.writeString(bifNames[i]);
+		key.writeByte(0);
+	}
+
+	for (size_t i = 0; i < bifs.size(); i++) {
+		for (size_t j = 0; j < bifs[i].size(); j++) {
+			writeFixedString(key, bifs[i][j].name, 16);
+			key.writeUint16LE(bifs[i][j].type);
+			key.writeUint32LE((i << 20) | j);
+		}
+	}
+
+	key.flush();
+}
+
+/** Write an ERF V1.0, with this ID ("ERF ", "MOD ", "HAK "). */
+static void writeERF(const Common::UString &path, uint32 id, const CorpusResources &resources) {
+	static const uint32 kHeaderSize = 160;
+	static const uint32 kKeySize    = 24;
+	static const uint32 kResSize    = 8;
+
+	Common::WriteFile erf;
+	openFile(erf, path);
+
+	const uint32 keyListOffset = kHeaderSize;
+	const uint32 resListOffset = keyListOffset + resources.size() * kKeySize;
+
+	erf.writeUint32BE(id);
+	erf.writeUint32BE(MKTAG('V', '1', '.', '0'));
+
+	erf.writeUint32LE(0);                // Number of description languages
+	erf.writeUint32LE(0);                // Size of the description
+	erf.writeUint32LE(resources.size());
+	erf.writeUint32LE(kHeaderSize);      // Description offset
+	erf.writeUint32LE(keyListOffset);
+	erf.writeUint32LE(resListOffset);
+	erf.writeUint32LE(100);              // Build year, since 1900
+	erf.writeUint32LE(1);                // Build day
+	erf.writeUint32LE(0xFFFFFFFF);       // Description string reference
+
+	for (int i = 0; i < 116; i++)
+		erf.writeByte(0);                // Reserved
+
+	for (size_t i = 0; i < resources.size(); i++) {
+		writeFixedString(erf, resources[i].name, 16);
+		erf.writeUint32LE(i);
+		erf.writeUint16LE(resources[i].type);
+		erf.writeUint16LE(0);
+	}
+
+	uint32 offset = resListOffset + resources.size() * kResSize;
+	for (size_t i = 0; i < resources.size(); i++) {
+		erf.writeUint32LE(offset);
+		erf.writeUint32LE(resources[i].data.size());
+
+		offset += resources[i].data.size();
+	}
+
+	for (size_t i = 0; i < resources.size(); i++)
+		if (!resources[i].data.empty())
+			erf.write(&resources[i].data[0], resources[i].data.size());
+
+	erf.flush();
+}
+
+/** Write a RIM V1.0. */
+static void writeRIM(const Common::UString &path, const CorpusResources &resources) {
+	static const uint32 kHeaderSize = 120;
+	static const uint32 kEntrySize  = 32;
+
+	Common::WriteFile rim;
+	openFile(rim, path);
+
+	rim.writeUint32BE(MKTAG('R', 'I', 'M', ' '));
+	rim.writeUint32BE(MKTAG('V', '1', '.', '0'));
+
+	rim.writeUint32LE(0); // Reserved
+	rim.writeUint32LE(resources.size());
+	rim.writeUint32LE(kHeaderSize);
+
+	for (uint32 i = 20; i < kHeaderSize; i++)
+		rim.writeByte(0); // Reserved
+
+	uint32 offset = kHeaderSize + resources.size() * kEntrySize;
+	for (size_t i = 0; i < resources.size(); i++) {
+		writeFixedString(rim, resources[i].name, 16);
+		rim.writeUint16LE(resources[i].type);
+		rim.writeUint32LE(i);
+		rim.writeUint16LE(0);
+		rim.writeUint32LE(offset);
+		rim.writeUint32LE(resources[i].data.size());
+
+		offset += resources[i].data.size();
+	}
+
+	for (size_t i = 0; i < resources.size(); i++)
+		if (!resources[i].data.empty())
+			rim.write(&resources[i].data[0], resources[i].data.size());
+
+	rim.flush();
+}
+
+static void createDirectory(const Common::UString &path) {
+	Common::FilePath::createDirectories(path);
+
+	if (!Common::FilePath::isDirectory(path))
+		throw Common::Exception("Can't create directory \"%s\"", path.c_str());
+}
+
+
+void writeCorpus(const Common::UString &directory, const CorpusOptions &options) {
+	Random random(options.seed);
+
+	createDirectory(directory);
+	createDirectory(directory + "/data");
+	createDirectory(directory + "/modules");
+	createDirectory(directory + "/rims");
+	createDirectory(directory + "/override");
+
+	// Global resources, in BIFs indexed by the KEY
+
+	static const Aurora::FileType kBIFTypes[] = {
+		Aurora::kFileType2DA, Aurora::kFileTypeNCS, Aurora::kFileTypeUTI,
+		Aurora::kFileTypeUTC, Aurora::kFileTypeUTP, Aurora::kFileTypeTGA
+	};
+
+	std::vector<Common::UString> bifNames;
+	std::vector<CorpusResources> bifs(options.bifCount);
+
+	for (size_t i = 0; i < options.bifCount; i++) {
+		bifNames.push_back(Common::UString::format("data/corpus_%02u.bif", (uint) i));
+
+		generateResources(bifs[i], Common::UString::format("b%02u", (uint) i).c_str(), options.resourcesPerBIF,
+		                  kBIFTypes, ARRAYSIZE(kBIFTypes), random, options);
+
+		writeBIF(directory + "/" + bifNames.back(), i, bifs[i]);
+	}
+
+	writeKEY(directory + "/chitin.key", bifNames, bifs);
+	bifs.clear();
+
+	// The talk table
+
+	{
+		Common::WriteFile tlk;
+		openFile(tlk, directory + "/dialog.tlk");
+
+		writeTLK(tlk, random, options);
+		tlk.flush();
+	}
+
+	// Modules, with areas, their objects and their scripts
+
+	static const Aurora::FileType kModuleTypes[] = {
+		Aurora::kFileTypeARE, Aurora::kFileTypeGIT, Aurora::kFileTypeUTC,
+		Aurora::kFileTypeDLG, Aurora::kFileTypeNCS, Aurora::kFileTypeIFO
+	};
+
+	for (size_t i = 0; i < options.moduleCount; i++) {
+		CorpusResources resources;
+		generateResources(resources, Common::UString::format("m%02u", (uint) i).c_str(),
+		                  options.resourcesPerModule, kModuleTypes, ARRAYSIZE(kModuleTypes), random, options);
+
+		writeERF(Common::UString::format("%s/modules/corpus_%02u.mod", directory.c_str(), (uint) i),
+		         MKTAG('M', 'O', 'D', ' '), resources);
+	}
+
+	// RIMs, like KotOR's area files
+
+	static const Aurora::FileType kRIMTypes[] = {
+		Aurora::kFileTypeARE, Aurora::kFileTypeGIT, Aurora::kFileTypeUTP, Aurora::kFileType2DA
+	};
+
+	for (size_t i = 0; i < options.rimCount; i++) {
+		CorpusResources resources;
+		generateResources(resources, Common::UString::format("r%02u", (uint) i).c_str(),
+		                  options.resourcesPerRIM, kRIMTypes, ARRAYSIZE(kRIMTypes), random, options);
+
+		writeRIM(Common::UString::format("%s/rims/corpus_%02u.rim", directory.c_str(), (uint) i), resources);
+	}
+
+	// Loose files, with the GFF4 tables
+
+	static const Aurora::FileType kOverrideTypes[] = {
+		Aurora::kFileTypeGDA, Aurora::kFileType2DA, Aurora::kFileTypeUTC
+	};
+
+	CorpusResources loose;
+	generateResources(loose, "o", options.overrideCount, kOverrideTypes, ARRAYSIZE(kOverrideTypes), random, options);
+
+	for (CorpusResources::const_iterator r = loose.begin(); r != loose.end(); ++r) {
+		Common::WriteFile file;
+		openFile(file, directory + "/override/" + TypeMan.setFileType(r->name, r->type));
+
+		if (!r->data.empty())
+			file.write(&r->data[0], r->data.size());
+
+		file.flush();
+	}
+}
+
+} // End of namespace Benchmark
@@ -0,0 +1,72 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Generator for a synthetic corpus of Aurora files.
+ */
+
+#ifndef BENCHMARK_CORPUS_H
+#define BENCHMARK_CORPUS_H
+
+#include "src/common/types.h"
+#include "src/common/ustring.h"
+
+namespace Benchmark {
+
+/** The size and shape of a synthetic corpus. */
+struct CorpusOptions {
+	uint32 seed; ///< Seed for the pseudo-random contents.
+
+	size_t bifCount;           ///< Number of BIFs indexed by the KEY.
+	size_t resourcesPerBIF;    ///< Number of resources in each BIF.
+	size_t moduleCount;        ///< Number of module ERFs.
+	size_t resourcesPerModule; ///< Number of resources in each module ERF.
+	size_t rimCount;           ///< Number of RIMs.
+	size_t resourcesPerRIM;    ///< Number of resources in each RIM.
+	size_t overrideCount;      ///< Number of loose files in the override directory.
+
+	size_t talkStrings;  ///< Number of strings in the talk table.
+	size_t listLength;   ///< Number of structs in the lists of a GFF.
+	size_t tableRows;    ///< Number of rows in a 2DA or GDA.
+	size_t tableColumns; ///< Number of columns in a 2DA or GDA.
+	size_t scriptBlocks; ///< Number of instruction blocks in an NCS.
+
+	CorpusOptions();
+
+	/** Multiply the number of archives and resources by this factor. */
+	void scale(size_t factor);
+};
+
+/** Write a synthetic but structurally realistic game corpus into this directory.
+ *
+ *  The corpus mimics the layout of an Aurora game: a chitin.key indexing
+ *  BIFs in data/, a dialog.tlk, module ERFs in modules/, RIMs in rims/ and
+ *  loose files in override/. The resources are GFF3, GFF4 (GDA), 2DA (both
+ *  text and binary), NCS and TGA files of the configured shape.
+ *
+ *  The contents only depend on the options, so every run with the same
+ *  options writes exactly the same corpus. The resource benchmarks can then
+ *  run offline, without any game data.
+ */
+void writeCorpus(const Common::UString &directory, const CorpusOptions &options);
+
+} // End of namespace Benchmark
+
+#endif // BENCHMARK_CORPUS_H
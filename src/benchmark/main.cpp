@@ -0,0 +1,214 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Entry point of the headless xoreos benchmark.
+ */
+
+#define SDL_MAIN_HANDLED
+
+#include <cstdio>
+#include <cstring>
+
+#include "src/common/ustring.h"
+#include "src/common/util.h"
+#include "src/common/error.h"
+#include "src/common/threads.h"
+#include "src/common/debugman.h"
+#include "src/common/configman.h"
+#include "src/common/workerpool.h"
+
+#include "src/aurora/resman.h"
+#include "src/aurora/util.h"
+
+#include "src/graphics/graphics.h"
+#include "src/graphics/queueman.h"
+#include "src/graphics/yuv_to_rgb.h"
+
+#include "src/graphics/aurora/textureman.h"
+
+#include "src/benchmark/benchmark.h"
+#include "src/benchmark/resources.h"
+#include "src/benchmark/codecs.h"
+#include "src/benchmark/scene.h"
+#include "src/benchmark/corpus.h"
+
+static void displayUsage(const char *name) {
+	std::printf("xoreos-benchmark - Headless benchmarks for xoreos\n");
+	std::printf("Usage: %s [options] [path]\n\n", name);
+	std::printf("          --help              Display this text and exit.\n");
+	std::printf("          --path=PATH         Benchmark the game installed at PATH.\n");
+	std::printf("          --types=LIST        Benchmark these resource categories.\n");
+	std::printf("                              Default: \"all\".\n");
+	std::printf("          --archives=BOOL     Benchmark reading all archives. Default: true.\n");
+	std::printf("          --micro=BOOL        Run the codec and scene benchmarks on synthetic\n");
+	std::printf("                              data. Default: true.\n");
+	std::printf("          --workers=N         Use N worker threads for parallel reads.\n");
+	std::printf("                              Default: number of CPUs - 1, at most 8.\n");
+	std::printf("          --threads=N         Also read every archive from N threads at once,\n");
+	std::printf("                              comparing against a single-threaded read.\n");
+	std::printf("          --output=FILE       Write the results into FILE instead of stdout.\n");
+	std::printf("          --makecorpus=DIR    Write a synthetic game corpus into DIR first. If no\n");
+	std::printf("                              PATH is given, benchmark that corpus.\n");
+	std::printf("          --corpusscale=N     Multiply the size of the corpus by N. Default: 1.\n");
+	std::printf("          --corpusseed=N      Seed for the corpus contents.\n");
+	std::printf("\n");
+	std::printf("PATH: Absolute or relative path to a game directory or an archive.\n");
+	std::printf("DIR:  Absolute or relative path to a directory.\n");
+	std::printf("LIST: A comma-separated list of gff3, gff4, 2da, tlk, mdl, image, ncs and\n");
+	std::printf("      xmv, or \"all\".\n");
+	std::printf("FILE: Absolute or relative path to a file.\n");
+	std::printf("BOOL: \"true\", \"yes\", \"y\", \"on\" and \"1\" are true, everything else is false.\n");
+	std::printf("N:    A positive integer.\n");
+	std::printf("\n");
+	std::printf("Results are written as JSON, one benchmark per line.\n");
+	std::printf("\n");
+}
+
+/** Parse the command line into the config manager's command line domain. */
+static bool parseCommandline(int argc, char **argv, int &code) {
+	for (int i = 1; i < argc; i++) {
+		const char *arg = argv[i];
+
+		if (!std::strcmp(arg, "--help")) {
+			displayUsage(argv[0]);
+			code = 0;
+			return false;
+		}
+
+		if (!std::strncmp(arg, "--", 2)) {
+			const char *e = std::strchr(arg + 2, '=');
+			if (!e) {
+				warning("Option \"%s\" is missing a value", arg);
+				code = 1;
+				return false;
+			}
+
+			ConfigMan.setCommandlineKey(Common::UString(arg + 2, e - arg - 2), e + 1);
+			continue;
+		}
+
+		if (ConfigMan.hasKey("path")) {
+			warning("Unrecognized command line argument \"%s\"", arg);
+			code = 1;
+			return false;
+		}
+
+		ConfigMan.setCommandlineKey("path", arg);
+	}
+
+	return true;
+}
+
+/** Write the synthetic corpus, as configured on the command line. */
+static void makeCorpus(Benchmark::Reporter &reporter, const Common::UString &directory) {
+	Benchmark::CorpusOptions options;
+
+	if (ConfigMan.hasKey("corpusseed"))
+		options.seed = (uint32) ConfigMan.getInt("corpusseed");
+
+	const int scale = ConfigMan.getInt("corpusscale", 1);
+	if (scale > 1)
+		options.scale(scale);
+
+	Benchmark::Result result("corpus.generate");
+
+	Benchmark::Timer timer;
+	Benchmark::writeCorpus(directory, options);
+	result.seconds = timer.getSeconds();
+
+	result.count = options.bifCount + options.moduleCount + options.rimCount + options.overrideCount + 2;
+	result.addValue("scale", MAX(scale, 1));
+
+	reporter.report(result);
+}
+
+static void deinit() {
+	Common::WorkerPool::destroy();
+
+	Graphics::Aurora::TextureManager::destroy();
+	Graphics::YUVToRGBManager::destroy();
+	Graphics::GraphicsManager::destroy();
+	Graphics::QueueManager::destroy();
+
+	Aurora::ResourceManager::destroy();
+	Aurora::FileTypeManager::destroy();
+
+	Common::DebugManager::destroy();
+	Common::ConfigManager::destroy();
+}
+
+int main(int argc, char **argv) {
+	int code;
+	if (!parseCommandline(argc, argv, code)) {
+		deinit();
+		return code;
+	}
+
+	const Common::UString corpus = ConfigMan.getString("makecorpus");
+	if (!corpus.empty() && !ConfigMan.hasKey("path"))
+		ConfigMan.setCommandlineKey("path", corpus);
+
+	const Common::UString path = ConfigMan.getString("path");
+	const bool micro = ConfigMan.getBool("micro", true);
+
+	if (path.empty() && !micro) {
+		displayUsage(argv[0]);
+
+		deinit();
+		return 1;
+	}
+
+	if (ConfigMan.hasKey("workers"))
+		ConfigMan.setCommandlineKey("workerthreads", ConfigMan.getString("workers"));
+
+	code = 0;
+
+	try {
+		Common::initThreads();
+
+		Benchmark::Reporter reporter(ConfigMan.getString("output"));
+
+		if (!corpus.empty())
+			makeCorpus(reporter, corpus);
+
+		if (micro) {
+			Benchmark::benchmarkCodecs(reporter);
+			Benchmark::benchmarkScene(reporter);
+		}
+
+		if (!path.empty()) {
+			std::vector<Benchmark::ResourceCategory> categories;
+			Benchmark::parseResourceCategories(ConfigMan.getString("types", "all"), categories);
+
+			Benchmark::benchmarkResources(reporter, path, categories);
+
+			if (ConfigMan.getBool("archives", true))
+				Benchmark::benchmarkArchives(reporter, path);
+		}
+
+	} catch (Common::Exception &e) {
+		Common::printException(e);
+		code = 1;
+	}
+
+	deinit();
+	return code;
+}
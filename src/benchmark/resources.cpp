@@ -0,0 +1,970 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Benchmarks on the resources of an installed game.
+ */
+
+#include <cstring>
+#include <list>
+#include <map>
+
+#include "src/common/util.h"
+#include "src/common/error.h"
+#include "src/common/strutil.h"
+#include "src/common/configman.h"
+#include "src/common/mutex.h"
+#include "src/common/thread.h"
+#include "src/common/readstream.h"
+#include "src/common/memreadstream.h"
+#include "src/common/readfile.h"
+#include "src/common/filepath.h"
+#include "src/common/filelist.h"
+#include "src/common/encoding.h"
+#include "src/common/workerpool.h"
+
+#include "src/aurora/types.h"
+#include "src/aurora/util.h"
+#include "src/aurora/resman.h"
+#include "src/aurora/biffile.h"
+#include "src/aurora/bzffile.h"
+#include "src/aurora/erffile.h"
+#include "src/aurora/rimfile.h"
+#include "src/aurora/zipfile.h"
+#include "src/aurora/herffile.h"
+#include "src/aurora/ndsrom.h"
+#include "src/aurora/smallfile.h"
+#include "src/aurora/gff3file.h"
+#include "src/aurora/gff4file.h"
+#include "src/aurora/2dafile.h"
+#include "src/aurora/talktable.h"
+#include "src/aurora/nwscript/ncsfile.h"
+
+#include "src/graphics/images/tga.h"
+#include "src/graphics/images/dds.h"
+#include "src/graphics/images/tpc.h"
+#include "src/graphics/images/surface.h"
+
+#include "src/graphics/aurora/textureman.h"
+#include "src/graphics/aurora/model_nwn.h"
+
+#include "src/video/codecs/xmvwmv2.h"
+
+#include "src/benchmark/benchmark.h"
+#include "src/benchmark/resources.h"
+#include "src/benchmark/codecs.h"
+
+namespace Benchmark {
+
+static void parseGFF3(const byte *data, size_t size, Aurora::FileType UNUSED(type)) {
+	if (size < 4)
+		throw Common::Exception(Common::kReadError);
+
+	Aurora::GFF3File gff3(new Common::MemoryReadStream(data, size), READ_BE_UINT32(data));
+}
+
+static void parseGFF4(const byte *data, size_t size, Aurora::FileType UNUSED(type)) {
+	if (size < 16)
+		throw Common::Exception(Common::kReadError);
+
+	Aurora::GFF4File gff4(new Common::MemoryReadStream(data, size), READ_BE_UINT32(data + 12));
+}
+
+static void parse2DA(const byte *data, size_t size, Aurora::FileType UNUSED(type)) {
+	Common::MemoryReadStream stream(data, size);
+
+	Aurora::TwoDAFile twoDA(stream);
+}
+
+static void parseTLK(const byte *data, size_t size, Aurora::FileType UNUSED(type)) {
+	Aurora::TalkTable *tlk =
+		Aurora::TalkTable::load(new Common::MemoryReadStream(data, size), Common::kEncodingCP1252);
+
+	if (!tlk)
+		throw Common::Exception("Not a talk table");
+
+	delete tlk;
+}
+
+static void parseImage(const byte *data, size_t size, Aurora::FileType type) {
+	Common::MemoryReadStream stream(data, size);
+
+	if      (type == Aurora::kFileTypeTGA)
+		Graphics::TGA tga(stream);
+	else if (type == Aurora::kFileTypeDDS)
+		Graphics::DDS dds(stream);
+	else if (type == Aurora::kFileTypeTPC)
+		Graphics::TPC tpc(stream);
+}
+
+static void parseNCS(const byte *data, size_t size, Aurora::FileType UNUSED(type)) {
+	Aurora::NWScript::NCSFile ncs(new Common::MemoryReadStream(data, size));
+}
+
+/** Demux an XMV video and decode all its video frames, ignoring the audio.
+ *
+ *  This walks the packets the same way Video::XboxMediaVideo does, but
+ *  without a GL texture or a sound channel to feed, and without waiting
+ *  for the frame timestamps.
+ */
+static void parseXMV(const byte *data, size_t size, Aurora::FileType UNUSED(type)) {
+	Common::MemoryReadStream xmv(data, size);
+
+	xmv.skip(4); // Next packet size
+	const uint32 thisPacketSize = xmv.readUint32LE();
+	xmv.skip(4); // Max packet size
+
+	const uint32 tag = xmv.readUint32LE();
+	if (tag != MKTAG('X', 'b', 'o', 'x'))
+		throw Common::Exception("No 'Xbox' tag (%s)", Common::debugTag(tag).c_str());
+
+	const uint32 version = xmv.readUint32LE();
+	if ((version == 0) || (version > 4))
+		throw Common::Exception("Unsupported XMV version %u", (uint) version);
+
+	const uint32 width  = xmv.readUint32LE();
+	const uint32 height = xmv.readUint32LE();
+
+	xmv.skip(4); // Duration in ms
+
+	const uint32 audioTrackCount = xmv.readUint16LE();
+
+	xmv.skip(2);                      // Unknown
+	xmv.skip(audioTrackCount * 12);   // Audio track headers
+
+	Graphics::Surface surface(NEXTPOWER2(width), NEXTPOWER2(height));
+	Video::XMVWMV2Codec *codec = 0;
+
+	size_t packetOffset = xmv.pos();
+	size_t packetSize   = thisPacketSize - packetOffset;
+
+	try {
+		while ((packetSize >= (12 + audioTrackCount * 4)) && ((packetOffset + packetSize) <= size)) {
+			xmv.seek(packetOffset);
+
+			const uint32 nextPacketSize = xmv.readUint32LE();
+
+			byte videoHeader[8];
+			if (xmv.read(videoHeader, 8) != 8)
+				throw Common::Exception(Common::kReadError);
+
+			uint32 dataSize   =  READ_LE_UINT32(videoHeader) & 0x007FFFFF;
+			uint32 frameCount = (READ_LE_UINT32(videoHeader) >> 23) & 0xFF;
+
+			const bool hasExtraData = (videoHeader[3] & 0x80) != 0;
+
+			// See XboxMediaVideo::processPacketHeader() for why the audio headers are taken from the video size
+			dataSize -= audioTrackCount * 4;
+			xmv.skip(audioTrackCount * 4);
+
+			size_t dataOffset = xmv.pos();
+
+			if (hasExtraData && (dataSize >= 4)) {
+				Common::SeekableSubReadStream extraData(&xmv, dataOffset, dataOffset + 4);
+
+				delete codec;
+				codec = 0;
+
+				codec = new Video::XMVWMV2Codec(width, height, extraData);
+
+				dataSize   -= 4;
+				dataOffset += 4;
+			}
+
+			for (; frameCount > 0; frameCount--) {
+				xmv.seek(dataOffset);
+
+				const uint32 frameSize = (xmv.readUint32LE() & 0x1FFFF) * 4 + 4;
+				if (frameSize > dataSize)
+					throw Common::Exception("Frame data overrun");
+
+				if (!codec)
+					throw Common::Exception("Video frame without a decoder");
+
+				Common::SeekableSubReadStream frameData(&xmv, xmv.pos(), xmv.pos() + frameSize);
+				codec->decodeFrame(surface, frameData);
+
+				dataSize   -= frameSize + 4;
+				dataOffset += frameSize + 4;
+			}
+
+			packetOffset += packetSize;
+			packetSize    = nextPacketSize;
+		}
+	} catch (...) {
+		delete codec;
+		throw;
+	}
+
+	delete codec;
+}
+
+typedef void (*ParseFunction)(const byte *data, size_t size, Aurora::FileType type);
+
+static const Aurora::FileType kTypesGFF3[] = {
+	Aurora::kFileTypeARE, Aurora::kFileTypeGIT, Aurora::kFileTypeIFO, Aurora::kFileTypeBIC,
+	Aurora::kFileTypeUTC, Aurora::kFileTypeUTD, Aurora::kFileTypeUTE, Aurora::kFileTypeUTI,
+	Aurora::kFileTypeUTM, Aurora::kFileTypeUTP, Aurora::kFileTypeUTS, Aurora::kFileTypeUTT,
+	Aurora::kFileTypeUTW, Aurora::kFileTypeDLG, Aurora::kFileTypeJRL, Aurora::kFileTypeFAC,
+	Aurora::kFileTypeGIC, Aurora::kFileTypeGUI, Aurora::kFileTypeITP, Aurora::kFileTypePTM,
+	Aurora::kFileTypePTT
+};
+
+static const Aurora::FileType kTypesGFF4[] = {
+	Aurora::kFileTypeGDA, Aurora::kFileTypeMMH, Aurora::kFileTypeMSH
+};
+
+static const Aurora::FileType kTypes2DA  [] = { Aurora::kFileType2DA };
+static const Aurora::FileType kTypesTLK  [] = { Aurora::kFileTypeTLK };
+static const Aurora::FileType kTypesMDL  [] = { Aurora::kFileTypeMDL };
+static const Aurora::FileType kTypesNCS  [] = { Aurora::kFileTypeNCS };
+static const Aurora::FileType kTypesXMV  [] = { Aurora::kFileTypeXMV };
+static const Aurora::FileType kTypesImage[] = {
+	Aurora::kFileTypeTGA, Aurora::kFileTypeDDS, Aurora::kFileTypeTPC
+};
+
+/** Everything we know about a resource category. */
+struct CategoryInfo {
+	const char *name;
+
+	const Aurora::FileType *types;
+	size_t typeCount;
+
+	/** Parse a resource of this category, or 0 if it can't be parsed headless. */
+	ParseFunction parse;
+};
+
+static const CategoryInfo kCategories[kCategoryMAX] = {
+	{ "gff3" , kTypesGFF3 , ARRAYSIZE(kTypesGFF3) , &parseGFF3  },
+	{ "gff4" , kTypesGFF4 , ARRAYSIZE(kTypesGFF4) , &parseGFF4  },
+	{ "2da"  , kTypes2DA  , ARRAYSIZE(kTypes2DA)  , &parse2DA   },
+	{ "tlk"  , kTypesTLK  , ARRAYSIZE(kTypesTLK)  , &parseTLK   },
+	{ "mdl"  , kTypesMDL  , ARRAYSIZE(kTypesMDL)  , 0           },
+	{ "image", kTypesImage, ARRAYSIZE(kTypesImage), &parseImage },
+	{ "ncs"  , kTypesNCS  , ARRAYSIZE(kTypesNCS)  , &parseNCS   },
+	{ "xmv"  , kTypesXMV  , ARRAYSIZE(kTypesXMV)  , &parseXMV   }
+};
+
+void parseResourceCategories(const Common::UString &list, std::vector<ResourceCategory> &categories) {
+	categories.clear();
+
+	std::vector<Common::UString> names;
+	Common::UString::split(list, ',', names);
+
+	for (std::vector<Common::UString>::iterator n = names.begin(); n != names.end(); ++n) {
+		n->trim();
+
+		if (n->equalsIgnoreCase("all")) {
+			categories.clear();
+			for (size_t i = 0; i < kCategoryMAX; i++)
+				categories.push_back((ResourceCategory) i);
+
+			return;
+		}
+
+		size_t i;
+		for (i = 0; i < kCategoryMAX; i++)
+			if (n->equalsIgnoreCase(kCategories[i].name))
+				break;
+
+		if (i == kCategoryMAX)
+			throw Common::Exception("Unknown resource category \"%s\"", n->c_str());
+
+		categories.push_back((ResourceCategory) i);
+	}
+}
+
+/** Is a file of this type an archive the ResourceManager can index? */
+static bool isIndexableArchive(Aurora::FileType type) {
+	switch (type) {
+		case Aurora::kFileTypeERF:
+		case Aurora::kFileTypeMOD:
+		case Aurora::kFileTypeHAK:
+		case Aurora::kFileTypeNWM:
+		case Aurora::kFileTypeRIM:
+		case Aurora::kFileTypeRIMP:
+		case Aurora::kFileTypeZIP:
+		case Aurora::kFileTypeNDS:
+		case Aurora::kFileTypeHERF:
+			return true;
+
+		default:
+			break;
+	}
+
+	return false;
+}
+
+/** Add all resources of the game at this path to the ResourceManager. */
+static void indexGame(Reporter &reporter, const Common::UString &path) {
+	Result result("resources.index");
+
+	HeapCounter heap;
+	Timer timer;
+
+	const Common::UString base = Common::FilePath::canonicalize(path);
+
+	if (Common::FilePath::isRegularFile(base)) {
+		// A single archive, like a Nintendo DS ROM
+		if (TypeMan.getFileType(base) == Aurora::kFileTypeNDS)
+			ResMan.setHasSmall(true);
+
+		ResMan.registerDataBase(base);
+		result.count = 1;
+
+		result.seconds = timer.getSeconds();
+		reporter.report(result);
+		return;
+	}
+
+	ResMan.registerDataBase(base);
+
+	// Make every file in every subdirectory known, so that all archives can be found
+	ResMan.indexResourceDir("", 0, -1, 1);
+
+	// Index KEYs first, the other archives after, overriding them
+
+	Common::FileList files;
+	files.addDirectory(base, -1);
+
+	std::vector<Common::UString> keys, archives;
+	for (Common::FileList::const_iterator f = files.begin(); f != files.end(); ++f) {
+		const Aurora::FileType type = TypeMan.getFileType(*f);
+
+		if      (type == Aurora::kFileTypeKEY)
+			keys.push_back(Common::FilePath::relativize(base, *f));
+		else if (isIndexableArchive(type))
+			archives.push_back(Common::FilePath::relativize(base, *f));
+	}
+
+	keys.insert(keys.end(), archives.begin(), archives.end());
+
+	for (size_t i = 0; i < keys.size(); i++) {
+		try {
+			ResMan.indexArchive(keys[i], 10 + i);
+			result.count++;
+		} catch (Common::Exception &e) {
+			e.add("Failed indexing archive \"%s\"", keys[i].c_str());
+			Common::printException(e, "WARNING: ");
+
+			result.failed++;
+		}
+	}
+
+	result.seconds = timer.getSeconds();
+
+	result.addValue("allocations", heap.getAllocations());
+	result.addValue("heapbytes"  , heap.getBytes());
+
+	reporter.report(result);
+}
+
+/** Read and parse all resources of one category. */
+static void benchmarkCategory(Reporter &reporter, const CategoryInfo &category) {
+	const std::vector<Aurora::FileType> types(category.types, category.types + category.typeCount);
+
+	std::list<Aurora::ResourceManager::ResourceID> resources;
+	ResMan.getAvailableResources(types, resources);
+
+	Result read (Common::UString("resources.") + category.name + ".read");
+	Result parse(Common::UString("resources.") + category.name + ".parse");
+
+	std::vector<byte> data;
+
+	for (std::list<Aurora::ResourceManager::ResourceID>::const_iterator r = resources.begin();
+	     r != resources.end(); ++r) {
+
+		// Read the whole resource into memory
+
+		Timer timer;
+
+		size_t size = 0;
+		try {
+			Common::SeekableReadStream *stream = ResMan.getResource(r->hash);
+			if (!stream)
+				throw Common::Exception("Resource vanished");
+
+			size = stream->size();
+			data.resize(size + 1);
+
+			const size_t bytesRead = stream->read(&data[0], size);
+			delete stream;
+
+			if (bytesRead != size)
+				throw Common::Exception(Common::kReadError);
+
+		} catch (Common::Exception &e) {
+			read.seconds += timer.getSeconds();
+			read.failed++;
+
+			e.add("Failed reading \"%s\"", TypeMan.setFileType(r->name, r->type).c_str());
+			Common::printException(e, "WARNING: ");
+			continue;
+		}
+
+		read.seconds += timer.getSeconds();
+		read.count++;
+		read.bytes += size;
+
+		if (!category.parse)
+			continue;
+
+		// Parse it out of memory
+
+		timer.start();
+
+		try {
+			category.parse(&data[0], size, r->type);
+		} catch (Common::Exception &e) {
+			parse.seconds += timer.getSeconds();
+			parse.failed++;
+
+			e.add("Failed parsing \"%s\"", TypeMan.setFileType(r->name, r->type).c_str());
+			Common::printException(e, "WARNING: ");
+			continue;
+		}
+
+		parse.seconds += timer.getSeconds();
+		parse.count++;
+		parse.bytes += size;
+	}
+
+	reporter.report(read);
+	if (category.parse)
+		reporter.report(parse);
+}
+
+typedef std::map<Common::UString, Graphics::Aurora::Model *, Common::UString::iless> ModelCache;
+
+/** A model we can load through Model_NWN. */
+struct ModelInfo {
+	Common::UString name;
+	uint64 size;
+};
+
+static void clearModelCache(ModelCache &modelCache) {
+	for (ModelCache::iterator m = modelCache.begin(); m != modelCache.end(); ++m)
+		delete m->second;
+
+	modelCache.clear();
+}
+
+/** Load models the way the NWN model loader does, sharing their supermodels. */
+static void loadModels(const std::vector<ModelInfo> &models, Result *result) {
+	ModelCache modelCache;
+
+	Timer timer;
+
+	for (std::vector<ModelInfo>::const_iterator m = models.begin(); m != models.end(); ++m) {
+		try {
+			delete new Graphics::Aurora::Model_NWN(m->name, Graphics::Aurora::kModelTypeObject, "", &modelCache);
+
+			if (result) {
+				result->count++;
+				result->bytes += m->size;
+			}
+
+		} catch (Common::Exception &e) {
+			if (!result)
+				continue;
+
+			result->failed++;
+
+			e.add("Failed loading model \"%s\"", m->name.c_str());
+			Common::printException(e, "WARNING: ");
+		}
+	}
+
+	if (result)
+		result->seconds += timer.getSeconds();
+
+	clearModelCache(modelCache);
+}
+
+/** Load all NWN models: binary ones once, and ASCII ones with and without the model cache.
+ *
+ *  Models are loaded completely, including their meshes and textures, but
+ *  nothing is uploaded to the GPU, since nothing ever renders them. A first,
+ *  untimed pass loads all textures and fills the model cache, so that the
+ *  timed passes only measure how the models themselves are parsed.
+ */
+static void benchmarkModels(Reporter &reporter) {
+	std::list<Aurora::ResourceManager::ResourceID> resources;
+	ResMan.getAvailableResources(Aurora::kFileTypeMDL, resources);
+
+	std::vector<ModelInfo> binaryModels;
+	std::vector<ModelInfo> asciiModels;
+
+	for (std::list<Aurora::ResourceManager::ResourceID>::const_iterator r = resources.begin();
+	     r != resources.end(); ++r) {
+
+		// KotOR and Jade Empire models come with an MDX, and aren't NWN models
+		if (ResMan.hasResource(r->name, Aurora::kFileTypeMDX))
+			continue;
+
+		Common::SeekableReadStream *mdl = ResMan.getResource(r->hash);
+		if (!mdl)
+			continue;
+
+		ModelInfo model;
+		model.name = r->name;
+		model.size = mdl->size();
+
+		const bool isASCII = (model.size >= 4) && (mdl->readUint32LE() != 0);
+
+		delete mdl;
+
+		if (isASCII)
+			asciiModels.push_back(model);
+		else
+			binaryModels.push_back(model);
+	}
+
+	if (binaryModels.empty() && asciiModels.empty())
+		return;
+
+	const bool useCache = ConfigMan.getBool("mdlcache", true);
+
+	loadModels(binaryModels, 0);
+	loadModels(asciiModels , 0);
+
+	Result binary("resources.mdl.parse");
+	Result ascii ("resources.mdl.ascii");
+	Result cached("resources.mdl.cached");
+
+	loadModels(binaryModels, &binary);
+
+	if (!asciiModels.empty()) {
+		ConfigMan.setCommandlineKey("mdlcache", "false");
+		loadModels(asciiModels, &ascii);
+
+		if (useCache) {
+			ConfigMan.setCommandlineKey("mdlcache", "true");
+			loadModels(asciiModels, &cached);
+
+			if (cached.seconds > 0.0)
+				cached.addValue("speedup", ascii.seconds / cached.seconds);
+		}
+
+		ConfigMan.setCommandlineKey("mdlcache", useCache ? "true" : "false");
+	}
+
+	TextureMan.clear();
+
+	if (!binaryModels.empty())
+		reporter.report(binary);
+
+	if (!asciiModels.empty()) {
+		reporter.report(ascii);
+		if (useCache)
+			reporter.report(cached);
+	}
+}
+
+void benchmarkResources(Reporter &reporter, const Common::UString &path,
+                        const std::vector<ResourceCategory> &categories) {
+
+	indexGame(reporter, path);
+
+	for (std::vector<ResourceCategory>::const_iterator c = categories.begin(); c != categories.end(); ++c) {
+		benchmarkCategory(reporter, kCategories[*c]);
+
+		if (*c == kCategoryMDL)
+			benchmarkModels(reporter);
+	}
+
+	ResMan.clear();
+}
+
+
+/** Take a checksum of a stream's remaining contents. */
+static uint64 checksumStream(Common::SeekableReadStream &stream, uint64 &size) {
+	byte buffer[4096];
+
+	// 64-bit FNV-1a
+	uint64 hash = 0xCBF29CE484222325ULL;
+
+	size_t n;
+	while ((n = stream.read(buffer, sizeof(buffer))) > 0) {
+		for (size_t i = 0; i < n; i++)
+			hash = (hash ^ buffer[i]) * 0x100000001B3ULL;
+
+		size += n;
+	}
+
+	return hash;
+}
+
+/** Open an archive file, if it's of a type we can open. */
+static Aurora::Archive *openArchive(const Common::UString &path, Common::UString &typeName) {
+	const Aurora::FileType type = TypeMan.getFileType(path);
+
+	switch (type) {
+		case Aurora::kFileTypeERF:
+		case Aurora::kFileTypeMOD:
+		case Aurora::kFileTypeHAK:
+		case Aurora::kFileTypeNWM:
+			typeName = "erf";
+			return new Aurora::ERFFile(new Common::ReadFile(path));
+
+		case Aurora::kFileTypeRIM:
+		case Aurora::kFileTypeRIMP:
+			typeName = "rim";
+			return new Aurora::RIMFile(new Common::ReadFile(path));
+
+		case Aurora::kFileTypeBIF:
+			typeName = "bif";
+			return new Aurora::BIFFile(new Common::ReadFile(path));
+
+		case Aurora::kFileTypeBZF:
+			typeName = "bzf";
+			return new Aurora::BZFFile(new Common::ReadFile(path));
+
+		case Aurora::kFileTypeZIP:
+			typeName = "zip";
+			return new Aurora::ZIPFile(new Common::ReadFile(path));
+
+		case Aurora::kFileTypeHERF:
+			typeName = "herf";
+			return new Aurora::HERFFile(new Common::ReadFile(path));
+
+		case Aurora::kFileTypeNDS:
+			typeName = "nds";
+			return new Aurora::NDSFile(new Common::ReadFile(path));
+
+		default:
+			break;
+	}
+
+	return 0;
+}
+
+/** Results of reading archives of one type. */
+struct ArchiveResults {
+	Result serial;
+	Result parallel;
+	Result threads;
+
+	ArchiveResults(const Common::UString &typeName) :
+		serial  ("archives." + typeName + ".serial"),
+		parallel("archives." + typeName + ".parallel"),
+		threads ("archives." + typeName + ".threads") {
+	}
+};
+
+/** A thread reading every resource of an archive, and comparing them against known checksums. */
+class ArchiveReader : public Common::Thread {
+public:
+	uint64 count;
+	uint64 failed;
+	uint64 bytes;
+
+	ArchiveReader(const Aurora::Archive &archive, const std::vector<uint32> &indices,
+	              const std::vector<uint64> &checksums, size_t start, Common::Semaphore &done) :
+		count(0), failed(0), bytes(0), _archive(&archive), _indices(&indices),
+		_checksums(&checksums), _start(start), _done(&done) {
+	}
+
+	~ArchiveReader() {
+		destroyThread();
+	}
+
+private:
+	const Aurora::Archive *_archive;
+
+	const std::vector<uint32> *_indices;
+	const std::vector<uint64> *_checksums;
+
+	size_t _start; ///< The resource to start with.
+
+	Common::Semaphore *_done;
+
+	void threadMethod() {
+		const size_t resourceCount = _indices->size();
+
+		for (size_t n = 0; n < resourceCount; n++) {
+			const size_t i = (_start + n) % resourceCount;
+
+			Common::SeekableReadStream *stream = 0;
+			try {
+				stream = _archive->getResource((*_indices)[i]);
+
+				if (checksumStream(*stream, bytes) == (*_checksums)[i])
+					count++;
+				else
+					failed++;
+
+			} catch (...) {
+				failed++;
+			}
+
+			delete stream;
+		}
+
+		_done->unlock();
+	}
+};
+
+/** Read all resources of an archive from several threads at once, and compare them against the serial read. */
+static void benchmarkArchiveThreads(const Aurora::Archive &archive, const std::vector<uint32> &indices,
+                                    const std::vector<uint64> &checksums, size_t threadCount, Result &result) {
+
+	if (indices.empty())
+		return;
+
+	Common::Semaphore done;
+
+	// Every thread starts at a different resource, so that they don't all read the same data in lockstep
+	std::vector<ArchiveReader *> readers;
+	for (size_t i = 0; i < threadCount; i++)
+		readers.push_back(new ArchiveReader(archive, indices, checksums, (i * indices.size()) / threadCount, done));
+
+	Timer timer;
+
+	size_t started = 0;
+	for (size_t i = 0; i < readers.size(); i++)
+		if (readers[i]->createThread())
+			started++;
+
+	for (size_t i = 0; i < started; i++)
+		done.lock();
+
+	result.seconds += timer.getSeconds();
+
+	for (size_t i = 0; i < readers.size(); i++) {
+		result.count  += readers[i]->count;
+		result.failed += readers[i]->failed;
+		result.bytes  += readers[i]->bytes;
+
+		delete readers[i];
+	}
+
+	if (started < threadCount)
+		throw Common::Exception("Failed to start %u of %u reader threads",
+		                        (uint) (threadCount - started), (uint) threadCount);
+}
+
+/** Read all resources of an archive, one by one, as a batch and optionally from several threads, and compare. */
+static void benchmarkArchive(const Aurora::Archive &archive, ArchiveResults &results, size_t threadCount) {
+	const Aurora::Archive::ResourceList &resources = archive.getResources();
+
+	std::vector<uint32> indices;
+	indices.reserve(resources.size());
+
+	for (Aurora::Archive::ResourceList::const_iterator r = resources.begin(); r != resources.end(); ++r)
+		indices.push_back(r->index);
+
+	// One by one
+
+	std::vector<uint64> checksums(indices.size(), 0);
+	std::vector<bool>   valid(indices.size(), false);
+
+	Timer timer;
+
+	for (size_t i = 0; i < indices.size(); i++) {
+		try {
+			Common::SeekableReadStream *stream = archive.getResource(indices[i]);
+
+			checksums[i] = checksumStream(*stream, results.serial.bytes);
+			valid[i]     = true;
+
+			delete stream;
+
+			results.serial.count++;
+
+		} catch (...) {
+			results.serial.failed++;
+		}
+	}
+
+	results.serial.seconds += timer.getSeconds();
+
+	// As a batch. A batch fails as a whole, so only take the resources we could read before
+
+	std::vector<uint32> validIndices;
+	std::vector<uint64> validChecksums;
+	for (size_t i = 0; i < indices.size(); i++) {
+		if (valid[i]) {
+			validIndices.push_back(indices[i]);
+			validChecksums.push_back(checksums[i]);
+		}
+	}
+
+	if (threadCount > 0)
+		benchmarkArchiveThreads(archive, validIndices, validChecksums, threadCount, results.threads);
+
+	timer.start();
+
+	std::vector<Common::SeekableReadStream *> streams;
+	try {
+		archive.getResources(validIndices, streams);
+	} catch (...) {
+		results.parallel.seconds += timer.getSeconds();
+		results.parallel.failed += validIndices.size();
+		return;
+	}
+
+	for (size_t i = 0; i < streams.size(); i++) {
+		uint64 checksum = 0;
+		try {
+			checksum = checksumStream(*streams[i], results.parallel.bytes);
+		} catch (...) {
+		}
+
+		delete streams[i];
+
+		if (checksum == validChecksums[i])
+			results.parallel.count++;
+		else
+			results.parallel.failed++;
+	}
+
+	results.parallel.seconds += timer.getSeconds();
+}
+
+/** Decompress all "small" files in a Nintendo DS ROM, with the current and with the reference decoder. */
+static void benchmarkSmall(const Aurora::Archive &archive, Result &current, Result &reference) {
+	const Aurora::Archive::ResourceList &resources = archive.getResources();
+
+	for (Aurora::Archive::ResourceList::const_iterator r = resources.begin(); r != resources.end(); ++r) {
+		if (r->type != Aurora::kFileTypeSMALL)
+			continue;
+
+		std::vector<byte> small(archive.getResourceSize(r->index));
+		if (small.empty())
+			continue;
+
+		Common::SeekableReadStream *stream = archive.getResource(r->index);
+		const size_t smallSize = stream->read(&small[0], small.size());
+		delete stream;
+
+		try {
+			Timer timer;
+
+			std::vector<byte> out(Aurora::Small::getDecompressedSize(&small[0], smallSize));
+			if (!out.empty())
+				Aurora::Small::decompress(&small[0], smallSize, &out[0], out.size());
+
+			current.seconds += timer.getSeconds();
+			current.count++;
+			current.bytes += out.size();
+
+			timer.start();
+
+			std::vector<byte> referenceOut;
+			decompressSmallReference(&small[0], smallSize, referenceOut);
+
+			reference.seconds += timer.getSeconds();
+			reference.count++;
+			reference.bytes += referenceOut.size();
+
+			if (out != referenceOut)
+				current.failed++;
+
+		} catch (...) {
+			current.failed++;
+		}
+	}
+}
+
+void benchmarkArchives(Reporter &reporter, const Common::UString &path) {
+	const Common::UString base = Common::FilePath::canonicalize(path);
+
+	std::list<Common::UString> files;
+	if (Common::FilePath::isRegularFile(base)) {
+		files.push_back(base);
+	} else {
+		Common::FileList fileList;
+		fileList.addDirectory(base, -1);
+
+		files.assign(fileList.begin(), fileList.end());
+	}
+
+	const size_t threadCount = MAX(ConfigMan.getInt("threads", 0), 0);
+
+	std::map<Common::UString, ArchiveResults *> results;
+
+	Result smallCurrent  ("archives.small.decompress");
+	Result smallReference("archives.small.decompress_reference");
+
+	for (std::list<Common::UString>::const_iterator f = files.begin(); f != files.end(); ++f) {
+		Common::UString typeName;
+		Aurora::Archive *archive = 0;
+
+		try {
+			archive = openArchive(*f, typeName);
+		} catch (Common::Exception &e) {
+			e.add("Failed opening archive \"%s\"", f->c_str());
+			Common::printException(e, "WARNING: ");
+			continue;
+		}
+
+		if (!archive)
+			continue;
+
+		std::map<Common::UString, ArchiveResults *>::iterator r = results.find(typeName);
+		if (r == results.end())
+			r = results.insert(std::make_pair(typeName, new ArchiveResults(typeName))).first;
+
+		try {
+			benchmarkArchive(*archive, *r->second, threadCount);
+		} catch (Common::Exception &e) {
+			e.add("Failed benchmarking archive \"%s\"", f->c_str());
+			Common::printException(e, "WARNING: ");
+		}
+
+		if (typeName == "nds")
+			benchmarkSmall(*archive, smallCurrent, smallReference);
+
+		delete archive;
+	}
+
+	for (std::map<Common::UString, ArchiveResults *>::iterator r = results.begin(); r != results.end(); ++r) {
+		Result &serial   = r->second->serial;
+		Result &parallel = r->second->parallel;
+
+		parallel.addValue("workers", WorkerPoolMan.getWorkerCount());
+		if (parallel.seconds > 0.0)
+			parallel.addValue("speedup", serial.seconds / parallel.seconds);
+
+		reporter.report(serial);
+		reporter.report(parallel);
+
+		if (threadCount > 0) {
+			Result &threads = r->second->threads;
+
+			threads.addValue("threads", threadCount);
+
+			reporter.report(threads);
+		}
+
+		delete r->second;
+	}
+
+	if (smallCurrent.count > 0) {
+		if (smallCurrent.seconds > 0.0)
+			smallCurrent.addValue("speedup", smallReference.seconds / smallCurrent.seconds);
+
+		reporter.report(smallCurrent);
+		reporter.report(smallReference);
+	}
+}
+
+} // End of namespace Benchmark
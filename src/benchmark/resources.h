@@ -0,0 +1,85 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Benchmarks on the resources of an installed game.
+ */
+
+#ifndef BENCHMARK_RESOURCES_H
+#define BENCHMARK_RESOURCES_H
+
+#include <vector>
+
+#include "src/common/ustring.h"
+
+namespace Benchmark {
+
+class Reporter;
+
+/** The kinds of resources that can be benchmarked. */
+enum ResourceCategory {
+	kCategoryGFF3  = 0, ///< Version 3 GFFs: areas, blueprints, dialogs, ...
+	kCategoryGFF4,      ///< Version 4 GFFs: GDA tables, Dragon Age meshes, ...
+	kCategory2DA,       ///< 2DA tables.
+	kCategoryTLK,       ///< Talk tables.
+	kCategoryMDL,       ///< Models. NWN models are also loaded, ASCII ones with and without the model cache.
+	kCategoryImage,     ///< TGA, DDS and TPC images.
+	kCategoryNCS,       ///< NWScript bytecode.
+	kCategoryXMV,       ///< Xbox videos. Parsing decodes every video frame.
+	kCategoryMAX
+};
+
+/** Parse a comma-separated list of resource categories, like "gff3,2da,tlk".
+ *
+ *  "all" selects every category. Throws on unknown names.
+ */
+void parseResourceCategories(const Common::UString &list, std::vector<ResourceCategory> &categories);
+
+/** Index the game at this path and benchmark reading and parsing its resources.
+ *
+ *  First, all archives found in the game directory are indexed, and the time
+ *  that takes is reported. Then, for each category, all resources are read
+ *  completely, and then parsed out of memory, reporting the time taken for
+ *  reading and for parsing separately.
+ *
+ *  NWN models are additionally loaded completely, like the game does but
+ *  without uploading anything to the GPU. Binary models are loaded once,
+ *  ASCII models once without and once with the binary model cache, unless
+ *  "mdlcache" is disabled.
+ */
+void benchmarkResources(Reporter &reporter, const Common::UString &path,
+                        const std::vector<ResourceCategory> &categories);
+
+/** Benchmark reading every resource out of every archive found at this path.
+ *
+ *  Each archive is read once resource by resource, and once as a batch spread
+ *  over the worker pool. Both times, a checksum of every resource is taken,
+ *  and resources whose checksums differ count as failed. If the "threads"
+ *  option is set to N, the archive is additionally read completely by N
+ *  threads at the same time, each resource checked against its first read.
+ *  "small" files found in Nintendo DS ROMs are additionally decompressed with
+ *  the current decoder and with a plain byte-by-byte reference decoder, for
+ *  comparison.
+ */
+void benchmarkArchives(Reporter &reporter, const Common::UString &path);
+
+} // End of namespace Benchmark
+
+#endif // BENCHMARK_RESOURCES_H
@@ -0,0 +1,731 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Benchmarks on synthetic scenes for the CPU-side scene code.
+ */
+
+#include <cmath>
+#include <list>
+#include <vector>
+#include <algorithm>
+
+#include "src/common/util.h"
+#include "src/common/maths.h"
+#include "src/common/transmatrix.h"
+#include "src/common/boundingbox.h"
+#include "src/common/aabbtree.h"
+
+#include "src/graphics/vertexbuffer.h"
+
+#include "src/graphics/aurora/keyframetrack.h"
+
+#include "src/benchmark/benchmark.h"
+#include "src/benchmark/scene.h"
+
+namespace Benchmark {
+
+// --- Transformation matrices ---
+
+/** Create a random transformation, like a model node would have. */
+static Common::TransformationMatrix randomTransformation(Random &random) {
+	Common::TransformationMatrix m;
+
+	m.translate(random.nextFloat(-100.0f, 100.0f), random.nextFloat(-100.0f, 100.0f), random.nextFloat(-10.0f, 10.0f));
+	m.rotate(random.nextFloat(0.0f, 360.0f), random.nextFloat(-1.0f, 1.0f), random.nextFloat(-1.0f, 1.0f), 1.0f);
+	m.scale(random.nextFloat(0.5f, 2.0f), random.nextFloat(0.5f, 2.0f), random.nextFloat(0.5f, 2.0f));
+
+	return m;
+}
+
+static void benchmarkMatrices(Reporter &reporter, Random &random) {
+	static const size_t kMatrixCount = 4096;
+	static const size_t kRuns        = 256;
+
+	std::vector<Common::TransformationMatrix> matrices;
+	matrices.reserve(kMatrixCount);
+
+	for (size_t i = 0; i < kMatrixCount; i++)
+		matrices.push_back(randomTransformation(random));
+
+	Result multiply("scene.matrix.multiply");
+	Result inverse ("scene.matrix.inverse");
+
+	// Concatenate parent and child transformations, like walking a node hierarchy
+
+	float sink = 0.0f;
+
+	{
+		Timer timer;
+
+		Common::TransformationMatrix result;
+		for (size_t r = 0; r < kRuns; r++) {
+			for (size_t i = 1; i < kMatrixCount; i++) {
+				result.transform(matrices[i - 1], matrices[i]);
+				sink += result[12];
+			}
+		}
+
+		multiply.seconds = timer.getSeconds();
+		multiply.count   = kRuns * (kMatrixCount - 1);
+	}
+
+	// Invert, and check that the inverse actually is one
+
+	std::vector<Common::TransformationMatrix> inverses(kMatrixCount);
+
+	{
+		Timer timer;
+
+		for (size_t r = 0; r < (kRuns / 16); r++)
+			for (size_t i = 0; i < kMatrixCount; i++)
+				inverses[i] = matrices[i].getInverse();
+
+		inverse.seconds = timer.getSeconds();
+		inverse.count   = (kRuns / 16) * kMatrixCount;
+	}
+
+	for (size_t i = 0; i < kMatrixCount; i++) {
+		const Common::TransformationMatrix identity = matrices[i] * inverses[i];
+
+		for (int e = 0; e < 16; e++) {
+			const float expected = ((e % 5) == 0) ? 1.0f : 0.0f;
+
+			if (!(ABS(identity[e] - expected) <= 1.0e-3f)) {
+				inverse.failed++;
+				break;
+			}
+		}
+	}
+
+	multiply.addValue("checksum", sink);
+
+	reporter.report(multiply);
+	reporter.report(inverse);
+}
+
+
+// --- Node transforms ---
+
+/** A node in a synthetic model, with the transformation data of a Graphics::Aurora::ModelNode. */
+struct SceneNode {
+	float position[3];
+	float orientation[4];
+	float scale[3];
+	float rotation[3];
+
+	Common::BoundingBox boundBox;
+
+	Common::TransformationMatrix absolutePosition;
+	Common::BoundingBox absoluteBoundBox;
+
+	std::list<SceneNode *> children;
+
+	void place(Random &random) {
+		for (int i = 0; i < 3; i++) {
+			position[i] = random.nextFloat(-1.0f, 1.0f);
+			scale   [i] = random.nextFloat(0.9f, 1.1f);
+			rotation[i] = 0.0f;
+		}
+
+		orientation[0] = random.nextFloat(-1.0f, 1.0f);
+		orientation[1] = random.nextFloat(-1.0f, 1.0f);
+		orientation[2] = 1.0f;
+		orientation[3] = random.nextFloat(0.0f, 360.0f);
+
+		boundBox.clear();
+		for (int i = 0; i < 8; i++)
+			boundBox.add(random.nextFloat(-0.5f, 0.5f), random.nextFloat(-0.5f, 0.5f), random.nextFloat(-0.5f, 0.5f));
+	}
+
+	/** Like ModelNode::applyTransformation(). */
+	void applyTransformation(Common::TransformationMatrix &matrix) const {
+		matrix.translate(position[0], position[1], position[2]);
+		matrix.rotate(orientation[3], orientation[0], orientation[1], orientation[2]);
+		matrix.scale(scale[0], scale[1], scale[2]);
+
+		matrix.rotate(rotation[0], 1.0f, 0.0f, 0.0f);
+		matrix.rotate(rotation[1], 0.0f, 1.0f, 0.0f);
+		matrix.rotate(rotation[2], 0.0f, 0.0f, 1.0f);
+	}
+
+	/** The recursive walk the model nodes used to do for their bounding boxes. */
+	void createAbsoluteBound(Common::BoundingBox parentPosition) {
+		parentPosition.translate(position[0], position[1], position[2]);
+		parentPosition.rotate(orientation[3], orientation[0], orientation[1], orientation[2]);
+		parentPosition.scale(scale[0], scale[1], scale[2]);
+
+		parentPosition.rotate(rotation[0], 1.0f, 0.0f, 0.0f);
+		parentPosition.rotate(rotation[1], 0.0f, 1.0f, 0.0f);
+		parentPosition.rotate(rotation[2], 0.0f, 0.0f, 1.0f);
+
+		absolutePosition = parentPosition.getOrigin();
+
+		absoluteBoundBox = parentPosition;
+		absoluteBoundBox.add(boundBox);
+		absoluteBoundBox.absolutize();
+
+		for (std::list<SceneNode *>::iterator c = children.begin(); c != children.end(); ++c) {
+			(*c)->createAbsoluteBound(parentPosition);
+
+			absoluteBoundBox.add((*c)->absoluteBoundBox);
+		}
+	}
+};
+
+/** A synthetic model: a node hierarchy, both as child lists and as a flat, breadth-first list. */
+struct SceneModel {
+	std::vector<SceneNode> nodes;
+	std::vector<SceneNode *> rootNodes;
+
+	std::vector<SceneNode *> flatNodes;
+	std::vector<int32> flatParents;
+
+	Common::BoundingBox boundBox;
+
+	SceneModel(Random &random, size_t nodeCount) : nodes(nodeCount) {
+		/* Attach every node to one of the few nodes created just before it,
+		 * giving long limbs with some branching, like a creature skeleton. */
+		for (size_t i = 0; i < nodeCount; i++) {
+			nodes[i].place(random);
+
+			if (i == 0)
+				rootNodes.push_back(&nodes[i]);
+			else
+				nodes[i - 1 - random.next(MIN<uint32>(i, 4))].children.push_back(&nodes[i]);
+		}
+
+		// Like Model::createFlatNodeLists()
+		for (size_t i = 0; i < rootNodes.size(); i++) {
+			flatNodes.push_back(rootNodes[i]);
+			flatParents.push_back(-1);
+		}
+
+		for (size_t i = 0; i < flatNodes.size(); i++) {
+			for (std::list<SceneNode *>::iterator c = flatNodes[i]->children.begin();
+			     c != flatNodes[i]->children.end(); ++c) {
+
+				flatNodes.push_back(*c);
+				flatParents.push_back(i);
+			}
+		}
+	}
+
+	/** Create the bounding boxes the way the models used to, recursing through the child lists. */
+	void createBoundRecursive() {
+		boundBox.clear();
+
+		for (size_t i = 0; i < rootNodes.size(); i++) {
+			Common::BoundingBox position;
+			rootNodes[i]->createAbsoluteBound(position);
+
+			boundBox.add(rootNodes[i]->absoluteBoundBox);
+		}
+	}
+
+	/** Create the bounding boxes the way Model::createBound() does now, in two linear passes. */
+	void createBoundFlat() {
+		boundBox.clear();
+
+		for (size_t i = 0; i < flatNodes.size(); i++) {
+			Common::TransformationMatrix position;
+			if (flatParents[i] >= 0)
+				position = flatNodes[flatParents[i]]->absolutePosition;
+
+			flatNodes[i]->applyTransformation(position);
+
+			flatNodes[i]->absolutePosition = position;
+		}
+
+		for (size_t i = 0; i < flatNodes.size(); i++) {
+			Common::BoundingBox bound;
+
+			bound.transform(flatNodes[i]->absolutePosition);
+			bound.add(flatNodes[i]->boundBox);
+			bound.absolutize();
+
+			flatNodes[i]->absoluteBoundBox = bound;
+		}
+
+		for (size_t i = flatNodes.size(); i-- > 0; ) {
+			if (flatParents[i] >= 0)
+				flatNodes[flatParents[i]]->absoluteBoundBox.add(flatNodes[i]->absoluteBoundBox);
+			else
+				boundBox.add(flatNodes[i]->absoluteBoundBox);
+		}
+	}
+};
+
+/** Are these two bounding boxes the same, give or take rounding? */
+static bool sameBound(const Common::BoundingBox &a, const Common::BoundingBox &b) {
+	float aMin[3], aMax[3], bMin[3], bMax[3];
+
+	a.getMin(aMin[0], aMin[1], aMin[2]);
+	a.getMax(aMax[0], aMax[1], aMax[2]);
+	b.getMin(bMin[0], bMin[1], bMin[2]);
+	b.getMax(bMax[0], bMax[1], bMax[2]);
+
+	for (int i = 0; i < 3; i++) {
+		const float tolerance = 1.0e-3f * MAX(1.0f, MAX(ABS(aMin[i]), ABS(aMax[i])));
+
+		if (!(ABS(aMin[i] - bMin[i]) <= tolerance) || !(ABS(aMax[i] - bMax[i]) <= tolerance))
+			return false;
+	}
+
+	return true;
+}
+
+static void benchmarkNodeTransforms(Reporter &reporter, Random &random) {
+	static const size_t kModelCount = 256;
+	static const size_t kNodeCount  = 64;
+	static const size_t kRuns       = 32;
+
+	std::vector<SceneModel *> models;
+	models.reserve(kModelCount);
+
+	for (size_t i = 0; i < kModelCount; i++)
+		models.push_back(new SceneModel(random, kNodeCount));
+
+	Result recursive("scene.nodes.recursive");
+	Result flat     ("scene.nodes.flat");
+
+	{
+		Timer timer;
+
+		for (size_t r = 0; r < kRuns; r++)
+			for (size_t i = 0; i < kModelCount; i++)
+				models[i]->createBoundRecursive();
+
+		recursive.seconds = timer.getSeconds();
+		recursive.count   = kRuns * kModelCount * kNodeCount;
+	}
+
+	std::vector<Common::BoundingBox> expected;
+	expected.reserve(kModelCount * (kNodeCount + 1));
+
+	for (size_t i = 0; i < kModelCount; i++) {
+		expected.push_back(models[i]->boundBox);
+
+		for (size_t n = 0; n < kNodeCount; n++)
+			expected.push_back(models[i]->nodes[n].absoluteBoundBox);
+	}
+
+	{
+		Timer timer;
+
+		for (size_t r = 0; r < kRuns; r++)
+			for (size_t i = 0; i < kModelCount; i++)
+				models[i]->createBoundFlat();
+
+		flat.seconds = timer.getSeconds();
+		flat.count   = kRuns * kModelCount * kNodeCount;
+	}
+
+	// Both ways need to come to the same boxes, for the models and for every node
+
+	for (size_t i = 0, e = 0; i < kModelCount; i++) {
+		bool valid = sameBound(models[i]->boundBox, expected[e++]);
+
+		for (size_t n = 0; n < kNodeCount; n++)
+			if (!sameBound(models[i]->nodes[n].absoluteBoundBox, expected[e++]))
+				valid = false;
+
+		if (!valid)
+			flat.failed++;
+	}
+
+	if (flat.seconds > 0.0)
+		flat.addValue("speedup", recursive.seconds / flat.seconds);
+
+	for (size_t i = 0; i < kModelCount; i++)
+		delete models[i];
+
+	reporter.report(recursive);
+	reporter.report(flat);
+}
+
+
+// --- AABB tree ---
+
+/** A box in a synthetic scene. */
+struct SceneBox {
+	float min[3];
+	float max[3];
+
+	void place(Random &random) {
+		for (int i = 0; i < 3; i++) {
+			min[i] = random.nextFloat(0.0f, 1000.0f);
+			max[i] = min[i] + random.nextFloat(0.5f, 10.0f);
+		}
+	}
+
+	void move(Random &random) {
+		for (int i = 0; i < 3; i++) {
+			const float delta = random.nextFloat(-1.0f, 1.0f);
+
+			min[i] += delta;
+			max[i] += delta;
+		}
+	}
+
+	bool overlaps(const float qMin[3], const float qMax[3]) const {
+		for (int i = 0; i < 3; i++)
+			if ((max[i] < qMin[i]) || (min[i] > qMax[i]))
+				return false;
+
+		return true;
+	}
+
+	bool touchesSegment(const float from[3], const float to[3]) const {
+		// Slab test
+		float tMin = 0.0f, tMax = 1.0f;
+
+		for (int i = 0; i < 3; i++) {
+			const float d = to[i] - from[i];
+
+			if (ABS(d) < 1.0e-9f) {
+				if ((from[i] < min[i]) || (from[i] > max[i]))
+					return false;
+
+				continue;
+			}
+
+			float t1 = (min[i] - from[i]) / d;
+			float t2 = (max[i] - from[i]) / d;
+			if (t1 > t2)
+				SWAP(t1, t2);
+
+			tMin = MAX(tMin, t1);
+			tMax = MIN(tMax, t2);
+
+			if (tMin > tMax)
+				return false;
+		}
+
+		return true;
+	}
+};
+
+/** Do the tree's results and the brute force results hold the same objects? */
+static bool sameObjects(std::vector<void *> &a, std::vector<void *> &b) {
+	std::sort(a.begin(), a.end());
+	std::sort(b.begin(), b.end());
+
+	return a == b;
+}
+
+static void benchmarkAABBTree(Reporter &reporter, Random &random) {
+	static const size_t kObjectCount = 10000;
+	static const size_t kQueryCount  = 1000;
+	static const size_t kMoveCount   = 10;
+
+	std::vector<SceneBox> boxes(kObjectCount);
+	for (size_t i = 0; i < kObjectCount; i++)
+		boxes[i].place(random);
+
+	Result insert  ("scene.aabbtree.insert");
+	Result update  ("scene.aabbtree.update");
+	Result planes  ("scene.aabbtree.queryplanes");
+	Result segment ("scene.aabbtree.querysegment");
+	Result bruteForce("scene.aabbtree.bruteforce");
+
+	Common::AABBTree tree;
+	std::vector<int32> proxies(kObjectCount);
+
+	{
+		Timer timer;
+
+		for (size_t i = 0; i < kObjectCount; i++)
+			proxies[i] = tree.insert(boxes[i].min, boxes[i].max, &boxes[i]);
+
+		insert.seconds = timer.getSeconds();
+		insert.count   = kObjectCount;
+	}
+
+	// Move everything around a bit, like creatures walking through an area
+
+	{
+		Timer timer;
+
+		for (size_t m = 0; m < kMoveCount; m++) {
+			for (size_t i = 0; i < kObjectCount; i++) {
+				boxes[i].move(random);
+				tree.update(proxies[i], boxes[i].min, boxes[i].max);
+			}
+		}
+
+		update.seconds = timer.getSeconds();
+		update.count   = kMoveCount * kObjectCount;
+	}
+
+	// Query with axis-aligned boxes, given as 6 planes like a view frustum
+
+	std::vector<void *> results, expected;
+	for (size_t q = 0; q < kQueryCount; q++) {
+		float qMin[3], qMax[3];
+		for (int i = 0; i < 3; i++) {
+			qMin[i] = random.nextFloat(-10.0f, 1000.0f);
+			qMax[i] = qMin[i] + random.nextFloat(10.0f, 200.0f);
+		}
+
+		const float queryPlanes[6][4] = {
+			{  1.0f,  0.0f,  0.0f, -qMin[0] }, { -1.0f,  0.0f,  0.0f, qMax[0] },
+			{  0.0f,  1.0f,  0.0f, -qMin[1] }, {  0.0f, -1.0f,  0.0f, qMax[1] },
+			{  0.0f,  0.0f,  1.0f, -qMin[2] }, {  0.0f,  0.0f, -1.0f, qMax[2] }
+		};
+
+		results.clear();
+
+		Timer timer;
+		tree.queryPlanes(queryPlanes, 6, results);
+		planes.seconds += timer.getSeconds();
+		planes.count++;
+
+		expected.clear();
+
+		timer.start();
+		for (size_t i = 0; i < kObjectCount; i++)
+			if (boxes[i].overlaps(qMin, qMax))
+				expected.push_back(&boxes[i]);
+		bruteForce.seconds += timer.getSeconds();
+		bruteForce.count++;
+
+		if (!sameObjects(results, expected))
+			planes.failed++;
+	}
+
+	// Query with line segments, like picking with the mouse
+
+	for (size_t q = 0; q < kQueryCount; q++) {
+		float from[3], to[3];
+		for (int i = 0; i < 3; i++) {
+			from[i] = random.nextFloat(0.0f, 1000.0f);
+			to[i]   = random.nextFloat(0.0f, 1000.0f);
+		}
+
+		results.clear();
+
+		Timer timer;
+		tree.querySegment(from[0], from[1], from[2], to[0], to[1], to[2], results);
+		segment.seconds += timer.getSeconds();
+		segment.count++;
+
+		expected.clear();
+		for (size_t i = 0; i < kObjectCount; i++)
+			if (boxes[i].touchesSegment(from, to))
+				expected.push_back(&boxes[i]);
+
+		if (!sameObjects(results, expected))
+			segment.failed++;
+	}
+
+	if (planes.seconds > 0.0)
+		planes.addValue("speedup", bruteForce.seconds / planes.seconds);
+
+	reporter.report(insert);
+	reporter.report(update);
+	reporter.report(planes);
+	reporter.report(segment);
+	reporter.report(bruteForce);
+}
+
+
+// --- Keyframe animations ---
+
+static void benchmarkKeyFrames(Reporter &reporter, Random &random) {
+	// A crowded area: 300 creatures with 20 animated nodes each
+	static const size_t kTrackCount    = 300 * 20;
+	static const size_t kKeyFrameCount = 30;
+	static const float  kLength        = 2.0f;
+
+	std::vector<Graphics::Aurora::KeyFrameTrack *> tracks;
+	tracks.reserve(2 * kTrackCount);
+
+	for (size_t t = 0; t < kTrackCount; t++) {
+		Graphics::Aurora::KeyFrameTrack *position    = new Graphics::Aurora::KeyFrameTrack(3);
+		Graphics::Aurora::KeyFrameTrack *orientation = new Graphics::Aurora::KeyFrameTrack(4);
+
+		for (size_t k = 0; k < kKeyFrameCount; k++) {
+			const float time = (kLength * k) / (kKeyFrameCount - 1);
+
+			const float p[3] = {
+				random.nextFloat(-1.0f, 1.0f), random.nextFloat(-1.0f, 1.0f), random.nextFloat(-1.0f, 1.0f)
+			};
+			const float q[4] = {
+				random.nextFloat(-1.0f, 1.0f), random.nextFloat(-1.0f, 1.0f),
+				random.nextFloat(-1.0f, 1.0f), random.nextFloat(0.0f, 360.0f)
+			};
+
+			position->addKeyFrame(time, p);
+			orientation->addKeyFrame(time, q);
+		}
+
+		tracks.push_back(position);
+		tracks.push_back(orientation);
+	}
+
+	std::vector<size_t> cursors(tracks.size(), 0);
+
+	Result forward("scene.keyframes.forward");
+	Result jumping("scene.keyframes.random");
+
+	float values[4];
+	float sink = 0.0f;
+
+	// Play forward at 60 frames per second, looping, for 10 seconds
+
+	{
+		Timer timer;
+
+		for (size_t frame = 0; frame < 600; frame++) {
+			const float time = std::fmod(frame / 60.0f, kLength);
+
+			for (size_t t = 0; t < tracks.size(); t++) {
+				tracks[t]->sample(time, cursors[t], values);
+				sink += values[0];
+			}
+		}
+
+		forward.seconds = timer.getSeconds();
+		forward.count   = 600 * tracks.size();
+	}
+
+	// Jump around in time, like animations being switched all the time
+
+	{
+		Timer timer;
+
+		for (size_t frame = 0; frame < 100; frame++) {
+			for (size_t t = 0; t < tracks.size(); t++) {
+				tracks[t]->sample(random.nextFloat(0.0f, kLength), cursors[t], values);
+				sink += values[0];
+			}
+		}
+
+		jumping.seconds = timer.getSeconds();
+		jumping.count   = 100 * tracks.size();
+	}
+
+	for (size_t t = 0; t < tracks.size(); t++)
+		delete tracks[t];
+
+	forward.addValue("checksum", sink);
+
+	reporter.report(forward);
+	reporter.report(jumping);
+}
+
+
+// --- Vertex packing ---
+
+static void benchmarkVertexPacking(Reporter &reporter, Random &random) {
+	static const uint32 kVertexCount = 100000;
+
+	static const float kPositionTolerance = 0.01f;
+	static const float kTexCoordTolerance = 0.001f;
+
+	Graphics::VertexDecl decl;
+	decl.push_back(Graphics::VertexAttrib(Graphics::VPOSITION, 3, GL_FLOAT));
+	decl.push_back(Graphics::VertexAttrib(Graphics::VNORMAL  , 3, GL_FLOAT));
+	decl.push_back(Graphics::VertexAttrib(Graphics::VTCOORD  , 2, GL_FLOAT));
+
+	Graphics::VertexBuffer buffer;
+	buffer.setVertexDeclLinear(kVertexCount, decl);
+
+	float *position = const_cast<float *>(reinterpret_cast<const float *>(decl[0].pointer));
+	float *normal   = const_cast<float *>(reinterpret_cast<const float *>(decl[1].pointer));
+	float *texCoord = const_cast<float *>(reinterpret_cast<const float *>(decl[2].pointer));
+
+	for (uint32 v = 0; v < kVertexCount; v++) {
+		for (int i = 0; i < 3; i++)
+			position[v * 3 + i] = random.nextFloat(-4.0f, 4.0f);
+
+		float n[3], length = 0.0f;
+		for (int i = 0; i < 3; i++) {
+			n[i] = random.nextFloat(-1.0f, 1.0f);
+			length += n[i] * n[i];
+		}
+
+		length = sqrtf(MAX(length, 1.0e-6f));
+		for (int i = 0; i < 3; i++)
+			normal[v * 3 + i] = n[i] / length;
+
+		texCoord[v * 2 + 0] = random.nextFloat(0.0f, 1.0f);
+		texCoord[v * 2 + 1] = random.nextFloat(0.0f, 1.0f);
+	}
+
+	const Graphics::VertexBuffer original = buffer;
+
+	Graphics::VertexPacking packing;
+	packing.halfFloat         = true;
+	packing.positionTolerance = kPositionTolerance;
+	packing.texCoordTolerance = kTexCoordTolerance;
+
+	Result pack("scene.vertexbuffer.pack");
+
+	Timer timer;
+
+	const uint32 saved = buffer.pack(packing);
+
+	pack.seconds = timer.getSeconds();
+	pack.count   = kVertexCount;
+	pack.bytes   = original.getCount() * original.getSize();
+
+	// Verify that no attribute lost more precision than allowed
+
+	static const float kTolerances[3] = { kPositionTolerance, 1.0f / 256.0f, kTexCoordTolerance };
+
+	for (uint32 v = 0; v < kVertexCount; v++) {
+		bool valid = true;
+
+		for (size_t a = 0; a < 3; a++) {
+			float expected[4], packed[4];
+
+			original.getAttrib(a, v, expected);
+			buffer.getAttrib(a, v, packed);
+
+			for (GLint i = 0; i < decl[a].size; i++)
+				if (!(ABS(packed[i] - expected[i]) <= kTolerances[a]))
+					valid = false;
+		}
+
+		if (!valid)
+			pack.failed++;
+	}
+
+	pack.addValue("bytesSaved", saved);
+	pack.addValue("bytesPerVertexBefore", original.getSize());
+	pack.addValue("bytesPerVertexAfter", buffer.getSize());
+
+	reporter.report(pack);
+}
+
+
+void benchmarkScene(Reporter &reporter) {
+	Random random;
+
+	benchmarkMatrices(reporter, random);
+	benchmarkNodeTransforms(reporter, random);
+	benchmarkAABBTree(reporter, random);
+	benchmarkKeyFrames(reporter, random);
+	benchmarkVertexPacking(reporter, random);
+}
+
+} // End of namespace Benchmark
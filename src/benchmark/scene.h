@@ -0,0 +1,44 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Benchmarks on synthetic scenes for the CPU-side scene code.
+ */
+
+#ifndef BENCHMARK_SCENE_H
+#define BENCHMARK_SCENE_H
+
+namespace Benchmark {
+
+class Reporter;
+
+/** Benchmark matrix math, node transforms, the AABB tree, keyframe sampling and vertex packing.
+ *
+ *  Everything runs on deterministic synthetic scenes, without any GL context.
+ *  Where there is a straightforward way to get the same answer, like a brute
+ *  force search instead of an AABB tree query, or recursing through a node
+ *  hierarchy instead of walking a flattened list, the results are compared
+ *  against it, and every mismatch counts as a failed item.
+ */
+void benchmarkScene(Reporter &reporter);
+
+} // End of namespace Benchmark
+
+#endif // BENCHMARK_SCENE_H
@@ -60,6 +60,12 @@ static void displayUsage(const char *name) {
 	std::printf("          --nologfile=BOOL    Don't write a log file.\n");
 	std::printf("          --consolelog=FILE   Write all debug console output into this file too.\n");
 	std::printf("          --noconsolelog=BOOL Don't write a debug console log file.\n");
+	std::printf("          --resourcetrace=FILE\n");
+	std::printf("                              Record all resource accesses into FILE.\n");
+	std::printf("          --prefetchdir=DIR   Prefetch resources listed in manifests in DIR.\n");
+	std::printf("          --makemanifests=FILE\n");
+	std::printf("                              Turn the trace FILE into prefetch manifests in the\n");
+	std::printf("                              prefetchdir and exit.\n");
 	std::printf("\n");
 	std::printf("FILE: Absolute or relative path to a file.\n");
 	std::printf("DIR:  Absolute or relative path to a directory.\n");
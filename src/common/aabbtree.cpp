@@ -0,0 +1,515 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A dynamic bounding volume hierarchy over axis-aligned bounding boxes.
+ */
+
+/* The insertion heuristic and tree rotations follow the dynamic AABB
+ * tree found in Erin Catto's Box2D, extended into three dimensions. */
+
+#include <cassert>
+
+#include "src/common/aabbtree.h"
+#include "src/common/util.h"
+
+namespace Common {
+
+static float getSurfaceArea(const float min[3], const float max[3]) {
+	const float x = max[0] - min[0];
+	const float y = max[1] - min[1];
+	const float z = max[2] - min[2];
+
+	return 2.0f * (x * y + y * z + z * x);
+}
+
+static float getCombinedSurfaceArea(const float minA[3], const float maxA[3],
+                                    const float minB[3], const float maxB[3]) {
+
+	float min[3], max[3];
+	for (int i = 0; i < 3; i++) {
+		min[i] = MIN(minA[i], minB[i]);
+		max[i] = MAX(maxA[i], maxB[i]);
+	}
+
+	return getSurfaceArea(min, max);
+}
+
+static bool contains(const float outerMin[3], const float outerMax[3],
+                     const float innerMin[3], const float innerMax[3]) {
+
+	for (int i = 0; i < 3; i++)
+		if ((innerMin[i] < outerMin[i]) || (innerMax[i] > outerMax[i]))
+			return false;
+
+	return true;
+}
+
+/** Does the segment from p to p + d touch the box? */
+static bool intersectsSegment(const float min[3], const float max[3], const float p[3], const float d[3]) {
+	float tMin = 0.0f, tMax = 1.0f;
+
+	for (int i = 0; i < 3; i++) {
+		if (ABS(d[i]) < 1e-12f) {
+			// Parallel to this slab
+			if ((p[i] < min[i]) || (p[i] > max[i]))
+				return false;
+
+			continue;
+		}
+
+		const float inv = 1.0f / d[i];
+
+		float t1 = (min[i] - p[i]) * inv;
+		float t2 = (max[i] - p[i]) * inv;
+		if (t1 > t2)
+			SWAP(t1, t2);
+
+		tMin = MAX(tMin, t1);
+		tMax = MIN(tMax, t2);
+
+		if (tMin > tMax)
+			return false;
+	}
+
+	return true;
+}
+
+enum PlaneSide {
+	kPlaneSideOutside,
+	kPlaneSideIntersecting,
+	kPlaneSideInside
+};
+
+/** Classify the box against a set of planes. */
+static PlaneSide classifyPlanes(const float min[3], const float max[3], const float (*planes)[4], size_t count) {
+	PlaneSide side = kPlaneSideInside;
+
+	for (size_t i = 0; i < count; i++) {
+		const float *plane = planes[i];
+
+		// The box corners farthest along and against the plane normal
+		float pos = plane[3], neg = plane[3];
+		for (int j = 0; j < 3; j++) {
+			if (plane[j] >= 0.0f) {
+				pos += plane[j] * max[j];
+				neg += plane[j] * min[j];
+			} else {
+				pos += plane[j] * min[j];
+				neg += plane[j] * max[j];
+			}
+		}
+
+		if (pos < 0.0f)
+			return kPlaneSideOutside;
+		if (neg < 0.0f)
+			side = kPlaneSideIntersecting;
+	}
+
+	return side;
+}
+
+
+bool AABBTree::Node::isLeaf() const {
+	return children[0] == kNull;
+}
+
+
+AABBTree::AABBTree(float margin) : _root(kNull), _freeList(kNull), _proxyCount(0), _margin(margin) {
+}
+
+AABBTree::~AABBTree() {
+}
+
+size_t AABBTree::size() const {
+	return _proxyCount;
+}
+
+bool AABBTree::empty() const {
+	return _proxyCount == 0;
+}
+
+void AABBTree::clear() {
+	_nodes.clear();
+
+	_root       = kNull;
+	_freeList   = kNull;
+	_proxyCount = 0;
+}
+
+int32 AABBTree::allocateNode() {
+	int32 node = _freeList;
+
+	if (node != kNull) {
+		_freeList = _nodes[node].parent;
+	} else {
+		node = _nodes.size();
+		_nodes.push_back(Node());
+	}
+
+	Node &n = _nodes[node];
+
+	n.data        = 0;
+	n.parent      = kNull;
+	n.children[0] = kNull;
+	n.children[1] = kNull;
+	n.height      = 0;
+
+	return node;
+}
+
+void AABBTree::freeNode(int32 node) {
+	assert((node >= 0) && ((size_t) node < _nodes.size()));
+
+	_nodes[node].parent = _freeList;
+	_nodes[node].height = -1;
+
+	_freeList = node;
+}
+
+int32 AABBTree::insert(const float min[3], const float max[3], void *data) {
+	const int32 proxy = allocateNode();
+
+	Node &n = _nodes[proxy];
+	for (int i = 0; i < 3; i++) {
+		n.min[i] = min[i] - _margin;
+		n.max[i] = max[i] + _margin;
+	}
+
+	n.data = data;
+
+	insertLeaf(proxy);
+
+	_proxyCount++;
+	return proxy;
+}
+
+void AABBTree::remove(int32 proxy) {
+	assert((proxy >= 0) && ((size_t) proxy < _nodes.size()) && _nodes[proxy].isLeaf());
+
+	removeLeaf(proxy);
+	freeNode(proxy);
+
+	_proxyCount--;
+}
+
+bool AABBTree::update(int32 proxy, const float min[3], const float max[3]) {
+	assert((proxy >= 0) && ((size_t) proxy < _nodes.size()) && _nodes[proxy].isLeaf());
+
+	Node &n = _nodes[proxy];
+	if (contains(n.min, n.max, min, max))
+		return false;
+
+	removeLeaf(proxy);
+
+	for (int i = 0; i < 3; i++) {
+		n.min[i] = min[i] - _margin;
+		n.max[i] = max[i] + _margin;
+	}
+
+	insertLeaf(proxy);
+	return true;
+}
+
+void *AABBTree::getData(int32 proxy) const {
+	assert((proxy >= 0) && ((size_t) proxy < _nodes.size()));
+
+	return _nodes[proxy].data;
+}
+
+void AABBTree::insertLeaf(int32 leaf) {
+	if (_root == kNull) {
+		_root = leaf;
+		_nodes[leaf].parent = kNull;
+		return;
+	}
+
+	const float *leafMin = _nodes[leaf].min;
+	const float *leafMax = _nodes[leaf].max;
+
+	// Find the best sibling for the new leaf
+	int32 index = _root;
+	while (!_nodes[index].isLeaf()) {
+		const Node &node = _nodes[index];
+
+		const float area         = getSurfaceArea(node.min, node.max);
+		const float combinedArea = getCombinedSurfaceArea(node.min, node.max, leafMin, leafMax);
+
+		// Cost of creating a new parent for this node and the new leaf
+		const float cost = 2.0f * combinedArea;
+
+		// Minimum cost of pushing the leaf further down the tree
+		const float inheritanceCost = 2.0f * (combinedArea - area);
+
+		float childCost[2];
+		for (int i = 0; i < 2; i++) {
+			const Node &child = _nodes[node.children[i]];
+
+			childCost[i] = getCombinedSurfaceArea(child.min, child.max, leafMin, leafMax) + inheritanceCost;
+			if (!child.isLeaf())
+				childCost[i] -= getSurfaceArea(child.min, child.max);
+		}
+
+		if ((cost < childCost[0]) && (cost < childCost[1]))
+			break;
+
+		index = node.children[(childCost[0] < childCost[1]) ? 0 : 1];
+	}
+
+	const int32 sibling   = index;
+	const int32 oldParent = _nodes[sibling].parent;
+	const int32 newParent = allocateNode();
+
+	// allocateNode() might have moved the nodes around
+	Node &parent = _nodes[newParent];
+
+	parent.parent      = oldParent;
+	parent.children[0] = sibling;
+	parent.children[1] = leaf;
+
+	if (oldParent != kNull) {
+		Node &grandParent = _nodes[oldParent];
+
+		grandParent.children[(grandParent.children[0] == sibling) ? 0 : 1] = newParent;
+	} else
+		_root = newParent;
+
+	_nodes[sibling].parent = newParent;
+	_nodes[leaf   ].parent = newParent;
+
+	// Walk back up the tree, fixing heights and boxes
+	for (index = newParent; index != kNull; index = _nodes[index].parent) {
+		index = balance(index);
+
+		refit(index);
+	}
+}
+
+void AABBTree::removeLeaf(int32 leaf) {
+	if (leaf == _root) {
+		_root = kNull;
+		return;
+	}
+
+	const int32 parent      = _nodes[leaf].parent;
+	const int32 grandParent = _nodes[parent].parent;
+	const int32 sibling     = _nodes[parent].children[(_nodes[parent].children[0] == leaf) ? 1 : 0];
+
+	freeNode(parent);
+
+	if (grandParent == kNull) {
+		_root = sibling;
+		_nodes[sibling].parent = kNull;
+		return;
+	}
+
+	// Replace the parent with the sibling
+	Node &grand = _nodes[grandParent];
+	grand.children[(grand.children[0] == parent) ? 0 : 1] = sibling;
+
+	_nodes[sibling].parent = grandParent;
+
+	for (int32 index = grandParent; index != kNull; index = _nodes[index].parent) {
+		index = balance(index);
+
+		refit(index);
+	}
+}
+
+int32 AABBTree::balance(int32 iA) {
+	Node &a = _nodes[iA];
+	if (a.isLeaf() || (a.height < 2))
+		return iA;
+
+	const int32 iB = a.children[0];
+	const int32 iC = a.children[1];
+
+	Node &b = _nodes[iB];
+	Node &c = _nodes[iC];
+
+	const int32 balanceFactor = c.height - b.height;
+
+	if (balanceFactor > 1) {
+		// Rotate C up
+
+		const int32 iF = c.children[0];
+		const int32 iG = c.children[1];
+
+		Node &f = _nodes[iF];
+		Node &g = _nodes[iG];
+
+		c.children[0] = iA;
+		c.parent      = a.parent;
+		a.parent      = iC;
+
+		if (c.parent != kNull) {
+			Node &parent = _nodes[c.parent];
+
+			parent.children[(parent.children[0] == iA) ? 0 : 1] = iC;
+		} else
+			_root = iC;
+
+		if (f.height > g.height) {
+			c.children[1] = iF;
+			a.children[1] = iG;
+			g.parent      = iA;
+		} else {
+			c.children[1] = iG;
+			a.children[1] = iF;
+			f.parent      = iA;
+		}
+
+		refit(iA);
+		refit(iC);
+
+		return iC;
+	}
+
+	if (balanceFactor < -1) {
+		// Rotate B up
+
+		const int32 iD = b.children[0];
+		const int32 iE = b.children[1];
+
+		Node &d = _nodes[iD];
+		Node &e = _nodes[iE];
+
+		b.children[0] = iA;
+		b.parent      = a.parent;
+		a.parent      = iB;
+
+		if (b.parent != kNull) {
+			Node &parent = _nodes[b.parent];
+
+			parent.children[(parent.children[0] == iA) ? 0 : 1] = iB;
+		} else
+			_root = iB;
+
+		if (d.height > e.height) {
+			b.children[1] = iD;
+			a.children[0] = iE;
+			e.parent      = iA;
+		} else {
+			b.children[1] = iE;
+			a.children[0] = iD;
+			d.parent      = iA;
+		}
+
+		refit(iA);
+		refit(iB);
+
+		return iB;
+	}
+
+	return iA;
+}
+
+void AABBTree::refit(int32 node) {
+	Node &n = _nodes[node];
+
+	const Node &c1 = _nodes[n.children[0]];
+	const Node &c2 = _nodes[n.children[1]];
+
+	for (int i = 0; i < 3; i++) {
+		n.min[i] = MIN(c1.min[i], c2.min[i]);
+		n.max[i] = MAX(c1.max[i], c2.max[i]);
+	}
+
+	n.height = 1 + MAX(c1.height, c2.height);
+}
+
+void AABBTree::collectLeaves(int32 node, std::vector<void *> &results) const {
+	std::vector<int32> stack;
+	stack.push_back(node);
+
+	while (!stack.empty()) {
+		const Node &n = _nodes[stack.back()];
+		stack.pop_back();
+
+		if (n.isLeaf()) {
+			results.push_back(n.data);
+			continue;
+		}
+
+		stack.push_back(n.children[0]);
+		stack.push_back(n.children[1]);
+	}
+}
+
+void AABBTree::querySegment(float x1, float y1, float z1, float x2, float y2, float z2,
+                            std::vector<void *> &results) const {
+
+	if (_root == kNull)
+		return;
+
+	const float p[3] = { x1, y1, z1 };
+	const float d[3] = { x2 - x1, y2 - y1, z2 - z1 };
+
+	std::vector<int32> stack;
+	stack.reserve(64);
+
+	stack.push_back(_root);
+	while (!stack.empty()) {
+		const Node &n = _nodes[stack.back()];
+		stack.pop_back();
+
+		if (!intersectsSegment(n.min, n.max, p, d))
+			continue;
+
+		if (n.isLeaf()) {
+			results.push_back(n.data);
+			continue;
+		}
+
+		stack.push_back(n.children[0]);
+		stack.push_back(n.children[1]);
+	}
+}
+
+void AABBTree::queryPlanes(const float (*planes)[4], size_t count, std::vector<void *> &results) const {
+	if (_root == kNull)
+		return;
+
+	std::vector<int32> stack;
+	stack.reserve(64);
+
+	stack.push_back(_root);
+	while (!stack.empty()) {
+		const int32 index = stack.back();
+		stack.pop_back();
+
+		const Node &n = _nodes[index];
+
+		const PlaneSide side = classifyPlanes(n.min, n.max, planes, count);
+		if (side == kPlaneSideOutside)
+			continue;
+
+		// Completely inside, so everything below is, too
+		if ((side == kPlaneSideInside) || n.isLeaf()) {
+			collectLeaves(index, results);
+			continue;
+		}
+
+		stack.push_back(n.children[0]);
+		stack.push_back(n.children[1]);
+	}
+}
+
+} // End of namespace Common
@@ -0,0 +1,130 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A dynamic bounding volume hierarchy over axis-aligned bounding boxes.
+ */
+
+#ifndef COMMON_AABBTREE_H
+#define COMMON_AABBTREE_H
+
+#include <vector>
+
+#include "src/common/types.h"
+
+namespace Common {
+
+/** A dynamic bounding volume hierarchy over axis-aligned bounding boxes.
+ *
+ *  Every object is stored as a proxy in a leaf of a balanced binary tree,
+ *  with its box enlarged by a margin. Moving an object only restructures
+ *  the tree once it leaves its enlarged box. Queries descend only into
+ *  subtrees whose boxes match, which makes them logarithmic in the number
+ *  of objects for typical scenes.
+ *
+ *  The tree is not thread-safe; the owner needs to serialize access.
+ */
+class AABBTree {
+public:
+	/** Create a tree, with the object boxes enlarged by this margin. */
+	AABBTree(float margin = 0.0f);
+	~AABBTree();
+
+	/** Return the number of objects in the tree. */
+	size_t size() const;
+	/** Is the tree empty? */
+	bool empty() const;
+
+	/** Remove all objects from the tree. */
+	void clear();
+
+	/** Add an object with this bounding box to the tree, returning its proxy. */
+	int32 insert(const float min[3], const float max[3], void *data);
+	/** Remove an object from the tree. */
+	void remove(int32 proxy);
+
+	/** Update an object's bounding box.
+	 *
+	 *  @return true if the object was moved within the tree.
+	 */
+	bool update(int32 proxy, const float min[3], const float max[3]);
+
+	/** Return the data of the object with this proxy. */
+	void *getData(int32 proxy) const;
+
+	/** Find all objects whose (enlarged) boxes are touched by the line segment from x1.y1.z1 to x2.y2.z2. */
+	void querySegment(float x1, float y1, float z1, float x2, float y2, float z2,
+	                  std::vector<void *> &results) const;
+
+	/** Find all objects whose (enlarged) boxes are at least partly on the positive side of all planes.
+	 *
+	 *  @param planes  The planes, each as (a, b, c, d) with a * x + b * y + c * z + d >= 0
+	 *                 for points on the positive side. For example the 6 planes of a view frustum.
+	 *  @param count   The number of planes.
+	 *  @param results The found objects are appended here.
+	 */
+	void queryPlanes(const float (*planes)[4], size_t count, std::vector<void *> &results) const;
+
+private:
+	static const int32 kNull = -1;
+
+	struct Node {
+		float min[3];
+		float max[3];
+
+		void *data;
+
+		int32 parent; ///< Parent node, or next free node while unused.
+		int32 children[2];
+
+		/** Height of the subtree. 0 for leaves, -1 for unused nodes. */
+		int32 height;
+
+		bool isLeaf() const;
+	};
+
+	std::vector<Node> _nodes;
+
+	int32 _root;
+	int32 _freeList;
+
+	size_t _proxyCount;
+
+	float _margin;
+
+	int32 allocateNode();
+	void freeNode(int32 node);
+
+	void insertLeaf(int32 leaf);
+	void removeLeaf(int32 leaf);
+
+	/** Perform a left or right rotation if this node is imbalanced. Returns the new root of this subtree. */
+	int32 balance(int32 node);
+
+	/** Recalculate the box and height of an inner node from its children. */
+	void refit(int32 node);
+
+	/** Append the data of all leaves within this subtree. */
+	void collectLeaves(int32 node, std::vector<void *> &results) const;
+};
+
+} // End of namespace Common
+
+#endif // COMMON_AABBTREE_H
@@ -28,8 +28,12 @@
 #include <cassert>
 
 #include "src/common/types.h"
+#include "src/common/util.h"
+#include "src/common/noncopyable.h"
 #include "src/common/error.h"
 #include "src/common/readstream.h"
+#include "src/common/memreadstream.h"
+#include "src/common/endianness.h"
 
 namespace Common {
 
@@ -63,6 +67,15 @@ public:
 	/** Add a bit to the value x, making it an n-bit value. */
 	virtual void addBit(uint32 &x, size_t n) = 0;
 
+	/** Read a multi-bit value from the bit stream, without advancing the position.
+	 *
+	 *  Bits past the end of the stream are returned as 0.
+	 */
+	virtual uint32 peekBits(size_t n) = 0;
+
+	/** Are the bits handed out in the order of MSB to LSB? */
+	virtual bool isMSBFirst() const = 0;
+
 protected:
 	BitStream() {
 	}
@@ -177,20 +190,32 @@ public:
 		if (n > 32)
 			throw Exception("Too many bits requested to be read");
 
-		// Read the number of bits
-		uint32 v = 0;
+		// Read the number of bits, taking as many as possible out of each value at once
+		uint64 v    = 0;
+		size_t read = 0;
 
-		if (isMSB2LSB) {
-			while (n-- > 0)
-				v = (v << 1) | getBit();
-		} else {
-			for (uint32 i = 0; i < n; i++)
-				v = (v >> 1) | (((uint32) getBit()) << 31);
+		while (read < n) {
+			// Check if we need the next value
+			if (_inValue == 0)
+				readValue();
+
+			const size_t count = MIN<size_t>(n - read, valueBits - _inValue);
+
+			if (isMSB2LSB) {
+				v = (v << count) | (_value >> (64 - count));
 
-			v >>= (32 - n);
+				_value <<= count;
+			} else {
+				v |= (_value & (0xFFFFFFFFFFFFFFFFULL >> (64 - count))) << read;
+
+				_value >>= count;
+			}
+
+			_inValue = (_inValue + count) % valueBits;
+			read    += count;
 		}
 
-		return v;
+		return (uint32) v;
 	}
 
 	/** Add a bit to the value x, making it an n-bit value. */
@@ -204,6 +229,49 @@ public:
 			x = (x & ~(1 << n)) | (getBit() << n);
 	}
 
+	/** Read a multi-bit value from the bit stream, without advancing the position. */
+	uint32 peekBits(size_t n) {
+		if (n > 32)
+			throw Exception("Too many bits requested to be read");
+
+		if (n == 0)
+			return 0;
+
+		// Fast path: all the requested bits are still in the current value
+		if ((_inValue != 0) && ((size_t) (valueBits - _inValue) >= n)) {
+			if (isMSB2LSB)
+				return (uint32) (_value >> (64 - n));
+
+			return (uint32) (_value & (0xFFFFFFFFULL >> (32 - n)));
+		}
+
+		// Otherwise, read the bits and restore the state afterwards
+		const size_t available = MIN<size_t>(n, size() - pos());
+		if (available == 0)
+			return 0;
+
+		const size_t streamPos = _stream->pos();
+		const uint64 value     = _value;
+		const uint8  inValue   = _inValue;
+
+		uint32 v = getBits(available);
+
+		_stream->seek(streamPos);
+		_value   = value;
+		_inValue = inValue;
+
+		// Pad missing bits at the end of the stream with 0
+		if (isMSB2LSB)
+			v <<= n - available;
+
+		return v;
+	}
+
+	/** Are the bits handed out in the order of MSB to LSB? */
+	bool isMSBFirst() const {
+		return isMSB2LSB;
+	}
+
 	/** Rewind the bit stream back to the start. */
 	void rewind() {
 		_stream->seek(0);
@@ -214,8 +282,12 @@ public:
 
 	/** Skip the specified amount of bits. */
 	void skip(size_t n) {
-		while (n-- > 0)
-			getBit();
+		while (n > 32) {
+			getBits(32);
+			n -= 32;
+		}
+
+		getBits(n);
 	}
 
 	/** Return the stream position in bits. */
@@ -237,6 +309,196 @@ public:
 	}
 };
 
+/**
+ * A template implementing a bit stream for different data memory layouts,
+ * reading directly out of a contiguous memory buffer.
+ *
+ * In contrast to BitStreamImpl, which reads one value at a time through a
+ * stream, this bit stream loads 64 bits at the current bit position with a
+ * single unaligned read, and then extracts the requested bits with shifts.
+ *
+ * This only works directly on layouts where the bit order within the values
+ * matches the byte order of the values, i.e. 8-bit data, big-endian data
+ * read MSB to LSB and little-endian data read LSB to MSB. For the other
+ * layouts, a copy of the data with the byte order of each value swapped is
+ * created on construction.
+ */
+template<int valueBits, bool isLE, bool isMSB2LSB>
+class MemoryBitStreamImpl : public BitStream, public NonCopyable {
+private:
+	const MemoryReadStream *_stream; ///< The input stream, if any.
+	bool _disposeAfterUse;           ///< Should we delete the stream on destruction?
+
+	const byte *_data; ///< The input data.
+	byte *_ownData;    ///< The swapped input data, if we needed to create it.
+
+	size_t _size; ///< Size of the data in bits.
+	size_t _pos;  ///< Current position in bits.
+
+	/** Do we need to swap the values' byte order to read them directly? */
+	static bool needsSwap() {
+		return (valueBits != 8) && (isLE == isMSB2LSB);
+	}
+
+	/** Create a copy of the data with the byte order of each value swapped. */
+	void swapData(const byte *data, size_t size) {
+		_ownData = new byte[size];
+
+		const size_t valueBytes = valueBits / 8;
+		for (size_t i = 0; i < size; i += valueBytes)
+			for (size_t j = 0; j < valueBytes; j++)
+				_ownData[i + j] = data[i + valueBytes - 1 - j];
+
+		_data = _ownData;
+	}
+
+	void init(const byte *data, size_t size) {
+		if ((valueBits != 8) && (valueBits != 16) && (valueBits != 32) && (valueBits != 64))
+			throw Exception("MemoryBitStream: Invalid memory layout %d, %d, %d", valueBits, isLE, isMSB2LSB);
+
+		// Only whole values are available
+		size &= ~((size_t) ((valueBits >> 3) - 1));
+
+		_size = size * 8;
+
+		if (needsSwap())
+			swapData(data, size);
+	}
+
+	/** Load the 64 bits at the current byte position, padded with 0 past the end of the data. */
+	inline uint64 loadData() const {
+		const size_t offset = _pos >> 3;
+		const size_t bytes  = _size >> 3;
+
+		if ((offset + 8) <= bytes)
+			return isMSB2LSB ? READ_BE_UINT64(_data + offset) : READ_LE_UINT64(_data + offset);
+
+		uint64 value = 0;
+		for (size_t i = 0; i < 8; i++) {
+			const uint64 b = ((offset + i) < bytes) ? _data[offset + i] : 0;
+
+			if (isMSB2LSB)
+				value |= b << (56 - 8 * i);
+			else
+				value |= b << (8 * i);
+		}
+
+		return value;
+	}
+
+	/** Return the next n bits, 0 <= n <= 32, without checking for the end of the stream. */
+	inline uint32 peekData(size_t n) const {
+		const uint64 value = loadData();
+		const size_t shift = _pos & 7;
+
+		// 64 bits minus at most 7 already consumed bits still hold at least 32 bits
+		if (isMSB2LSB)
+			return (uint32) (((value << shift) >> 32) >> (32 - n));
+
+		return (uint32) ((value >> shift) & (0xFFFFFFFFULL >> (32 - n)));
+	}
+
+public:
+	/** Create a bit stream reading from this memory buffer. */
+	MemoryBitStreamImpl(const byte *data, size_t size) :
+		_stream(0), _disposeAfterUse(false), _data(data), _ownData(0), _size(0), _pos(0) {
+
+		init(data, size);
+	}
+
+	/** Create a bit stream reading the data of this memory stream and optionally delete it on destruction. */
+	MemoryBitStreamImpl(const MemoryReadStream *stream, bool disposeAfterUse = false) :
+		_stream(stream), _disposeAfterUse(disposeAfterUse), _data(stream->getData()),
+		_ownData(0), _size(0), _pos(0) {
+
+		init(stream->getData(), stream->size());
+	}
+
+	/** Create a bit stream reading the data of this memory stream. */
+	MemoryBitStreamImpl(const MemoryReadStream &stream) :
+		_stream(&stream), _disposeAfterUse(false), _data(stream.getData()),
+		_ownData(0), _size(0), _pos(0) {
+
+		init(stream.getData(), stream.size());
+	}
+
+	~MemoryBitStreamImpl() {
+		delete[] _ownData;
+
+		if (_disposeAfterUse)
+			delete _stream;
+	}
+
+	/** Read a bit from the bit stream. */
+	uint32 getBit() {
+		return getBits(1);
+	}
+
+	/** Read a multi-bit value from the bit stream. */
+	uint32 getBits(size_t n) {
+		if (n > 32)
+			throw Exception("Too many bits requested to be read");
+		if ((_size - _pos) < n)
+			throw Exception("MemoryBitStream::getBits(): End of bit stream reached");
+
+		const uint32 v = peekData(n);
+
+		_pos += n;
+		return v;
+	}
+
+	/** Read a multi-bit value from the bit stream, without advancing the position. */
+	uint32 peekBits(size_t n) {
+		if (n > 32)
+			throw Exception("Too many bits requested to be read");
+
+		return peekData(n);
+	}
+
+	/** Add a bit to the value x, making it an n-bit value. */
+	void addBit(uint32 &x, size_t n) {
+		if (n > 32)
+			throw Exception("Too many bits requested to be read");
+
+		if (isMSB2LSB)
+			x = (x << 1) | getBit();
+		else
+			x = (x & ~(1 << n)) | (getBit() << n);
+	}
+
+	/** Are the bits handed out in the order of MSB to LSB? */
+	bool isMSBFirst() const {
+		return isMSB2LSB;
+	}
+
+	/** Rewind the bit stream back to the start. */
+	void rewind() {
+		_pos = 0;
+	}
+
+	/** Skip the specified amount of bits. */
+	void skip(size_t n) {
+		if ((_size - _pos) < n)
+			throw Exception("MemoryBitStream::skip(): End of bit stream reached");
+
+		_pos += n;
+	}
+
+	/** Return the stream position in bits. */
+	size_t pos() const {
+		return _pos;
+	}
+
+	/** Return the stream size in bits. */
+	size_t size() const {
+		return _size;
+	}
+
+	bool eos() const {
+		return _pos >= _size;
+	}
+};
+
 // typedefs for various memory layouts.
 
 /** 8-bit data, MSB to LSB. */
@@ -271,6 +533,38 @@ typedef BitStreamImpl<64, false, true > BitStream64BEMSB;
 /** 64-bit big-endian data, LSB to MSB. */
 typedef BitStreamImpl<64, false, false> BitStream64BELSB;
 
+/** 8-bit data, MSB to LSB, read directly from memory. */
+typedef MemoryBitStreamImpl<8, false, true > MemoryBitStream8MSB;
+/** 8-bit data, LSB to MSB, read directly from memory. */
+typedef MemoryBitStreamImpl<8, false, false> MemoryBitStream8LSB;
+
+/** 16-bit little-endian data, MSB to LSB, read directly from memory. */
+typedef MemoryBitStreamImpl<16, true , true > MemoryBitStream16LEMSB;
+/** 16-bit little-endian data, LSB to MSB, read directly from memory. */
+typedef MemoryBitStreamImpl<16, true , false> MemoryBitStream16LELSB;
+/** 16-bit big-endian data, MSB to LSB, read directly from memory. */
+typedef MemoryBitStreamImpl<16, false, true > MemoryBitStream16BEMSB;
+/** 16-bit big-endian data, LSB to MSB, read directly from memory. */
+typedef MemoryBitStreamImpl<16, false, false> MemoryBitStream16BELSB;
+
+/** 32-bit little-endian data, MSB to LSB, read directly from memory. */
+typedef MemoryBitStreamImpl<32, true , true > MemoryBitStream32LEMSB;
+/** 32-bit little-endian data, LSB to MSB, read directly from memory. */
+typedef MemoryBitStreamImpl<32, true , false> MemoryBitStream32LELSB;
+/** 32-bit big-endian data, MSB to LSB, read directly from memory. */
+typedef MemoryBitStreamImpl<32, false, true > MemoryBitStream32BEMSB;
+/** 32-bit big-endian data, LSB to MSB, read directly from memory. */
+typedef MemoryBitStreamImpl<32, false, false> MemoryBitStream32BELSB;
+
+/** 64-bit little-endian data, MSB to LSB, read directly from memory. */
+typedef MemoryBitStreamImpl<64, true , true > MemoryBitStream64LEMSB;
+/** 64-bit little-endian data, LSB to MSB, read directly from memory. */
+typedef MemoryBitStreamImpl<64, true , false> MemoryBitStream64LELSB;
+/** 64-bit big-endian data, MSB to LSB, read directly from memory. */
+typedef MemoryBitStreamImpl<64, false, true > MemoryBitStream64BEMSB;
+/** 64-bit big-endian data, LSB to MSB, read directly from memory. */
+typedef MemoryBitStreamImpl<64, false, false> MemoryBitStream64BELSB;
+
 } // End of namespace Common
 
 #endif // COMMON_BITSTREAM_H
@@ -239,6 +239,54 @@ static inline uint64 hashString(const UString &string, HashAlgo algo) {
 	return 0;
 }
 
+/** Hash a plain ASCII string of this length with the given algorithm.
+ *
+ *  For 7-bit ASCII strings, this results in the same hash as hashString()
+ *  on the equivalent UString, without having to construct one first.
+ */
+static inline uint64 hashString(const char *string, size_t length, HashAlgo algo) {
+	const byte *str = reinterpret_cast<const byte *>(string);
+
+	switch (algo) {
+		case kHashDJB2: {
+			uint32 hash = 5381;
+			for (size_t i = 0; i < length; i++)
+				hash = hashDJB2(hash, str[i]);
+
+			return hash;
+		}
+
+		case kHashFNV32: {
+			uint32 hash = 0x811C9DC5;
+			for (size_t i = 0; i < length; i++)
+				hash = hashFNV32(hash, str[i]);
+
+			return hash;
+		}
+
+		case kHashFNV64: {
+			uint64 hash = 0xCBF29CE484222325LL;
+			for (size_t i = 0; i < length; i++)
+				hash = hashFNV64(hash, str[i]);
+
+			return hash;
+		}
+
+		case kHashCRC32: {
+			uint32 hash = 0xFFFFFFFF;
+			for (size_t i = 0; i < length; i++)
+				hash = hashCRC32(hash, str[i]);
+
+			return hash ^ 0xFFFFFFFF;
+		}
+
+		default:
+			break;
+	}
+
+	return 0;
+}
+
 /** Hash the string with the given algorithm, as a series of bytes in the given encoding. */
 static inline uint64 hashString(const UString &string, HashAlgo algo, Encoding encoding) {
 	switch (algo) {
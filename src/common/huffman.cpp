@@ -24,6 +24,8 @@
 
 #include <cassert>
 
+#include <algorithm>
+
 #include "src/common/huffman.h"
 #include "src/common/util.h"
 #include "src/common/error.h"
@@ -31,16 +33,24 @@
 
 namespace Common {
 
-Huffman::Symbol::Symbol(uint32 c, uint32 s) : code(c), symbol(s) {
+static inline uint32 lowMask(uint8 n) {
+	return (n >= 32) ? 0xFFFFFFFF : ((1U << n) - 1);
+}
+
+
+Huffman::LookupEntry::LookupEntry() : length(0), value(0) {
+}
+
+Huffman::Code::Code(uint32 c, uint8 l, uint32 i) : code(c), length(l), index(i) {
 }
 
 
-Huffman::Huffman(const HuffmanTable &table) {
+Huffman::Huffman(const HuffmanTable &table) : _lookupBits(0) {
 	init(table.maxLength, table.codeCount, table.codes, table.lengths, table.symbols);
 }
 
 Huffman::Huffman(uint8 maxLength, size_t codeCount, const uint32 *codes,
-                 const uint8 *lengths, const uint32 *symbols) {
+                 const uint8 *lengths, const uint32 *symbols) : _lookupBits(0) {
 
 	init(maxLength, codeCount, codes, lengths, symbols);
 }
@@ -59,41 +69,128 @@ void Huffman::init(uint8 maxLength, size_t codeCount, const uint32 *codes,
 
 	assert(maxLength <= 32);
 
-	_codes.resize(maxLength);
 	_symbols.resize(codeCount);
 
+	CodeList codeList;
+	codeList.reserve(codeCount);
+
 	for (size_t i = 0; i < codeCount; i++) {
 		// The symbol. If none were specified, just assume it's identical to the code index
-		uint32 symbol = symbols ? symbols[i] : i;
+		_symbols[i] = symbols ? symbols[i] : i;
 
-		// Put the code and symbol into the correct list
-		_codes[lengths[i] - 1].push_back(Symbol(codes[i], symbol));
+		if ((lengths[i] == 0) || (lengths[i] > maxLength))
+			continue;
 
-		// And put the pointer to the symbol/code struct into the symbol list.
-		_symbols[i] = &_codes[lengths[i] - 1].back();
+		codeList.push_back(Code(codes[i] & lowMask(lengths[i]), lengths[i], i));
 	}
+
+	_lookupBits = MAX<uint8>(MIN<uint8>(maxLength, kLookupBits), 1);
+
+	buildTable(_tableMSB, codeList, _lookupBits, true);
+	buildTable(_tableLSB, codeList, _lookupBits, false);
 }
 
 Huffman::~Huffman() {
 }
 
+bool Huffman::compareCodes(const Code &a, const Code &b) {
+	if (a.length != b.length)
+		return a.length > b.length;
+
+	return a.index > b.index;
+}
+
+size_t Huffman::buildTable(LookupTable &table, const CodeList &codes, uint8 bits, bool msbFirst) {
+	const size_t offset = table.size();
+	const size_t size   = ((size_t) 1) << bits;
+
+	table.resize(offset + size);
+
+	/* Codes longer than this table can resolve are put into subtables,
+	 * grouped by the prefix used to index into this table. */
+
+	std::vector<CodeList> subCodes(size);
+	CodeList leafCodes;
+
+	for (CodeList::const_iterator c = codes.begin(); c != codes.end(); ++c) {
+		if (c->length <= bits) {
+			leafCodes.push_back(*c);
+			continue;
+		}
+
+		const uint8 rest = c->length - bits;
+
+		if (msbFirst)
+			subCodes[c->code >> rest].push_back(Code(c->code & lowMask(rest), rest, c->index));
+		else
+			subCodes[c->code & lowMask(bits)].push_back(Code(c->code >> bits, rest, c->index));
+	}
+
+	for (size_t i = 0; i < size; i++) {
+		if (subCodes[i].empty())
+			continue;
+
+		uint8 subBits = 0;
+		for (CodeList::const_iterator c = subCodes[i].begin(); c != subCodes[i].end(); ++c)
+			subBits = MAX(subBits, c->length);
+
+		subBits = MIN(subBits, kLookupBits);
+
+		const size_t subOffset = buildTable(table, subCodes[i], subBits, msbFirst);
+
+		table[offset + i].length = -((int8) subBits);
+		table[offset + i].value  = subOffset;
+	}
+
+	/* Fill in the codes that end in this table. Each code occupies all entries
+	 * starting with its bits. To keep the precedence of the old linear search,
+	 * shorter codes and earlier codes of the same length are written last. */
+
+	std::sort(leafCodes.begin(), leafCodes.end(), compareCodes);
+
+	for (CodeList::const_iterator c = leafCodes.begin(); c != leafCodes.end(); ++c) {
+		const size_t count = ((size_t) 1) << (bits - c->length);
+
+		for (size_t j = 0; j < count; j++) {
+			const size_t index = msbFirst ? ((c->code << (bits - c->length)) | j) : (c->code | (j << c->length));
+
+			table[offset + index].length = c->length;
+			table[offset + index].value  = c->index;
+		}
+	}
+
+	return offset;
+}
+
 void Huffman::setSymbols(const uint32 *symbols) {
 	for (size_t i = 0; i < _symbols.size(); i++)
-		_symbols[i]->symbol = symbols ? *symbols++ : i;
+		_symbols[i] = symbols ? *symbols++ : i;
 }
 
-uint32 Huffman::getSymbol(BitStream &bits) const {
-	uint32 code = 0;
+uint32 Huffman::getIndex(const LookupTable &table, BitStream &bits) const {
+	size_t offset = 0;
+	uint8  n      = _lookupBits;
 
-	for (size_t i = 0; i < _codes.size(); i++) {
-		bits.addBit(code, i);
+	while (true) {
+		const LookupEntry &entry = table[offset + bits.peekBits(n)];
 
-		for (CodeList::const_iterator cCode = _codes[i].begin(); cCode != _codes[i].end(); ++cCode)
-			if (code == cCode->code)
-				return cCode->symbol;
+		if (entry.length > 0) {
+			bits.skip(entry.length);
+			return entry.value;
+		}
+
+		if (entry.length == 0)
+			throw Exception("Unknown Huffman code");
+
+		bits.skip(n);
+
+		offset = entry.value;
+		n      = -entry.length;
 	}
+}
 
-	throw Exception("Unknown Huffman code");
+uint32 Huffman::getSymbol(BitStream &bits) const {
+	return _symbols[getIndex(bits.isMSBFirst() ? _tableMSB : _tableLSB, bits)];
 }
 
 } // End of namespace Common
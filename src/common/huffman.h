@@ -26,7 +26,6 @@
 #define COMMON_HUFFMAN_H
 
 #include <vector>
-#include <list>
 
 #include "src/common/types.h"
 
@@ -43,7 +42,15 @@ struct HuffmanTable {
 	const uint32 *symbols; ///< The symbols, 0 if identical to the codes.
 };
 
-/** Decode a Huffman'd bitstream. */
+/** Decode a Huffman'd bitstream.
+ *
+ *  The codes are decoded with the help of lookup tables, resolving up to
+ *  kLookupBits bits with a single peek into the bitstream. Longer codes
+ *  continue into subtables.
+ *
+ *  Since the codes' bit order depends on the bitstream they are read from,
+ *  lookup tables for both MSB-to-LSB and LSB-to-MSB bitstreams are built.
+ */
 class Huffman {
 public:
 	/** Construct a Huffman decoder.
@@ -66,25 +73,52 @@ public:
 	uint32 getSymbol(BitStream &bits) const;
 
 private:
-	struct Symbol {
-		uint32 code;
-		uint32 symbol;
+	/** Number of bits resolved by one lookup. */
+	static const uint8 kLookupBits = 9;
+
+	/** An entry in a lookup table. */
+	struct LookupEntry {
+		/** If > 0, the length of the code. If < 0, the negated number of bits of a subtable. */
+		int8 length;
+		/** The code index, or the offset of the subtable. */
+		uint32 value;
+
+		LookupEntry();
+	};
+
+	typedef std::vector<LookupEntry> LookupTable;
+
+	/** A code, relative to the lookup table it's placed in. */
+	struct Code {
+		uint32 code;   ///< The remaining bits of the code.
+		uint8  length; ///< The remaining length of the code.
+		uint32 index;  ///< Index of the code.
 
-		Symbol(uint32 c, uint32 s);
+		Code(uint32 c, uint8 l, uint32 i);
 	};
 
-	typedef std::list<Symbol>     CodeList;
-	typedef std::vector<CodeList> CodeLists;
-	typedef std::vector<Symbol *> SymbolList;
+	typedef std::vector<Code> CodeList;
 
-	/** Lists of codes and their symbols, sorted by code length. */
-	CodeLists _codes;
+	/** Lookup tables for MSB-to-LSB bitstreams. */
+	LookupTable _tableMSB;
+	/** Lookup tables for LSB-to-MSB bitstreams. */
+	LookupTable _tableLSB;
 
-	/** Sorted list of pointers to the symbols. */
-	SymbolList _symbols;
+	/** Number of bits resolved by the top-level lookup tables. */
+	uint8 _lookupBits;
+
+	/** The symbols, by code index. */
+	std::vector<uint32> _symbols;
 
 	void init(uint8 maxLength, size_t codeCount, const uint32 *codes,
 	          const uint8 *lengths, const uint32 *symbols);
+
+	/** Order codes by descending length, then descending index. */
+	static bool compareCodes(const Code &a, const Code &b);
+	/** Build a lookup table of 2^bits entries out of these codes, returning its offset. */
+	static size_t buildTable(LookupTable &table, const CodeList &codes, uint8 bits, bool msbFirst);
+	/** Read a code index out of the bitstream, using this lookup table. */
+	uint32 getIndex(const LookupTable &table, BitStream &bits) const;
 };
 
 } // End of namespace Common
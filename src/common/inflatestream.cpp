@@ -0,0 +1,318 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A stream that inflates deflate compressed data on demand.
+ */
+
+#include <cassert>
+#include <cstring>
+
+#include <zlib.h>
+
+#include "src/common/inflatestream.h"
+#include "src/common/error.h"
+#include "src/common/util.h"
+
+namespace Common {
+
+static const size_t kInBufferSize = 16 * 1024;
+static const size_t kWindowSize   = 32 * 1024;
+
+/** Never place checkpoints closer together than this. */
+static const size_t kMinCheckpointSpacing = 256 * 1024;
+/** Spread the checkpoints so that there are at most this many. */
+static const size_t kMaxCheckpoints = 64;
+
+InflateReadStream::InflateReadStream(SeekableReadStream *packedStream, size_t unpackedSize,
+                                     int windowBits, bool disposePackedStream) :
+	_packedStream(packedStream), _disposePackedStream(disposePackedStream),
+	_packedSize(0), _unpackedSize(unpackedSize), _windowBits(windowBits), _zStream(0),
+	_inBuffer(0), _inPos(0), _history(0), _historyPos(0), _historySize(0),
+	_pos(0), _inflatePos(0), _eos(false), _streamEnd(false), _checkpointSpacing(0) {
+
+	assert(_packedStream);
+
+	_packedSize        = _packedStream->size();
+	_checkpointSpacing = MAX(kMinCheckpointSpacing, _unpackedSize / kMaxCheckpoints);
+
+	try {
+		_inBuffer = new byte[kInBufferSize];
+		_history  = new byte[kWindowSize];
+
+		initInflate();
+	} catch (...) {
+		delete[] _inBuffer;
+		delete[] _history;
+
+		if (_disposePackedStream)
+			delete _packedStream;
+
+		throw;
+	}
+}
+
+InflateReadStream::~InflateReadStream() {
+	if (_zStream)
+		inflateEnd(_zStream);
+	delete _zStream;
+
+	for (std::vector<Checkpoint>::iterator c = _checkpoints.begin(); c != _checkpoints.end(); ++c)
+		delete[] c->window;
+
+	delete[] _inBuffer;
+	delete[] _history;
+
+	if (_disposePackedStream)
+		delete _packedStream;
+}
+
+void InflateReadStream::initInflate() {
+	_zStream = new z_stream_s;
+	std::memset(_zStream, 0, sizeof(z_stream_s));
+
+	_zStream->zalloc = Z_NULL;
+	_zStream->zfree  = Z_NULL;
+	_zStream->opaque = Z_NULL;
+
+	// Negative windows bits means there is no zlib header present in the data.
+	if (inflateInit2(_zStream, -_windowBits) != Z_OK) {
+		delete _zStream;
+		_zStream = 0;
+
+		throw Exception("Could not initialize zlib inflate");
+	}
+}
+
+bool InflateReadStream::eos() const {
+	return _eos;
+}
+
+size_t InflateReadStream::pos() const {
+	return _pos;
+}
+
+size_t InflateReadStream::size() const {
+	return _unpackedSize;
+}
+
+size_t InflateReadStream::seek(ptrdiff_t offset, Origin whence) {
+	const size_t oldPos = _pos;
+	const size_t newPos = evalSeek(offset, whence, _pos, 0, size());
+	if (newPos > _unpackedSize)
+		throw Exception(kSeekError);
+
+	// Only remember the position here. The inflater catches up on the next read
+	_pos = newPos;
+	_eos = false;
+
+	return oldPos;
+}
+
+size_t InflateReadStream::read(void *dataPtr, size_t dataSize) {
+	if (dataSize > (_unpackedSize - _pos)) {
+		dataSize = _unpackedSize - _pos;
+		_eos = true;
+	}
+
+	if (dataSize == 0)
+		return 0;
+
+	syncPosition();
+	if (_inflatePos != _pos) {
+		// The deflate data ended before the position we wanted
+		_eos = true;
+		return 0;
+	}
+
+	const size_t bytesRead = inflateInto((byte *) dataPtr, dataSize);
+	if (bytesRead != dataSize)
+		_eos = true;
+
+	_pos += bytesRead;
+
+	return bytesRead;
+}
+
+void InflateReadStream::restart(const Checkpoint *checkpoint) {
+	if (inflateReset(_zStream) != Z_OK)
+		throw Exception("Could not reset zlib inflate");
+
+	_zStream->next_in  = 0;
+	_zStream->avail_in = 0;
+
+	_historyPos  = 0;
+	_historySize = 0;
+
+	_streamEnd = false;
+
+	if (!checkpoint) {
+		_inPos      = 0;
+		_inflatePos = 0;
+
+		return;
+	}
+
+	_inPos      = checkpoint->packedPos;
+	_inflatePos = checkpoint->unpackedPos;
+
+	// Feed the inflater the bits of the partially used byte
+	if (checkpoint->bits > 0) {
+		byte partial;
+		if (_packedStream->readAt(_inPos - 1, &partial, 1) != 1)
+			throw Exception(kReadError);
+
+		if (inflatePrime(_zStream, checkpoint->bits, partial >> (8 - checkpoint->bits)) != Z_OK)
+			throw Exception("Could not restart zlib inflate");
+	}
+
+	if (inflateSetDictionary(_zStream, checkpoint->window, checkpoint->windowSize) != Z_OK)
+		throw Exception("Could not restart zlib inflate");
+
+	addHistory(checkpoint->window, checkpoint->windowSize);
+}
+
+void InflateReadStream::syncPosition() {
+	if (_inflatePos == _pos)
+		return;
+
+	// Find the last checkpoint before the position we want to reach
+	const Checkpoint *checkpoint = 0;
+	for (std::vector<Checkpoint>::const_iterator c = _checkpoints.begin(); c != _checkpoints.end(); ++c) {
+		if (c->unpackedPos > _pos)
+			break;
+
+		checkpoint = &*c;
+	}
+
+	// Restart when going backwards, or when the checkpoint is further along than we are
+	const size_t checkpointPos = checkpoint ? checkpoint->unpackedPos : 0;
+	if ((_pos < _inflatePos) || (checkpointPos > _inflatePos))
+		restart(checkpoint);
+
+	// Inflate and throw away the data up to the position
+	byte buffer[4096];
+	while (_inflatePos < _pos) {
+		const size_t toSkip = MIN<size_t>(sizeof(buffer), _pos - _inflatePos);
+
+		if (inflateInto(buffer, toSkip) != toSkip)
+			break;
+	}
+}
+
+size_t InflateReadStream::inflateInto(byte *data, size_t size) {
+	if (_streamEnd)
+		return 0;
+
+	_zStream->next_out  = data;
+	_zStream->avail_out = size;
+
+	while (_zStream->avail_out > 0) {
+		if (_zStream->avail_in == 0)
+			fillInBuffer();
+
+		byte *outStart = _zStream->next_out;
+
+		// Stop at the end of each deflate block, to find places for checkpoints
+		const int zResult = inflate(_zStream, Z_BLOCK);
+
+		const size_t inflated = _zStream->next_out - outStart;
+
+		addHistory(outStart, inflated);
+		_inflatePos += inflated;
+
+		if (zResult == Z_STREAM_END) {
+			_streamEnd = true;
+			break;
+		}
+
+		if ((zResult != Z_OK) && (zResult != Z_BUF_ERROR))
+			throw Exception("Failed to inflate: %d", zResult);
+
+		// At the end of a block that isn't the last one, we can place a checkpoint
+		const bool blockEnd  = (_zStream->data_type & 128) != 0;
+		const bool lastBlock = (_zStream->data_type &  64) != 0;
+
+		const size_t lastCheckpoint = _checkpoints.empty() ? 0 : _checkpoints.back().unpackedPos;
+
+		if (blockEnd && !lastBlock && (_inflatePos >= (lastCheckpoint + _checkpointSpacing)))
+			addCheckpoint();
+	}
+
+	return size - _zStream->avail_out;
+}
+
+void InflateReadStream::fillInBuffer() {
+	if (_inPos >= _packedSize)
+		throw Exception("Unexpected end of deflate data");
+
+	const size_t toRead = MIN(kInBufferSize, _packedSize - _inPos);
+	if (_packedStream->readAt(_inPos, _inBuffer, toRead) != toRead)
+		throw Exception(kReadError);
+
+	_inPos += toRead;
+
+	_zStream->next_in  = _inBuffer;
+	_zStream->avail_in = toRead;
+}
+
+void InflateReadStream::addHistory(const byte *data, size_t size) {
+	if (size >= kWindowSize) {
+		std::memcpy(_history, data + size - kWindowSize, kWindowSize);
+
+		_historyPos  = 0;
+		_historySize = kWindowSize;
+		return;
+	}
+
+	const size_t first = MIN(size, kWindowSize - _historyPos);
+
+	std::memcpy(_history + _historyPos, data, first);
+	std::memcpy(_history, data + first, size - first);
+
+	_historyPos  = (_historyPos + size) % kWindowSize;
+	_historySize = MIN(_historySize + size, kWindowSize);
+}
+
+void InflateReadStream::addCheckpoint() {
+	Checkpoint checkpoint;
+
+	checkpoint.unpackedPos = _inflatePos;
+	checkpoint.packedPos   = _inPos - _zStream->avail_in;
+	checkpoint.bits        = _zStream->data_type & 7;
+	checkpoint.windowSize  = _historySize;
+	checkpoint.window      = new byte[_historySize];
+
+	// Unroll the ring buffer into the checkpoint's window
+	const size_t start = (_historyPos + kWindowSize - _historySize) % kWindowSize;
+	const size_t first = MIN(_historySize, kWindowSize - start);
+
+	std::memcpy(checkpoint.window, _history + start, first);
+	std::memcpy(checkpoint.window + first, _history, _historySize - first);
+
+	try {
+		_checkpoints.push_back(checkpoint);
+	} catch (...) {
+		delete[] checkpoint.window;
+		throw;
+	}
+}
+
+} // End of namespace Common
@@ -0,0 +1,130 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A stream that inflates deflate compressed data on demand.
+ */
+
+#ifndef COMMON_INFLATESTREAM_H
+#define COMMON_INFLATESTREAM_H
+
+#include <vector>
+
+#include "src/common/types.h"
+#include "src/common/readstream.h"
+#include "src/common/noncopyable.h"
+
+struct z_stream_s;
+
+namespace Common {
+
+/** A SeekableReadStream that inflates raw deflate data lazily, in chunks.
+ *
+ *  Instead of inflating a whole resource into memory up front, only the data
+ *  that is actually read gets inflated, a chunk of compressed data at a time.
+ *  So the memory needed for sequential readers, like music and videos, stays
+ *  bounded by the size of the compressed data, no matter the inflated size.
+ *
+ *  Every so often, at deflate block boundaries, the stream remembers a
+ *  checkpoint: the position in both the compressed and the inflated data, and
+ *  the last 32KB of inflated data. Seeking backwards then only has to restart
+ *  inflating from the nearest checkpoint, not from the beginning.
+ *
+ *  The compressed data is only ever read through the packed stream's readAt(),
+ *  so several InflateReadStreams can share one packed stream.
+ */
+class InflateReadStream : public SeekableReadStream, public NonCopyable {
+public:
+	/** Resources at least this big are worth inflating on demand. */
+	static const size_t kStreamingThreshold = 4 * 1024 * 1024;
+
+	/** Create an inflating stream.
+	 *
+	 *  @param packedStream The raw deflate data, without a zlib header.
+	 *  @param unpackedSize The size of the data after inflating.
+	 *  @param windowBits The base two logarithm of the deflate window size.
+	 *  @param disposePackedStream Should the packed stream be deleted with this stream?
+	 */
+	InflateReadStream(SeekableReadStream *packedStream, size_t unpackedSize,
+	                  int windowBits = 15, bool disposePackedStream = false);
+	~InflateReadStream();
+
+	bool eos() const;
+
+	size_t pos() const;
+	size_t size() const;
+
+	size_t seek(ptrdiff_t offset, Origin whence = kOriginBegin);
+	size_t read(void *dataPtr, size_t dataSize);
+
+private:
+	/** A point from which inflating can be restarted. */
+	struct Checkpoint {
+		size_t unpackedPos; ///< Position in the inflated data.
+		size_t packedPos;   ///< Position in the compressed data, after the partially used byte.
+		int    bits;        ///< Number of bits still unused in the byte before packedPos.
+
+		size_t windowSize;  ///< Number of bytes in the window.
+		byte  *window;      ///< The inflated data directly before unpackedPos.
+	};
+
+	SeekableReadStream *_packedStream;
+	bool _disposePackedStream;
+
+	size_t _packedSize;
+	size_t _unpackedSize;
+
+	int _windowBits;
+
+	z_stream_s *_zStream;
+
+	byte  *_inBuffer;  ///< Compressed data waiting to be inflated.
+	size_t _inPos;     ///< Position in the compressed data after the buffered data.
+
+	byte  *_history;     ///< Ring buffer of the most recently inflated data.
+	size_t _historyPos;  ///< Where the next inflated byte goes into the ring buffer.
+	size_t _historySize; ///< Number of valid bytes in the ring buffer.
+
+	size_t _pos;        ///< Position in the stream, as seen by the reader.
+	size_t _inflatePos; ///< Position the inflater has reached in the inflated data.
+
+	bool _eos;
+	bool _streamEnd; ///< Has the inflater reached the end of the deflate data?
+
+	size_t _checkpointSpacing;
+	std::vector<Checkpoint> _checkpoints;
+
+
+	void initInflate();
+	void restart(const Checkpoint *checkpoint);
+
+	/** Make the inflater reach the reader's position. */
+	void syncPosition();
+	/** Inflate into the buffer, returning the number of bytes inflated. */
+	size_t inflateInto(byte *data, size_t size);
+
+	void fillInBuffer();
+	void addHistory(const byte *data, size_t size);
+	void addCheckpoint();
+};
+
+} // End of namespace Common
+
+#endif // COMMON_INFLATESTREAM_H
@@ -58,6 +58,20 @@ size_t MemoryReadStream::read(void *dataPtr, size_t dataSize) {
 	return dataSize;
 }
 
+size_t MemoryReadStream::readAt(size_t offset, void *dataPtr, size_t dataSize) {
+	if (offset >= _size)
+		return 0;
+
+	dataSize = MIN(dataSize, _size - offset);
+	std::memcpy(dataPtr, _ptrOrig + offset, dataSize);
+
+	return dataSize;
+}
+
+bool MemoryReadStream::canReadAtConcurrently() const {
+	return true;
+}
+
 size_t MemoryReadStream::seek(ptrdiff_t offset, Origin whence) {
 	assert((size_t)_pos <= _size);
 
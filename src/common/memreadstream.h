@@ -55,6 +55,9 @@ public:
 
 	size_t seek(ptrdiff_t offset, Origin whence = kOriginBegin);
 
+	size_t readAt(size_t offset, void *dataPtr, size_t dataSize);
+	bool canReadAtConcurrently() const;
+
 	const byte *getData() const;
 
 private:
@@ -22,9 +22,15 @@
  *  Implementing the stream reading interfaces for files.
  */
 
+#if defined(UNIX)
+	#include <unistd.h>
+	#include <cerrno>
+#endif
+
 #include "src/common/readfile.h"
 #include "src/common/error.h"
 #include "src/common/ustring.h"
+#include "src/common/util.h"
 
 namespace Common {
 
@@ -135,4 +141,43 @@ size_t ReadFile::read(void *dataPtr, size_t dataSize) {
 	return std::fread(dataPtr, 1, dataSize, _handle);
 }
 
+size_t ReadFile::readAt(size_t offset, void *dataPtr, size_t dataSize) {
+	if (!_handle || (offset >= _size))
+		return 0;
+
+	dataSize = MIN(dataSize, _size - offset);
+
+#if defined(UNIX)
+	const int fd = fileno(_handle);
+
+	byte  *data      = (byte *) dataPtr;
+	size_t bytesRead = 0;
+
+	while (bytesRead < dataSize) {
+		const ssize_t n = pread(fd, data + bytesRead, dataSize - bytesRead, offset + bytesRead);
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+
+			break;
+		}
+
+		if (n == 0)
+			break;
+
+		bytesRead += (size_t) n;
+	}
+
+	return bytesRead;
+#else
+	StackLock lock(_readAtMutex);
+
+	return SeekableReadStream::readAt(offset, dataPtr, dataSize);
+#endif
+}
+
+bool ReadFile::canReadAtConcurrently() const {
+	return _handle != 0;
+}
+
 } // End of namespace Common
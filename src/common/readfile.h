@@ -30,6 +30,7 @@
 #include "src/common/types.h"
 #include "src/common/readstream.h"
 #include "src/common/noncopyable.h"
+#include "src/common/mutex.h"
 
 namespace Common {
 
@@ -66,9 +67,25 @@ public:
 	size_t seek(ptrdiff_t offset, Origin whence = kOriginBegin);
 	size_t read(void *dataPtr, size_t dataSize);
 
+	/** Read data from an absolute position in the file.
+	 *
+	 *  This reads with pread() on the underlying file descriptor and neither
+	 *  uses nor changes the file position indicator, so it can be called from
+	 *  several threads at the same time. Where pread() is not available, the
+	 *  calls are serialized instead.
+	 *
+	 *  Note that calling seek() or read() at the same time is still not safe.
+	 */
+	size_t readAt(size_t offset, void *dataPtr, size_t dataSize);
+	bool canReadAtConcurrently() const;
+
 protected:
 	std::FILE *_handle; ///< The actual file handle.
 	size_t _size;       ///< The file's size.
+
+#if !defined(UNIX)
+	Mutex _readAtMutex; ///< Serializes readAt() calls without pread().
+#endif
 };
 
 } // End of namespace Common
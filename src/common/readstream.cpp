@@ -25,7 +25,9 @@
  */
 
 #include <cassert>
+#include <cstring>
 
+#include "src/common/util.h"
 #include "src/common/readstream.h"
 #include "src/common/memreadstream.h"
 #include "src/common/error.h"
@@ -54,6 +56,91 @@ MemoryReadStream *ReadStream::readStream(size_t dataSize) {
 	return new MemoryReadStream(buf, dataSize, true);
 }
 
+/** Byte-swap an array of 16-bit values in place. */
+static void swapArray16(uint16 *values, size_t count) {
+	for (size_t i = 0; i < count; i++)
+		values[i] = SWAP_BYTES_16(values[i]);
+}
+
+/** Byte-swap an array of 32-bit values in place. */
+static void swapArray32(uint32 *values, size_t count) {
+	for (size_t i = 0; i < count; i++)
+		values[i] = SWAP_BYTES_32(values[i]);
+}
+
+/** Byte-swap an array of 32-bit floats in place. */
+static void swapArrayFloat(float *values, size_t count) {
+	// Like convertIEEEFloat(), this assumes floats are 32-bit IEEE 754 values
+
+	for (size_t i = 0; i < count; i++) {
+		uint32 data;
+
+		std::memcpy(&data, &values[i], sizeof(data));
+		data = SWAP_BYTES_32(data);
+		std::memcpy(&values[i], &data, sizeof(data));
+	}
+}
+
+/** Read count elements of size bytes each into values, throwing on a short read. */
+static void readRawArray(ReadStream &stream, void *values, size_t size, size_t count) {
+	if (count == 0)
+		return;
+
+	if (count > (SIZE_MAX / size))
+		throw Exception(kReadError);
+
+	if (stream.read(values, size * count) != (size * count))
+		throw Exception(kReadError);
+}
+
+void ReadStream::readUint16LE(uint16 *values, size_t count) {
+	readRawArray(*this, values, sizeof(uint16), count);
+
+#ifdef XOREOS_BIG_ENDIAN
+	swapArray16(values, count);
+#endif
+}
+
+void ReadStream::readUint32LE(uint32 *values, size_t count) {
+	readRawArray(*this, values, sizeof(uint32), count);
+
+#ifdef XOREOS_BIG_ENDIAN
+	swapArray32(values, count);
+#endif
+}
+
+void ReadStream::readUint16BE(uint16 *values, size_t count) {
+	readRawArray(*this, values, sizeof(uint16), count);
+
+#ifdef XOREOS_LITTLE_ENDIAN
+	swapArray16(values, count);
+#endif
+}
+
+void ReadStream::readUint32BE(uint32 *values, size_t count) {
+	readRawArray(*this, values, sizeof(uint32), count);
+
+#ifdef XOREOS_LITTLE_ENDIAN
+	swapArray32(values, count);
+#endif
+}
+
+void ReadStream::readIEEEFloatLE(float *values, size_t count) {
+	readRawArray(*this, values, sizeof(float), count);
+
+#ifdef XOREOS_BIG_ENDIAN
+	swapArrayFloat(values, count);
+#endif
+}
+
+void ReadStream::readIEEEFloatBE(float *values, size_t count) {
+	readRawArray(*this, values, sizeof(float), count);
+
+#ifdef XOREOS_LITTLE_ENDIAN
+	swapArrayFloat(values, count);
+#endif
+}
+
 
 SeekableReadStream::SeekableReadStream() {
 }
@@ -78,6 +165,36 @@ size_t SeekableReadStream::evalSeek(ptrdiff_t offset, Origin whence, size_t pos,
 	throw Exception("Invalid whence (%d)", (int) whence);
 }
 
+size_t SeekableReadStream::readAt(size_t offset, void *dataPtr, size_t dataSize) {
+	const size_t oldPos = pos();
+
+	seek(offset);
+	dataSize = read(dataPtr, dataSize);
+	seek(oldPos);
+
+	return dataSize;
+}
+
+bool SeekableReadStream::canReadAtConcurrently() const {
+	return false;
+}
+
+MemoryReadStream *SeekableReadStream::readStreamAt(size_t offset, size_t dataSize) {
+	byte *buf = new byte[dataSize];
+
+	try {
+
+		if (readAt(offset, buf, dataSize) != dataSize)
+			throw Exception(kReadError);
+
+	} catch (...) {
+		delete[] buf;
+		throw;
+	}
+
+	return new MemoryReadStream(buf, dataSize, true);
+}
+
 
 SubReadStream::SubReadStream(ReadStream *parentStream, size_t end, bool disposeParentStream) :
 	_parentStream(parentStream), _disposeParentStream(disposeParentStream),
@@ -147,6 +264,76 @@ size_t SeekableSubReadStream::seek(ptrdiff_t offset, Origin whence) {
 }
 
 
+PositionalSubReadStream::PositionalSubReadStream(SeekableReadStream *parentStream, size_t begin,
+                                                 size_t end, bool disposeParentStream) :
+	_parentStream(parentStream), _disposeParentStream(disposeParentStream),
+	_begin(begin), _end(end), _pos(begin), _eos(false) {
+
+	assert(_parentStream);
+	assert(_begin <= _end);
+}
+
+PositionalSubReadStream::~PositionalSubReadStream() {
+	if (_disposeParentStream)
+		delete _parentStream;
+}
+
+bool PositionalSubReadStream::eos() const {
+	return _eos;
+}
+
+size_t PositionalSubReadStream::pos() const {
+	return _pos - _begin;
+}
+
+size_t PositionalSubReadStream::size() const {
+	return _end - _begin;
+}
+
+size_t PositionalSubReadStream::seek(ptrdiff_t offset, Origin whence) {
+	assert(_pos >= _begin);
+	assert(_pos <= _end);
+
+	const size_t oldPos = _pos - _begin;
+	const size_t newPos = evalSeek(offset, whence, _pos, _begin, size());
+	if ((newPos < _begin) || (newPos > _end))
+		throw Exception(kSeekError);
+
+	_pos = newPos;
+	_eos = false;
+
+	return oldPos;
+}
+
+size_t PositionalSubReadStream::read(void *dataPtr, size_t dataSize) {
+	if (dataSize > (_end - _pos)) {
+		dataSize = _end - _pos;
+		_eos = true;
+	}
+
+	const size_t bytesRead = _parentStream->readAt(_pos, dataPtr, dataSize);
+	if (bytesRead != dataSize)
+		_eos = true;
+
+	_pos += bytesRead;
+
+	return bytesRead;
+}
+
+size_t PositionalSubReadStream::readAt(size_t offset, void *dataPtr, size_t dataSize) {
+	if (offset >= size())
+		return 0;
+
+	dataSize = MIN(dataSize, size() - offset);
+
+	return _parentStream->readAt(_begin + offset, dataPtr, dataSize);
+}
+
+bool PositionalSubReadStream::canReadAtConcurrently() const {
+	return _parentStream->canReadAtConcurrently();
+}
+
+
 SeekableSubReadStreamEndian::SeekableSubReadStreamEndian(SeekableReadStream *parentStream,
 		size_t begin, size_t end, bool bigEndian, bool disposeParentStream) :
 		SeekableSubReadStream(parentStream, begin, end, disposeParentStream), _bigEndian(bigEndian) {
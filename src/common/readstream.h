@@ -228,6 +228,47 @@ public:
 		return convertIEEEDouble(readUint64BE());
 	}
 
+	/** Read count unsigned 16-bit words stored in little endian (LSB first)
+	 *  order from the stream into values.
+	 *
+	 *  The whole array is read with a single read() call and then, if
+	 *  necessary, byte-swapped in place. This is a lot faster than calling
+	 *  readUint16LE() count times.
+	 *
+	 *  When reading fails, a kReadError exception is thrown.
+	 */
+	void readUint16LE(uint16 *values, size_t count);
+
+	/** Read count unsigned 32-bit words stored in little endian (LSB first)
+	 *  order from the stream into values.
+	 *  @see readUint16LE(uint16 *, size_t)
+	 */
+	void readUint32LE(uint32 *values, size_t count);
+
+	/** Read count unsigned 16-bit words stored in big endian (MSB first)
+	 *  order from the stream into values.
+	 *  @see readUint16LE(uint16 *, size_t)
+	 */
+	void readUint16BE(uint16 *values, size_t count);
+
+	/** Read count unsigned 32-bit words stored in big endian (MSB first)
+	 *  order from the stream into values.
+	 *  @see readUint16LE(uint16 *, size_t)
+	 */
+	void readUint32BE(uint32 *values, size_t count);
+
+	/** Read count 32-bit IEEE floats stored in little endian (LSB first)
+	 *  order from the stream into values.
+	 *  @see readUint16LE(uint16 *, size_t)
+	 */
+	void readIEEEFloatLE(float *values, size_t count);
+
+	/** Read count 32-bit IEEE floats stored in big endian (MSB first)
+	 *  order from the stream into values.
+	 *  @see readUint16LE(uint16 *, size_t)
+	 */
+	void readIEEEFloatBE(float *values, size_t count);
+
 	/** Read the specified amount of data into a new[]'ed buffer
 	 *  which then is wrapped into a MemoryReadStream.
 	 *
@@ -294,6 +335,31 @@ public:
 		return seek(offset, kOriginCurrent);
 	}
 
+	/** Read data from an absolute position in the stream, without using or
+	 *  changing the stream position indicator.
+	 *
+	 *  The default implementation seeks, reads and seeks back, and is therefore
+	 *  no safer to use from several threads than seek() and read() are. Streams
+	 *  that can do better override it and return true from canReadAtConcurrently().
+	 *
+	 *  @param  offset the position, measured from the beginning of the stream.
+	 *  @param  dataPtr pointer to a buffer into which the data is read.
+	 *  @param  dataSize number of bytes to be read.
+	 *  @return the number of bytes which were actually read.
+	 */
+	virtual size_t readAt(size_t offset, void *dataPtr, size_t dataSize);
+
+	/** Can readAt() be called from several threads at the same time? */
+	virtual bool canReadAtConcurrently() const;
+
+	/** Read the specified amount of data from an absolute position into a
+	 *  new[]'ed buffer, which then is wrapped into a MemoryReadStream.
+	 *
+	 *  Like readAt(), this does not change the stream position indicator.
+	 *  When reading fails, a kReadError exception is thrown.
+	 */
+	MemoryReadStream *readStreamAt(size_t offset, size_t dataSize);
+
 	/** Evaluate the seek offset relative to whence into a position from the beginning. */
 	static size_t evalSeek(ptrdiff_t offset, Origin whence, size_t pos, size_t begin, size_t size);
 };
@@ -352,6 +418,45 @@ protected:
 };
 
 
+/** PositionalSubReadStream provides access to a SeekableReadStream restricted to
+ *  the range [begin, end).
+ *
+ *  Unlike SeekableSubReadStream, it only ever reads from its parent through
+ *  readAt() and keeps its own position, so it neither uses nor changes the
+ *  parent's position. If the parent supports concurrent readAt() calls,
+ *  several PositionalSubReadStreams of one parent can be read from different
+ *  threads at the same time.
+ */
+class PositionalSubReadStream : public SeekableReadStream {
+public:
+	PositionalSubReadStream(SeekableReadStream *parentStream, size_t begin, size_t end,
+	                        bool disposeParentStream = false);
+	~PositionalSubReadStream();
+
+	bool eos() const;
+
+	size_t pos() const;
+	size_t size() const;
+
+	size_t seek(ptrdiff_t offset, Origin whence = kOriginBegin);
+	size_t read(void *dataPtr, size_t dataSize);
+
+	size_t readAt(size_t offset, void *dataPtr, size_t dataSize);
+	bool canReadAtConcurrently() const;
+
+private:
+	SeekableReadStream *_parentStream;
+
+	bool _disposeParentStream;
+
+	size_t _begin;
+	size_t _end;
+	size_t _pos;
+
+	bool _eos;
+};
+
+
 /** This is a wrapper around SeekableSubReadStream, but it adds non-endian
  *  read methods whose endianness is set on the stream creation.
  *
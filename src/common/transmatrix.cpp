@@ -24,6 +24,12 @@
 
 #include <cstring>
 
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 1))
+	#define TRANSMATRIX_USE_SSE 1
+
+	#include <xmmintrin.h>
+#endif
+
 #include "src/common/transmatrix.h"
 #include "src/common/maths.h"
 
@@ -34,6 +40,107 @@ static const float kIdentity[] = {
 	0.0f, 0.0f, 0.0f, 1.0f
 };
 
+/* The kernels below work on column-major 4x4 matrices. They come in two
+ * variants: SSE, with one column per register, and plain C++. Both add
+ * the products in the same order, so that they produce the same results.
+ *
+ * The matrices aren't guaranteed to be 16-byte aligned, so the SSE variants
+ * use unaligned loads and stores. */
+
+/** result = a * b. result may alias neither a nor b. */
+static inline void multiplyMatrix(const float *a, const float *b, float *result) {
+#ifdef TRANSMATRIX_USE_SSE
+	const __m128 a0 = _mm_loadu_ps(a +  0);
+	const __m128 a1 = _mm_loadu_ps(a +  4);
+	const __m128 a2 = _mm_loadu_ps(a +  8);
+	const __m128 a3 = _mm_loadu_ps(a + 12);
+
+	for (int i = 0; i < 16; i += 4) {
+		__m128 r =         _mm_mul_ps(a0, _mm_set1_ps(b[i + 0]));
+		r = _mm_add_ps(r,  _mm_mul_ps(a1, _mm_set1_ps(b[i + 1])));
+		r = _mm_add_ps(r,  _mm_mul_ps(a2, _mm_set1_ps(b[i + 2])));
+		r = _mm_add_ps(r,  _mm_mul_ps(a3, _mm_set1_ps(b[i + 3])));
+
+		_mm_storeu_ps(result + i, r);
+	}
+#else
+	for (int i = 0; i < 16; i += 4) {
+		result[i + 0] = a[0 + 0] * b[i];
+		result[i + 1] = a[0 + 1] * b[i];
+		result[i + 2] = a[0 + 2] * b[i];
+		result[i + 3] = a[0 + 3] * b[i];
+		for (int j = 1; j < 4; j++) {
+			result[i + 0] += a[j * 4 + 0] * b[i + j];
+			result[i + 1] += a[j * 4 + 1] * b[i + j];
+			result[i + 2] += a[j * 4 + 2] * b[i + j];
+			result[i + 3] += a[j * 4 + 3] * b[i + j];
+		}
+	}
+#endif
+}
+
+/** Multiply the matrix with the 3x3 rotation matrix m, given in column-major order. */
+static inline void rotateMatrix(float *e, const float *m) {
+#ifdef TRANSMATRIX_USE_SSE
+	const __m128 e0 = _mm_loadu_ps(e + 0);
+	const __m128 e1 = _mm_loadu_ps(e + 4);
+	const __m128 e2 = _mm_loadu_ps(e + 8);
+
+	for (int i = 0; i < 3; i++) {
+		__m128 r =         _mm_mul_ps(e0, _mm_set1_ps(m[i * 3 + 0]));
+		r = _mm_add_ps(r,  _mm_mul_ps(e1, _mm_set1_ps(m[i * 3 + 1])));
+		r = _mm_add_ps(r,  _mm_mul_ps(e2, _mm_set1_ps(m[i * 3 + 2])));
+
+		_mm_storeu_ps(e + i * 4, r);
+	}
+#else
+	float result[12];
+	for (int i = 0; i < 4; i++) {
+		result[0 + i] = (e[i] * m[0]) + (e[i + 4] * m[1]) + (e[i + 8] * m[2]);
+		result[4 + i] = (e[i] * m[3]) + (e[i + 4] * m[4]) + (e[i + 8] * m[5]);
+		result[8 + i] = (e[i] * m[6]) + (e[i + 4] * m[7]) + (e[i + 8] * m[8]);
+	}
+
+	memcpy(e, result, 12 * sizeof(float));
+#endif
+}
+
+/** Build the 3x3 matrix of a rotation around a normalized axis, in column-major order. */
+static inline void createRotation(float *m, float angle, float x, float y, float z) {
+	const float cosa  = cos(angle);
+	const float sina  = sin(angle);
+	const float mcosa = 1.0f - cosa;
+
+	m[0] = (x * x * mcosa) + cosa;
+	m[1] = (x * y * mcosa) + (z * sina);
+	m[2] = (x * z * mcosa) - (y * sina);
+
+	m[3] = (x * y * mcosa) - (z * sina);
+	m[4] = (y * y * mcosa) + cosa;
+	m[5] = (y * z * mcosa) + (x * sina);
+
+	m[6] = (x * z * mcosa) + (y * sina);
+	m[7] = (y * z * mcosa) - (x * sina);
+	m[8] = (z * z * mcosa) + cosa;
+}
+
+/** result = m * (x, y, z, w). */
+static inline void transformVector(const float *m, float x, float y, float z, float w, float *result) {
+#ifdef TRANSMATRIX_USE_SSE
+	__m128 r =         _mm_mul_ps(_mm_loadu_ps(m +  0), _mm_set1_ps(x));
+	r = _mm_add_ps(r,  _mm_mul_ps(_mm_loadu_ps(m +  4), _mm_set1_ps(y)));
+	r = _mm_add_ps(r,  _mm_mul_ps(_mm_loadu_ps(m +  8), _mm_set1_ps(z)));
+	r = _mm_add_ps(r,  _mm_mul_ps(_mm_loadu_ps(m + 12), _mm_set1_ps(w)));
+
+	_mm_storeu_ps(result, r);
+#else
+	result[0] = m[0] * x + m[4] * y + m[ 8] * z + m[12] * w;
+	result[1] = m[1] * x + m[5] * y + m[ 9] * z + m[13] * w;
+	result[2] = m[2] * x + m[6] * y + m[10] * z + m[14] * w;
+	result[3] = m[3] * x + m[7] * y + m[11] * z + m[15] * w;
+#endif
+}
+
 namespace Common {
 
 TransformationMatrix::TransformationMatrix(bool identity) {
@@ -180,15 +287,10 @@ void TransformationMatrix::loadIdentity() {
 }
 
 void TransformationMatrix::translate(float x, float y, float z) {
-	float xx, yy, zz, ww;
-	xx = _elements[0] * x + _elements[4] * y + _elements[8]  * z + _elements[12];
-	yy = _elements[1] * x + _elements[5] * y + _elements[9]  * z + _elements[13];
-	zz = _elements[2] * x + _elements[6] * y + _elements[10] * z + _elements[14];
-	ww = _elements[3] * x + _elements[7] * y + _elements[11] * z + _elements[15];
-	_elements[12] = xx;
-	_elements[13] = yy;
-	_elements[14] = zz;
-	_elements[15] = ww;
+	float result[4];
+	transformVector(_elements, x, y, z, 1.0f, result);
+
+	memcpy(_elements + 12, result, 4 * sizeof(float));
 }
 
 void TransformationMatrix::translate(const Vector3 &v) {
@@ -198,15 +300,10 @@ void TransformationMatrix::translate(const Vector3 &v) {
 	 * If done, then _elements[15] should be set to 1.0f.
 	 * It can also be safely assumed that v._w is 1.0f, for further optimisations.
 	 */
-	float x, y, z, w;
-	x = _elements[0] * v._x + _elements[4] * v._y + _elements[8]  * v._z + _elements[12] * v._w;
-	y = _elements[1] * v._x + _elements[5] * v._y + _elements[9]  * v._z + _elements[13] * v._w;
-	z = _elements[2] * v._x + _elements[6] * v._y + _elements[10] * v._z + _elements[14] * v._w;
-	w = _elements[3] * v._x + _elements[7] * v._y + _elements[11] * v._z + _elements[15] * v._w;
-	_elements[12] = x;
-	_elements[13] = y;
-	_elements[14] = z;
-	_elements[15] = w;
+	float result[4];
+	transformVector(_elements, v._x, v._y, v._z, v._w, result);
+
+	memcpy(_elements + 12, result, 4 * sizeof(float));
 }
 
 void TransformationMatrix::scale(float x, float y, float z) {
@@ -261,72 +358,22 @@ void TransformationMatrix::rotate(float angle, float x, float y, float z, bool n
 		}
 	}
 
-	angle = deg2rad(angle);
-
-	/* Slightly optimised matrix calculation for generic rotation. Note that
-	 * SSE implementations might end up being faster, if implemented.
-	 */
-	float result[16];
-
-	float cosa  = cos(angle);
-	float sina  = sin(angle);
-	float mcosa = 1.0f - cosa;
-	float m0  = (x * x * mcosa) + cosa;
-	float m1  = (x * y * mcosa) + (z * sina);
-	float m2  = (x * z * mcosa) - (y * sina);
-
-	float m4  = (x * y * mcosa) - (z * sina);
-	float m5  = (y * y * mcosa) + cosa;
-	float m6  = (y * z * mcosa) + (x * sina);
+	float m[9];
+	createRotation(m, deg2rad(angle), x, y, z);
 
-	float m8  = (x * z * mcosa) + (y * sina);
-	float m9  = (y * z * mcosa) - (x * sina);
-	float m10 = (z * z * mcosa) + cosa;
-
-	for (int i = 0; i < 4; i++) {
-		result[0  + i] = (_elements[i] * m0) + (_elements[i + 4] * m1) + (_elements[i + 8] * m2);
-		result[4  + i] = (_elements[i] * m4) + (_elements[i + 4] * m5) + (_elements[i + 8] * m6);
-		result[8  + i] = (_elements[i] * m8) + (_elements[i + 4] * m9) + (_elements[i + 8] * m10);
-		result[12 + i] = (_elements[i + 12]);
-	}
-	memcpy(_elements, result, 16 * sizeof(float));  // Copy the rotation into the matrix.
+	rotateMatrix(_elements, m);
 }
 
 void TransformationMatrix::rotateAxisLocal(const Vector3 &vin, float angle, bool normalise) {
-	angle = deg2rad(angle);
-
-	/* Slightly optimised matrix calculation for generic rotation. Note that
-	 * SSE implementations might end up being faster, if implemented.
-	 */
-	float result[16];
-
 	Vector3 v(vin);
 	if (normalise) {
 		v.norm();
 	}
 
-	float cosa  = cos(angle);
-	float sina  = sin(angle);
-	float mcosa = 1.0f - cosa;
-	float m0  = (v._x * v._x * mcosa) + cosa;
-	float m1  = (v._x * v._y * mcosa) + (v._z * sina);
-	float m2  = (v._x * v._z * mcosa) - (v._y * sina);
-
-	float m4  = (v._x * v._y * mcosa) - (v._z * sina);
-	float m5  = (v._y * v._y * mcosa) + cosa;
-	float m6  = (v._y * v._z * mcosa) + (v._x * sina);
+	float m[9];
+	createRotation(m, deg2rad(angle), v._x, v._y, v._z);
 
-	float m8  = (v._x * v._z * mcosa) + (v._y * sina);
-	float m9  = (v._y * v._z * mcosa) - (v._x * sina);
-	float m10 = (v._z * v._z * mcosa) + cosa;
-
-	for (int i = 0; i < 4; i++) {
-		result[0  + i] = (_elements[i] * m0) + (_elements[i + 4] * m1) + (_elements[i + 8] * m2);
-		result[4  + i] = (_elements[i] * m4) + (_elements[i + 4] * m5) + (_elements[i + 8] * m6);
-		result[8  + i] = (_elements[i] * m8) + (_elements[i + 4] * m9) + (_elements[i + 8] * m10);
-		result[12 + i] = (_elements[i + 12]);
-	}
-	memcpy(_elements, result, 16 * sizeof(float));  // Copy the rotation into the matrix.
+	rotateMatrix(_elements, m);
 }
 
 void TransformationMatrix::rotateXAxisLocal(float angle, bool normalise) {
@@ -405,10 +452,6 @@ void TransformationMatrix::rotateZAxisLocal(float angle, bool normalise) {
 }
 
 void TransformationMatrix::rotateAxisWorld(const Vector3 &vin, float angle, bool normalise) {
-	angle = deg2rad(angle);
-
-	float result[16];
-
 	Vector3 v(vin._x * _elements[0] + vin._y * _elements[4] + vin._z * _elements[8],
 	          vin._x * _elements[1] + vin._y * _elements[5] + vin._z * _elements[9],
 	          vin._x * _elements[2] + vin._y * _elements[6] + vin._z * _elements[10]);
@@ -416,28 +459,10 @@ void TransformationMatrix::rotateAxisWorld(const Vector3 &vin, float angle, bool
 		v.norm();
 	}
 
-	float cosa  = cos(angle);
-	float sina  = sin(angle);
-	float mcosa = 1.0f - cosa;
-	float m0  = (v._x * v._x * mcosa) + cosa;
-	float m1  = (v._x * v._y * mcosa) + (v._z * sina);
-	float m2  = (v._x * v._z * mcosa) - (v._y * sina);
-
-	float m4  = (v._x * v._y * mcosa) - (v._z * sina);
-	float m5  = (v._y * v._y * mcosa) + cosa;
-	float m6  = (v._y * v._z * mcosa) + (v._x * sina);
+	float m[9];
+	createRotation(m, deg2rad(angle), v._x, v._y, v._z);
 
-	float m8  = (v._x * v._z * mcosa) + (v._y * sina);
-	float m9  = (v._y * v._z * mcosa) - (v._x * sina);
-	float m10 = (v._z * v._z * mcosa) + cosa;
-
-	for (int i = 0; i < 4; i++) {
-		result[0 + i]  = (_elements[i] * m0) + (_elements[i + 4] * m1) + (_elements[i + 8] * m2);
-		result[4 + i]  = (_elements[i] * m4) + (_elements[i + 4] * m5) + (_elements[i + 8] * m6);
-		result[8 + i]  = (_elements[i] * m8) + (_elements[i + 4] * m9) + (_elements[i + 8] * m10);
-		result[12 + i] = (_elements[i + 12]);
-	}
-	memcpy(_elements, result, 16 * sizeof(float));  // Copy the rotation into the matrix.
+	rotateMatrix(_elements, m);
 }
 
 void TransformationMatrix::rotateXAxisWorld(float angle, bool normalise) {
@@ -482,42 +507,16 @@ void TransformationMatrix::resetRotation() {
 
 void TransformationMatrix::transform(const TransformationMatrix &m) {
 	float result[16];
-	for (uint32 i = 0; i < 16; i+=4) {
-		// __m128 r, __m128 a, __m128 b
-		// a = _mm_load_ps(&_elements[0]);
-		// b = _mm_set1_ps(m[i]);
-		// r = _mm_mul_ps(a, b);
-		result[i + 0] = _elements[0 + 0] * m[i];
-		result[i + 1] = _elements[0 + 1] * m[i];
-		result[i + 2] = _elements[0 + 2] * m[i];
-		result[i + 3] = _elements[0 + 3] * m[i];
-		for (uint32 j= 1; j < 4; j++) {
-			// a = _mm_load_ps(&_elements[j<<2]);
-			// b = _mm_set1_ps(m[i+j]);
-			// r = _mm_add_ps(a, b);
-			result[i + 0] += _elements[j * 4 + 0] * m[i + j];
-			result[i + 1] += _elements[j * 4 + 1] * m[i + j];
-			result[i + 2] += _elements[j * 4 + 2] * m[i + j];
-			result[i + 3] += _elements[j * 4 + 3] * m[i + j];
-		}
-		// _mm_store_ps(&result[i], r);
-	}
+	multiplyMatrix(_elements, m._elements, result);
+
 	memcpy(_elements, result, 16 * sizeof(float));
 }
 
 void TransformationMatrix::transform(const TransformationMatrix &a, const TransformationMatrix &b) {
-	for (uint32 i = 0; i < 16; i+=4) {
-		_elements[i + 0] = a[0 + 0] * b[i];
-		_elements[i + 1] = a[0 + 1] * b[i];
-		_elements[i + 2] = a[0 + 2] * b[i];
-		_elements[i + 3] = a[0 + 3] * b[i];
-		for (uint32 j= 1; j < 4; j++) {
-			_elements[i + 0] += a[j * 4 + 0] * b[i + j];
-			_elements[i + 1] += a[j * 4 + 1] * b[i + j];
-			_elements[i + 2] += a[j * 4 + 2] * b[i + j];
-			_elements[i + 3] += a[j * 4 + 3] * b[i + j];
-		}
-	}
+	float result[16];
+	multiplyMatrix(a._elements, b._elements, result);
+
+	memcpy(_elements, result, 16 * sizeof(float));
 }
 
 TransformationMatrix TransformationMatrix::getInverse() {
@@ -675,10 +674,10 @@ TransformationMatrix TransformationMatrix::operator*(const TransformationMatrix
 }
 
 Vector3 TransformationMatrix::operator*(const Vector3 &v) const {
-	return Vector3(v._x * _elements[ 0] + v._y * _elements[ 4] + v._z * _elements[ 8] + v._w * _elements[12],
-	               v._x * _elements[ 1] + v._y * _elements[ 5] + v._z * _elements[ 9] + v._w * _elements[13],
-	               v._x * _elements[ 2] + v._y * _elements[ 6] + v._z * _elements[10] + v._w * _elements[14],
-	               v._x * _elements[ 3] + v._y * _elements[ 7] + v._z * _elements[11] + v._w * _elements[15]);
+	float result[4];
+	transformVector(_elements, v._x, v._y, v._z, v._w, result);
+
+	return Vector3(result[0], result[1], result[2], result[3]);
 }
 
 Vector3 TransformationMatrix::vectorRotate(Vector3 &v) const {
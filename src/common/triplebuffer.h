@@ -0,0 +1,116 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A lock-free triple buffer, for handing data from one thread to another.
+ */
+
+#ifndef COMMON_TRIPLEBUFFER_H
+#define COMMON_TRIPLEBUFFER_H
+
+#include "src/common/atomic.h"
+
+#include "src/common/types.h"
+#include "src/common/noncopyable.h"
+
+namespace Common {
+
+/** A lock-free single-producer, single-consumer triple buffer.
+ *
+ *  The producer (for example, the game thread) writes into the back
+ *  buffer and publishes it, the consumer (for example, the render thread)
+ *  picks up the most recently published buffer as its front buffer.
+ *  Neither side ever waits for the other: the producer can publish any
+ *  number of times in between two consumer updates, and the consumer
+ *  always sees a complete, consistent value.
+ *
+ *  Only one thread may call the producer methods (getBack(), publish()),
+ *  and only one thread may call the consumer methods (update(), getFront()).
+ */
+template<typename T>
+class TripleBuffer : NonCopyable {
+public:
+	TripleBuffer(const T &value = T()) : _state(1), _back(2), _front(0) {
+		_buffers[0] = value;
+		_buffers[1] = value;
+		_buffers[2] = value;
+	}
+
+	// .--- Producer ---.
+
+	/** Return the back buffer, to be filled by the producer. */
+	T &getBack() {
+		return _buffers[_back];
+	}
+
+	/** Publish the back buffer, making it available to the consumer. */
+	void publish() {
+		const uint8 old = _state.exchange(_back | kStateDirty, boost::memory_order_acq_rel);
+
+		_back = old & kStateIndex;
+	}
+
+	/** Copy a value into the back buffer and publish it. */
+	void publish(const T &value) {
+		_buffers[_back] = value;
+		publish();
+	}
+
+	// '--- Producer ---'
+
+	// .--- Consumer ---.
+
+	/** Pick up the most recently published value, if there is one.
+	 *
+	 *  @return true if the front buffer changed.
+	 */
+	bool update() {
+		if (!(_state.load(boost::memory_order_relaxed) & kStateDirty))
+			return false;
+
+		const uint8 old = _state.exchange(_front, boost::memory_order_acq_rel);
+
+		_front = old & kStateIndex;
+		return true;
+	}
+
+	/** Return the front buffer, as seen by the consumer. */
+	const T &getFront() const {
+		return _buffers[_front];
+	}
+
+	// '--- Consumer ---'
+
+private:
+	static const uint8 kStateIndex = 0x03; ///< Mask for the index of the middle buffer.
+	static const uint8 kStateDirty = 0x04; ///< The middle buffer holds an unread value.
+
+	T _buffers[3];
+
+	/** Index of the middle buffer, plus the dirty flag. */
+	boost::atomic<uint8> _state;
+
+	uint8 _back;  ///< Index of the buffer the producer is writing to.
+	uint8 _front; ///< Index of the buffer the consumer is reading from.
+};
+
+} // End of namespace Common
+
+#endif // COMMON_TRIPLEBUFFER_H
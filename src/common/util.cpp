@@ -247,3 +247,56 @@ float readIEEEFloat16(uint16 value) {
 	return convertIEEEFloat(fS | fE | fM);
 }
 // '--- Convert IEEE float16 to IEEE float32, based on code by James Tursa ---'
+
+/* Convert a float32 into a float16.
+ *
+ * Values too large for a float16 become (-)Inf, values too small become
+ * denormalized float16 numbers or (-)0.0. The mantissa is rounded to the
+ * nearest value, with ties going to the even one. A carry out of the
+ * mantissa correctly increases the exponent.
+ */
+uint16 writeIEEEFloat16(float value) {
+	const uint32 data = convertIEEEFloat(value);
+
+	const uint16 vS = (data >> 16) & 0x8000;   // float16 sign
+	const uint32 fE = (data >> 23) & 0xFF;     // float32 exponent
+	uint32       fM =  data        & 0x7FFFFF; // float32 mantissa
+
+	// Check for (-)Inf and NaN
+	if (fE == 0xFF)
+		return vS | 0x7C00 | ((fM != 0) ? 0x0200 : 0x0000);
+
+	// Rebias the exponent
+	const int32 vE = ((int32) fE) - 127 + 15;
+
+	// Too large, becomes (-)Inf
+	if (vE >= 0x1F)
+		return vS | 0x7C00;
+
+	if (vE <= 0) {
+		// Too small even for a denormalized float16, becomes (-)0.0
+		if (vE < -10)
+			return vS;
+
+		// Denormalized float16: shift the mantissa, including the implicit bit, into place
+		fM |= 0x800000;
+
+		const uint32 shift   = 14 - vE;
+		const uint32 rest    = fM & ((1 << shift) - 1);
+		const uint32 halfway = 1 << (shift - 1);
+
+		uint32 vM = fM >> shift;
+		if ((rest > halfway) || ((rest == halfway) && (vM & 1)))
+			vM++;
+
+		return vS | vM;
+	}
+
+	uint32 v = (((uint32) vE) << 10) | (fM >> 13);
+
+	const uint32 rest = fM & 0x1FFF;
+	if ((rest > 0x1000) || ((rest == 0x1000) && (v & 1)))
+		v++;
+
+	return vS | v;
+}
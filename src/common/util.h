@@ -140,4 +140,7 @@ double readNintendoFixedPoint(uint32 value, bool sign, uint8 iBits, uint8 fBits)
 /** Read a half-precision 16-bit IEEE float, converting it into a 32-bit iEEE float. */
 float readIEEEFloat16(uint16 value);
 
+/** Convert a 32-bit IEEE float into a half-precision 16-bit IEEE float, rounding to nearest even. */
+uint16 writeIEEEFloat16(float value);
+
 #endif // COMMON_UTIL_H
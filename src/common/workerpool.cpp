@@ -0,0 +1,194 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A pool of worker threads.
+ */
+
+#include <SDL_cpuinfo.h>
+
+#include "src/common/workerpool.h"
+#include "src/common/thread.h"
+#include "src/common/error.h"
+#include "src/common/util.h"
+#include "src/common/configman.h"
+
+DECLARE_SINGLETON(Common::WorkerPool)
+
+namespace Common {
+
+/** Never automatically start more workers than this.
+ *
+ *  Without an explicit "workerthreads" value, the pool starts one worker less
+ *  than there are CPUs, but at least one and at most this many. More workers
+ *  hardly help with reading and decompressing resources, which is the main
+ *  use of the pool, and only cost memory and contention on the archive files.
+ *  An explicit "workerthreads" value is not capped.
+ */
+static const int kMaxAutoWorkers = 8;
+
+/** How long a worker waits for a job before checking whether it should quit, in ms. */
+static const uint32 kWorkerWaitTime = 100;
+
+class WorkerPool::Worker : public Thread {
+public:
+	Worker(WorkerPool &pool) : _pool(&pool) {
+	}
+
+	~Worker() {
+		destroyThread();
+	}
+
+private:
+	WorkerPool *_pool;
+
+	void threadMethod() {
+		while (!_killThread)
+			if (_pool->_queued.lock(kWorkerWaitTime))
+				_pool->runNext();
+	}
+};
+
+struct WorkerPool::Batch {
+	Semaphore done; ///< Unlocked once for every finished job.
+
+	Mutex mutex;
+	bool failed;
+	Exception exception;
+
+	Batch() : failed(false) {
+	}
+
+	void fail(const Exception &e) {
+		StackLock lock(mutex);
+
+		if (failed)
+			return;
+
+		failed    = true;
+		exception = e;
+	}
+};
+
+
+WorkerPool::WorkerPool() : _started(false) {
+}
+
+WorkerPool::~WorkerPool() {
+	for (std::vector<Worker *>::iterator w = _workers.begin(); w != _workers.end(); ++w)
+		delete *w;
+}
+
+size_t WorkerPool::getWorkerCount() {
+	start();
+
+	return _workers.size();
+}
+
+void WorkerPool::start() {
+	StackLock lock(_mutex);
+
+	if (_started)
+		return;
+
+	_started = true;
+
+	int count = ConfigMan.getInt("workerthreads", -1);
+	if (count < 0)
+		count = CLIP(SDL_GetCPUCount() - 1, 1, kMaxAutoWorkers);
+
+	for (int i = 0; i < count; i++) {
+		Worker *worker = new Worker(*this);
+
+		if (!worker->createThread()) {
+			warning("Failed to start worker thread %d", i);
+
+			delete worker;
+			break;
+		}
+
+		_workers.push_back(worker);
+	}
+}
+
+void WorkerPool::run(const std::vector<Job> &jobs) {
+	if (jobs.empty())
+		return;
+
+	start();
+
+	Batch batch;
+
+	_mutex.lock();
+	for (std::vector<Job>::const_iterator j = jobs.begin(); j != jobs.end(); ++j) {
+		QueuedJob job;
+
+		job.job   = &*j;
+		job.batch = &batch;
+
+		_queue.push_back(job);
+	}
+	_mutex.unlock();
+
+	if (!_workers.empty())
+		for (size_t i = 0; i < jobs.size(); i++)
+			_queued.unlock();
+
+	// Help out instead of idly waiting
+	while (runNext())
+		;
+
+	// Wait for the jobs the workers are still busy with
+	for (size_t i = 0; i < jobs.size(); i++)
+		batch.done.lock();
+
+	if (batch.failed)
+		throw batch.exception;
+}
+
+bool WorkerPool::runNext() {
+	QueuedJob job;
+
+	{
+		StackLock lock(_mutex);
+
+		if (_queue.empty())
+			return false;
+
+		job = _queue.front();
+		_queue.pop_front();
+	}
+
+	try {
+		(*job.job)();
+	} catch (Exception &e) {
+		job.batch->fail(e);
+	} catch (std::exception &e) {
+		job.batch->fail(Exception(e));
+	} catch (...) {
+		job.batch->fail(Exception("Unknown exception in worker job"));
+	}
+
+	job.batch->done.unlock();
+
+	return true;
+}
+
+} // End of namespace Common
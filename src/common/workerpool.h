@@ -0,0 +1,95 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A pool of worker threads.
+ */
+
+#ifndef COMMON_WORKERPOOL_H
+#define COMMON_WORKERPOOL_H
+
+#include <list>
+#include <vector>
+
+#include <boost/function.hpp>
+
+#include "src/common/types.h"
+#include "src/common/singleton.h"
+#include "src/common/mutex.h"
+
+namespace Common {
+
+/** A pool of worker threads that run batches of independent jobs.
+ *
+ *  The workers are only started when the first batch is run. Their number
+ *  is taken from the "workerthreads" config option; by default, there's one
+ *  worker for every CPU core but one, up to 8. With 0 workers, all jobs run
+ *  on the calling thread.
+ */
+class WorkerPool : public Singleton<WorkerPool> {
+public:
+	/** A job to run. */
+	typedef boost::function<void ()> Job;
+
+	WorkerPool();
+	~WorkerPool();
+
+	/** Return the number of worker threads, starting them if necessary. */
+	size_t getWorkerCount();
+
+	/** Run all these jobs concurrently, and return once all of them are done.
+	 *
+	 *  The calling thread helps running jobs while it waits. If any job
+	 *  throws, the first exception is thrown again here, after all other
+	 *  jobs in the batch have finished.
+	 */
+	void run(const std::vector<Job> &jobs);
+
+private:
+	class Worker;
+	struct Batch;
+
+	struct QueuedJob {
+		const Job *job;
+		Batch *batch;
+	};
+
+	Mutex _mutex;     ///< Protects the job queue and the workers.
+	Semaphore _queued; ///< Wakes up a worker for each queued job.
+
+	std::list<QueuedJob> _queue;
+
+	bool _started;
+	std::vector<Worker *> _workers;
+
+	void start();
+
+	/** Take the next job out of the queue and run it. Return false if the queue was empty. */
+	bool runNext();
+
+	friend class Worker;
+};
+
+} // End of namespace Common
+
+/** Shortcut for accessing the worker pool. */
+#define WorkerPoolMan Common::WorkerPool::instance()
+
+#endif // COMMON_WORKERPOOL_H
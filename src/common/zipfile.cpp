@@ -29,6 +29,7 @@
 #include "src/common/util.h"
 #include "src/common/encoding.h"
 #include "src/common/memreadstream.h"
+#include "src/common/inflatestream.h"
 
 #include <zlib.h>
 
@@ -134,28 +135,32 @@ const ZipFile::IFile &ZipFile::getIFile(uint32 index) const {
 }
 
 void ZipFile::getFileProperties(SeekableReadStream &zip, const IFile &file,
-		uint16 &compMethod, uint32 &compSize, uint32 &realSize) const {
+		uint16 &compMethod, uint32 &compSize, uint32 &realSize, size_t &dataOffset) const {
 
-	zip.seek(file.offset);
+	/* Read the local file header in one go and without touching the stream
+	 * position, so that several threads can pull files out of the same archive. */
 
-	uint32 tag = zip.readUint32LE();
-	if (tag != 0x04034B50)
-		throw Exception("Unknown ZIP record %08X", tag);
+	static const size_t kLocalHeaderSize = 30;
 
-	zip.skip(4);
+	byte header[kLocalHeaderSize];
+	if (zip.readAt(file.offset, header, kLocalHeaderSize) != kLocalHeaderSize)
+		throw Exception(kReadError);
 
-	compMethod = zip.readUint16LE();
+	uint32 tag = READ_LE_UINT32(header);
+	if (tag != 0x04034B50)
+		throw Exception("Unknown ZIP record %08X", tag);
 
-	zip.skip(8);
+	compMethod = READ_LE_UINT16(header +  8);
 
-	compSize = zip.readUint32LE();
-	realSize = zip.readUint32LE();
+	compSize   = READ_LE_UINT32(header + 18);
+	realSize   = READ_LE_UINT32(header + 22);
 
-	uint16 nameLength  = zip.readUint16LE();
-	uint16 extraLength = zip.readUint16LE();
+	uint16 nameLength  = READ_LE_UINT16(header + 26);
+	uint16 extraLength = READ_LE_UINT16(header + 28);
 
-	zip.skip(nameLength);
-	zip.skip(extraLength);
+	dataOffset = file.offset + kLocalHeaderSize + nameLength + extraLength;
+	if ((dataOffset + compSize) > zip.size())
+		throw Exception(kReadError);
 }
 
 size_t ZipFile::getFileSize(uint32 index) const {
@@ -169,32 +174,42 @@ SeekableReadStream *ZipFile::getFile(uint32 index, bool tryNoCopy) const {
 	uint32 compSize;
 	uint32 realSize;
 
-	getFileProperties(*_zip, file, compMethod, compSize, realSize);
+	size_t dataOffset;
+
+	getFileProperties(*_zip, file, compMethod, compSize, realSize, dataOffset);
 
 	if (tryNoCopy && (compMethod == 0))
-		return new SeekableSubReadStream(_zip, _zip->pos(), _zip->pos() + compSize);
+		return new PositionalSubReadStream(_zip, dataOffset, dataOffset + compSize);
+
+	return decompressFile(*_zip, dataOffset, compMethod, compSize, realSize);
+}
 
-	return decompressFile(*_zip, compMethod, compSize, realSize);
+bool ZipFile::canGetFilesConcurrently() const {
+	return _zip->canReadAtConcurrently();
 }
 
-SeekableReadStream *ZipFile::decompressFile(SeekableReadStream &zip, uint32 method,
+SeekableReadStream *ZipFile::decompressFile(SeekableReadStream &zip, size_t offset, uint32 method,
 		uint32 compSize, uint32 realSize) {
 
 	if (method == 0) {
 		// Uncompressed
 
-		return zip.readStream(compSize);
+		return zip.readStreamAt(offset, compSize);
 	}
 
 	if (method != 8)
 		throw Exception("Unhandled Zip compression %d", method);
 
+	// Inflate big files on demand, to keep the memory footprint down
+	if (realSize >= InflateReadStream::kStreamingThreshold)
+		return new InflateReadStream(zip.readStreamAt(offset, compSize), realSize, MAX_WBITS, true);
+
 	// Allocate the decompressed data
 	byte *decompressedData = new byte[realSize];
 
 	// Read in the compressed data
 	byte *compressedData = new byte[compSize];
-	if (zip.read(compressedData, compSize) != compSize) {
+	if (zip.readAt(offset, compressedData, compSize) != compSize) {
 		delete[] decompressedData;
 		delete[] compressedData;
 
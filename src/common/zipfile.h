@@ -58,6 +58,9 @@ public:
 	/** Return a stream of the files's contents. */
 	SeekableReadStream *getFile(uint32 index, bool tryNoCopy = false) const;
 
+	/** Can files be read from several threads at the same time? */
+	bool canGetFilesConcurrently() const;
+
 private:
 	/** Internal file information. */
 	struct IFile {
@@ -78,12 +81,12 @@ private:
 	void load(SeekableReadStream &zip);
 	size_t findCentralDirectoryEnd(SeekableReadStream &zip);
 
-	static SeekableReadStream *decompressFile(SeekableReadStream &zip, uint32 method,
+	static SeekableReadStream *decompressFile(SeekableReadStream &zip, size_t offset, uint32 method,
 			uint32 compSize, uint32 realSize);
 
 	const IFile &getIFile(uint32 index) const;
 	void getFileProperties(SeekableReadStream &zip, const IFile &file,
-			uint16 &compMethod, uint32 &compSize, uint32 &realSize) const;
+			uint16 &compMethod, uint32 &compSize, uint32 &realSize, size_t &dataOffset) const;
 };
 
 } // End of namespace Common
@@ -39,16 +39,19 @@
 
 #include "src/graphics/graphics.h"
 #include "src/graphics/font.h"
+#include "src/graphics/vertexbuffer.h"
 
 #include "src/sound/sound.h"
 
 #include "src/events/events.h"
 
 #include "src/graphics/aurora/textureman.h"
+#include "src/graphics/aurora/guibatchman.h"
 #include "src/graphics/aurora/cursorman.h"
 #include "src/graphics/aurora/fontman.h"
 #include "src/graphics/aurora/text.h"
 #include "src/graphics/aurora/guiquad.h"
+#include "src/graphics/aurora/staticgeometry.h"
 
 #include "src/engines/engine.h"
 
@@ -742,6 +745,13 @@ Console::Console(Engine &engine, const Common::UString &font, int fontHeight) :
 			"Usage: setoption <option> <value>\nSet the value of a config option for this session");
 	registerCommand("showfps"    , boost::bind(&Console::cmdShowFPS    , this, _1),
 			"Usage: showfps <true/false>\nShow/Hide the frames-per-second display");
+	registerCommand("vertexmem"  , boost::bind(&Console::cmdVertexMem  , this, _1),
+			"Usage: vertexmem\nPrint the memory used by vertex data");
+	registerCommand("texmem"     , boost::bind(&Console::cmdTexMem     , this, _1),
+			"Usage: texmem [<budget>]\nPrint the memory used by textures. If a budget in MiB\n"
+			"is given, set the texture memory budget. 0 means unlimited");
+	registerCommand("guistats"   , boost::bind(&Console::cmdGUIStats   , this, _1),
+			"Usage: guistats\nPrint how long rendering the GUI took in the last frame");
 	registerCommand("listlangs"  , boost::bind(&Console::cmdListLangs  , this, _1),
 			"Usage: listlangs\nLists all languages supported by this game version");
 	registerCommand("getlang"    , boost::bind(&Console::cmdGetLang    , this, _1),
@@ -1320,6 +1330,49 @@ void Console::cmdShowFPS(const CommandLine &cl) {
 	_engine->showFPS();
 }
 
+void Console::cmdVertexMem(const CommandLine &UNUSED(cl)) {
+	const uint64 total = Graphics::VertexBuffer::getTotalMemory();
+	const uint64 saved = Graphics::VertexBuffer::getPackedSavings();
+
+	printf("Vertex data: %.2f MiB", total / (1024.0 * 1024.0));
+	printf("Saved by compact vertex formats: %.2f MiB (\"packvertices\" is %s)",
+	       saved / (1024.0 * 1024.0), ConfigMan.getBool("packvertices", true) ? "on" : "off");
+}
+
+void Console::cmdTexMem(const CommandLine &cl) {
+	if (!cl.args.empty()) {
+		uint32 budget = 0;
+		try {
+			Common::parseString(cl.args, budget);
+		} catch (...) {
+			printCommandHelp(cl.cmd);
+			return;
+		}
+
+		TextureMan.setBudget(budget * 1024ULL * 1024ULL);
+	}
+
+	const uint64 budget = TextureMan.getBudget();
+
+	printf("Resident textures: %.2f MiB", TextureMan.getResidentSize() / (1024.0 * 1024.0));
+	if (budget == 0)
+		printf("Budget: unlimited");
+	else
+		printf("Budget: %.2f MiB", budget / (1024.0 * 1024.0));
+
+	printf("Textures with dropped mip levels: %u", (uint) TextureMan.getReducedCount());
+	printf("Mip levels dropped: %u, restored: %u",
+	       (uint) TextureMan.getEvictionCount(), (uint) TextureMan.getRestoreCount());
+}
+
+void Console::cmdGUIStats(const CommandLine &UNUSED(cl)) {
+	printf("GUI rendering: %.3f ms, %u quads batched into %u draw calls",
+	       GfxMan.getGUIFrameTime() / 1000.0, GUIBatchMan.getQuadCount(), GUIBatchMan.getDrawCallCount());
+	printf("GUI texture atlas: %u textures in %u pages (\"guiatlas\" is %s)",
+	       (uint) GUIBatchMan.getAtlasTextureCount(), (uint) GUIBatchMan.getAtlasPageCount(),
+	       ConfigMan.getBool("guiatlas", true) ? "on" : "off");
+}
+
 void Console::cmdListLangs(const CommandLine &UNUSED(cl)) {
 	std::vector<Aurora::Language> langs;
 	if (_engine->detectLanguages(langs)) {
@@ -1427,6 +1480,24 @@ void Console::printFullHelp() {
 	printList(commands, maxSize);
 }
 
+void Console::printStaticGeometryStats(const Graphics::Aurora::StaticGeometry &geometry) {
+	printf("Static geometry: %u nodes, merged into %u batches of %u materials, with %u triangles",
+	       (uint) geometry.getNodeCount(), (uint) geometry.getBatchCount(),
+	       (uint) geometry.getMaterialCount(), (uint) geometry.getTriangleCount());
+
+	printf("Last frame: %u batches drawn in %u draw calls, %u world objects drawn and %u culled",
+	       geometry.getDrawnBatchCount(), geometry.getDrawCallCount(),
+	       GfxMan.getDrawnObjectCount(), GfxMan.getCulledObjectCount());
+
+	/* Without batching, every node drawn within a batch would have been a draw call
+	 * of its own. The counts are sampled while rendering, so they might be off by a
+	 * frame against each other. */
+	const uint32 drawCalls = MAX(GfxMan.getWorldDrawCallCount(), geometry.getDrawCallCount());
+	const uint32 unbatched = drawCalls - geometry.getDrawCallCount() + geometry.getDrawnNodeCount();
+
+	printf("Last frame: %u world draw calls, %u without batching", drawCalls, unbatched);
+}
+
 void Console::printList(const std::list<Common::UString> &list, size_t maxSize) {
 	const size_t columns = getColumns();
 
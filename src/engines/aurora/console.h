@@ -222,6 +222,8 @@ protected:
 
 	void printCommandHelp(const Common::UString &cmd);
 	void printList(const std::list<Common::UString> &list, size_t maxSize = 0);
+	/** Print the size of an area's batched static geometry and how much of it was drawn. */
+	void printStaticGeometryStats(const Graphics::Aurora::StaticGeometry &geometry);
 
 	void setArguments(const Common::UString &cmd, const std::list<Common::UString> &args);
 	void setArguments(const Common::UString &cmd);
@@ -294,6 +296,9 @@ private:
 	void cmdGetOption  (const CommandLine &cl);
 	void cmdSetOption  (const CommandLine &cl);
 	void cmdShowFPS    (const CommandLine &cl);
+	void cmdVertexMem  (const CommandLine &cl);
+	void cmdTexMem     (const CommandLine &cl);
+	void cmdGUIStats   (const CommandLine &cl);
 	void cmdListLangs  (const CommandLine &cl);
 	void cmdGetLang    (const CommandLine &cl);
 	void cmdSetLang    (const CommandLine &cl);
@@ -22,6 +22,11 @@
  *  An abstract Aurora model loader.
  */
 
+#include <boost/shared_ptr.hpp>
+
+#include "src/common/system.h"
+#include "src/common/error.h"
+
 #include "src/graphics/aurora/model.h"
 
 #include "src/engines/aurora/modelloader.h"
@@ -36,4 +41,43 @@ void ModelLoader::free(Graphics::Aurora::Model *&model) {
 	model = 0;
 }
 
+Graphics::Aurora::Model *ModelLoader::loadInstance(const Common::UString &resref,
+		Graphics::Aurora::ModelType type, const Common::UString &texture) {
+
+	const Common::UString key = Common::UString::format("%s|%d|%s",
+			resref.toLower().c_str(), (int) type, texture.toLower().c_str());
+
+	TemplateMap::iterator t = _templates.find(key);
+	if (t != _templates.end()) {
+		boost::shared_ptr<Graphics::Aurora::Model> modelTemplate = t->second.lock();
+		if (modelTemplate)
+			return new Graphics::Aurora::Model(modelTemplate);
+	}
+
+	boost::shared_ptr<Graphics::Aurora::Model> modelTemplate(loadTemplate(resref, type, texture));
+
+	/* Loading a template is far more expensive than walking the map, so
+	 * take this chance to drop the templates whose instances are all gone. */
+	removeExpiredTemplates();
+
+	_templates[key] = modelTemplate;
+
+	return new Graphics::Aurora::Model(modelTemplate);
+}
+
+void ModelLoader::removeExpiredTemplates() {
+	for (TemplateMap::iterator t = _templates.begin(); t != _templates.end(); ) {
+		if (t->second.expired())
+			_templates.erase(t++);
+		else
+			++t;
+	}
+}
+
+Graphics::Aurora::Model *ModelLoader::loadTemplate(const Common::UString &resref,
+		Graphics::Aurora::ModelType UNUSED(type), const Common::UString &UNUSED(texture)) {
+
+	throw Common::Exception("Model templates not supported for model \"%s\"", resref.c_str());
+}
+
 } // End of namespace Engines
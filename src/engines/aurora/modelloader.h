@@ -25,11 +25,13 @@
 #ifndef ENGINES_AURORA_MODELLOADER_H
 #define ENGINES_AURORA_MODELLOADER_H
 
-#include "src/graphics/aurora/types.h"
+#include <map>
+
+#include <boost/weak_ptr.hpp>
 
-namespace Common {
-	class UString;
-}
+#include "src/common/ustring.h"
+
+#include "src/graphics/aurora/types.h"
 
 namespace Engines {
 
@@ -40,6 +42,28 @@ public:
 	virtual Graphics::Aurora::Model *load(const Common::UString &resref,
 			Graphics::Aurora::ModelType type, const Common::UString &texture) = 0;
 	virtual void free(Graphics::Aurora::Model *&model);
+
+protected:
+	/** Create a new instance of a model.
+	 *
+	 *  All instances of the same model, type and texture share one template,
+	 *  which is loaded through loadTemplate() when no instance of it exists.
+	 */
+	Graphics::Aurora::Model *loadInstance(const Common::UString &resref,
+			Graphics::Aurora::ModelType type, const Common::UString &texture);
+
+	/** Load a model that serves as a template for loadInstance(). */
+	virtual Graphics::Aurora::Model *loadTemplate(const Common::UString &resref,
+			Graphics::Aurora::ModelType type, const Common::UString &texture);
+
+private:
+	typedef std::map<Common::UString, boost::weak_ptr<Graphics::Aurora::Model> > TemplateMap;
+
+	/** All model templates that still have living instances. */
+	TemplateMap _templates;
+
+	/** Remove the entries of all templates without any living instances. */
+	void removeExpiredTemplates();
 };
 
 } // End of namespace Engines
@@ -28,6 +28,8 @@
 
 #include "src/aurora/resman.h"
 
+#include "src/graphics/aurora/guibatchman.h"
+
 #include "src/events/events.h"
 
 #include "src/engines/aurora/resources.h"
@@ -76,6 +78,9 @@ bool indexOptionalDirectory(const Common::UString &dir, const char *glob, int de
 
 void deindexResources(Common::ChangeID &changeID) {
 	ResMan.undo(changeID);
+
+	// The GUI atlas might hold textures from the resources we just removed
+	GUIBatchMan.clear();
 }
 
 } // End of namespace Engines
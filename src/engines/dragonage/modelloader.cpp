@@ -39,6 +39,12 @@ namespace DragonAge {
 Graphics::Aurora::Model *DragonAgeModelLoader::load(const Common::UString &resref,
 		Graphics::Aurora::ModelType type, const Common::UString &UNUSED(texture)) {
 
+	return loadInstance(resref, type, "");
+}
+
+Graphics::Aurora::Model *DragonAgeModelLoader::loadTemplate(const Common::UString &resref,
+		Graphics::Aurora::ModelType type, const Common::UString &UNUSED(texture)) {
+
 	return new Graphics::Aurora::Model_DragonAge(resref, type);
 }
 
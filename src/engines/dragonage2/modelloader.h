@@ -35,6 +35,10 @@ class DragonAge2ModelLoader : public ModelLoader {
 public:
 	Graphics::Aurora::Model *load(const Common::UString &resref,
 			Graphics::Aurora::ModelType type, const Common::UString &texture);
+
+protected:
+	Graphics::Aurora::Model *loadTemplate(const Common::UString &resref,
+			Graphics::Aurora::ModelType type, const Common::UString &texture);
 };
 
 } // End of namespace DragonAge2
@@ -45,6 +45,7 @@
 #include "src/graphics/aurora/cursorman.h"
 #include "src/graphics/aurora/fontman.h"
 #include "src/graphics/aurora/textureman.h"
+#include "src/graphics/aurora/guibatchman.h"
 
 #include "src/events/events.h"
 #include "src/events/requests.h"
@@ -290,6 +291,7 @@ void EngineManager::cleanup() const {
 
 		FontMan.clear();
 		CursorMan.clear();
+		GUIBatchMan.clear();
 		TextureMan.clear();
 
 		TokenMan.clear();
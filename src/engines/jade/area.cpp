@@ -35,6 +35,7 @@
 #include "src/graphics/renderable.h"
 
 #include "src/graphics/aurora/cursorman.h"
+#include "src/graphics/aurora/staticgeometry.h"
 
 #include "src/engines/aurora/resources.h"
 
@@ -46,7 +47,8 @@ namespace Engines {
 
 namespace Jade {
 
-Area::Area() : _loaded(false), _visible(false), _activeObject(0), _highlightAll(false) {
+Area::Area() : _loaded(false), _visible(false), _staticGeometry(0), _activeObject(0),
+	_highlightAll(false) {
 }
 
 Area::~Area() {
@@ -69,6 +71,9 @@ void Area::show() {
 	for (RoomList::iterator r = _rooms.begin(); r != _rooms.end(); ++r)
 		(*r)->show();
 
+	if (_staticGeometry)
+		_staticGeometry->show();
+
 	// Show objects
 	for (ObjectList::iterator o = _objects.begin(); o != _objects.end(); ++o)
 		(*o)->show();
@@ -91,8 +96,11 @@ void Area::hide() {
 		(*o)->hide();
 
 	// Hide rooms
+	if (_staticGeometry)
+		_staticGeometry->hide();
+
 	for (RoomList::iterator r = _rooms.begin(); r != _rooms.end(); ++r)
-		(*r)->show();
+		(*r)->hide();
 
 	GfxMan.unlockFrame();
 
@@ -166,6 +174,15 @@ void Area::loadRooms() {
 	const Aurora::LYTFile::RoomArray &rooms = _lyt.getRooms();
 	for (size_t i = 0; i < rooms.size(); i++)
 		_rooms.push_back(new Room(rooms[i].model, i, rooms[i].x, rooms[i].y, rooms[i].z));
+
+	// Merge the static parts of all rooms into batches
+	_staticGeometry = new Graphics::Aurora::StaticGeometry;
+
+	for (RoomList::iterator r = _rooms.begin(); r != _rooms.end(); ++r)
+		if ((*r)->getModel())
+			_staticGeometry->add(*(*r)->getModel());
+
+	_staticGeometry->build();
 }
 
 void Area::loadObject(Object &object) {
@@ -195,6 +212,9 @@ void Area::unload() {
 	for (ObjectList::iterator o = _objects.begin(); o != _objects.end(); ++o)
 		delete *o;
 
+	delete _staticGeometry;
+	_staticGeometry = 0;
+
 	for (RoomList::iterator r = _rooms.begin(); r != _rooms.end(); ++r)
 		delete *r;
 
@@ -36,6 +36,8 @@
 #include "src/aurora/lytfile.h"
 #include "src/aurora/visfile.h"
 
+#include "src/graphics/aurora/types.h"
+
 #include "src/events/types.h"
 #include "src/events/notifyable.h"
 
@@ -90,6 +92,9 @@ private:
 
 	RoomList _rooms;
 
+	/** The static geometry of all rooms, merged into batches. */
+	Graphics::Aurora::StaticGeometry *_staticGeometry;
+
 	ObjectList _objects;
 	ObjectMap  _objectMap;
 
@@ -121,6 +126,8 @@ private:
 	Object *getObjectAt(int x, int y);
 
 	void highlightAll(bool enabled);
+
+	friend class Console;
 };
 
 } // End of namespace Jade
@@ -33,10 +33,12 @@
 #include "src/aurora/resman.h"
 
 #include "src/graphics/aurora/types.h"
+#include "src/graphics/aurora/staticgeometry.h"
 
 #include "src/engines/jade/console.h"
 #include "src/engines/jade/jade.h"
 #include "src/engines/jade/module.h"
+#include "src/engines/jade/area.h"
 
 namespace Engines {
 
@@ -52,6 +54,8 @@ Console::Console(JadeEngine &engine) :
 			"Usage: listmodules\nList all modules");
 	registerCommand("loadmodule" , boost::bind(&Console::cmdLoadModule , this, _1),
 			"Usage: loadmodule <module>\nLoad and enter the specified module");
+	registerCommand("areastats"  , boost::bind(&Console::cmdAreaStats  , this, _1),
+			"Usage: areastats\nShow rendering statistics of the current area");
 }
 
 Console::~Console() {
@@ -112,6 +116,20 @@ void Console::cmdLoadModule(const CommandLine &cl) {
 	printf("No such module \"%s\"", cl.args.c_str());
 }
 
+void Console::cmdAreaStats(const CommandLine &UNUSED(cl)) {
+	Module *module = _engine->getModule();
+	if (!module)
+		return;
+
+	Area *area = module->getCurrentArea();
+	if (!area || !area->_staticGeometry) {
+		printf("No area loaded");
+		return;
+	}
+
+	printStaticGeometryStats(*area->_staticGeometry);
+}
+
 } // End of namespace Jade
 
 } // End of namespace Engines
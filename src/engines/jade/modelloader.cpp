@@ -38,6 +38,12 @@ namespace Jade {
 Graphics::Aurora::Model *JadeModelLoader::load(const Common::UString &resref,
 		Graphics::Aurora::ModelType type, const Common::UString &texture) {
 
+	return loadInstance(resref, type, texture);
+}
+
+Graphics::Aurora::Model *JadeModelLoader::loadTemplate(const Common::UString &resref,
+		Graphics::Aurora::ModelType type, const Common::UString &texture) {
+
 	return new Graphics::Aurora::Model_Jade(resref, type, texture);
 }
 
@@ -75,6 +75,10 @@ void Room::hide() {
 		_model->hide();
 }
 
+Graphics::Aurora::Model *Room::getModel() const {
+	return _model;
+}
+
 } // End of namespace Jade
 
 } // End of namespace Engines
@@ -41,6 +41,9 @@ public:
 	void show();
 	void hide();
 
+	/** Return the room's model, or 0 if the room has none. */
+	Graphics::Aurora::Model *getModel() const;
+
 private:
 	Common::ChangeID _resources;
 	Graphics::Aurora::Model *_model;
@@ -38,6 +38,7 @@
 #include "src/graphics/renderable.h"
 
 #include "src/graphics/aurora/cursorman.h"
+#include "src/graphics/aurora/staticgeometry.h"
 
 #include "src/sound/sound.h"
 
@@ -53,7 +54,8 @@ namespace Engines {
 
 namespace KotOR {
 
-Area::Area() : _loaded(false), _visible(false), _activeObject(0), _highlightAll(false) {
+Area::Area() : _loaded(false), _visible(false), _staticGeometry(0), _activeObject(0),
+	_highlightAll(false) {
 }
 
 Area::~Area() {
@@ -118,6 +120,9 @@ void Area::show() {
 	for (RoomList::iterator r = _rooms.begin(); r != _rooms.end(); ++r)
 		(*r)->show();
 
+	if (_staticGeometry)
+		_staticGeometry->show();
+
 	// Show objects
 	for (ObjectList::iterator o = _objects.begin(); o != _objects.end(); ++o)
 		(*o)->show();
@@ -144,6 +149,9 @@ void Area::hide() {
 		(*o)->hide();
 
 	// Hide rooms
+	if (_staticGeometry)
+		_staticGeometry->hide();
+
 	for (RoomList::iterator r = _rooms.begin(); r != _rooms.end(); ++r)
 		(*r)->hide();
 
@@ -278,6 +286,15 @@ void Area::loadRooms() {
 	const Aurora::LYTFile::RoomArray &rooms = _lyt.getRooms();
 	for (Aurora::LYTFile::RoomArray::const_iterator r = rooms.begin(); r != rooms.end(); ++r)
 		_rooms.push_back(new Room(r->model, r->x, r->y, r->z));
+
+	// Merge the static parts of all rooms into batches
+	_staticGeometry = new Graphics::Aurora::StaticGeometry;
+
+	for (RoomList::iterator r = _rooms.begin(); r != _rooms.end(); ++r)
+		if ((*r)->getModel())
+			_staticGeometry->add(*(*r)->getModel());
+
+	_staticGeometry->build();
 }
 
 void Area::loadObject(Object &object) {
@@ -322,6 +339,9 @@ void Area::unload() {
 	for (ObjectList::iterator o = _objects.begin(); o != _objects.end(); ++o)
 		delete *o;
 
+	delete _staticGeometry;
+	_staticGeometry = 0;
+
 	for (RoomList::iterator r = _rooms.begin(); r != _rooms.end(); ++r)
 		delete *r;
 
@@ -38,6 +38,8 @@
 
 #include "src/sound/types.h"
 
+#include "src/graphics/aurora/types.h"
+
 #include "src/events/types.h"
 #include "src/events/notifyable.h"
 
@@ -106,6 +108,9 @@ private:
 
 	RoomList _rooms;
 
+	/** The static geometry of all rooms, merged into batches. */
+	Graphics::Aurora::StaticGeometry *_staticGeometry;
+
 	ObjectList _objects;
 	ObjectMap  _objectMap;
 
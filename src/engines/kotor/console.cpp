@@ -31,10 +31,12 @@
 #include "src/common/configman.h"
 
 #include "src/graphics/aurora/types.h"
+#include "src/graphics/aurora/staticgeometry.h"
 
 #include "src/engines/kotor/console.h"
 #include "src/engines/kotor/kotor.h"
 #include "src/engines/kotor/module.h"
+#include "src/engines/kotor/area.h"
 
 namespace Engines {
 
@@ -50,6 +52,8 @@ Console::Console(KotOREngine &engine) :
 			"Usage: listmodules\nList all modules");
 	registerCommand("loadmodule" , boost::bind(&Console::cmdLoadModule , this, _1),
 			"Usage: loadmodule <module>\nLoad and enter the specified module");
+	registerCommand("areastats"  , boost::bind(&Console::cmdAreaStats  , this, _1),
+			"Usage: areastats\nShow rendering statistics of the current area");
 }
 
 Console::~Console() {
@@ -122,6 +126,20 @@ void Console::cmdLoadModule(const CommandLine &cl) {
 	printf("No such module \"%s\"", cl.args.c_str());
 }
 
+void Console::cmdAreaStats(const CommandLine &UNUSED(cl)) {
+	Module *module = _engine->getModule();
+	if (!module)
+		return;
+
+	Area *area = module->getCurrentArea();
+	if (!area || !area->_staticGeometry) {
+		printf("No area loaded");
+		return;
+	}
+
+	printStaticGeometryStats(*area->_staticGeometry);
+}
+
 } // End of namespace KotOR
 
 } // End of namespace Engines
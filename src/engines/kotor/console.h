@@ -54,6 +54,7 @@ private:
 	void cmdExitModule (const CommandLine &cl);
 	void cmdListModules(const CommandLine &cl);
 	void cmdLoadModule (const CommandLine &cl);
+	void cmdAreaStats  (const CommandLine &cl);
 };
 
 } // End of namespace KotOR
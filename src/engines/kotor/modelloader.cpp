@@ -38,6 +38,12 @@ namespace KotOR {
 Graphics::Aurora::Model *KotORModelLoader::load(const Common::UString &resref,
 		Graphics::Aurora::ModelType type, const Common::UString &texture) {
 
+	return loadInstance(resref, type, texture);
+}
+
+Graphics::Aurora::Model *KotORModelLoader::loadTemplate(const Common::UString &resref,
+		Graphics::Aurora::ModelType type, const Common::UString &texture) {
+
 	return new Graphics::Aurora::Model_KotOR(resref, false, type, texture);
 }
 
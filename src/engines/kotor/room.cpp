@@ -64,6 +64,10 @@ void Room::hide() {
 		_model->hide();
 }
 
+Graphics::Aurora::Model *Room::getModel() const {
+	return _model;
+}
+
 } // End of namespace KotOR
 
 } // End of namespace Engines
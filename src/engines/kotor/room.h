@@ -43,6 +43,9 @@ public:
 	void show();
 	void hide();
 
+	/** Return the room's model, or 0 if the room has none. */
+	Graphics::Aurora::Model *getModel() const;
+
 private:
 	Graphics::Aurora::Model *_model;
 
@@ -38,6 +38,12 @@ namespace KotOR2 {
 Graphics::Aurora::Model *KotOR2ModelLoader::load(const Common::UString &resref,
 		Graphics::Aurora::ModelType type, const Common::UString &texture) {
 
+	return loadInstance(resref, type, texture);
+}
+
+Graphics::Aurora::Model *KotOR2ModelLoader::loadTemplate(const Common::UString &resref,
+		Graphics::Aurora::ModelType type, const Common::UString &texture) {
+
 	return new Graphics::Aurora::Model_KotOR(resref, true, type, texture);
 }
 
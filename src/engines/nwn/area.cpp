@@ -27,6 +27,7 @@
 #include "src/common/util.h"
 #include "src/common/error.h"
 
+#include "src/aurora/resman.h"
 #include "src/aurora/locstring.h"
 #include "src/aurora/gff3file.h"
 #include "src/aurora/2dafile.h"
@@ -36,6 +37,7 @@
 
 #include "src/graphics/aurora/cursorman.h"
 #include "src/graphics/aurora/model.h"
+#include "src/graphics/aurora/staticgeometry.h"
 
 #include "src/sound/sound.h"
 
@@ -55,7 +57,7 @@ namespace Engines {
 namespace NWN {
 
 Area::Area(Module &module, const Common::UString &resRef) : _module(&module), _loaded(false),
-	_resRef(resRef), _visible(false), _tileset(0),
+	_resRef(resRef), _visible(false), _tileset(0), _staticGeometry(0),
 	_activeObject(0), _highlightAll(false) {
 
 	try {
@@ -231,6 +233,9 @@ void Area::show() {
 	for (std::vector<Tile>::iterator t = _tiles.begin(); t != _tiles.end(); ++t)
 		t->model->show();
 
+	if (_staticGeometry)
+		_staticGeometry->show();
+
 	// Show objects
 	for (ObjectList::iterator o = _objects.begin(); o != _objects.end(); ++o)
 		(*o)->show();
@@ -259,6 +264,9 @@ void Area::hide() {
 		(*o)->hide();
 
 	// Hide tiles
+	if (_staticGeometry)
+		_staticGeometry->hide();
+
 	for (std::vector<Tile>::iterator t = _tiles.begin(); t != _tiles.end(); ++t)
 		t->model->hide();
 
@@ -392,20 +400,31 @@ void Area::loadTile(const Aurora::GFF3Struct &t, Tile &tile) {
 }
 
 void Area::loadModels() {
-	loadTileModels();
+	// Mark the load for the resource trace, and prefetch what it needed last time
+	ResMan.beginLoad("nwn-area-" + _resRef);
+
+	try {
+		loadTileModels();
 
-	for (ObjectList::iterator o = _objects.begin(); o != _objects.end(); ++o) {
-		Engines::NWN::Object &object = **o;
+		for (ObjectList::iterator o = _objects.begin(); o != _objects.end(); ++o) {
+			Engines::NWN::Object &object = **o;
 
-		object.loadModel();
+			object.loadModel();
 
-		if (!object.isStatic()) {
-			const std::list<uint32> &ids = object.getIDs();
+			if (!object.isStatic()) {
+				const std::list<uint32> &ids = object.getIDs();
 
-			for (std::list<uint32>::const_iterator id = ids.begin(); id != ids.end(); ++id)
-				_objectMap.insert(std::make_pair(*id, &object));
+				for (std::list<uint32>::const_iterator id = ids.begin(); id != ids.end(); ++id)
+					_objectMap.insert(std::make_pair(*id, &object));
+			}
 		}
+
+	} catch (...) {
+		ResMan.endLoad();
+		throw;
 	}
+
+	ResMan.endLoad();
 }
 
 void Area::unloadModels() {
@@ -447,6 +466,9 @@ void Area::unloadTileset() {
 }
 
 void Area::loadTiles() {
+	// A tileset's tiles are 10 units wide, so each batch covers 4x4 tiles
+	_staticGeometry = new Graphics::Aurora::StaticGeometry(40.0f);
+
 	for (uint32 y = 0; y < _height; y++) {
 		for (uint32 x = 0; x < _width; x++) {
 			uint32 n = y * _width + x;
@@ -469,11 +491,18 @@ void Area::loadTiles() {
 
 			t.model->setPosition(tileX, tileY, tileZ);
 			t.model->setRotation(0.0f, 0.0f, -(((int) t.orientation) * 90.0f));
+
+			_staticGeometry->add(*t.model);
 		}
 	}
+
+	_staticGeometry->build();
 }
 
 void Area::unloadTiles() {
+	delete _staticGeometry;
+	_staticGeometry = 0;
+
 	for (uint32 y = 0; y < _height; y++) {
 		for (uint32 x = 0; x < _width; x++) {
 			uint32 n = y * _width + x;
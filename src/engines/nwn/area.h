@@ -184,6 +184,9 @@ private:
 
 	std::vector<Tile> _tiles; ///< The area's tiles.
 
+	/** The static geometry of all tiles, merged into batches. */
+	Graphics::Aurora::StaticGeometry *_staticGeometry;
+
 	ObjectList _objects;   ///< List of all objects in the area.
 	ObjectMap  _objectMap; ///< Map of all non-static objects in the area.
 
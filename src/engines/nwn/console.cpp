@@ -32,6 +32,7 @@
 #include "src/aurora/talkman.h"
 
 #include "src/graphics/aurora/types.h"
+#include "src/graphics/aurora/staticgeometry.h"
 
 #include "src/engines/aurora/util.h"
 
@@ -76,6 +77,8 @@ Console::Console(NWNEngine &engine) :
 			"Usage: listareas\nList all areas in the current module");
 	registerCommand("gotoarea"     , boost::bind(&Console::cmdGotoArea     , this, _1),
 			"Usage: gotoarea <area>\nMove to a specific area");
+	registerCommand("areastats"    , boost::bind(&Console::cmdAreaStats    , this, _1),
+			"Usage: areastats\nShow rendering statistics of the current area");
 	registerCommand("listmusic"    , boost::bind(&Console::cmdListMusic    , this, _1),
 			"Usage: listmusic\nList all available music resources");
 	registerCommand("stopmusic"    , boost::bind(&Console::cmdStopMusic    , this, _1),
@@ -274,6 +277,20 @@ void Console::cmdGotoArea(const CommandLine &cl) {
 	printf("Area \"%s\" does not exist", cl.args.c_str());
 }
 
+void Console::cmdAreaStats(const CommandLine &UNUSED(cl)) {
+	Module *module = _engine->getModule();
+	if (!module)
+		return;
+
+	Area *area = module->getCurrentArea();
+	if (!area || !area->_staticGeometry) {
+		printf("No area loaded");
+		return;
+	}
+
+	printStaticGeometryStats(*area->_staticGeometry);
+}
+
 void Console::cmdListMusic(const CommandLine &UNUSED(cl)) {
 	updateMusic();
 	printList(_music, _maxSizeMusic);
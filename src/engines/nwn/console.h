@@ -78,6 +78,7 @@ private:
 	void cmdLoadModule   (const CommandLine &cl);
 	void cmdListAreas    (const CommandLine &cl);
 	void cmdGotoArea     (const CommandLine &cl);
+	void cmdAreaStats    (const CommandLine &cl);
 	void cmdListMusic    (const CommandLine &cl);
 	void cmdStopMusic    (const CommandLine &cl);
 	void cmdPlayMusic    (const CommandLine &cl);
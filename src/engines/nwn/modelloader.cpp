@@ -38,6 +38,12 @@ namespace NWN {
 Graphics::Aurora::Model *NWNModelLoader::load(const Common::UString &resref,
 		Graphics::Aurora::ModelType type, const Common::UString &texture) {
 
+	return loadInstance(resref, type, texture);
+}
+
+Graphics::Aurora::Model *NWNModelLoader::loadTemplate(const Common::UString &resref,
+		Graphics::Aurora::ModelType type, const Common::UString &texture) {
+
 	// if supermodel
 	// check model cache
 	// else load supermodel and insert into cache
@@ -37,6 +37,10 @@ public:
 			Graphics::Aurora::ModelType type, const Common::UString &texture);
 
 	std::map<Common::UString, Graphics::Aurora::Model*, Common::UString::iless> modelCache;
+
+protected:
+	Graphics::Aurora::Model *loadTemplate(const Common::UString &resref,
+			Graphics::Aurora::ModelType type, const Common::UString &texture);
 };
 
 } // End of namespace NWN
@@ -182,8 +182,7 @@ void TRXFile::loadTRRN(Common::SeekableReadStream &trx, Packet &packet) {
 
 	float textureColors[6][3];
 	for (int i = 0; i < 6; i++)
-		for (int j = 0; j < 3; j++)
-			textureColors[i][j] = ttrn.readIEEEFloatLE();
+		ttrn.readIEEEFloatLE(textureColors[i], 3);
 
 	uint32 vCount = ttrn.readUint32LE();
 	uint32 fCount = ttrn.readUint32LE();
@@ -229,13 +228,9 @@ void TRXFile::loadTRRN(Common::SeekableReadStream &trx, Packet &packet) {
 
 	float *v = vertexData;
 	for (uint32 i = 0; i < vCount; i++) {
-		*v++ = ttrn.readIEEEFloatLE();
-		*v++ = ttrn.readIEEEFloatLE();
-		*v++ = ttrn.readIEEEFloatLE();
-
-		*v++ = ttrn.readIEEEFloatLE();
-		*v++ = ttrn.readIEEEFloatLE();
-		*v++ = ttrn.readIEEEFloatLE();
+		// Position and normal
+		ttrn.readIEEEFloatLE(v, 6);
+		v += 6;
 
 		for (int j = 0; j < 3; j++) {
 			int   vals = 1;
@@ -262,11 +257,7 @@ void TRXFile::loadTRRN(Common::SeekableReadStream &trx, Packet &packet) {
 	iBuf.setSize(fCount * 3, sizeof(uint16), GL_UNSIGNED_SHORT);
 
 	uint16 *f = (uint16 *) iBuf.getData();
-	for (uint32 i = 0; i < fCount; i++) {
-		*f++ = ttrn.readUint16LE();
-		*f++ = ttrn.readUint16LE();
-		*f++ = ttrn.readUint16LE();
-	}
+	ttrn.readUint16LE(f, fCount * 3);
 
 	/* TODO:
 	 *   - uint32 dds1Size
@@ -287,9 +278,7 @@ void TRXFile::loadWATR(Common::SeekableReadStream &trx, Packet &packet) {
 	Common::UString name = Common::readStringFixed(watr, Common::kEncodingASCII, 128);
 
 	float color[3];
-	color[0] = watr.readIEEEFloatLE();
-	color[1] = watr.readIEEEFloatLE();
-	color[2] = watr.readIEEEFloatLE();
+	watr.readIEEEFloatLE(color, 3);
 
 	watr.skip(4); // float rippleX
 	watr.skip(4); // float rippleY
@@ -358,9 +347,8 @@ void TRXFile::loadWATR(Common::SeekableReadStream &trx, Packet &packet) {
 
 	float *v = vertexData;
 	for (uint32 i = 0; i < vCount; i++) {
-		*v++ = watr.readIEEEFloatLE();
-		*v++ = watr.readIEEEFloatLE();
-		*v++ = watr.readIEEEFloatLE();
+		watr.readIEEEFloatLE(v, 3);
+		v += 3;
 
 		*v++ = color[0];
 		*v++ = color[1];
@@ -373,11 +361,7 @@ void TRXFile::loadWATR(Common::SeekableReadStream &trx, Packet &packet) {
 	iBuf.setSize(fCount * 3, sizeof(uint16), GL_UNSIGNED_SHORT);
 
 	uint16 *f = (uint16 *) iBuf.getData();
-	for (uint32 i = 0; i < fCount; i++) {
-		*f++ = watr.readUint16LE();
-		*f++ = watr.readUint16LE();
-		*f++ = watr.readUint16LE();
-	}
+	watr.readUint16LE(f, fCount * 3);
 
 	/* TODO:
 	 *   - uint32  ddsSize
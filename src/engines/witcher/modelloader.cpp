@@ -39,6 +39,12 @@ namespace Witcher {
 Graphics::Aurora::Model *WitcherModelLoader::load(const Common::UString &resref,
 		Graphics::Aurora::ModelType UNUSED(type), const Common::UString &UNUSED(texture)) {
 
+	return loadInstance(resref, Graphics::Aurora::kModelTypeObject, "");
+}
+
+Graphics::Aurora::Model *WitcherModelLoader::loadTemplate(const Common::UString &resref,
+		Graphics::Aurora::ModelType UNUSED(type), const Common::UString &UNUSED(texture)) {
+
 	return new Graphics::Aurora::Model_Witcher(resref);
 }
 
@@ -49,7 +49,7 @@ public:
 	float getWidth (uint32 c) const;
 	float getHeight()         const;
 
-	void draw(uint32 c) const;
+	void getGlyph(uint32 c, Glyph &glyph) const;
 
 private:
 	/** A font character. */
@@ -22,6 +22,7 @@
  *  An animation to be applied to a model.
  */
 
+#include "src/common/util.h"
 #include "src/common/readstream.h"
 #include "src/common/debug.h"
 
@@ -68,15 +69,44 @@ void Animation::setTransTime(float transtime) {
 	_transtime = transtime;
 }
 
-void Animation::update(Model *model, float lastFrame, float nextFrame) {
+void Animation::bind(Model *model, AnimationChannels &channels) const {
+	channels.clear();
+	channels.reserve(nodeList.size());
+
+	for (NodeList::const_iterator n = nodeList.begin(); n != nodeList.end(); ++n) {
+		AnimationChannel channel;
+
+		channel.keyFrames = (*n)->getNodeData();
+		channel.target    = model->getNode((*n)->getName());
+
+		if (!channel.keyFrames || !channel.target)
+			continue;
+
+		channel.positionCursor    = 0;
+		channel.orientationCursor = 0;
+
+		channels.push_back(channel);
+	}
+}
+
+void Animation::update(Model *model, AnimationChannels &channels, float UNUSED(lastFrame), float nextFrame) const {
 	// TODO: Also need to fire off associated events
 	//       for event in _events event->fire()
 
 
-	float scale = model->getAnimationScale(_name);
-	for (NodeList::iterator n = nodeList.begin();
-	     n != nodeList.end(); ++n) {
-		(*n)->update(model, lastFrame, nextFrame, scale);
+	const float scale = model->getAnimationScale(_name);
+
+	for (AnimationChannels::iterator c = channels.begin(); c != channels.end(); ++c) {
+		// Determine the corresponding keyframes
+		float posX, posY, posZ;
+		c->keyFrames->interpolatePosition(nextFrame, c->positionCursor, posX, posY, posZ);
+
+		float oX, oY, oZ, oA;
+		c->keyFrames->interpolateOrientation(nextFrame, c->orientationCursor, oX, oY, oZ, oA);
+
+		// Update the position/orientation of corresponding modelnode
+		c->target->setPosition(posX * scale, posY * scale, posZ * scale);
+		c->target->setOrientation(oX, oY, oZ, oA);
 	}
 }
 
@@ -85,6 +115,10 @@ void Animation::addAnimNode(AnimNode *node) {
 	nodeMap.insert(std::make_pair(node->getName(), node));
 }
 
+bool Animation::hasAnimNode(const Common::UString &node) const {
+	return nodeMap.find(node) != nodeMap.end();
+}
+
 } // End of namespace Aurora
 
 } // End of namespace Graphics
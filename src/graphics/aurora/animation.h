@@ -27,6 +27,7 @@
 
 #include <list>
 #include <map>
+#include <vector>
 
 #include "src/common/ustring.h"
 #include "src/common/transmatrix.h"
@@ -48,6 +49,18 @@ namespace Aurora {
 
 class AnimNode;
 
+/** An animation node bound to the node of a specific model it animates. */
+struct AnimationChannel {
+	const ModelNode *keyFrames; ///< The node holding the keyframes.
+	ModelNode *target;          ///< The node being animated.
+
+	size_t positionCursor;    ///< Cursor into the position keyframes.
+	size_t orientationCursor; ///< Cursor into the orientation keyframes.
+};
+
+/** All channels of an animation bound to a specific model. */
+typedef std::vector<AnimationChannel> AnimationChannels;
+
 class Animation {
 public:
 	Animation();
@@ -75,8 +88,14 @@ public:
 	float getLength() const;
 	void setTransTime(float transtime);
 
-	void update(Model *model, float lastFrame, float nextFrame);
+	/** Bind all nodes of this animation to the nodes of a model they animate. */
+	void bind(Model *model, AnimationChannels &channels) const;
+	/** Update the model bound to these channels, interpolating between frames. */
+	void update(Model *model, AnimationChannels &channels, float lastFrame, float nextFrame) const;
+
 	void addAnimNode(AnimNode *node);
+	/** Does this animation animate a node with this name? */
+	bool hasAnimNode(const Common::UString &node) const;
 };
 
 } // End of namespace Aurora
@@ -47,8 +47,8 @@ public:
 	/** Get the node's name. */
 	const Common::UString &getName() const;
 
-	/** Update the model properties interpolating between frames */
-	void update(Model *model, float lastFrame, float nextFrame, float scale);
+	/** Get the model node holding this node's keyframes. */
+	const ModelNode *getNodeData() const;
 protected:
 	// Animation *_animation; ///< The animation this node belongs to.
 
@@ -0,0 +1,337 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  The Aurora GUI quad batch manager.
+ */
+
+#include <cstring>
+
+#include "src/common/util.h"
+#include "src/common/configman.h"
+
+#include "src/graphics/graphics.h"
+#include "src/graphics/vertexbuffer.h"
+
+#include "src/graphics/images/surface.h"
+
+#include "src/graphics/aurora/guibatchman.h"
+#include "src/graphics/aurora/textureman.h"
+#include "src/graphics/aurora/texture.h"
+
+DECLARE_SINGLETON(Graphics::Aurora::GUIBatchManager)
+
+namespace Graphics {
+
+namespace Aurora {
+
+/** The width and height of an atlas page. */
+static const uint32 kPageSize = 1024;
+/** Never use more than that many atlas pages. */
+static const size_t kMaxPageCount = 4;
+/** Only textures up to that width and height go into the atlas. */
+static const uint32 kMaxTextureSize = 128;
+/** Border around each texture in the atlas, repeating its edges against filtering bleed. */
+static const uint32 kBorder = 1;
+
+/** The number of floats in a batched vertex: x, y, u, v, r, g, b, a. */
+static const size_t kVertexSize = 8;
+
+GUIBatchManager::Page::Page() : curX(0), curY(0), lineHeight(0), dirty(false) {
+	surface = new Surface(kPageSize, kPageSize);
+	surface->fill(0x00, 0x00, 0x00, 0x00);
+
+	texture = TextureMan.add(Texture::create(surface));
+}
+
+
+GUIBatchManager::GUIBatchManager() : _texture(0), _handle(0), _batching(false),
+	_frameQuads(0), _frameDrawCalls(0) {
+
+	_hasDirtyPages.store(false);
+
+	_generation.store(0);
+
+	_quadCount.store(0);
+	_drawCallCount.store(0);
+}
+
+GUIBatchManager::~GUIBatchManager() {
+	clear();
+}
+
+void GUIBatchManager::clear() {
+	Common::StackLock lock(_mutex);
+
+	for (std::vector<Page *>::iterator p = _pages.begin(); p != _pages.end(); ++p)
+		delete *p;
+
+	_pages.clear();
+	_regions.clear();
+	_rejected.clear();
+
+	_hasDirtyPages.store(false);
+
+	_generation++;
+}
+
+uint32 GUIBatchManager::getGeneration() const {
+	return _generation.load();
+}
+
+size_t GUIBatchManager::getAtlasTextureCount() const {
+	return _regions.size();
+}
+
+size_t GUIBatchManager::getAtlasPageCount() const {
+	return _pages.size();
+}
+
+bool GUIBatchManager::findInAtlas(const TextureHandle &texture, TextureHandle &page, float region[4]) {
+	if (texture.empty() || !ConfigMan.getBool("guiatlas", true))
+		return false;
+
+	Common::StackLock lock(_mutex);
+
+	const Common::UString &name = texture.getName();
+
+	RegionMap::iterator r = _regions.find(name);
+	if (r == _regions.end()) {
+		if (_rejected.find(name) != _rejected.end())
+			return false;
+
+		Region newRegion;
+		if (!addToAtlas(texture.getTexture(), newRegion)) {
+			_rejected.insert(name);
+			return false;
+		}
+
+		r = _regions.insert(std::make_pair(name, newRegion)).first;
+
+		// Only mark the page. It's uploaded once, before the next batch is drawn
+		_pages[r->second.page]->dirty = true;
+		_hasDirtyPages.store(true);
+	}
+
+	page = _pages[r->second.page]->texture;
+
+	memcpy(region, r->second.coords, 4 * sizeof(float));
+
+	return true;
+}
+
+void GUIBatchManager::uploadDirtyPages() {
+	if (!_hasDirtyPages.load())
+		return;
+
+	/* Hold the lock while uploading, so that no other thread can copy a
+	 * texture into a page while we're reading it. */
+	Common::StackLock lock(_mutex);
+
+	for (std::vector<Page *>::iterator p = _pages.begin(); p != _pages.end(); ++p) {
+		if (!(*p)->dirty)
+			continue;
+
+		(*p)->texture.getTexture().rebuild();
+		(*p)->dirty = false;
+	}
+
+	_hasDirtyPages.store(false);
+}
+
+bool GUIBatchManager::canAddToAtlas(const Texture &texture) const {
+	if (texture.isDynamic() || (texture.getWidth() == 0) || (texture.getHeight() == 0))
+		return false;
+
+	if ((texture.getWidth() > kMaxTextureSize) || (texture.getHeight() > kMaxTextureSize))
+		return false;
+
+	const ImageDecoder &image = texture.getImage();
+	if (image.isCompressed() || (image.getDataType() != kPixelDataType8))
+		return false;
+
+	const PixelFormat format = image.getFormat();
+
+	return (format == kPixelFormatRGB ) || (format == kPixelFormatBGR ) ||
+	       (format == kPixelFormatRGBA) || (format == kPixelFormatBGRA);
+}
+
+bool GUIBatchManager::addToAtlas(const Texture &texture, Region &region) {
+	if (!canAddToAtlas(texture))
+		return false;
+
+	const uint32 width  = texture.getWidth()  + 2 * kBorder;
+	const uint32 height = texture.getHeight() + 2 * kBorder;
+
+	if (_pages.empty())
+		_pages.push_back(new Page);
+
+	Page *page = _pages.back();
+
+	if ((page->curX + width) > kPageSize) {
+		// Doesn't fit into the current line, start a new one
+
+		page->curX       = 0;
+		page->curY      += page->lineHeight;
+		page->lineHeight = 0;
+	}
+
+	if ((page->curY + height) > kPageSize) {
+		// Doesn't fit into the current page, start a new one
+
+		if (_pages.size() >= kMaxPageCount)
+			return false;
+
+		_pages.push_back(new Page);
+		page = _pages.back();
+	}
+
+	copyToPage(texture, *page, page->curX, page->curY);
+
+	region.page = _pages.size() - 1;
+
+	region.coords[0] = (page->curX + kBorder) / (float) kPageSize;
+	region.coords[1] = (page->curY + kBorder) / (float) kPageSize;
+	region.coords[2] = texture.getWidth ()    / (float) kPageSize;
+	region.coords[3] = texture.getHeight()    / (float) kPageSize;
+
+	page->curX      += width;
+	page->lineHeight = MAX(page->lineHeight, height);
+
+	return true;
+}
+
+void GUIBatchManager::copyToPage(const Texture &texture, Page &page, uint32 x, uint32 y) {
+	const ImageDecoder::MipMap &source = texture.getImage().getMipMap(0);
+	ImageDecoder::MipMap &target = page.surface->getMipMap();
+
+	const int width  = source.width;
+	const int height = source.height;
+
+	// Copy the texture, repeating its outermost pixels into the border
+	for (int tY = -((int) kBorder); tY < (height + (int) kBorder); tY++) {
+		for (int tX = -((int) kBorder); tX < (width + (int) kBorder); tX++) {
+			const int sX = CLIP(tX, 0, width  - 1);
+			const int sY = CLIP(tY, 0, height - 1);
+
+			float r, g, b, a;
+			source.getPixel(sY * width + sX, r, g, b, a);
+
+			target.setPixel((y + kBorder + tY) * kPageSize + (x + kBorder + tX), r, g, b, a);
+		}
+	}
+}
+
+void GUIBatchManager::begin() {
+	uploadDirtyPages();
+
+	_vertices.clear();
+
+	_texture  = 0;
+	_handle   = 0;
+	_batching = true;
+}
+
+void GUIBatchManager::add(const TextureHandle &texture,
+                          float  x1, float  y1, float  x2, float  y2,
+                          float tX1, float tY1, float tX2, float tY2,
+                          float r, float g, float b, float a) {
+
+	const Texture *t = texture.empty() ? 0 : &texture.getTexture();
+
+	// A quad with a different texture starts a new batch
+	if (!_vertices.empty() && (t != _texture))
+		flush();
+
+	_texture = t;
+	_handle  = &texture;
+
+	const float vertices[4 * kVertexSize] = {
+		x1, y1, tX1, tY1, r, g, b, a,
+		x2, y1, tX2, tY1, r, g, b, a,
+		x2, y2, tX2, tY2, r, g, b, a,
+		x1, y2, tX1, tY2, r, g, b, a
+	};
+
+	_vertices.insert(_vertices.end(), vertices, vertices + 4 * kVertexSize);
+
+	_frameQuads++;
+
+	if (!_batching)
+		flush();
+}
+
+void GUIBatchManager::flush() {
+	if (_vertices.empty())
+		return;
+
+	TextureMan.set(*_handle);
+
+	const GLsizei stride = kVertexSize * sizeof(float);
+
+	const VertexAttrib position(VPOSITION, 2, GL_FLOAT, stride, &_vertices[0]);
+	const VertexAttrib texCoord(VTCOORD  , 2, GL_FLOAT, stride, &_vertices[2]);
+	const VertexAttrib color   (VCOLOR   , 4, GL_FLOAT, stride, &_vertices[4]);
+
+	position.enable();
+	texCoord.enable();
+	color.enable();
+
+	glDrawArrays(GL_QUADS, 0, _vertices.size() / kVertexSize);
+
+	color.disable();
+	texCoord.disable();
+	position.disable();
+
+	glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+
+	_vertices.clear();
+
+	_texture = 0;
+	_handle  = 0;
+
+	_frameDrawCalls++;
+}
+
+void GUIBatchManager::end() {
+	flush();
+
+	_batching = false;
+}
+
+void GUIBatchManager::finishFrame() {
+	_quadCount.store(_frameQuads);
+	_drawCallCount.store(_frameDrawCalls);
+
+	_frameQuads     = 0;
+	_frameDrawCalls = 0;
+}
+
+uint32 GUIBatchManager::getQuadCount() const {
+	return _quadCount.load();
+}
+
+uint32 GUIBatchManager::getDrawCallCount() const {
+	return _drawCallCount.load();
+}
+
+} // End of namespace Aurora
+
+} // End of namespace Graphics
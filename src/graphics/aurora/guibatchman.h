@@ -0,0 +1,178 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  The Aurora GUI quad batch manager.
+ */
+
+#ifndef GRAPHICS_AURORA_GUIBATCHMAN_H
+#define GRAPHICS_AURORA_GUIBATCHMAN_H
+
+#include <vector>
+#include <map>
+#include <set>
+
+#include "src/common/types.h"
+#include "src/common/singleton.h"
+#include "src/common/mutex.h"
+#include "src/common/ustring.h"
+#include "src/common/atomic.h"
+
+#include "src/graphics/aurora/texturehandle.h"
+
+namespace Graphics {
+
+class Surface;
+
+namespace Aurora {
+
+class Texture;
+
+/** The global Aurora GUI quad batch manager.
+ *
+ *  GUI elements that consist of simple quads add themselves to the current
+ *  batch instead of drawing themselves. Runs of quads using the same texture
+ *  are then drawn together, keeping the order of the GUI elements intact.
+ *
+ *  To let quads with different textures share a batch, small GUI textures
+ *  are copied into texture atlas pages when they're first used by a quad.
+ */
+class GUIBatchManager : public Common::Singleton<GUIBatchManager> {
+public:
+	GUIBatchManager();
+	~GUIBatchManager();
+
+	// .--- Texture atlas
+	/** Remove all textures from the atlas and release its pages.
+	 *
+	 *  Needs to be called whenever the textures might have changed, since
+	 *  the atlas only knows the textures by name. Quads still using a page
+	 *  keep it alive until they look up their texture again.
+	 */
+	void clear();
+	/** Return the atlas generation, which changes each time the atlas is cleared. */
+	uint32 getGeneration() const;
+
+	/** Find a texture in the atlas, adding it if possible.
+	 *
+	 *  @param texture The texture to look for.
+	 *  @param page    Receives the atlas page the texture is found in.
+	 *  @param region  Receives the texture's position and size within the page, in texture coordinates.
+	 *
+	 *  @return true if the texture is in the atlas.
+	 */
+	bool findInAtlas(const TextureHandle &texture, TextureHandle &page, float region[4]);
+
+	/** Return the number of textures in the atlas. */
+	size_t getAtlasTextureCount() const;
+	/** Return the number of atlas pages. */
+	size_t getAtlasPageCount() const;
+	// '---
+
+	// .--- Batching
+	/** Start batching quads, uploading the atlas pages that changed first. */
+	void begin();
+	/** Draw all batched quads. */
+	void flush();
+	/** Draw all batched quads and stop batching. */
+	void end();
+
+	/** Add a quad to the batch.
+	 *
+	 *  The texture handle needs to stay valid until the batch is flushed.
+	 */
+	void add(const TextureHandle &texture,
+	         float  x1, float  y1, float  x2, float  y2,
+	         float tX1, float tY1, float tX2, float tY2,
+	         float r, float g, float b, float a);
+
+	/** Signal that the frame is finished, publishing its statistics. */
+	void finishFrame();
+
+	/** Return the number of quads batched in the last frame. */
+	uint32 getQuadCount() const;
+	/** Return the number of draw calls the batched quads needed in the last frame. */
+	uint32 getDrawCallCount() const;
+	// '---
+
+private:
+	/** A texture atlas page. */
+	struct Page {
+		Surface *surface;
+		TextureHandle texture;
+
+		uint32 curX;
+		uint32 curY;
+		uint32 lineHeight;
+
+		bool dirty; ///< Were textures added since the page was last uploaded?
+
+		Page();
+	};
+
+	/** A texture within an atlas page. */
+	struct Region {
+		size_t page;
+		float coords[4];
+	};
+
+	typedef std::map<Common::UString, Region> RegionMap;
+
+
+	std::vector<Page *> _pages;
+	RegionMap _regions;
+
+	/** Textures we already know can't be put into the atlas. */
+	std::set<Common::UString> _rejected;
+
+	Common::Mutex _mutex;
+
+	boost::atomic<bool> _hasDirtyPages;
+
+	boost::atomic<uint32> _generation; ///< Incremented each time the atlas is cleared.
+
+	std::vector<float> _vertices; ///< The currently batched quads.
+	const Texture *_texture;      ///< The texture of the currently batched quads.
+	const TextureHandle *_handle; ///< The handle to the texture of the currently batched quads.
+
+	bool _batching;
+
+	uint32 _frameQuads;
+	uint32 _frameDrawCalls;
+
+	boost::atomic<uint32> _quadCount;
+	boost::atomic<uint32> _drawCallCount;
+
+	bool canAddToAtlas(const Texture &texture) const;
+	bool addToAtlas(const Texture &texture, Region &region);
+	void copyToPage(const Texture &texture, Page &page, uint32 x, uint32 y);
+
+	/** Upload all atlas pages that changed since the last upload. Main thread only. */
+	void uploadDirtyPages();
+};
+
+} // End of namespace Aurora
+
+} // End of namespace Graphics
+
+/** Shortcut for accessing the GUI quad batch manager. */
+#define GUIBatchMan Graphics::Aurora::GUIBatchManager::instance()
+
+#endif // GRAPHICS_AURORA_GUIBATCHMAN_H
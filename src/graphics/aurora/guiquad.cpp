@@ -28,6 +28,7 @@
 #include "src/graphics/aurora/guiquad.h"
 #include "src/graphics/aurora/textureman.h"
 #include "src/graphics/aurora/texture.h"
+#include "src/graphics/aurora/guibatchman.h"
 
 namespace Graphics {
 
@@ -52,6 +53,8 @@ GUIQuad::GUIQuad(const Common::UString &texture,
 		_r = _g = _b = _a = 0.0f;
 	}
 
+	findInAtlas();
+
 	_distance = -FLT_MAX;
 }
 
@@ -63,6 +66,8 @@ GUIQuad::GUIQuad(TextureHandle texture,
 	_tX1(tX1), _tY1(tY1), _tX2(tX2), _tY2(tY2),
 	_xor(false) {
 
+	findInAtlas();
+
 	_distance = -FLT_MAX;
 }
 
@@ -127,6 +132,8 @@ void GUIQuad::setTexture(const Common::UString &texture) {
 		_r = _g = _b = _a = 0.0f;
 	}
 
+	findInAtlas();
+
 	unlockFrameIfVisible();
 }
 
@@ -135,9 +142,18 @@ void GUIQuad::setTexture(TextureHandle texture) {
 
 	_texture = texture;
 
+	findInAtlas();
+
 	unlockFrameIfVisible();
 }
 
+void GUIQuad::findInAtlas() {
+	_atlasGeneration = GUIBatchMan.getGeneration();
+
+	if (!GUIBatchMan.findInAtlas(_texture, _atlasPage, _atlasRegion))
+		_atlasPage.clear();
+}
+
 float GUIQuad::getWidth() const {
 	return ABS(_x2 - _x1);
 }
@@ -214,6 +230,33 @@ void GUIQuad::render(RenderPass pass) {
 	glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
 }
 
+bool GUIQuad::renderBatched() {
+	if (_xor)
+		return false;
+
+	// The atlas was cleared since we last looked, our page and region are stale
+	if (_atlasGeneration != GUIBatchMan.getGeneration())
+		findInAtlas();
+
+	// Only use the atlas if the quad doesn't need the texture to repeat
+	const bool inAtlas = !_atlasPage.empty() &&
+		(MIN(_tX1, _tX2) >= 0.0f) && (MAX(_tX1, _tX2) <= 1.0f) &&
+		(MIN(_tY1, _tY2) >= 0.0f) && (MAX(_tY1, _tY2) <= 1.0f);
+
+	if (!inAtlas) {
+		GUIBatchMan.add(_texture, _x1, _y1, _x2, _y2, _tX1, _tY1, _tX2, _tY2, _r, _g, _b, _a);
+		return true;
+	}
+
+	const float tX1 = _atlasRegion[0] + _tX1 * _atlasRegion[2];
+	const float tY1 = _atlasRegion[1] + _tY1 * _atlasRegion[3];
+	const float tX2 = _atlasRegion[0] + _tX2 * _atlasRegion[2];
+	const float tY2 = _atlasRegion[1] + _tY2 * _atlasRegion[3];
+
+	GUIBatchMan.add(_atlasPage, _x1, _y1, _x2, _y2, tX1, tY1, tX2, tY2, _r, _g, _b, _a);
+	return true;
+}
+
 } // End of namespace Aurora
 
 } // End of namespace Graphics
@@ -77,10 +77,15 @@ public:
 	// Renderable
 	void calculateDistance();
 	void render(RenderPass pass);
+	bool renderBatched();
 
 private:
 	TextureHandle _texture;
 
+	TextureHandle _atlasPage;  ///< The texture atlas page holding our texture.
+	float _atlasRegion[4];     ///< Our texture's position and size within the atlas page.
+	uint32 _atlasGeneration;   ///< The atlas generation our atlas page and region are from.
+
 	float _r;
 	float _g;
 	float _b;
@@ -97,6 +102,8 @@ private:
 	float _tY2;
 
 	bool _xor;
+
+	void findInAtlas();
 };
 
 } // End of namespace Aurora
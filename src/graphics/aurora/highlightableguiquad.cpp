@@ -34,13 +34,22 @@ HighlightableGUIQuad::~HighlightableGUIQuad() {
 }
 
 void HighlightableGUIQuad::render(RenderPass pass) {
+	updateHighlight();
+	Graphics::Aurora::GUIQuad::render(pass);
+}
+
+bool HighlightableGUIQuad::renderBatched() {
+	updateHighlight();
+	return Graphics::Aurora::GUIQuad::renderBatched();
+}
+
+void HighlightableGUIQuad::updateHighlight() {
 	if (isHighlightable() && isHightlighted()) {
 		float initialR, initialG, initialB, initialA, r, g, b, a;
 		getColor(initialR, initialG, initialB, initialA);
 		incrementColor(initialR, initialG, initialB, initialA, r, g, b, a);
 		setColor(r, g, b, a);
 	}
-	Graphics::Aurora::GUIQuad::render(pass);
 }
 
 } // End of namespace Aurora
@@ -37,6 +37,10 @@ public:
 	~HighlightableGUIQuad();
 
 	void render (RenderPass pass);
+	bool renderBatched();
+
+private:
+	void updateHighlight();
 };
 
 } // End of namespace Aurora
@@ -0,0 +1,124 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A track of animation keyframes.
+ */
+
+#include <cassert>
+
+#include <algorithm>
+
+#include "src/graphics/aurora/keyframetrack.h"
+
+namespace Graphics {
+
+namespace Aurora {
+
+KeyFrameTrack::KeyFrameTrack(size_t components) : _components(components) {
+	assert(_components > 0);
+}
+
+KeyFrameTrack::~KeyFrameTrack() {
+}
+
+size_t KeyFrameTrack::getComponentCount() const {
+	return _components;
+}
+
+size_t KeyFrameTrack::size() const {
+	return _times.size();
+}
+
+bool KeyFrameTrack::empty() const {
+	return _times.empty();
+}
+
+void KeyFrameTrack::clear() {
+	_times.clear();
+	_values.clear();
+}
+
+void KeyFrameTrack::addKeyFrame(float time, const float *values) {
+	_times.push_back(time);
+	_values.insert(_values.end(), values, values + _components);
+}
+
+float KeyFrameTrack::getTime(size_t frame) const {
+	assert(frame < _times.size());
+
+	return _times[frame];
+}
+
+const float *KeyFrameTrack::getValues(size_t frame) const {
+	assert(frame < _times.size());
+
+	return &_values[frame * _components];
+}
+
+size_t KeyFrameTrack::findKeyFrame(float time, size_t &cursor) const {
+	const size_t count = _times.size();
+	if (count < 2)
+		return cursor = 0;
+
+	/* Frame f starts the segment containing the time, if it's either the
+	 * first frame or before the time, and it's either the last frame or
+	 * the next frame is not before the time. */
+
+	if (cursor < count) {
+		if (((cursor == 0) || (_times[cursor] < time)) &&
+		    ((cursor + 1 >= count) || (_times[cursor + 1] >= time)))
+			return cursor;
+
+		// Playing forward, we most likely just crossed into the next segment
+		const size_t next = cursor + 1;
+		if ((next < count) && (_times[next] < time) &&
+		    ((next + 1 >= count) || (_times[next + 1] >= time)))
+			return cursor = next;
+	}
+
+	// Jumped somewhere else, search for the first frame not before the time
+	const size_t frame = std::lower_bound(_times.begin(), _times.end(), time) - _times.begin();
+
+	return cursor = ((frame > 0) ? (frame - 1) : 0);
+}
+
+void KeyFrameTrack::sample(float time, size_t &cursor, float *values) const {
+	assert(!_times.empty());
+
+	const size_t frame = findKeyFrame(time, cursor);
+
+	const float *last = &_values[frame * _components];
+
+	if ((frame + 1 >= _times.size()) || (_times[frame] >= time)) {
+		std::copy(last, last + _components, values);
+		return;
+	}
+
+	const float *next = &_values[(frame + 1) * _components];
+
+	const float f = (time - _times[frame]) / (_times[frame + 1] - _times[frame]);
+	for (size_t i = 0; i < _components; i++)
+		values[i] = f * next[i] + (1.0f - f) * last[i];
+}
+
+} // End of namespace Aurora
+
+} // End of namespace Graphics
@@ -0,0 +1,98 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A track of animation keyframes.
+ */
+
+#ifndef GRAPHICS_AURORA_KEYFRAMETRACK_H
+#define GRAPHICS_AURORA_KEYFRAMETRACK_H
+
+#include <vector>
+
+#include "src/common/types.h"
+
+namespace Graphics {
+
+namespace Aurora {
+
+/** A track of keyframes, each holding a fixed number of float components.
+ *
+ *  The keyframe times and values are stored in separate, contiguous arrays.
+ *  Sampling takes a cursor, owned by the caller, that remembers the last
+ *  used keyframe. When the track is played forward, finding the keyframes
+ *  to interpolate between is amortized O(1); after a jump in time, they
+ *  are found with a binary search.
+ */
+class KeyFrameTrack {
+public:
+	KeyFrameTrack(size_t components);
+	~KeyFrameTrack();
+
+	/** Return the number of values per keyframe. */
+	size_t getComponentCount() const;
+
+	/** Return the number of keyframes. */
+	size_t size() const;
+	/** Does the track hold no keyframes at all? */
+	bool empty() const;
+
+	/** Remove all keyframes. */
+	void clear();
+
+	/** Add a keyframe. Keyframes need to be added in chronological order. */
+	void addKeyFrame(float time, const float *values);
+
+	/** Return the time of a keyframe. */
+	float getTime(size_t frame) const;
+	/** Return the values of a keyframe. */
+	const float *getValues(size_t frame) const;
+
+	/** Find the keyframe that starts the segment containing this time.
+	 *
+	 *  That's the last keyframe before the time, or the first keyframe
+	 *  if there is none before it.
+	 *
+	 *  @param time   The time to look up.
+	 *  @param cursor The result of the previous lookup on this track. Updated
+	 *                to hold the result of this lookup.
+	 */
+	size_t findKeyFrame(float time, size_t &cursor) const;
+
+	/** Linearly interpolate the values at this time.
+	 *
+	 *  @param time   The time to sample.
+	 *  @param cursor The cursor passed on to findKeyFrame().
+	 *  @param values Receives getComponentCount() values.
+	 */
+	void sample(float time, size_t &cursor, float *values) const;
+
+private:
+	size_t _components;
+
+	std::vector<float> _times;  ///< The time of each keyframe.
+	std::vector<float> _values; ///< The values of all keyframes, back to back.
+};
+
+} // End of namespace Aurora
+
+} // End of namespace Graphics
+
+#endif // GRAPHICS_AURORA_KEYFRAMETRACK_H
@@ -23,6 +23,7 @@
  */
 
 #include <cassert>
+#include <cstring>
 
 #include <SDL_timer.h>
 
@@ -49,7 +50,7 @@ namespace Aurora {
 Model::Model(ModelType type) : Renderable((RenderableType) type),
 	_type(type), _supermodel(0), _currentState(0),
 	_currentAnimation(0), _nextAnimation(0), _drawBound(false),
-	_drawSkeleton(false), _drawSkeletonInvisible(false) {
+	_drawSkeleton(false), _drawSkeletonInvisible(false), _boundAnimation(0) {
 
 	_position[0] = 0.0f; _position[1] = 0.0f; _position[2] = 0.0f;
 	_rotation[0] = 0.0f; _rotation[1] = 0.0f; _rotation[2] = 0.0f;
@@ -62,17 +63,45 @@ Model::Model(ModelType type) : Renderable((RenderableType) type),
 
 	_loopAnimation = 0;
 
-	_boundRenderable = new Shader::ShaderRenderable();
-	_boundRenderable->setSurface(SurfaceMan.getSurface("defaultSurface"));
-	_boundRenderable->setMaterial(MaterialMan.getMaterial("defaultWhite"));
-	_boundRenderable->setMesh(MeshMan.getMesh("defaultWireBox"));
+	createBoundRenderable();
+
+	publishRenderState();
+}
+
+Model::Model(const boost::shared_ptr<Model> &modelTemplate) :
+	Renderable((RenderableType) modelTemplate->_type), _type(modelTemplate->_type),
+	_fileName(modelTemplate->_fileName), _name(modelTemplate->_name),
+	_superModelName(modelTemplate->_superModelName), _supermodel(modelTemplate->_supermodel),
+	_template(modelTemplate), _currentState(0), _stateNames(modelTemplate->_stateNames),
+	_animationMap(modelTemplate->_animationMap),
+	_currentAnimation(modelTemplate->_currentAnimation), _nextAnimation(0),
+	_loopAnimation(0), _animationScale(modelTemplate->_animationScale),
+	_defaultAnimations(modelTemplate->_defaultAnimations),
+	_absolutePosition(modelTemplate->_absolutePosition), _boundBox(modelTemplate->_boundBox),
+	_absoluteBoundBox(modelTemplate->_absoluteBoundBox), _drawBound(false),
+	_drawSkeleton(false), _drawSkeletonInvisible(false), _elapsedTime(0.0f),
+	_boundAnimation(0) {
+
+	memcpy(_modelScale, modelTemplate->_modelScale, sizeof(_modelScale));
+	memcpy(_position  , modelTemplate->_position  , sizeof(_position));
+	memcpy(_rotation  , modelTemplate->_rotation  , sizeof(_rotation));
+	memcpy(_center    , modelTemplate->_center    , sizeof(_center));
+
+	instantiateStates(*modelTemplate);
+	createFlatNodeLists();
+
+	createBoundRenderable();
+
+	publishRenderState();
 }
 
 Model::~Model() {
 	hide();
 
-	for (AnimationMap::iterator a = _animationMap.begin(); a != _animationMap.end(); ++a)
-		delete a->second;
+	// Animations are owned by the template
+	if (!_template)
+		for (AnimationMap::iterator a = _animationMap.begin(); a != _animationMap.end(); ++a)
+			delete a->second;
 
 	for (StateList::iterator s = _stateList.begin(); s != _stateList.end(); ++s) {
 		for (NodeList::iterator n = (*s)->nodeList.begin(); n != (*s)->nodeList.end(); ++n)
@@ -128,6 +157,16 @@ bool Model::isIn(float x1, float y1, float z1, float x2, float y2, float z2) con
 	return _absoluteBoundBox.isIn(x1, y1, z1, x2, y2, z2);
 }
 
+bool Model::getWorldBound(float min[3], float max[3]) const {
+	if (_absoluteBoundBox.empty())
+		return false;
+
+	_absoluteBoundBox.getMin(min[0], min[1], min[2]);
+	_absoluteBoundBox.getMax(max[0], max[1], max[2]);
+
+	return true;
+}
+
 float Model::getWidth() const {
 	return _boundBox.getWidth() * _modelScale[0];
 }
@@ -196,48 +235,33 @@ void Model::getAbsolutePosition(float &x, float &y, float &z) const {
 }
 
 void Model::setPosition(float x, float y, float z) {
-	lockFrameIfVisible();
-
 	_position[0] = x / _modelScale[0];
 	_position[1] = y / _modelScale[1];
 	_position[2] = z / _modelScale[2];
 
 	createAbsolutePosition();
-	calculateDistance();
-
-	resort();
 
-	unlockFrameIfVisible();
+	publishRenderState();
 }
 
 void Model::setRotation(float x, float y, float z) {
-	lockFrameIfVisible();
-
 	_rotation[0] = x;
 	_rotation[1] = y;
 	_rotation[2] = z;
 
 	createAbsolutePosition();
-	calculateDistance();
-
-	resort();
 
-	unlockFrameIfVisible();
+	publishRenderState();
 }
 
 void Model::setScale(float x, float y, float z) {
-	lockFrameIfVisible();
-
 	_modelScale[0] = x;
 	_modelScale[1] = y;
 	_modelScale[2] = z;
 
 	createAbsolutePosition();
-	calculateDistance();
 
-	resort();
-
-	unlockFrameIfVisible();
+	publishRenderState();
 }
 
 void Model::move(float x, float y, float z) {
@@ -252,6 +276,43 @@ void Model::rotate(float x, float y, float z) {
 	setRotation(_rotation[0] + x, _rotation[1] + y, _rotation[2] + z);
 }
 
+void Model::publishRenderState() {
+	RenderState &state = _renderState.getBack();
+
+	memcpy(state.scale   , _modelScale, sizeof(state.scale));
+	memcpy(state.position, _position  , sizeof(state.position));
+	memcpy(state.rotation, _rotation  , sizeof(state.rotation));
+
+	state.absolutePosition = _absolutePosition;
+
+	Common::TransformationMatrix center = _absolutePosition;
+	center.translate(_center[0], _center[1], _center[2]);
+	center.getPosition(state.center[0], state.center[1], state.center[2]);
+
+	state.hasBound = getWorldBound(state.boundMin, state.boundMax);
+
+	_renderState.publish();
+}
+
+const Model::RenderState &Model::getRenderState() const {
+	return _renderState.getFront();
+}
+
+bool Model::updateRenderState() {
+	return _renderState.update();
+}
+
+bool Model::getRenderBound(float min[3], float max[3]) const {
+	const RenderState &state = getRenderState();
+	if (!state.hasBound)
+		return false;
+
+	memcpy(min, state.boundMin, 3 * sizeof(float));
+	memcpy(max, state.boundMax, 3 * sizeof(float));
+
+	return true;
+}
+
 void Model::getTooltipAnchor(float &x, float &y, float &z) const {
 	Common::TransformationMatrix pos = _absolutePosition;
 
@@ -311,6 +372,9 @@ void Model::setState(const Common::UString &name) {
 
 	_currentState = state;
 
+	// The animated nodes are different in the new state
+	_boundAnimation = 0;
+
 	// TODO: Do we need to recreate the bounding box on a state change?
 
 	// createBound();
@@ -391,6 +455,17 @@ Animation *Model::getAnimation(const Common::UString &anim) {
 	return n->second;
 }
 
+bool Model::isNodeAnimated(const Common::UString &node) const {
+	for (AnimationMap::const_iterator a = _animationMap.begin(); a != _animationMap.end(); ++a)
+		if (a->second->hasAnimNode(node))
+			return true;
+
+	if (_supermodel)
+		return _supermodel->isNodeAnimated(node);
+
+	return false;
+}
+
 float Model::getAnimationScale(const Common::UString &anim) {
 	// TODO: We can cache this for performance
 	AnimationMap::iterator n = _animationMap.find(anim);
@@ -406,24 +481,20 @@ float Model::getAnimationScale(const Common::UString &anim) {
 }
 
 void Model::calculateDistance() {
+	const RenderState &state = getRenderState();
+
 	if (_type == kModelTypeGUIFront) {
-		_distance = _position[2];
+		_distance = state.position[2];
 		return;
 	}
 
 
-	Common::TransformationMatrix center = _absolutePosition;
-
-	center.translate(_center[0], _center[1], _center[2]);
-
-
-	const float cameraX =  CameraMan.getPosition()[0];
-	const float cameraY =  CameraMan.getPosition()[1];
-	const float cameraZ = -CameraMan.getPosition()[2];
+	float cameraPosition[3], cameraOrientation[3];
+	CameraMan.getRenderState(cameraPosition, cameraOrientation);
 
-	const float x = ABS(center.getX() - cameraX);
-	const float y = ABS(center.getY() - cameraY);
-	const float z = ABS(center.getZ() - cameraZ);
+	const float x = ABS(state.center[0] - cameraPosition[0]);
+	const float y = ABS(state.center[1] - cameraPosition[1]);
+	const float z = ABS(state.center[2] + cameraPosition[2]);
 
 
 	_distance = x + y + z;
@@ -473,8 +544,17 @@ void Model::manageAnimations(float dt) {
 	}
 
 	// Update the animation, if we have any
-	if (_currentAnimation)
-		_currentAnimation->update(this, lastFrame, nextFrame);
+	if (_currentAnimation) {
+		// Resolve the animated nodes only once, not every frame
+		if (_boundAnimation != _currentAnimation) {
+			_currentAnimation->bind(this, _animationChannels);
+			_boundAnimation = _currentAnimation;
+		}
+
+		_currentAnimation->update(this, _animationChannels, lastFrame, nextFrame);
+
+		createAbsolutePositions();
+	}
 }
 
 void Model::render(RenderPass pass) {
@@ -487,24 +567,28 @@ void Model::render(RenderPass pass) {
 		return;
 	}
 
+	const RenderState &transform = getRenderState();
+
 	// Apply our global model transformation
-	glScalef(_modelScale[0], _modelScale[1], _modelScale[2]);
+	glScalef(transform.scale[0], transform.scale[1], transform.scale[2]);
 
 	if (_type == kModelTypeObject)
 		// Aurora world objects have a rotated axis
 		glRotatef(90.0f, -1.0f, 0.0f, 0.0f);
 
-	glTranslatef(_position[0], _position[1], _position[2]);
+	glTranslatef(transform.position[0], transform.position[1], transform.position[2]);
 
-	glRotatef( _rotation[0], 1.0f, 0.0f, 0.0f);
-	glRotatef( _rotation[1], 0.0f, 1.0f, 0.0f);
-	glRotatef(-_rotation[2], 0.0f, 0.0f, 1.0f);
+	glRotatef( transform.rotation[0], 1.0f, 0.0f, 0.0f);
+	glRotatef( transform.rotation[1], 0.0f, 1.0f, 0.0f);
+	glRotatef(-transform.rotation[2], 0.0f, 0.0f, 1.0f);
 
 
 	// Draw the bounding box, if requested
 	doDrawBound();
 
 	// Draw the nodes
+	TextureMan.setCoverage(getScreenCoverage());
+
 	for (NodeList::iterator n = _currentState->rootNodes.begin();
 	     n != _currentState->rootNodes.end(); ++n) {
 
@@ -514,12 +598,27 @@ void Model::render(RenderPass pass) {
 	}
 
 	// Reset the first texture units
+	TextureMan.setCoverage(1.0f);
 	TextureMan.reset();
 
 	// Draw the skeleton, if requested
 	doDrawSkeleton();
 }
 
+float Model::getScreenCoverage() const {
+	if ((_type == kModelTypeGUIFront) || (_distance <= 0.0))
+		return 1.0f;
+
+	float min[3], max[3];
+	if (!getRenderBound(min, max))
+		return 1.0f;
+
+	// The size of the model in relation to its distance from the camera
+	const float size = (max[0] - min[0]) + (max[1] - min[1]) + (max[2] - min[2]);
+
+	return MIN<float>(size / _distance, 1.0f);
+}
+
 void Model::doDrawBound() {
 	if (!_drawBound)
 		return;
@@ -577,7 +676,7 @@ void Model::doDrawBound() {
 	glEnd();
 	*/
 
-	Common::TransformationMatrix tform = _absolutePosition;
+	Common::TransformationMatrix tform = getRenderState().absolutePosition;
 	tform.translate((maxX + minX) * 0.5f, (maxY + minY) * 0.5f, (maxZ + minZ) * 0.5f);
 	tform.scale((maxX - minX) * 0.5f, (maxY - minY) * 0.5f, (maxZ - minZ) * 0.5f);
 	_boundRenderable->renderImmediate(tform);
@@ -617,6 +716,7 @@ void Model::finalize() {
 	createStateNamesList();
 	setState();
 
+	createFlatNodeLists();
 	createBound();
 
 	// Order all node children lists
@@ -625,6 +725,68 @@ void Model::finalize() {
 			(*n)->orderChildren();
 
 	_currentAnimation = selectDefaultAnimation();
+	_boundAnimation   = 0;
+
+	publishRenderState();
+}
+
+void Model::instantiateStates(const Model &modelTemplate) {
+	std::map<const State *, State *> states;
+	std::map<const ModelNode *, ModelNode *> nodes;
+
+	for (StateList::const_iterator s = modelTemplate._stateList.begin();
+	     s != modelTemplate._stateList.end(); ++s) {
+
+		State *state = new State;
+		state->name = (*s)->name;
+
+		_stateList.push_back(state);
+		states.insert(std::make_pair(*s, state));
+
+		for (NodeList::const_iterator n = (*s)->nodeList.begin(); n != (*s)->nodeList.end(); ++n) {
+			ModelNode *node = new ModelNode(*this, **n);
+
+			state->nodeList.push_back(node);
+			nodes.insert(std::make_pair(*n, node));
+		}
+	}
+
+	// Reconnect the node hierarchy, now that all nodes exist
+	for (std::map<const ModelNode *, ModelNode *>::iterator n = nodes.begin(); n != nodes.end(); ++n) {
+		std::map<const ModelNode *, ModelNode *>::iterator parent = nodes.find(n->first->_parent);
+		if (parent != nodes.end())
+			n->second->_parent = parent->second;
+
+		for (std::list<ModelNode *>::const_iterator c = n->first->_children.begin();
+		     c != n->first->_children.end(); ++c) {
+
+			std::map<const ModelNode *, ModelNode *>::iterator child = nodes.find(*c);
+			if (child != nodes.end())
+				n->second->_children.push_back(child->second);
+		}
+	}
+
+	for (StateList::const_iterator s = modelTemplate._stateList.begin();
+	     s != modelTemplate._stateList.end(); ++s) {
+
+		State *state = states[*s];
+
+		for (NodeMap::const_iterator n = (*s)->nodeMap.begin(); n != (*s)->nodeMap.end(); ++n)
+			if (nodes.find(n->second) != nodes.end())
+				state->nodeMap.insert(std::make_pair(n->first, nodes[n->second]));
+
+		for (NodeList::const_iterator n = (*s)->rootNodes.begin(); n != (*s)->rootNodes.end(); ++n)
+			if (nodes.find(*n) != nodes.end())
+				state->rootNodes.push_back(nodes[*n]);
+	}
+
+	for (StateMap::const_iterator s = modelTemplate._stateMap.begin();
+	     s != modelTemplate._stateMap.end(); ++s)
+		if (states.find(s->second) != states.end())
+			_stateMap.insert(std::make_pair(s->first, states[s->second]));
+
+	if (states.find(modelTemplate._currentState) != states.end())
+		_currentState = states[modelTemplate._currentState];
 }
 
 void Model::createStateNamesList() {
@@ -634,20 +796,88 @@ void Model::createStateNamesList() {
 		_stateNames.push_back((*s)->name);
 }
 
+void Model::createBoundRenderable() {
+	_boundRenderable = new Shader::ShaderRenderable();
+	_boundRenderable->setSurface(SurfaceMan.getSurface("defaultSurface"));
+	_boundRenderable->setMaterial(MaterialMan.getMaterial("defaultWhite"));
+	_boundRenderable->setMesh(MeshMan.getMesh("defaultWireBox"));
+}
+
+void Model::createFlatNodeLists() {
+	for (StateList::iterator s = _stateList.begin(); s != _stateList.end(); ++s) {
+		std::vector<ModelNode *> &nodes   = (*s)->flatNodes;
+		std::vector<int32>       &parents = (*s)->flatParents;
+
+		nodes.clear();
+		parents.clear();
+
+		nodes.reserve((*s)->nodeList.size());
+		parents.reserve((*s)->nodeList.size());
+
+		for (NodeList::iterator r = (*s)->rootNodes.begin(); r != (*s)->rootNodes.end(); ++r) {
+			nodes.push_back(*r);
+			parents.push_back(-1);
+		}
+
+		// Breadth-first, so every node is appended after its parent
+		for (size_t i = 0; i < nodes.size(); i++) {
+			for (std::list<ModelNode *>::iterator c = nodes[i]->_children.begin();
+			     c != nodes[i]->_children.end(); ++c) {
+
+				nodes.push_back(*c);
+				parents.push_back(i);
+			}
+		}
+	}
+}
+
+void Model::createAbsolutePositions() {
+	if (!_currentState)
+		return;
+
+	const std::vector<ModelNode *> &nodes   = _currentState->flatNodes;
+	const std::vector<int32>       &parents = _currentState->flatParents;
+
+	for (size_t i = 0; i < nodes.size(); i++) {
+		Common::TransformationMatrix position;
+		if (parents[i] >= 0)
+			position = nodes[parents[i]]->_absolutePosition;
+
+		nodes[i]->applyTransformation(position);
+
+		nodes[i]->_absolutePosition = position;
+	}
+}
+
 void Model::createBound() {
 	_boundBox.clear();
 
 	if (!_currentState)
 		return;
 
-	for (NodeList::iterator n = _currentState->rootNodes.begin();
-	     n != _currentState->rootNodes.end(); ++n) {
+	createAbsolutePositions();
 
-		Common::BoundingBox position;
+	const std::vector<ModelNode *> &nodes   = _currentState->flatNodes;
+	const std::vector<int32>       &parents = _currentState->flatParents;
 
-		(*n)->createAbsoluteBound(position);
+	// Each node's own bounding box, in model space
+	for (size_t i = 0; i < nodes.size(); i++) {
+		Common::BoundingBox bound;
+
+		bound.transform(nodes[i]->_absolutePosition);
+		bound.add(nodes[i]->_boundBox);
+		bound.absolutize();
+
+		nodes[i]->_absoluteBoundBox = bound;
+	}
 
-		_boundBox.add((*n)->getAbsoluteBound());
+	/* Add each node's box to its parent's. Going backwards, all children of a
+	 * node have been added to it before it's added to its own parent. */
+	for (size_t i = nodes.size(); i-- > 0; ) {
+		if (parents[i] >= 0)
+			nodes[parents[i]]->_absoluteBoundBox.add(nodes[i]->_absoluteBoundBox);
+		else
+			_boundBox.add(nodes[i]->_absoluteBoundBox);
 	}
 
 	float minX, minY, minZ, maxX, maxY, maxZ;
@@ -664,12 +894,12 @@ void Model::createBound() {
 	_absoluteBoundBox.absolutize();
 }
 
-void Model::readValue(Common::SeekableReadStream &stream, uint32 &value) {
-	value = stream.readUint32LE();
+void Model::readValues(Common::SeekableReadStream &stream, uint32 *values, uint32 count) {
+	stream.readUint32LE(values, count);
 }
 
-void Model::readValue(Common::SeekableReadStream &stream, float &value) {
-	value = stream.readIEEEFloatLE();
+void Model::readValues(Common::SeekableReadStream &stream, float *values, uint32 count) {
+	stream.readIEEEFloatLE(values, count);
 }
 
 void Model::readArrayDef(Common::SeekableReadStream &stream,
@@ -694,8 +924,8 @@ void Model::readArray(Common::SeekableReadStream &stream,
 	uint32 pos = stream.seek(offset);
 
 	values.resize(count);
-	for (uint32 i = 0; i < count; i++)
-		readValue(stream, values[i]);
+	if (count > 0)
+		readValues(stream, &values[0], count);
 
 	stream.seek(pos);
 }
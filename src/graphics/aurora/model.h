@@ -29,7 +29,10 @@
 #include <list>
 #include <map>
 
+#include <boost/shared_ptr.hpp>
+
 #include "src/common/ustring.h"
+#include "src/common/triplebuffer.h"
 #include "src/common/transmatrix.h"
 #include "src/common/boundingbox.h"
 
@@ -38,6 +41,7 @@
 #include "src/graphics/renderable.h"
 
 #include "src/graphics/aurora/types.h"
+#include "src/graphics/aurora/animation.h"
 
 #include "src/graphics/shader/shaderrenderable.h"
 
@@ -55,6 +59,14 @@ class Animation;
 class Model : public GLContainer, public Renderable {
 public:
 	Model(ModelType type = kModelTypeObject);
+	/** Create an instance of a model template.
+	 *
+	 *  The instance shares the node geometry and the animations with the
+	 *  template, but has its own node hierarchy, transformations, animation
+	 *  state and textures. The template is kept alive for as long as any of
+	 *  its instances exist.
+	 */
+	Model(const boost::shared_ptr<Model> &modelTemplate);
 	~Model();
 
 	ModelType getType() const; ///< Return the model's type.
@@ -79,6 +91,11 @@ public:
 	/** Does the line from x1.y1.z1 to x2.y2.z2 intersect with model's bounding box? */
 	bool isIn(float x1, float y1, float z1, float x2, float y2, float z2) const;
 
+	/** Get the model's bounding box in world space. */
+	bool getWorldBound(float min[3], float max[3]) const;
+	/** Get the model's bounding box in world space, as last picked up by the renderer. */
+	bool getRenderBound(float min[3], float max[3]) const;
+
 
 	// Positioning
 
@@ -147,6 +164,7 @@ public:
 
 
 	// Renderable
+	bool updateRenderState();
 	void calculateDistance();
 	void render(RenderPass pass);
 	void advanceTime(float dt);
@@ -165,6 +183,11 @@ protected:
 		NodeMap  nodeMap;  ///< The nodes within the state, indexed by name.
 
 		NodeList rootNodes; ///< The nodes in the state without a parent.
+
+		/** All nodes in the state, ordered so that parents come before their children. */
+		std::vector<ModelNode *> flatNodes;
+		/** For each node in flatNodes, the index of its parent in there. -1 for root nodes. */
+		std::vector<int32> flatParents;
 	};
 
 	typedef std::list<State *> StateList;
@@ -189,6 +212,9 @@ protected:
 	Common::UString _superModelName; ///< Name of the supermodel.
 	Model *_supermodel; ///< The actual supermodel.
 
+	/** The template this model is an instance of, if any. */
+	boost::shared_ptr<Model> _template;
+
 	StateList _stateList;   ///< All states within this model.
 	StateMap  _stateMap;    ///< All states within this model, index by name.
 	State   *_currentState; ///< The current state.
@@ -215,6 +241,24 @@ protected:
 
 	Common::TransformationMatrix _absolutePosition;
 
+	/** Everything the renderer needs to know about the model's placement. */
+	struct RenderState {
+		float scale[3];
+		float position[3];
+		float rotation[3];
+
+		float center[3]; ///< The model's center, in world space.
+
+		Common::TransformationMatrix absolutePosition;
+
+		bool  hasBound;    ///< Does the model have a bounding box?
+		float boundMin[3]; ///< Minimum of the bounding box, in world space.
+		float boundMax[3]; ///< Maximum of the bounding box, in world space.
+	};
+
+	/** Snapshots of the model's placement, handed from the game to the render thread. */
+	Common::TripleBuffer<RenderState> _renderState;
+
 	/** The model's bounding box. */
 	Common::BoundingBox _boundBox;
 	/** The model's box after translate/rotate. */
@@ -226,10 +270,15 @@ protected:
 	void doDrawBound();
 	void doDrawSkeleton();
 
+	/** Estimate how much of the screen the model covers, 0.0f to 1.0f. */
+	float getScreenCoverage() const;
+
 	// Animation
 
 	/** Get the animation from its name. */
 	Animation *getAnimation(const Common::UString &anim);
+	/** Is this node animated by any of our or our supermodel's animations? */
+	bool isNodeAnimated(const Common::UString &node) const;
 
 
 	/** Finalize the loading procedure. */
@@ -237,6 +286,15 @@ protected:
 
 	virtual void createAbsolutePosition();
 
+	/** Publish the model's current placement to the render thread.
+	 *
+	 *  The renderer picks it up at the start of the next frame, and culls,
+	 *  sorts and draws the model with it for that whole frame.
+	 */
+	void publishRenderState();
+	/** Return the placement picked up for the current frame. Render thread only. */
+	const RenderState &getRenderState() const;
+
 
 	// GLContainer
 	void doRebuild();
@@ -252,9 +310,21 @@ private:
 
 	float _elapsedTime; ///< Track animation duration
 
+	const Animation *_boundAnimation;     ///< The animation bound to our nodes.
+	AnimationChannels _animationChannels; ///< The channels of the bound animation.
+
 	void createStateNamesList(); ///< Create the list of all state names.
 	void createBound();          ///< Create the model's bounding box.
 
+	/** Create the parent-ordered lists of all nodes in every state. */
+	void createFlatNodeLists();
+	/** Calculate the absolute positions of all nodes in the current state in one pass. */
+	void createAbsolutePositions();
+	void createBoundRenderable(); ///< Create the renderable drawing the bounding box.
+
+	/** Copy all states and their nodes from the template. */
+	void instantiateStates(const Model &modelTemplate);
+
 	void manageAnimations(float dt);
 
 	Animation *selectDefaultAnimation() const;
@@ -263,8 +333,8 @@ private:
 public:
 	// General loading helpers
 
-	static void readValue(Common::SeekableReadStream &stream, uint32 &value);
-	static void readValue(Common::SeekableReadStream &stream, float  &value);
+	static void readValues(Common::SeekableReadStream &stream, uint32 *values, uint32 count);
+	static void readValues(Common::SeekableReadStream &stream, float  *values, uint32 count);
 
 	static void readArrayDef(Common::SeekableReadStream &stream,
 	                         uint32 &offset, uint32 &count);
@@ -274,6 +344,7 @@ public:
 	                      uint32 offset, uint32 count, std::vector<T> &values);
 
 	friend class ModelNode;
+	friend class StaticGeometry;
 };
 
 } // End of namespace Aurora
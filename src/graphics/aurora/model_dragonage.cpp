@@ -31,6 +31,9 @@
 
 #include <cstdio>
 
+#include <set>
+#include <vector>
+
 #include "src/common/util.h"
 #include "src/common/strutil.h"
 #include "src/common/error.h"
@@ -120,6 +123,27 @@ static const GFF4Struct *findMeshChunk(const GFF4Struct &mshTop, const Common::U
 
 	return 0;
 }
+
+/** Collect the names of the material objects used by all meshes under this node. */
+static void collectMaterials(const GFF4Struct &nodeGFF, std::set<Common::UString> &materials) {
+	if (isType(nodeGFF, kMSHHID)) {
+		const Common::UString materialName = nodeGFF.getString(kGFF4MMHMaterialObject);
+		if (!materialName.empty())
+			materials.insert(materialName);
+	}
+
+	const GFF4Struct *children = nodeGFF.getGeneric(kGFF4MMHChildren);
+	if (!children)
+		return;
+
+	for (size_t i = 0; i < children->getFieldCount(); i++) {
+		const GFF4Struct *childGFF = getChild(*children, i);
+		if (!isType(childGFF, kNODEID) && !isType(childGFF, kMSHHID) && !isType(childGFF, kCRSTID))
+			continue;
+
+		collectMaterials(*childGFF, materials);
+	}
+}
 // '--- GFF4 helpers
 
 
@@ -172,6 +196,10 @@ void Model_DragonAge::ParserContext::open(const Common::UString &name) {
 }
 
 Model_DragonAge::ParserContext::~ParserContext() {
+	for (std::map<Common::UString, Common::SeekableReadStream *>::iterator m = materials.begin();
+	     m != materials.end(); ++m)
+		delete m->second;
+
 	delete msh;
 	delete mmh;
 
@@ -214,6 +242,8 @@ void Model_DragonAge::load(ParserContext &ctx) {
 	if (!rootNodes)
 		return;
 
+	prefetchMaterials(ctx);
+
 	newState(ctx);
 
 	// Create root nodes
@@ -231,6 +261,31 @@ void Model_DragonAge::load(ParserContext &ctx) {
 	addState(ctx);
 }
 
+void Model_DragonAge::prefetchMaterials(ParserContext &ctx) {
+	std::set<Common::UString> materialSet;
+	collectMaterials(*ctx.mmhTop, materialSet);
+
+	std::vector<Common::UString> materialNames(materialSet.begin(), materialSet.end());
+	if (materialNames.size() < 2)
+		return;
+
+	/* Read all material objects in one batch, so that the ones in compressed
+	 * archives are decompressed concurrently. */
+
+	std::vector<Common::SeekableReadStream *> streams;
+	try {
+		ResMan.getResources(materialNames, kFileTypeMAO, streams);
+	} catch (...) {
+		/* One of the material objects failed to read. Don't prefetch any, then;
+		 * readMAO() will read them one by one, and only the broken one will fail. */
+		return;
+	}
+
+	for (size_t i = 0; i < materialNames.size(); i++)
+		if (streams[i])
+			ctx.materials.insert(std::make_pair(materialNames[i], streams[i]));
+}
+
 void Model_DragonAge::newState(ParserContext &ctx) {
 	ctx.clear();
 
@@ -275,8 +330,8 @@ void ModelNode_DragonAge::read2Float32(Common::ReadStream &stream, MeshDeclType
 		case kMeshDeclTypeFloat32_2:
 		case kMeshDeclTypeFloat32_3:
 		case kMeshDeclTypeFloat32_4:
-			*f++ = stream.readIEEEFloatLE();
-			*f++ = stream.readIEEEFloatLE();
+			stream.readIEEEFloatLE(f, 2);
+			f += 2;
 			break;
 
 		case kMeshDeclTypeSint16_2:
@@ -312,9 +367,8 @@ void ModelNode_DragonAge::read3Float32(Common::ReadStream &stream, MeshDeclType
 	switch (type) {
 		case kMeshDeclTypeFloat32_3:
 		case kMeshDeclTypeFloat32_4:
-			*f++ = stream.readIEEEFloatLE();
-			*f++ = stream.readIEEEFloatLE();
-			*f++ = stream.readIEEEFloatLE();
+			stream.readIEEEFloatLE(f, 3);
+			f += 3;
 			break;
 
 		case kMeshDeclTypeColor:
@@ -387,17 +441,14 @@ void ModelNode_DragonAge::read3Float32(Common::ReadStream &stream, MeshDeclType
 void ModelNode_DragonAge::read4Float32(Common::ReadStream &stream, MeshDeclType type, float *&f) {
 	switch (type) {
 		case kMeshDeclTypeFloat32_3:
-			*f++ = stream.readIEEEFloatLE();
-			*f++ = stream.readIEEEFloatLE();
-			*f++ = stream.readIEEEFloatLE();
+			stream.readIEEEFloatLE(f, 3);
+			f += 3;
 			*f++ = 1.0f;
 			break;
 
 		case kMeshDeclTypeFloat32_4:
-			*f++ = stream.readIEEEFloatLE();
-			*f++ = stream.readIEEEFloatLE();
-			*f++ = stream.readIEEEFloatLE();
-			*f++ = stream.readIEEEFloatLE();
+			stream.readIEEEFloatLE(f, 4);
+			f += 4;
 			break;
 
 		case kMeshDeclTypeColor:
@@ -492,6 +543,7 @@ void ModelNode_DragonAge::load(Model_DragonAge::ParserContext &ctx, const GFF4St
 
 	// Create the bounding box
 	createBound();
+	packGeometry();
 }
 
 void ModelNode_DragonAge::readTransformation(const GFF4Struct &nodeGFF) {
@@ -607,14 +659,13 @@ void ModelNode_DragonAge::createIndexBuffer(const GFF4Struct &meshChunk,
 		Common::SeekableReadStream &indexData) {
 
 	uint32 indexCount = meshChunk.getUint(kGFF4MeshChunkIndexCount);
-	_indexBuffer.setSize(indexCount, sizeof(uint16), GL_UNSIGNED_SHORT);
+	_geometry->indexBuffer.setSize(indexCount, sizeof(uint16), GL_UNSIGNED_SHORT);
 
 	const uint32 startIndex = meshChunk.getUint(kGFF4MeshChunkStartIndex);
 	indexData.skip(startIndex * 2);
 
-	uint16 *indices = (uint16 *) _indexBuffer.getData();
-	while (indexCount-- > 0)
-		*indices++ = indexData.readUint16LE();
+	uint16 *indices = (uint16 *) _geometry->indexBuffer.getData();
+	indexData.readUint16LE(indices, indexCount);
 }
 
 void ModelNode_DragonAge::createVertexBuffer(const GFF4Struct &meshChunk,
@@ -651,9 +702,9 @@ void ModelNode_DragonAge::createVertexBuffer(const GFF4Struct &meshChunk,
 		}
 	}
 
-	_vertexBuffer.setVertexDeclInterleave(vertexCount, vertexDecl);
+	_geometry->vertexBuffer.setVertexDeclInterleave(vertexCount, vertexDecl);
 
-	float *vData = (float *) _vertexBuffer.getData();
+	float *vData = (float *) _geometry->vertexBuffer.getData();
 	for (uint32 v = 0; v < vertexCount; v++) {
 
 		for (MeshDeclarations::const_iterator d = meshDecl.begin(); d != meshDecl.end(); ++d) {
@@ -710,14 +761,22 @@ void ModelNode_DragonAge::readMAOGFF(Common::SeekableReadStream *maoStream, Mate
 
 	// Vectors
 	const GFF4List &vectors = maoTop.getList(kGFF4MAOVectors);
-	for (GFF4List::const_iterator v = floats.begin(); v != floats.end(); ++v) {
+	for (GFF4List::const_iterator v = vectors.begin(); v != vectors.end(); ++v) {
 		if (!isType(*v, kFLT4ID))
 			continue;
 
-		double v1 = 0.0, v2 = 0.0, v3 = 0.0, v4 = 1.0;
-		(*v)->getVector4(kGFF4MAOVectorValue, v1, v2, v3, v4);
+		// Read the vector's components as floats, without going through doubles
+		std::vector<float> value;
+		(*v)->getFloat(kGFF4MAOVectorValue, value);
 
-		material.vectors[(*v)->getString(kGFF4MAOVectorName)] = Common::Vector3(v1, v2, v3, v4);
+		// Missing components default to (0, 0, 0, 1)
+		if (value.size() < 4) {
+			value.resize(3, 0.0f);
+			value.resize(4, 1.0f);
+		}
+
+		material.vectors[(*v)->getString(kGFF4MAOVectorName)] =
+			Common::Vector3(value[0], value[1], value[2], value[3]);
 	}
 
 	// Textures
@@ -780,10 +839,20 @@ void ModelNode_DragonAge::readMAOXML(Common::SeekableReadStream *maoStream, Mate
 }
 
 /** Read a material object MAO, which can be encoded in either XML or GFF. */
-void ModelNode_DragonAge::readMAO(const Common::UString &materialName, MaterialObject &material) {
+void ModelNode_DragonAge::readMAO(Model_DragonAge::ParserContext &ctx,
+                                  const Common::UString &materialName, MaterialObject &material) {
 	try {
 
-		Common::SeekableReadStream *maoStream = ResMan.getResource(materialName, kFileTypeMAO);
+		Common::SeekableReadStream *maoStream = 0;
+
+		// Take the prefetched MAO, if there is one
+		std::map<Common::UString, Common::SeekableReadStream *>::iterator m = ctx.materials.find(materialName);
+		if (m != ctx.materials.end()) {
+			maoStream = m->second;
+			ctx.materials.erase(m);
+		} else
+			maoStream = ResMan.getResource(materialName, kFileTypeMAO);
+
 		if (!maoStream)
 			throw Common::Exception("No such MAO");
 
@@ -843,7 +912,7 @@ void ModelNode_DragonAge::readMesh(Model_DragonAge::ParserContext &ctx, const GF
 		// Load the material object, grab the diffuse texture and load
 
 		MaterialObject materialObject;
-		readMAO(materialName, materialObject);
+		readMAO(ctx, materialName, materialObject);
 
 		std::vector<Common::UString> textures;
 		textures.push_back(materialObject.textures["mml_tDiffuse"]);
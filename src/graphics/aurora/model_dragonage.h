@@ -25,6 +25,8 @@
 #ifndef GRAPHICS_AURORA_MODEL_DRAGONAGE_H
 #define GRAPHICS_AURORA_MODEL_DRAGONAGE_H
 
+#include <map>
+
 #include "src/common/vector3.h"
 
 #include "src/aurora/types.h"
@@ -74,6 +76,9 @@ private:
 
 		std::list<ModelNode_DragonAge *> nodes;
 
+		/** Material objects fetched ahead of time, by name. */
+		std::map<Common::UString, Common::SeekableReadStream *> materials;
+
 		ParserContext(const Common::UString &name);
 		~ParserContext();
 
@@ -86,6 +91,7 @@ private:
 	void addState(ParserContext &ctx);
 
 	void load(ParserContext &ctx);
+	void prefetchMaterials(ParserContext &ctx);
 
 	friend class ModelNode_DragonAge;
 };
@@ -178,7 +184,8 @@ private:
 	void createVertexBuffer(const ::Aurora::GFF4Struct &meshChunk, Common::SeekableReadStream &vertexData,
 	                        const MeshDeclarations &meshDecl);
 
-	void readMAO(const Common::UString &materialName, MaterialObject &material);
+	void readMAO(Model_DragonAge::ParserContext &ctx, const Common::UString &materialName,
+	             MaterialObject &material);
 	void readMAOGFF(Common::SeekableReadStream *maoStream, MaterialObject &material);
 	void readMAOXML(Common::SeekableReadStream *maoStream, MaterialObject &material);
 
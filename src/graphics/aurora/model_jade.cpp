@@ -455,16 +455,13 @@ void ModelNode_Jade::readMesh(Model_Jade::ParserContext &ctx) {
 	for (uint32 i = 0; i < vertexCount; i++) {
 		ctx.mdx->seek(vertexOffset + i * mdxStructSize);
 
-		ctx.vertices[i * 3 + 0] = ctx.mdx->readIEEEFloatLE();
-		ctx.vertices[i * 3 + 1] = ctx.mdx->readIEEEFloatLE();
-		ctx.vertices[i * 3 + 2] = ctx.mdx->readIEEEFloatLE();
+		ctx.mdx->readIEEEFloatLE(&ctx.vertices[i * 3], 3);
 
 		for (uint32 t = 0; t < textureCount; t++) {
 			if ((offUV[t] != 0xFFFFFFFF) && ((offUV[t] + 8) <= mdxStructSize)) {
 				ctx.mdx->seek(vertexOffset + i * mdxStructSize + offUV[t]);
 
-				ctx.texCoords[t][i * 2 + 0] = ctx.mdx->readIEEEFloatLE();
-				ctx.texCoords[t][i * 2 + 1] = ctx.mdx->readIEEEFloatLE();
+				ctx.mdx->readIEEEFloatLE(&ctx.texCoords[t][i * 2], 2);
 			} else {
 				ctx.texCoords[t][i * 2 + 0] = 0.0f;
 				ctx.texCoords[t][i * 2 + 1] = 0.0f;
@@ -491,8 +488,8 @@ void ModelNode_Jade::readPlainIndices(Common::SeekableReadStream &stream, std::v
 	stream.seek(offset);
 
 	indices.resize(count);
-	for (std::vector<uint16>::iterator i = indices.begin(); i != indices.end(); ++i)
-		*i = stream.readUint16LE();
+	if (count > 0)
+		stream.readUint16LE(&indices[0], count);
 
 	stream.seek(pos);
 }
@@ -517,8 +514,12 @@ void ModelNode_Jade::readChunkedIndices(Common::SeekableReadStream &stream, std:
 		uint32 chunkLength = ((chunk >> 16) & 0x1FFF) / 2;
 		uint32 toRead = MIN(chunkLength, count);
 
-		for (uint32 i = 0; i < toRead; i++)
-			indices.push_back(stream.readUint16LE());
+		if (toRead > 0) {
+			const size_t start = indices.size();
+
+			indices.resize(start + toRead);
+			stream.readUint16LE(&indices[start], toRead);
+		}
 
 		count -= toRead;
 	}
@@ -609,9 +610,9 @@ void ModelNode_Jade::createMesh(Model_Jade::ParserContext &ctx) {
 	for (uint t = 0; t < textureCount; t++)
 		vertexDecl.push_back(VertexAttrib(VTCOORD + t , 2, GL_FLOAT));
 
-	_vertexBuffer.setVertexDeclInterleave(vertexCount, vertexDecl);
+	_geometry->vertexBuffer.setVertexDeclInterleave(vertexCount, vertexDecl);
 
-	float *v = (float *) _vertexBuffer.getData();
+	float *v = (float *) _geometry->vertexBuffer.getData();
 	for (uint32 i = 0; i < vertexCount; i++) {
 		// Position
 		*v++ = ctx.vertices[i * 3 + 0];
@@ -625,12 +626,13 @@ void ModelNode_Jade::createMesh(Model_Jade::ParserContext &ctx) {
 		}
 	}
 
-	_indexBuffer.setSize(indexCount, sizeof(uint16), GL_UNSIGNED_SHORT);
+	_geometry->indexBuffer.setSize(indexCount, sizeof(uint16), GL_UNSIGNED_SHORT);
 
-	uint16 *f = (uint16 *) _indexBuffer.getData();
+	uint16 *f = (uint16 *) _geometry->indexBuffer.getData();
 	memcpy(f, &ctx.indices[0], indexCount * sizeof(uint16));
 
 	createBound();
+	packGeometry();
 }
 
 /** Opens the resource for the materialID and parses it to return the 4 normal textures.
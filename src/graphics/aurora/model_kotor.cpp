@@ -533,28 +533,22 @@ void ModelNode_KotOR::readMesh(Model_KotOR::ParserContext &ctx) {
 	for (uint t = 0; t < textureCount; t++)
 		vertexDecl.push_back(VertexAttrib(VTCOORD + t , 2, GL_FLOAT));
 
-	_vertexBuffer.setVertexDeclInterleave(vertexCount, vertexDecl);
+	_geometry->vertexBuffer.setVertexDeclInterleave(vertexCount, vertexDecl);
 
-	float *v = (float *)_vertexBuffer.getData();
+	float *v = (float *)_geometry->vertexBuffer.getData();
 	for (uint32 i = 0; i < vertexCount; i++) {
-		// Position
+		// Position and normal
 		ctx.mdx->seek(offNodeData + i * mdxStructSize);
-		*v++ = ctx.mdx->readIEEEFloatLE();
-		*v++ = ctx.mdx->readIEEEFloatLE();
-		*v++ = ctx.mdx->readIEEEFloatLE();
-
-		// Normal
 		//ctx.mdx->seek(offNodeData + i * mdxStructSize + offNormals);
-		*v++ = ctx.mdx->readIEEEFloatLE();
-		*v++ = ctx.mdx->readIEEEFloatLE();
-		*v++ = ctx.mdx->readIEEEFloatLE();
+		ctx.mdx->readIEEEFloatLE(v, 6);
+		v += 6;
 
 		// TexCoords
 		for (uint16 t = 0; t < textureCount; t++) {
 			if (offUV[t] != 0xFFFFFFFF) {
 				ctx.mdx->seek(offNodeData + i * mdxStructSize + offUV[t]);
-				*v++ = ctx.mdx->readIEEEFloatLE();
-				*v++ = ctx.mdx->readIEEEFloatLE();
+				ctx.mdx->readIEEEFloatLE(v, 2);
+				v += 2;
 			} else {
 				*v++ = 0.0f;
 				*v++ = 0.0f;
@@ -570,13 +564,13 @@ void ModelNode_KotOR::readMesh(Model_KotOR::ParserContext &ctx) {
 
 	ctx.mdl->seek(ctx.offModelData + offVerts);
 
-	_indexBuffer.setSize(facesCount * 3, sizeof(uint16), GL_UNSIGNED_SHORT);
+	_geometry->indexBuffer.setSize(facesCount * 3, sizeof(uint16), GL_UNSIGNED_SHORT);
 
-	uint16 *f = (uint16 *) _indexBuffer.getData();
-	for (uint32 i = 0; i < facesCount * 3; i++)
-		f[i] = ctx.mdl->readUint16LE();
+	uint16 *f = (uint16 *) _geometry->indexBuffer.getData();
+	ctx.mdl->readUint16LE(f, facesCount * 3);
 
 	createBound();
+	packGeometry();
 
 	ctx.mdl->seek(endPos);
 }
@@ -29,6 +29,9 @@
  */
 
 #include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
 
 #include <boost/unordered_set.hpp>
 
@@ -37,10 +40,17 @@
 #include "src/common/maths.h"
 #include "src/common/debug.h"
 #include "src/common/readstream.h"
+#include "src/common/memreadstream.h"
+#include "src/common/memwritestream.h"
+#include "src/common/readfile.h"
+#include "src/common/writefile.h"
+#include "src/common/filepath.h"
+#include "src/common/hash.h"
 #include "src/common/strutil.h"
 #include "src/common/encoding.h"
 #include "src/common/streamtokenizer.h"
 #include "src/common/vector3.h"
+#include "src/common/configman.h"
 
 #include "src/aurora/types.h"
 #include "src/aurora/resman.h"
@@ -114,13 +124,58 @@ static const uint16 kControllerTypeSizeMid_Y            = 488;
 static const uint16 kControllerTypeSelfIllumColor       = 100;
 static const uint16 kControllerTypeAlpha                = 128;
 
+/** The ID of an ASCII MDL model cache file. */
+static const uint32 kCacheID      = MKTAG('X', 'M', 'D', 'C');
+/** The version of the model cache format. Bump whenever the format or the ASCII parser changes. */
+static const uint32 kCacheVersion = 1;
+
 namespace Graphics {
 
 namespace Aurora {
 
+static Common::UString getASCIICacheFile(uint64 hash) {
+	return Common::FilePath::getUserDataDirectory() + "/mdlcache/" +
+	       Common::UString::format("%08X%08X.xmdc", (uint) (hash >> 32), (uint) (hash & 0xFFFFFFFF));
+}
+
+static void writeCacheString(Common::WriteStream &cache, const Common::UString &str) {
+	const size_t length = std::strlen(str.c_str());
+
+	cache.writeUint32LE(length);
+	cache.write(str.c_str(), length);
+}
+
+static Common::UString readCacheString(Common::SeekableReadStream &cache) {
+	const uint32 length = cache.readUint32LE();
+
+	return Common::readStringFixed(cache, Common::kEncodingUTF8, length);
+}
+
+static void writeCacheFloats(Common::WriteStream &cache, const std::vector<float> &floats) {
+	for (std::vector<float>::const_iterator f = floats.begin(); f != floats.end(); ++f)
+		cache.writeIEEEFloatLE(*f);
+}
+
+static void readCacheFloats(Common::SeekableReadStream &cache, std::vector<float> &floats, uint32 count) {
+	floats.resize(count);
+	if (count > 0)
+		cache.readIEEEFloatLE(&floats[0], count);
+}
+
+static void writeCacheInts(Common::WriteStream &cache, const std::vector<uint32> &ints) {
+	for (std::vector<uint32>::const_iterator i = ints.begin(); i != ints.end(); ++i)
+		cache.writeUint32LE(*i);
+}
+
+static void readCacheInts(Common::SeekableReadStream &cache, std::vector<uint32> &ints, uint32 count) {
+	ints.resize(count);
+	if (count > 0)
+		cache.readUint32LE(&ints[0], count);
+}
+
 Model_NWN::ParserContext::ParserContext(const Common::UString &name,
                                         const Common::UString &t) :
-	mdl(0), state(0), texture(t) {
+	mdl(0), state(0), texture(t), hash(0), cache(0), cacheNodeCount(0) {
 
 	mdl = ResMan.getResource(name, ::Aurora::kFileTypeMDL);
 	if (!mdl)
@@ -140,6 +195,7 @@ Model_NWN::ParserContext::ParserContext(const Common::UString &name,
 }
 
 Model_NWN::ParserContext::~ParserContext() {
+	delete cache;
 	delete tokenize;
 	delete mdl;
 
@@ -190,9 +246,12 @@ Model_NWN::Model_NWN(const Common::UString &name, ModelType type,
 
 	ParserContext ctx(name, texture);
 
-	if (ctx.isASCII)
-		loadASCII(ctx);
-	else
+	if (ctx.isASCII) {
+		if (!loadASCIICache(ctx)) {
+			loadASCII(ctx);
+			writeASCIICache(ctx);
+		}
+	} else
 		loadBinary(ctx);
 
 	if (!_superModelName.empty() && _superModelName != "NULL") {
@@ -349,6 +408,118 @@ void Model_NWN::loadASCII(ParserContext &ctx) {
 		readAnimASCII(ctx);
 	}
 }
+
+bool Model_NWN::loadASCIICache(ParserContext &ctx) {
+	if (!ConfigMan.getBool("mdlcache", true))
+		return false;
+
+	// Identify the model by the hash over the whole MDL
+	ctx.hash = 0xCBF29CE484222325LL;
+
+	ctx.mdl->seek(0);
+
+	byte buffer[4096];
+	size_t bufferSize;
+	while ((bufferSize = ctx.mdl->read(buffer, sizeof(buffer))) > 0)
+		for (size_t i = 0; i < bufferSize; i++)
+			ctx.hash = Common::hashFNV64(ctx.hash, buffer[i]);
+
+	// Collect the parsed nodes in case we have to create a new cache file
+	ctx.cache = new Common::MemoryWriteStreamDynamic(true);
+
+	const Common::UString cacheFile = getASCIICacheFile(ctx.hash);
+	if (!Common::FilePath::isRegularFile(cacheFile))
+		return false;
+
+	Common::SeekableReadStream *cache = 0;
+	try {
+		Common::ReadFile file(cacheFile);
+
+		cache = file.readStream(file.size());
+
+		if (cache->readUint32BE() != kCacheID)
+			throw Common::Exception("Not a model cache file");
+		if (cache->readUint32LE() != kCacheVersion)
+			throw Common::Exception("Unsupported model cache version");
+		if (cache->readUint64LE() != ctx.hash)
+			throw Common::Exception("Model cache hash mismatch");
+
+		_name           = readCacheString(*cache);
+		_superModelName = readCacheString(*cache);
+		_animationScale = cache->readIEEEFloatLE();
+
+		const uint32 nodeCount = cache->readUint32LE();
+
+		newState(ctx);
+
+		for (uint32 i = 0; i < nodeCount; i++) {
+			ModelNode_NWN_ASCII *newNode = new ModelNode_NWN_ASCII(*this);
+			ctx.nodes.push_back(newNode);
+
+			newNode->loadCache(ctx, *cache);
+		}
+
+		addState(ctx);
+
+	} catch (Common::Exception &e) {
+		delete cache;
+
+		e.add("Failed to load model cache \"%s\" for \"%s\"", cacheFile.c_str(), _fileName.c_str());
+		Common::printException(e, "WARNING: ");
+
+		// Start over from scratch
+		ctx.clear();
+
+		_name.clear();
+		_superModelName.clear();
+		_animationScale = 1.0f;
+
+		return false;
+	}
+
+	delete cache;
+
+	debugC(4, kDebugGraphics, "Loaded NWN ASCII model \"%s\" from the model cache", _fileName.c_str());
+
+	return true;
+}
+
+void Model_NWN::writeASCIICache(ParserContext &ctx) {
+	if (!ctx.cache)
+		return;
+
+	const Common::UString cacheFile = getASCIICacheFile(ctx.hash);
+	const Common::UString tempFile  = cacheFile + ".tmp";
+
+	Common::FilePath::createDirectories(Common::FilePath::getDirectory(cacheFile));
+
+	Common::WriteFile file;
+	if (!file.open(tempFile)) {
+		warning("Failed to create model cache file \"%s\"", tempFile.c_str());
+		return;
+	}
+
+	file.writeUint32BE(kCacheID);
+	file.writeUint32LE(kCacheVersion);
+	file.writeUint64LE(ctx.hash);
+
+	writeCacheString(file, _name);
+	writeCacheString(file, _superModelName);
+	file.writeIEEEFloatLE(_animationScale);
+
+	file.writeUint32LE(ctx.cacheNodeCount);
+	file.write(ctx.cache->getData(), ctx.cache->size());
+
+	file.flush();
+	file.close();
+
+	// Only make the cache file visible once it's complete
+	if (std::rename(tempFile.c_str(), cacheFile.c_str()) != 0) {
+		warning("Failed to create model cache file \"%s\"", cacheFile.c_str());
+		std::remove(tempFile.c_str());
+	}
+}
+
 void Model_NWN::newState(ParserContext &ctx) {
 	ctx.clear();
 
@@ -728,8 +899,7 @@ void ModelNode_NWN_Binary::readMesh(Model_NWN::ParserContext &ctx) {
 	uint32 colorOffset = ctx.mdl->readUint32LE(); // Vertex RGBA colors
 
 	uint32 textureAnimOffset[6]; // Texture animation data
-	for (uint32 i = 0; i < 6; i++)
-		textureAnimOffset[i] = ctx.mdl->readUint32LE();
+	ctx.mdl->readUint32LE(textureAnimOffset, 6);
 
 	bool lightMapped = ctx.mdl->readByte() == 1;
 
@@ -763,7 +933,7 @@ void ModelNode_NWN_Binary::readMesh(Model_NWN::ParserContext &ctx) {
 	// Convert to one normal per vertex by duplicating vertex data
 	// for face verts with multiple normals
 
-	_indexBuffer.setSize(facesCount * 3, sizeof(uint16), GL_UNSIGNED_SHORT);
+	_geometry->indexBuffer.setSize(facesCount * 3, sizeof(uint16), GL_UNSIGNED_SHORT);
 
 	std::vector<Normal> new_verts_norms;
 	boost::unordered_set<Normal> verts_norms;
@@ -771,13 +941,11 @@ void ModelNode_NWN_Binary::readMesh(Model_NWN::ParserContext &ctx) {
 
 	Normal n;
 	uint16 vertexCountNew = vertexCount;
-	uint16 *f = (uint16 *) _indexBuffer.getData();
+	uint16 *f = (uint16 *) _geometry->indexBuffer.getData();
 	ctx.mdl->seek(ctx.offModelData + facesOffset);
 	for (uint32 i = 0; i < facesCount; i++) {
 		// Face normal
-		n.xyz[0] = ctx.mdl->readIEEEFloatLE();
-		n.xyz[1] = ctx.mdl->readIEEEFloatLE();
-		n.xyz[2] = ctx.mdl->readIEEEFloatLE();
+		ctx.mdl->readIEEEFloatLE(n.xyz, 3);
 
 		ctx.mdl->skip(    4); // Plane distance
 		ctx.mdl->skip(    4); // Surface ID / smoothing group ??
@@ -807,9 +975,9 @@ void ModelNode_NWN_Binary::readMesh(Model_NWN::ParserContext &ctx) {
 	GLsizei vnsize = 3;
 	GLsizei vtsize = 2;
 	uint32 vertexSize = (vpsize + vnsize + vtsize * textureCount) * sizeof(float);
-	_vertexBuffer.setSize(vertexCountNew, vertexSize);
+	_geometry->vertexBuffer.setSize(vertexCountNew, vertexSize);
 
-	float *vertexData = (float *) _vertexBuffer.getData();
+	float *vertexData = (float *) _geometry->vertexBuffer.getData();
 	VertexDecl vertexDecl;
 
 	// Read vertex coordinates
@@ -826,11 +994,8 @@ void ModelNode_NWN_Binary::readMesh(Model_NWN::ParserContext &ctx) {
 	ctx.mdl->seek(ctx.offRawData + vertexOffset);
 
 	float *v = (float *) vp.pointer;
-	for (uint32 i = 0; i < vertexCount; i++) {
-		*v++ = ctx.mdl->readIEEEFloatLE();
-		*v++ = ctx.mdl->readIEEEFloatLE();
-		*v++ = ctx.mdl->readIEEEFloatLE();
-	}
+	ctx.mdl->readIEEEFloatLE(v, vertexCount * 3);
+	v += vertexCount * 3;
 
 	// duplicate positions for unique norms
 	for (size_t i = 0; i < new_verts_norms.size(); i++) {
@@ -882,10 +1047,11 @@ void ModelNode_NWN_Binary::readMesh(Model_NWN::ParserContext &ctx) {
 			ctx.mdl->seek(ctx.offRawData + textureVertexOffset[t]);
 
 		v = (float *) vt.pointer;
-		for (uint32 i = 0; i < vertexCount; i++) {
-			*v++ = hasTexture ? ctx.mdl->readIEEEFloatLE() : 0.0f;
-			*v++ = hasTexture ? ctx.mdl->readIEEEFloatLE() : 0.0f;
-		}
+		if (hasTexture)
+			ctx.mdl->readIEEEFloatLE(v, vertexCount * 2);
+		else
+			std::fill(v, v + vertexCount * 2, 0.0f);
+		v += vertexCount * 2;
 
 		// duplicate tcoords for unique norms
 		for (size_t i = 0; i < new_verts_norms.size(); i++) {
@@ -896,9 +1062,10 @@ void ModelNode_NWN_Binary::readMesh(Model_NWN::ParserContext &ctx) {
 		}
 	}
 
-	_vertexBuffer.setVertexDecl(vertexDecl);
+	_geometry->vertexBuffer.setVertexDecl(vertexDecl);
 
 	createBound();
+	packGeometry();
 
 	ctx.mdl->seek(endPos);
 }
@@ -945,18 +1112,16 @@ void ModelNode_NWN_Binary::readNodeControllers(Model_NWN::ParserContext &ctx,
 			if (columnCount != 3)
 				throw Common::Exception("Position controller with %d values", columnCount);
 			for (int r = 0; r < rowCount; r++) {
-				PositionKeyFrame p;
-				p.time = data[timeIndex + r];
-				p.x = data[dataIndex + (r * columnCount) + 0];
-				p.y = data[dataIndex + (r * columnCount) + 1];
-				p.z = data[dataIndex + (r * columnCount) + 2];
-				_positionFrames.push_back(p);
+				const float  time = data[timeIndex + r];
+				const float *p    = &data[dataIndex + (r * columnCount)];
+
+				_positionFrames.addKeyFrame(time, p);
 
 				// Starting position
-				if (p.time == 0.0f) {
-					_position[0] = p.x;
-					_position[1] = p.y;
-					_position[2] = p.z;
+				if (time == 0.0f) {
+					_position[0] = p[0];
+					_position[1] = p[1];
+					_position[2] = p[2];
 					ctx.hasPosition = true;
 				}
 			}
@@ -966,13 +1131,8 @@ void ModelNode_NWN_Binary::readNodeControllers(Model_NWN::ParserContext &ctx,
 				throw Common::Exception("Orientation controller with %d values", columnCount);
 
 			for (int r = 0; r < rowCount; r++) {
-				QuaternionKeyFrame q;
-				q.time = data[timeIndex + r];
-				q.x = data[dataIndex + (r * columnCount) + 0];
-				q.y = data[dataIndex + (r * columnCount) + 1];
-				q.z = data[dataIndex + (r * columnCount) + 2];
-				q.q = data[dataIndex + (r * columnCount) + 3];
-				_orientationFrames.push_back(q);
+				_orientationFrames.addKeyFrame(data[timeIndex + r], &data[dataIndex + (r * columnCount)]);
+
 				// Starting orientation
 				// TODO: Handle animation orientation correctly
 				if (data[timeIndex + 0] == 0.0f) {
@@ -1039,6 +1199,7 @@ void ModelNode_NWN_ASCII::load(Model_NWN::ParserContext &ctx,
 		_dangly = true;
 
 	Mesh mesh;
+	Common::UString parentName;
 
 	while (!ctx.mdl->eos()) {
 		std::vector<Common::UString> line;
@@ -1061,6 +1222,8 @@ void ModelNode_NWN_ASCII::load(Model_NWN::ParserContext &ctx,
 		} else if (line[0] == "parent") {
 			ModelNode *parent = 0;
 
+			parentName = line[1];
+
 			if (!ctx.findNode(line[1], parent))
 				warning("ModelNode_NWN_ASCII::load(): Non-existent parent node \"%s\"",
 				        line[1].c_str());
@@ -1114,6 +1277,99 @@ void ModelNode_NWN_ASCII::load(Model_NWN::ParserContext &ctx,
 	if (!end)
 		throw Common::Exception("ModelNode_NWN_ASCII::load(): node without endnode");
 
+	if (ctx.cache)
+		writeCache(*ctx.cache, parentName, mesh);
+	ctx.cacheNodeCount++;
+
+	if (!mesh.textures.empty() && !ctx.texture.empty())
+		mesh.textures[0] = ctx.texture;
+
+	processMesh(mesh);
+}
+
+void ModelNode_NWN_ASCII::writeCache(Common::WriteStream &cache, const Common::UString &parent,
+                                     const Mesh &mesh) {
+
+	writeCacheString(cache, _name);
+	writeCacheString(cache, parent);
+
+	cache.writeByte(_render           ? 1 : 0);
+	cache.writeByte(_dangly           ? 1 : 0);
+	cache.writeByte(_transparencyHint ? 1 : 0);
+
+	for (int i = 0; i < 3; i++)
+		cache.writeIEEEFloatLE(_position[i]);
+	for (int i = 0; i < 4; i++)
+		cache.writeIEEEFloatLE(_orientation[i]);
+
+	cache.writeUint32LE(mesh.textures.size());
+	for (std::vector<Common::UString>::const_iterator t = mesh.textures.begin(); t != mesh.textures.end(); ++t)
+		writeCacheString(cache, *t);
+
+	cache.writeUint32LE(mesh.vCount);
+	writeCacheFloats(cache, mesh.vX);
+	writeCacheFloats(cache, mesh.vY);
+	writeCacheFloats(cache, mesh.vZ);
+
+	cache.writeUint32LE(mesh.tCount);
+	writeCacheFloats(cache, mesh.tX);
+	writeCacheFloats(cache, mesh.tY);
+
+	cache.writeUint32LE(mesh.faceCount);
+	writeCacheInts(cache, mesh.vIA);
+	writeCacheInts(cache, mesh.vIB);
+	writeCacheInts(cache, mesh.vIC);
+	writeCacheInts(cache, mesh.tIA);
+	writeCacheInts(cache, mesh.tIB);
+	writeCacheInts(cache, mesh.tIC);
+	writeCacheInts(cache, mesh.smooth);
+	writeCacheInts(cache, mesh.mat);
+}
+
+void ModelNode_NWN_ASCII::loadCache(Model_NWN::ParserContext &ctx, Common::SeekableReadStream &cache) {
+	_name = readCacheString(cache);
+
+	const Common::UString parentName = readCacheString(cache);
+
+	ModelNode *parent = 0;
+	if (!ctx.findNode(parentName, parent))
+		warning("ModelNode_NWN_ASCII::loadCache(): Non-existent parent node \"%s\"",
+		        parentName.c_str());
+
+	setParent(parent);
+
+	_render           = cache.readByte() != 0;
+	_dangly           = cache.readByte() != 0;
+	_transparencyHint = cache.readByte() != 0;
+
+	cache.readIEEEFloatLE(_position, 3);
+	cache.readIEEEFloatLE(_orientation, 4);
+
+	Mesh mesh;
+
+	mesh.textures.resize(cache.readUint32LE());
+	for (std::vector<Common::UString>::iterator t = mesh.textures.begin(); t != mesh.textures.end(); ++t)
+		*t = readCacheString(cache);
+
+	mesh.vCount = cache.readUint32LE();
+	readCacheFloats(cache, mesh.vX, mesh.vCount);
+	readCacheFloats(cache, mesh.vY, mesh.vCount);
+	readCacheFloats(cache, mesh.vZ, mesh.vCount);
+
+	mesh.tCount = cache.readUint32LE();
+	readCacheFloats(cache, mesh.tX, mesh.tCount);
+	readCacheFloats(cache, mesh.tY, mesh.tCount);
+
+	mesh.faceCount = cache.readUint32LE();
+	readCacheInts(cache, mesh.vIA   , mesh.faceCount);
+	readCacheInts(cache, mesh.vIB   , mesh.faceCount);
+	readCacheInts(cache, mesh.vIC   , mesh.faceCount);
+	readCacheInts(cache, mesh.tIA   , mesh.faceCount);
+	readCacheInts(cache, mesh.tIB   , mesh.faceCount);
+	readCacheInts(cache, mesh.tIC   , mesh.faceCount);
+	readCacheInts(cache, mesh.smooth, mesh.faceCount);
+	readCacheInts(cache, mesh.mat   , mesh.faceCount);
+
 	if (!mesh.textures.empty() && !ctx.texture.empty())
 		mesh.textures[0] = ctx.texture;
 
@@ -1283,13 +1539,13 @@ void ModelNode_NWN_ASCII::processMesh(Mesh &mesh) {
 	// Read faces
 
 	uint32 facesCount = mesh.faceCount;
-	_indexBuffer.setSize(facesCount * 3, sizeof(uint32), GL_UNSIGNED_INT);
+	_geometry->indexBuffer.setSize(facesCount * 3, sizeof(uint32), GL_UNSIGNED_INT);
 
 	boost::unordered_set<FaceVert> verts;
 	typedef boost::unordered_set<FaceVert>::iterator verts_set_it;
 
 	uint32 vertexCount = 0;
-	uint32 *f = (uint32 *) _indexBuffer.getData();
+	uint32 *f = (uint32 *) _geometry->indexBuffer.getData();
 	for (uint32 i = 0; i < facesCount; i++) {
 		const uint32 v[3] = {mesh.vIA[i], mesh.vIB[i], mesh.vIC[i]};
 		const uint32 t[3] = {mesh.tIA[i], mesh.tIB[i], mesh.tIC[i]};
@@ -1322,9 +1578,9 @@ void ModelNode_NWN_ASCII::processMesh(Mesh &mesh) {
 	GLsizei vnsize = 3;
 	GLsizei vtsize = 2;
 	uint32 vertexSize = (vpsize + vnsize + vtsize * textureCount) * sizeof(float);
-	_vertexBuffer.setSize(vertexCount, vertexSize);
+	_geometry->vertexBuffer.setSize(vertexCount, vertexSize);
 
-	float *vertexData = (float *) _vertexBuffer.getData();
+	float *vertexData = (float *) _geometry->vertexBuffer.getData();
 	VertexDecl vertexDecl;
 
 	VertexAttrib vp;
@@ -1353,7 +1609,7 @@ void ModelNode_NWN_ASCII::processMesh(Mesh &mesh) {
 		vertexDecl.push_back(vt);
 	}
 
-	_vertexBuffer.setVertexDecl(vertexDecl);
+	_geometry->vertexBuffer.setVertexDecl(vertexDecl);
 
 	for (verts_set_it i = verts.begin(); i != verts.end(); ++i) {
 		float *v = vertexData + i->i * vertexSize / sizeof(float);
@@ -1383,6 +1639,7 @@ void ModelNode_NWN_ASCII::processMesh(Mesh &mesh) {
 	}
 
 	createBound();
+	packGeometry();
 }
 
 } // End of namespace Aurora
@@ -30,6 +30,8 @@
 
 namespace Common {
 	class SeekableReadStream;
+	class WriteStream;
+	class MemoryWriteStreamDynamic;
 	class StreamTokenizer;
 }
 
@@ -68,6 +70,13 @@ private:
 		Common::StreamTokenizer *tokenize;
 		std::vector<uint32> anims;
 
+		/** Hash over the ASCII MDL, identifying its entry in the model cache. */
+		uint64 hash;
+		/** The parsed ASCII nodes, as they're written into the model cache. */
+		Common::MemoryWriteStreamDynamic *cache;
+		/** Number of nodes in the model cache data. */
+		uint32 cacheNodeCount;
+
 		ParserContext(const Common::UString &name, const Common::UString &t);
 		~ParserContext();
 
@@ -84,6 +93,11 @@ private:
 	void readAnimBinary(ParserContext &ctx, uint32 offset);
 
 	void loadASCII(ParserContext &ctx);
+
+	/** Try to load the parsed ASCII model from the model cache. */
+	bool loadASCIICache(ParserContext &ctx);
+	/** Write the parsed ASCII model into the model cache. */
+	void writeASCIICache(ParserContext &ctx);
 	void readAnimASCII(ParserContext &ctx);
 	void skipAnimASCII(ParserContext &ctx);
 
@@ -116,6 +130,9 @@ public:
 	void load(Model_NWN::ParserContext &ctx,
 	          const Common::UString &type, const Common::UString &name);
 
+	/** Load a node that was parsed before, from the model cache. */
+	void loadCache(Model_NWN::ParserContext &ctx, Common::SeekableReadStream &cache);
+
 private:
 	struct Mesh {
 		uint32 vCount;
@@ -146,6 +163,8 @@ private:
 
 	void readFaces(Model_NWN::ParserContext &ctx, Mesh &mesh);
 
+	void writeCache(Common::WriteStream &cache, const Common::UString &parent, const Mesh &mesh);
+
 	void processMesh(Mesh &mesh);
 };
 
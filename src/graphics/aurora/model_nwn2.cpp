@@ -255,27 +255,20 @@ bool ModelNode_NWN2::loadRigid(Model_NWN2::ParserContext &ctx) {
 	if (!_tintMap.empty())
 		vertexDecl.push_back(VertexAttrib(VTCOORD + 1, 3, GL_FLOAT));
 
-	_vertexBuffer.setVertexDeclInterleave(vertexCount, vertexDecl);
+	_geometry->vertexBuffer.setVertexDeclInterleave(vertexCount, vertexDecl);
 
-	float *v = (float *) _vertexBuffer.getData();
+	float *v = (float *) _geometry->vertexBuffer.getData();
 	for (uint32 i = 0; i < vertexCount; i++) {
-		// Position
-		*v++ = ctx.mdb->readIEEEFloatLE();
-		*v++ = ctx.mdb->readIEEEFloatLE();
-		*v++ = ctx.mdb->readIEEEFloatLE();
-
-		// Normal
-		*v++ = ctx.mdb->readIEEEFloatLE();
-		*v++ = ctx.mdb->readIEEEFloatLE();
-		*v++ = ctx.mdb->readIEEEFloatLE();
+		// Position and normal
+		ctx.mdb->readIEEEFloatLE(v, 6);
+		v += 6;
 
 		ctx.mdb->skip(3 * 4); // Tangent
 		ctx.mdb->skip(3 * 4); // Binormal
 
 		// Texture Coords
-		*v++ = ctx.mdb->readIEEEFloatLE();
-		*v++ = ctx.mdb->readIEEEFloatLE();
-		*v++ = ctx.mdb->readIEEEFloatLE();
+		ctx.mdb->readIEEEFloatLE(v, 3);
+		v += 3;
 
 		// TintMap TexCoords
 		if (!_tintMap.empty()) {
@@ -289,13 +282,13 @@ bool ModelNode_NWN2::loadRigid(Model_NWN2::ParserContext &ctx) {
 
 	// Read faces
 
-	_indexBuffer.setSize(facesCount * 3, sizeof(uint16), GL_UNSIGNED_SHORT);
+	_geometry->indexBuffer.setSize(facesCount * 3, sizeof(uint16), GL_UNSIGNED_SHORT);
 
-	uint16 *f = (uint16 *) _indexBuffer.getData();
-	for (uint32 i = 0; i < facesCount * 3; i++)
-		f[i] = ctx.mdb->readUint16LE();
+	uint16 *f = (uint16 *) _geometry->indexBuffer.getData();
+	ctx.mdb->readUint16LE(f, facesCount * 3);
 
 	createBound();
+	packGeometry();
 
 	_render = true;
 
@@ -355,19 +348,13 @@ bool ModelNode_NWN2::loadSkin(Model_NWN2::ParserContext &ctx) {
 	if (!_tintMap.empty())
 		vertexDecl.push_back(VertexAttrib(VTCOORD + 1, 3, GL_FLOAT));
 
-	_vertexBuffer.setVertexDeclInterleave(vertexCount, vertexDecl);
+	_geometry->vertexBuffer.setVertexDeclInterleave(vertexCount, vertexDecl);
 
-	float *v = (float *) _vertexBuffer.getData();
+	float *v = (float *) _geometry->vertexBuffer.getData();
 	for (uint32 i = 0; i < vertexCount; i++) {
-		// Position
-		*v++ = ctx.mdb->readIEEEFloatLE();
-		*v++ = ctx.mdb->readIEEEFloatLE();
-		*v++ = ctx.mdb->readIEEEFloatLE();
-
-		// Normal
-		*v++ = ctx.mdb->readIEEEFloatLE();
-		*v++ = ctx.mdb->readIEEEFloatLE();
-		*v++ = ctx.mdb->readIEEEFloatLE();
+		// Position and normal
+		ctx.mdb->readIEEEFloatLE(v, 6);
+		v += 6;
 
 		ctx.mdb->skip(4 * 4); // Bone weights
 		ctx.mdb->skip(4 * 1); // Bone indices
@@ -375,9 +362,8 @@ bool ModelNode_NWN2::loadSkin(Model_NWN2::ParserContext &ctx) {
 		ctx.mdb->skip(3 * 4); // Binormal
 
 		// TexCoords
-		*v++ = ctx.mdb->readIEEEFloatLE();
-		*v++ = ctx.mdb->readIEEEFloatLE();
-		*v++ = ctx.mdb->readIEEEFloatLE();
+		ctx.mdb->readIEEEFloatLE(v, 3);
+		v += 3;
 
 		// TintMap TexCoords
 		if (!_tintMap.empty()) {
@@ -393,13 +379,13 @@ bool ModelNode_NWN2::loadSkin(Model_NWN2::ParserContext &ctx) {
 
 	// Read faces
 
-	_indexBuffer.setSize(facesCount * 3, sizeof(uint16), GL_UNSIGNED_SHORT);
+	_geometry->indexBuffer.setSize(facesCount * 3, sizeof(uint16), GL_UNSIGNED_SHORT);
 
-	uint16 *f = (uint16 *) _indexBuffer.getData();
-	for (uint32 i = 0; i < facesCount * 3; i++)
-		f[i] = ctx.mdb->readUint16LE();
+	uint16 *f = (uint16 *) _geometry->indexBuffer.getData();
+	ctx.mdb->readUint16LE(f, facesCount * 3);
 
 	createBound();
+	packGeometry();
 
 	_render = true;
 
@@ -1340,14 +1340,16 @@ void Model_Sonic::render(RenderPass pass) {
 		return;
 	}
 
+	const RenderState &transform = getRenderState();
+
 	// Apply our global model transformation
-	glScalef(_modelScale[0], _modelScale[1], _modelScale[2]);
+	glScalef(transform.scale[0], transform.scale[1], transform.scale[2]);
 
-	glTranslatef(_position[0], _position[1], _position[2]);
+	glTranslatef(transform.position[0], transform.position[1], transform.position[2]);
 
-	glRotatef( _rotation[0], 1.0f, 0.0f, 0.0f);
-	glRotatef( _rotation[1], 0.0f, 1.0f, 0.0f);
-	glRotatef(-_rotation[2], 0.0f, 0.0f, 1.0f);
+	glRotatef( transform.rotation[0], 1.0f, 0.0f, 0.0f);
+	glRotatef( transform.rotation[1], 0.0f, 1.0f, 0.0f);
+	glRotatef(-transform.rotation[2], 0.0f, 0.0f, 1.0f);
 
 
 	// Draw the bounding box, if requested
@@ -472,50 +472,34 @@ void ModelNode_Witcher::readMesh(Model_Witcher::ParserContext &ctx) {
 	for (uint t = 0; t < texCount; t++)
 		vertexDecl.push_back(VertexAttrib(VTCOORD + t, 2, GL_FLOAT));
 
-	_vertexBuffer.setVertexDeclLinear(vertexCount, vertexDecl);
+	_geometry->vertexBuffer.setVertexDeclLinear(vertexCount, vertexDecl);
 
 	// Read vertex position
 	ctx.mdb->seek(ctx.offRawData + vertexOffset);
 	float *v = (float *) vertexDecl[0].pointer;
-	for (uint32 i = 0; i < vertexCount; i++) {
-		*v++ = ctx.mdb->readIEEEFloatLE();
-		*v++ = ctx.mdb->readIEEEFloatLE();
-		*v++ = ctx.mdb->readIEEEFloatLE();
-	}
+	ctx.mdb->readIEEEFloatLE(v, vertexCount * 3);
 
 	// Read vertex normals
 	assert(normalsCount == vertexCount);
 	ctx.mdb->seek(ctx.offRawData + normalsOffset);
 	v = (float *) vertexDecl[1].pointer;
-	for (uint32 i = 0; i < normalsCount; i++) {
-		*v++ = ctx.mdb->readIEEEFloatLE();
-		*v++ = ctx.mdb->readIEEEFloatLE();
-		*v++ = ctx.mdb->readIEEEFloatLE();
-	}
+	ctx.mdb->readIEEEFloatLE(v, normalsCount * 3);
 
 	// Read texture coordinates
 	for (uint t = 0; t < texCount; t++) {
 
 		ctx.mdb->seek(ctx.offRawData + tVertsOffset[t]);
 		v = (float *) vertexDecl[2 + t].pointer;
-		for (uint32 i = 0; i < tVertsCount[t]; i++) {
-			if (i < tVertsCount[t]) {
-				*v++ = ctx.mdb->readIEEEFloatLE();
-				*v++ = ctx.mdb->readIEEEFloatLE();
-			} else {
-				*v++ = 0.0f;
-				*v++ = 0.0f;
-			}
-		}
+		ctx.mdb->readIEEEFloatLE(v, tVertsCount[t] * 2);
 	}
 
 
 	// Read faces
 
-	_indexBuffer.setSize(facesCount * 3, sizeof(uint32), GL_UNSIGNED_INT);
+	_geometry->indexBuffer.setSize(facesCount * 3, sizeof(uint32), GL_UNSIGNED_INT);
 
 	ctx.mdb->seek(ctx.offRawData + facesOffset);
-	uint32 *f = (uint32 *) _indexBuffer.getData();
+	uint32 *f = (uint32 *) _geometry->indexBuffer.getData();
 	for (uint32 i = 0; i < facesCount; i++) {
 		ctx.mdb->skip(4 * 4 + 4);
 
@@ -523,15 +507,15 @@ void ModelNode_Witcher::readMesh(Model_Witcher::ParserContext &ctx) {
 			ctx.mdb->skip(3 * 4);
 
 		// Vertex indices
-		*f++ = ctx.mdb->readUint32LE();
-		*f++ = ctx.mdb->readUint32LE();
-		*f++ = ctx.mdb->readUint32LE();
+		ctx.mdb->readUint32LE(f, 3);
+		f += 3;
 
 		if (ctx.fileVersion == 133)
 			ctx.mdb->skip(4);
 	}
 
 	createBound();
+	packGeometry();
 
 	ctx.mdb->seek(endPos);
 }
@@ -674,9 +658,8 @@ void ModelNode_Witcher::readTexturePaint(Model_Witcher::ParserContext &ctx) {
 
 		ctx.mdb->seek(ctx.offRawData + weightsOffset);
 		layers[l].weights.resize(weightsCount);
-
-		for (std::vector<float>::iterator w = layers[l].weights.begin(); w != layers[l].weights.end(); ++w)
-			*w = ctx.mdb->readIEEEFloatLE();
+		if (weightsCount > 0)
+			ctx.mdb->readIEEEFloatLE(&layers[l].weights[0], weightsCount);
 	}
 
 	std::vector<Common::UString> textures;
@@ -697,60 +680,44 @@ void ModelNode_Witcher::readTexturePaint(Model_Witcher::ParserContext &ctx) {
 	for (uint t = 0; t < texCount; t++)
 		vertexDecl.push_back(VertexAttrib(VTCOORD + t, 2, GL_FLOAT));
 
-	_vertexBuffer.setVertexDeclLinear(vertexCount, vertexDecl);
+	_geometry->vertexBuffer.setVertexDeclLinear(vertexCount, vertexDecl);
 
 	// Read vertex position
 	ctx.mdb->seek(ctx.offRawData + vertexOffset);
 	float *v = (float *) vertexDecl[0].pointer;
-	for (uint32 i = 0; i < vertexCount; i++) {
-		*v++ = ctx.mdb->readIEEEFloatLE();
-		*v++ = ctx.mdb->readIEEEFloatLE();
-		*v++ = ctx.mdb->readIEEEFloatLE();
-	}
+	ctx.mdb->readIEEEFloatLE(v, vertexCount * 3);
 
 	// Read vertex normals
 	assert(normalsCount == vertexCount);
 	ctx.mdb->seek(ctx.offRawData + normalsOffset);
 	v = (float *) vertexDecl[1].pointer;
-	for (uint32 i = 0; i < normalsCount; i++) {
-		*v++ = ctx.mdb->readIEEEFloatLE();
-		*v++ = ctx.mdb->readIEEEFloatLE();
-		*v++ = ctx.mdb->readIEEEFloatLE();
-	}
+	ctx.mdb->readIEEEFloatLE(v, normalsCount * 3);
 
 	// Read texture coordinates
 	for (uint t = 0; t < texCount; t++) {
 
 		ctx.mdb->seek(ctx.offRawData + tVertsOffset[t]);
 		v = (float *) vertexDecl[2 + t].pointer;
-		for (uint32 i = 0; i < tVertsCount[t]; i++) {
-			if (i < tVertsCount[t]) {
-				*v++ = ctx.mdb->readIEEEFloatLE();
-				*v++ = ctx.mdb->readIEEEFloatLE();
-			} else {
-				*v++ = 0.0f;
-				*v++ = 0.0f;
-			}
-		}
+		ctx.mdb->readIEEEFloatLE(v, tVertsCount[t] * 2);
 	}
 
 
 	// Read faces
 
-	_indexBuffer.setSize(facesCount * 3, sizeof(uint32), GL_UNSIGNED_INT);
+	_geometry->indexBuffer.setSize(facesCount * 3, sizeof(uint32), GL_UNSIGNED_INT);
 
 	ctx.mdb->seek(ctx.offRawData + facesOffset);
-	uint32 *f = (uint32 *) _indexBuffer.getData();
+	uint32 *f = (uint32 *) _geometry->indexBuffer.getData();
 	for (uint32 i = 0; i < facesCount; i++) {
 		// Vertex indices
-		*f++ = ctx.mdb->readUint32LE();
-		*f++ = ctx.mdb->readUint32LE();
-		*f++ = ctx.mdb->readUint32LE();
+		ctx.mdb->readUint32LE(f, 3);
+		f += 3;
 
 		ctx.mdb->skip(68); // Unknown
 	}
 
 	createBound();
+	packGeometry();
 
 	ctx.mdb->seek(endPos);
 }
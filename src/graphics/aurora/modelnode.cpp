@@ -28,7 +28,9 @@
 #include "src/common/util.h"
 #include "src/common/maths.h"
 #include "src/common/error.h"
+#include "src/common/configman.h"
 
+#include "src/graphics/graphics.h"
 #include "src/graphics/camera.h"
 
 #include "src/graphics/images/txi.h"
@@ -110,8 +112,9 @@ static void DisableVertexAttrib(const VertexAttrib &va) {
 }
 
 ModelNode::ModelNode(Model &model) :
-	_model(&model), _parent(0), _level(0),
-	_isTransparent(false), _render(false), _hasTransparencyHint(false) {
+	_model(&model), _parent(0), _level(0), _geometry(new Geometry),
+	_positionFrames(3), _orientationFrames(4),
+	_isTransparent(false), _render(false), _batched(false), _hasTransparencyHint(false) {
 
 	_position[0] = 0.0f; _position[1] = 0.0f; _position[2] = 0.0f;
 	_rotation[0] = 0.0f; _rotation[1] = 0.0f; _rotation[2] = 0.0f;
@@ -126,6 +129,37 @@ ModelNode::ModelNode(Model &model) :
 	_scale[2] = 1.0f;
 }
 
+ModelNode::ModelNode(Model &model, const ModelNode &source) :
+	_model(&model), _parent(0), _level(source._level), _name(source._name),
+	_geometry(source._geometry), _positionFrames(3), _orientationFrames(4),
+	_absolutePosition(source._absolutePosition),
+	_shininess(source._shininess), _textures(source._textures),
+	_isTransparent(source._isTransparent), _dangly(source._dangly),
+	_period(source._period), _tightness(source._tightness),
+	_displacement(source._displacement), _showdispl(source._showdispl),
+	_displtype(source._displtype), _constraints(source._constraints),
+	_tilefade(source._tilefade), _render(source._render), _batched(false),
+	_shadow(source._shadow), _beaming(source._beaming), _inheritcolor(source._inheritcolor),
+	_rotatetexture(source._rotatetexture), _alpha(source._alpha),
+	_hasTransparencyHint(source._hasTransparencyHint),
+	_transparencyHint(source._transparencyHint),
+	_boundBox(source._boundBox), _absoluteBoundBox(source._absoluteBoundBox) {
+
+	memcpy(_center     , source._center     , sizeof(_center));
+	memcpy(_position   , source._position   , sizeof(_position));
+	memcpy(_rotation   , source._rotation   , sizeof(_rotation));
+	memcpy(_orientation, source._orientation, sizeof(_orientation));
+	memcpy(_scale      , source._scale      , sizeof(_scale));
+
+	memcpy(_wirecolor, source._wirecolor, sizeof(_wirecolor));
+	memcpy(_ambient  , source._ambient  , sizeof(_ambient));
+	memcpy(_diffuse  , source._diffuse  , sizeof(_diffuse));
+	memcpy(_specular , source._specular , sizeof(_specular));
+	memcpy(_selfIllum, source._selfIllum, sizeof(_selfIllum));
+
+	// The keyframes aren't copied: animations always read them from the template's nodes
+}
+
 ModelNode::~ModelNode() {
 	// dtor
 }
@@ -266,8 +300,7 @@ void ModelNode::inheritGeometry(ModelNode &node) const {
 	node._textures      = _textures;
 	node._render        = _render;
 	node._isTransparent = _isTransparent;
-	node._vertexBuffer  = _vertexBuffer;
-	node._indexBuffer   = _indexBuffer;
+	node._geometry      = _geometry;
 
 	memcpy(node._center, _center, 3 * sizeof(float));
 	node._boundBox = _boundBox;
@@ -405,7 +438,7 @@ void ModelNode::loadTextures(const std::vector<Common::UString> &textures) {
 void ModelNode::createBound() {
 	_boundBox.clear();
 
-	const VertexDecl vertexDecl = _vertexBuffer.getVertexDecl();
+	const VertexDecl vertexDecl = _geometry->vertexBuffer.getVertexDecl();
 	for (VertexDecl::const_iterator vA = vertexDecl.begin(); vA != vertexDecl.end(); ++vA) {
 		if ((vA->index != VPOSITION) || (vA->type != GL_FLOAT))
 			continue;
@@ -416,13 +449,29 @@ void ModelNode::createBound() {
 		float *vY = ((float *) vA->pointer) + 1;
 		float *vZ = ((float *) vA->pointer) + 2;
 
-		for (uint32 v = 0; v < _vertexBuffer.getCount(); v++)
+		for (uint32 v = 0; v < _geometry->vertexBuffer.getCount(); v++)
 			_boundBox.add(vX[v * stride], vY[v * stride], vZ[v * stride]);
 	}
 
 	createCenter();
 }
 
+void ModelNode::packGeometry() {
+	if (!ConfigMan.getBool("packvertices", true))
+		return;
+
+	VertexPacking packing;
+
+	packing.halfFloat     = GfxMan.supportHalfFloatVertices();
+	packing.packedNormals = GfxMan.supportPackedNormals();
+
+	// A millimeter, and an eighth of a texel of a 512x512 texture
+	packing.positionTolerance = 0.001f;
+	packing.texCoordTolerance = 1.0f / 4096.0f;
+
+	_geometry->vertexBuffer.pack(packing);
+}
+
 void ModelNode::createCenter() {
 
 	float minX, minY, minZ, maxX, maxY, maxZ;
@@ -473,6 +522,16 @@ void ModelNode::createAbsoluteBound(Common::BoundingBox parentPosition) {
 	}
 }
 
+void ModelNode::applyTransformation(Common::TransformationMatrix &matrix) const {
+	matrix.translate(_position[0], _position[1], _position[2]);
+	matrix.rotate(_orientation[3], _orientation[0], _orientation[1], _orientation[2]);
+	matrix.scale(_scale[0], _scale[1], _scale[2]);
+
+	matrix.rotate(_rotation[0], 1.0f, 0.0f, 0.0f);
+	matrix.rotate(_rotation[1], 0.0f, 1.0f, 0.0f);
+	matrix.rotate(_rotation[2], 0.0f, 0.0f, 1.0f);
+}
+
 void ModelNode::orderChildren() {
 	_children.sort(nodeComp);
 
@@ -492,12 +551,13 @@ void ModelNode::renderGeometry() {
 
 	// Render the node's faces
 
-	const VertexDecl &vertexDecl = _vertexBuffer.getVertexDecl();
+	const VertexDecl &vertexDecl = _geometry->vertexBuffer.getVertexDecl();
 
 	for (size_t i = 0; i < vertexDecl.size(); i++)
 		EnableVertexAttrib(vertexDecl[i]);
 
-	glDrawElements(GL_TRIANGLES, _indexBuffer.getCount(), _indexBuffer.getType(), _indexBuffer.getData());
+	glDrawElements(GL_TRIANGLES, _geometry->indexBuffer.getCount(), _geometry->indexBuffer.getType(), _geometry->indexBuffer.getData());
+	GfxMan.countDrawCalls();
 
 	for (size_t i = 0; i < vertexDecl.size(); i++)
 		DisableVertexAttrib(vertexDecl[i]);
@@ -523,7 +583,7 @@ void ModelNode::render(RenderPass pass) {
 
 	// Render the node's geometry
 
-	bool shouldRender = _render && (_indexBuffer.getCount() > 0);
+	bool shouldRender = _render && !_batched && (_geometry->indexBuffer.getCount() > 0);
 	if (((pass == kRenderPassOpaque)      &&  _isTransparent) ||
 	    ((pass == kRenderPassTransparent) && !_isTransparent))
 		shouldRender = false;
@@ -588,71 +648,35 @@ void ModelNode::unlockFrameIfVisible() {
 	_model->unlockFrameIfVisible();
 }
 
-void ModelNode::interpolatePosition(float time, float &x, float &y, float &z) const {
+void ModelNode::interpolatePosition(float time, size_t &cursor, float &x, float &y, float &z) const {
 	// If less than 2 keyframes, don't interpolate, just return the only position
 	if (_positionFrames.size() < 2) {
 		getPosition(x, y, z);
 		return;
 	}
 
-	size_t lastFrame = 0;
-	for (size_t i = 0; i < _positionFrames.size(); i++) {
-		const PositionKeyFrame &pos = _positionFrames[i];
-		if (pos.time >= time)
-			break;
+	float position[3];
+	_positionFrames.sample(time, cursor, position);
 
-		lastFrame = i;
-	}
-
-	const PositionKeyFrame &last = _positionFrames[lastFrame];
-	if (lastFrame + 1 >= _positionFrames.size() || last.time == time) {
-		x = last.x;
-		y = last.y;
-		z = last.z;
-		return;
-	}
-
-	const PositionKeyFrame &next = _positionFrames[lastFrame + 1];
-
-	const float f = (time - last.time) / (next.time - last.time);
-	x = f * next.x + (1.0f - f) * last.x;
-	y = f * next.y + (1.0f - f) * last.y;
-	z = f * next.z + (1.0f - f) * last.z;
+	x = position[0];
+	y = position[1];
+	z = position[2];
 }
 
-void ModelNode::interpolateOrientation(float time, float &x, float &y, float &z, float &a) const {
+void ModelNode::interpolateOrientation(float time, size_t &cursor, float &x, float &y, float &z, float &a) const {
 	// If less than 2 keyframes, don't interpolate just return the only orientation
 	if (_orientationFrames.size() < 2) {
 		getOrientation(x, y, z, a);
 		return;
 	}
 
-	size_t lastFrame = 0;
-	for (size_t i = 0; i < _orientationFrames.size(); i++) {
-		const QuaternionKeyFrame &pos = _orientationFrames[i];
-		if (pos.time >= time)
-			break;
-
-		lastFrame = i;
-	}
-
-	const QuaternionKeyFrame &last = _orientationFrames[lastFrame];
-	if (lastFrame + 1 >= _orientationFrames.size() || last.time == time) {
-		x = last.x;
-		y = last.y;
-		z = last.z;
-		a = Common::rad2deg(acos(last.q) * 2.0);
-	}
-
-	const QuaternionKeyFrame &next = _orientationFrames[lastFrame + 1];
-
-	const float f = (time - last.time) / (next.time - last.time);
-	x = f * next.x + (1.0f - f) * last.x;
-	y = f * next.y + (1.0f - f) * last.y;
-	z = f * next.z + (1.0f - f) * last.z;
+	float orientation[4];
+	_orientationFrames.sample(time, cursor, orientation);
 
-	const float q = f * next.q + (1.0f - f) * last.q;
-	a = Common::rad2deg(acos(q) * 2.0);
+	x = orientation[0];
+	y = orientation[1];
+	z = orientation[2];
+	a = Common::rad2deg(acos(orientation[3]) * 2.0);
 }
 
 } // End of namespace Aurora
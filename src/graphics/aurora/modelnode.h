@@ -28,6 +28,8 @@
 #include <list>
 #include <vector>
 
+#include <boost/shared_ptr.hpp>
+
 #include "src/common/ustring.h"
 #include "src/common/transmatrix.h"
 #include "src/common/boundingbox.h"
@@ -38,6 +40,7 @@
 
 #include "src/graphics/aurora/types.h"
 #include "src/graphics/aurora/texturehandle.h"
+#include "src/graphics/aurora/keyframetrack.h"
 
 namespace Graphics {
 
@@ -45,24 +48,15 @@ namespace Aurora {
 
 class Model;
 
-struct PositionKeyFrame {
-	float time;
-	float x;
-	float y;
-	float z;
-};
-
-struct QuaternionKeyFrame {
-	float time;
-	float x;
-	float y;
-	float z;
-	float q;
-};
-
 class ModelNode {
 public:
 	ModelNode(Model &model);
+	/** Create a copy of another node, as part of an instance of that node's model.
+	 *
+	 *  The geometry is shared with the source node. The copy is not
+	 *  connected to any parent or children yet.
+	 */
+	ModelNode(Model &model, const ModelNode &source);
 	virtual ~ModelNode();
 
 	/** Get the node's name. */
@@ -118,8 +112,13 @@ protected:
 
 	Common::UString _name; ///< The node's name.
 
-	VertexBuffer _vertexBuffer; ///< Node geometry vertex buffer.
-	IndexBuffer _indexBuffer;   ///< Node geometry index buffer.
+	/** The node's geometry, shared between all instances of a model. */
+	struct Geometry {
+		VertexBuffer vertexBuffer; ///< Node geometry vertex buffer.
+		IndexBuffer indexBuffer;   ///< Node geometry index buffer.
+	};
+
+	boost::shared_ptr<Geometry> _geometry; ///< Node geometry.
 
 	float _center     [3]; ///< The node's center.
 	float _position   [3]; ///< Position of the node.
@@ -127,8 +126,8 @@ protected:
 	float _orientation[4]; ///< Orientation of the node.
 	float _scale      [3]; ///< Scale of the node.
 
-	std::vector<PositionKeyFrame> _positionFrames; ///< Keyframes for position animation
-	std::vector<QuaternionKeyFrame> _orientationFrames; ///< Keyframes for orientation animation
+	KeyFrameTrack _positionFrames;    ///< Keyframes for position animation (x, y, z).
+	KeyFrameTrack _orientationFrames; ///< Keyframes for orientation animation (x, y, z, q).
 
 	/** Position of the node after translate/rotate. */
 	Common::TransformationMatrix _absolutePosition;
@@ -157,7 +156,8 @@ protected:
 
 	int _tilefade;
 
-	bool _render; ///< Render the node?
+	bool _render;  ///< Render the node?
+	bool _batched; ///< Is the node's geometry drawn by a StaticGeometry instead?
 	bool _shadow; ///< Does the node have a shadow?
 
 	bool _beaming;
@@ -178,9 +178,15 @@ protected:
 	void createBound();
 	void createCenter();
 
+	/** Convert the node's geometry into compact vertex formats, where possible. */
+	void packGeometry();
+
 	void createAbsoluteBound();
 	void createAbsoluteBound(Common::BoundingBox parentPosition);
 
+	/** Apply the node's position, orientation, scale and rotation onto this matrix. */
+	void applyTransformation(Common::TransformationMatrix &matrix) const;
+
 	void render(RenderPass pass);
 	void drawSkeleton(const Common::TransformationMatrix &parent, bool showInvisible);
 
@@ -217,10 +223,13 @@ public:
 	void reparent(ModelNode &parent);
 
 	// Animation helpers
-	void interpolatePosition(float time, float &x, float &y, float &z) const;
-	void interpolateOrientation(float time, float &x, float &y, float &z, float &a) const;
+	/** Sample the position keyframes at this time. The cursor caches the last keyframe used. */
+	void interpolatePosition(float time, size_t &cursor, float &x, float &y, float &z) const;
+	/** Sample the orientation keyframes at this time. The cursor caches the last keyframe used. */
+	void interpolateOrientation(float time, size_t &cursor, float &x, float &y, float &z, float &a) const;
 
 	friend class Model;
+	friend class StaticGeometry;
 };
 
 } // End of namespace Aurora
@@ -51,7 +51,7 @@ public:
 	float getWidth (uint32 c) const;
 	float getHeight()         const;
 
-	void draw(uint32 c) const;
+	void getGlyph(uint32 c, Font::Glyph &glyph) const;
 
 private:
 	struct Header {
@@ -115,7 +115,6 @@ private:
 	void drawGlyphs(const std::vector<Glyph> &glyphs);
 	void drawGlyph(const Glyph &glyph, Surface &surface, uint32 x, uint32 y);
 
-	void drawMissing() const;
 
 	static uint32 convertToUTF32(uint16 codePoint, uint8 encoding);
 };
@@ -0,0 +1,512 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Static world geometry, merged into a few large batches.
+ */
+
+#include <cassert>
+#include <cmath>
+#include <cfloat>
+
+#include <algorithm>
+
+#include "src/common/util.h"
+#include "src/common/maths.h"
+#include "src/common/boundingbox.h"
+
+#include "src/graphics/graphics.h"
+#include "src/graphics/camera.h"
+
+#include "src/graphics/aurora/staticgeometry.h"
+#include "src/graphics/aurora/textureman.h"
+#include "src/graphics/aurora/model.h"
+#include "src/graphics/aurora/modelnode.h"
+
+namespace Graphics {
+
+namespace Aurora {
+
+bool StaticGeometry::Source::operator<(const Source &source) const {
+	for (int i = 0; i < 3; i++)
+		if (cell[i] != source.cell[i])
+			return cell[i] < source.cell[i];
+
+	return false;
+}
+
+
+StaticGeometry::StaticGeometry(float cellSize) : Renderable(kRenderableTypeObject),
+	_cellSize(cellSize), _nodeCount(0), _batchCount(0), _triangleCount(0) {
+
+	assert(_cellSize > 0.0f);
+
+	_min[0] = _min[1] = _min[2] = 0.0f;
+	_max[0] = _max[1] = _max[2] = 0.0f;
+
+	_drawnBatches.store(0);
+	_drawCalls.store(0);
+	_drawnNodes.store(0);
+}
+
+StaticGeometry::~StaticGeometry() {
+	hide();
+
+	clear();
+}
+
+void StaticGeometry::clear() {
+	assert(!isVisible());
+
+	for (MaterialMap::iterator m = _materials.begin(); m != _materials.end(); ++m)
+		delete m->second;
+
+	_materials.clear();
+
+	_nodeCount     = 0;
+	_batchCount    = 0;
+	_triangleCount = 0;
+
+	_min[0] = _min[1] = _min[2] = 0.0f;
+	_max[0] = _max[1] = _max[2] = 0.0f;
+}
+
+size_t StaticGeometry::getNodeCount() const {
+	return _nodeCount;
+}
+
+size_t StaticGeometry::getMaterialCount() const {
+	return _materials.size();
+}
+
+size_t StaticGeometry::getBatchCount() const {
+	return _batchCount;
+}
+
+size_t StaticGeometry::getTriangleCount() const {
+	return _triangleCount;
+}
+
+uint32 StaticGeometry::getDrawnBatchCount() const {
+	return _drawnBatches.load();
+}
+
+uint32 StaticGeometry::getDrawCallCount() const {
+	return _drawCalls.load();
+}
+
+uint32 StaticGeometry::getDrawnNodeCount() const {
+	return _drawnNodes.load();
+}
+
+bool StaticGeometry::getWorldBound(float min[3], float max[3]) const {
+	if (_batchCount == 0)
+		return false;
+
+	for (int i = 0; i < 3; i++) {
+		min[i] = _min[i];
+		max[i] = _max[i];
+	}
+
+	return true;
+}
+
+bool StaticGeometry::isBatchable(const ModelNode &node) {
+	if (!node._render || node._isTransparent)
+		return false;
+
+	const IndexBuffer  &indices  = node._geometry->indexBuffer;
+	const VertexBuffer &vertices = node._geometry->vertexBuffer;
+
+	if ((indices.getCount() == 0) || (vertices.getCount() == 0))
+		return false;
+
+	if ((indices.getType() != GL_UNSIGNED_SHORT) && (indices.getType() != GL_UNSIGNED_INT))
+		return false;
+
+	// We can read floats and the compact formats created by VertexBuffer::pack()
+	bool hasPosition = false;
+
+	const VertexDecl &decl = vertices.getVertexDecl();
+	for (VertexDecl::const_iterator a = decl.begin(); a != decl.end(); ++a) {
+		if ((a->type != GL_FLOAT) && (a->type != GL_HALF_FLOAT) &&
+		    (a->type != GL_SHORT) && (a->type != GL_INT_2_10_10_10_REV))
+			return false;
+
+		if (a->size > 4)
+			return false;
+
+		if (a->index == VPOSITION)
+			hasPosition = a->size == 3;
+		else if ((a->index == VNORMAL) && (a->size != 3))
+			return false;
+	}
+
+	return hasPosition;
+}
+
+Common::UString StaticGeometry::getMaterialKey(const ModelNode &node) {
+	Common::UString key;
+
+	for (std::vector<TextureHandle>::const_iterator t = node._textures.begin(); t != node._textures.end(); ++t)
+		key += (t->empty() ? Common::UString("") : t->getName()) + "|";
+
+	key += "#";
+
+	const VertexDecl &decl = node._geometry->vertexBuffer.getVertexDecl();
+	for (VertexDecl::const_iterator a = decl.begin(); a != decl.end(); ++a)
+		key += Common::UString::format("%u:%d;", (uint) a->index, (int) a->size);
+
+	return key;
+}
+
+void StaticGeometry::add(Model &model) {
+	assert(!isVisible() && !model.isVisible());
+
+	if (!model._currentState)
+		return;
+
+	const std::vector<ModelNode *> &nodes   = model._currentState->flatNodes;
+	const std::vector<int32>       &parents = model._currentState->flatParents;
+
+	std::vector<Common::TransformationMatrix> transforms(nodes.size());
+	std::vector<bool> animated(nodes.size(), false);
+
+	for (size_t i = 0; i < nodes.size(); i++) {
+		ModelNode &node = *nodes[i];
+
+		transforms[i] = (parents[i] >= 0) ? transforms[parents[i]] : model._absolutePosition;
+		node.applyTransformation(transforms[i]);
+
+		// An animated node moves all its children along
+		animated[i] = ((parents[i] >= 0) && animated[parents[i]]) || model.isNodeAnimated(node._name);
+
+		if (animated[i] || node._batched || !isBatchable(node))
+			continue;
+
+		addSource(node, transforms[i]);
+
+		node._batched = true;
+	}
+}
+
+void StaticGeometry::addSource(const ModelNode &node, const Common::TransformationMatrix &transform) {
+	const Common::UString key = getMaterialKey(node);
+
+	MaterialMap::iterator m = _materials.find(key);
+	if (m == _materials.end()) {
+		Material *material = new Material;
+
+		material->textures   = node._textures;
+		material->vertexDecl = node._geometry->vertexBuffer.getVertexDecl();
+
+		// The merged geometry is always stored as floats
+		for (VertexDecl::iterator a = material->vertexDecl.begin(); a != material->vertexDecl.end(); ++a) {
+			a->type       = GL_FLOAT;
+			a->normalized = GL_FALSE;
+		}
+
+		m = _materials.insert(std::make_pair(key, material)).first;
+	}
+
+	Common::BoundingBox bound;
+
+	bound.transform(transform);
+	bound.add(node._boundBox);
+	bound.absolutize();
+
+	float minX, minY, minZ, maxX, maxY, maxZ;
+	bound.getMin(minX, minY, minZ);
+	bound.getMax(maxX, maxY, maxZ);
+
+	Source source;
+
+	source.node      = &node;
+	source.transform = transform;
+
+	source.cell[0] = (int32) floorf(((minX + maxX) * 0.5f) / _cellSize);
+	source.cell[1] = (int32) floorf(((minY + maxY) * 0.5f) / _cellSize);
+	source.cell[2] = (int32) floorf(((minZ + maxZ) * 0.5f) / _cellSize);
+
+	m->second->sources.push_back(source);
+
+	_nodeCount++;
+}
+
+void StaticGeometry::build() {
+	assert(!isVisible());
+
+	_batchCount    = 0;
+	_triangleCount = 0;
+
+	bool first = true;
+	for (MaterialMap::iterator m = _materials.begin(); m != _materials.end(); ++m) {
+		Material &material = *m->second;
+
+		build(material);
+
+		_batchCount    += material.batches.size();
+		_triangleCount += material.indexBuffer.getCount() / 3;
+
+		for (std::vector<Batch>::const_iterator b = material.batches.begin(); b != material.batches.end(); ++b) {
+			for (int i = 0; i < 3; i++) {
+				_min[i] = first ? b->min[i] : MIN(_min[i], b->min[i]);
+				_max[i] = first ? b->max[i] : MAX(_max[i], b->max[i]);
+			}
+
+			first = false;
+		}
+	}
+
+	calculateDistance();
+}
+
+void StaticGeometry::build(Material &material) {
+	if (material.sources.empty())
+		return;
+
+	// Sort the nodes into their cells, so that each cell is a continuous range
+	std::stable_sort(material.sources.begin(), material.sources.end());
+
+	uint32 vertexCount = material.vertexBuffer.getCount();
+	uint32 indexCount  = material.indexBuffer.getCount();
+
+	for (std::vector<Source>::const_iterator s = material.sources.begin(); s != material.sources.end(); ++s) {
+		vertexCount += s->node->_geometry->vertexBuffer.getCount();
+		indexCount  += s->node->_geometry->indexBuffer.getCount();
+	}
+
+	// Keep what has already been built
+	VertexBuffer oldVertices = material.vertexBuffer;
+	IndexBuffer  oldIndices  = material.indexBuffer;
+
+	VertexDecl decl = material.vertexDecl;
+	material.vertexBuffer.setVertexDeclInterleave(vertexCount, decl);
+	material.indexBuffer.setSize(indexCount, sizeof(uint32), GL_UNSIGNED_INT);
+
+	uint32 vertex = oldVertices.getCount();
+	uint32 index  = oldIndices.getCount();
+
+	if (vertex > 0)
+		memcpy(material.vertexBuffer.getData(), oldVertices.getData(), vertex * oldVertices.getSize());
+	if (index > 0)
+		memcpy(material.indexBuffer.getData(), oldIndices.getData(), index * sizeof(uint32));
+
+	const Source *cell = 0;
+	for (std::vector<Source>::const_iterator s = material.sources.begin(); s != material.sources.end(); ++s) {
+		if (!cell || (*cell < *s)) {
+			Batch batch;
+
+			batch.firstIndex = index;
+			batch.indexCount = 0;
+			batch.nodeCount  = 0;
+
+			for (int i = 0; i < 3; i++) {
+				batch.min[i] =  FLT_MAX;
+				batch.max[i] = -FLT_MAX;
+			}
+
+			material.batches.push_back(batch);
+			cell = &*s;
+		}
+
+		copyGeometry(material, *s, vertex, index, material.batches.back());
+	}
+
+	assert((vertex == vertexCount) && (index == indexCount));
+
+	material.sources.clear();
+}
+
+void StaticGeometry::copyGeometry(Material &material, const Source &source,
+                                  uint32 &vertex, uint32 &index, Batch &batch) {
+
+	const VertexBuffer &srcVertices = source.node->_geometry->vertexBuffer;
+	const IndexBuffer  &srcIndices  = source.node->_geometry->indexBuffer;
+
+	const VertexDecl &srcDecl = srcVertices.getVertexDecl();
+	const VertexDecl &dstDecl = material.vertexBuffer.getVertexDecl();
+
+	assert(srcDecl.size() == dstDecl.size());
+
+	const float *m = source.transform.get();
+
+	const uint32 count = srcVertices.getCount();
+	for (size_t a = 0; a < srcDecl.size(); a++) {
+		const uint32 dstStride = dstDecl[a].stride;
+
+		byte *dst = const_cast<byte *>(reinterpret_cast<const byte *>(dstDecl[a].pointer)) + vertex * dstStride;
+
+		for (uint32 v = 0; v < count; v++, dst += dstStride) {
+			float  in[4];
+			float *out = reinterpret_cast<float *>(dst);
+
+			srcVertices.getAttrib(a, v, in);
+
+			if (srcDecl[a].index == VPOSITION) {
+
+				out[0] = m[0] * in[0] + m[4] * in[1] + m[ 8] * in[2] + m[12];
+				out[1] = m[1] * in[0] + m[5] * in[1] + m[ 9] * in[2] + m[13];
+				out[2] = m[2] * in[0] + m[6] * in[1] + m[10] * in[2] + m[14];
+
+				for (int i = 0; i < 3; i++) {
+					batch.min[i] = MIN(batch.min[i], out[i]);
+					batch.max[i] = MAX(batch.max[i], out[i]);
+				}
+
+			} else if (srcDecl[a].index == VNORMAL) {
+
+				const float x = m[0] * in[0] + m[4] * in[1] + m[ 8] * in[2];
+				const float y = m[1] * in[0] + m[5] * in[1] + m[ 9] * in[2];
+				const float z = m[2] * in[0] + m[6] * in[1] + m[10] * in[2];
+
+				// Renormalize, in case the node was scaled
+				const float length = sqrtf(x * x + y * y + z * z);
+				const float scale  = (length > 0.0f) ? (1.0f / length) : 0.0f;
+
+				out[0] = x * scale;
+				out[1] = y * scale;
+				out[2] = z * scale;
+
+			} else
+				memcpy(out, in, srcDecl[a].size * sizeof(float));
+		}
+	}
+
+	uint32 *dstIndices = reinterpret_cast<uint32 *>(material.indexBuffer.getData()) + index;
+
+	const uint32 indexCount = srcIndices.getCount();
+	if (srcIndices.getType() == GL_UNSIGNED_SHORT) {
+		const uint16 *srcIndex = reinterpret_cast<const uint16 *>(srcIndices.getData());
+		for (uint32 i = 0; i < indexCount; i++)
+			dstIndices[i] = vertex + srcIndex[i];
+	} else {
+		const uint32 *srcIndex = reinterpret_cast<const uint32 *>(srcIndices.getData());
+		for (uint32 i = 0; i < indexCount; i++)
+			dstIndices[i] = vertex + srcIndex[i];
+	}
+
+	vertex += count;
+	index  += indexCount;
+
+	batch.indexCount += indexCount;
+	batch.nodeCount++;
+}
+
+void StaticGeometry::calculateDistance() {
+	const float cameraX =  CameraMan.getPosition()[0];
+	const float cameraY =  CameraMan.getPosition()[1];
+	const float cameraZ = -CameraMan.getPosition()[2];
+
+	const float x = ABS((_min[0] + _max[0]) * 0.5f - cameraX);
+	const float y = ABS((_min[1] + _max[1]) * 0.5f - cameraY);
+	const float z = ABS((_min[2] + _max[2]) * 0.5f - cameraZ);
+
+	_distance = x + y + z;
+}
+
+void StaticGeometry::render(RenderPass pass) {
+	// All our geometry is opaque
+	if ((pass != kRenderPassOpaque) && (pass != kRenderPassAll))
+		return;
+
+	uint32 drawnBatches = 0, drawCalls = 0, drawnNodes = 0;
+
+	for (MaterialMap::iterator m = _materials.begin(); m != _materials.end(); ++m)
+		renderMaterial(*m->second, drawnBatches, drawCalls, drawnNodes);
+
+	// Reset the first texture units
+	TextureMan.reset();
+
+	_drawnBatches.store(drawnBatches);
+	_drawCalls.store(drawCalls);
+	_drawnNodes.store(drawnNodes);
+
+	GfxMan.countDrawCalls(drawCalls);
+}
+
+void StaticGeometry::renderMaterial(Material &material, uint32 &drawnBatches, uint32 &drawCalls,
+                                    uint32 &drawnNodes) {
+
+	const uint32 *indices = reinterpret_cast<const uint32 *>(material.indexBuffer.getData());
+	const VertexDecl &vertexDecl = material.vertexBuffer.getVertexDecl();
+
+	bool enabled = false;
+
+	/* Visible batches that follow each other in the index buffer are merged
+	 * into one draw call, so we only issue a call whenever the run breaks. */
+	uint32 runStart = 0, runCount = 0;
+
+	for (size_t b = 0; b <= material.batches.size(); b++) {
+		const bool visible = (b < material.batches.size()) &&
+		                     GfxMan.isBoxInFrustum(material.batches[b].min, material.batches[b].max);
+
+		if (visible && (runCount > 0) && (material.batches[b].firstIndex == runStart + runCount)) {
+			runCount   += material.batches[b].indexCount;
+			drawnNodes += material.batches[b].nodeCount;
+			drawnBatches++;
+			continue;
+		}
+
+		if (runCount > 0) {
+			if (!enabled) {
+				for (size_t t = 0; t < material.textures.size(); t++) {
+					TextureMan.activeTexture(t);
+					glEnable(GL_TEXTURE_2D);
+
+					TextureMan.set(material.textures[t]);
+				}
+
+				for (size_t i = 0; i < vertexDecl.size(); i++)
+					vertexDecl[i].enable();
+
+				enabled = true;
+			}
+
+			glDrawElements(GL_TRIANGLES, runCount, GL_UNSIGNED_INT, indices + runStart);
+			drawCalls++;
+		}
+
+		runStart = 0;
+		runCount = 0;
+
+		if (visible) {
+			runStart    = material.batches[b].firstIndex;
+			runCount    = material.batches[b].indexCount;
+			drawnNodes += material.batches[b].nodeCount;
+			drawnBatches++;
+		}
+	}
+
+	if (!enabled)
+		return;
+
+	for (size_t i = 0; i < vertexDecl.size(); i++)
+		vertexDecl[i].disable();
+
+	for (size_t i = 0; i < material.textures.size(); i++) {
+		TextureMan.activeTexture(i);
+		glDisable(GL_TEXTURE_2D);
+	}
+}
+
+} // End of namespace Aurora
+
+} // End of namespace Graphics
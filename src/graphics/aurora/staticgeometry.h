@@ -0,0 +1,188 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Static world geometry, merged into a few large batches.
+ */
+
+#ifndef GRAPHICS_AURORA_STATICGEOMETRY_H
+#define GRAPHICS_AURORA_STATICGEOMETRY_H
+
+#include <vector>
+#include <map>
+
+#include "src/common/atomic.h"
+
+#include "src/common/types.h"
+#include "src/common/ustring.h"
+#include "src/common/transmatrix.h"
+
+#include "src/graphics/types.h"
+#include "src/graphics/renderable.h"
+#include "src/graphics/indexbuffer.h"
+#include "src/graphics/vertexbuffer.h"
+
+#include "src/graphics/aurora/types.h"
+#include "src/graphics/aurora/texturehandle.h"
+
+namespace Graphics {
+
+namespace Aurora {
+
+class Model;
+class ModelNode;
+
+/** The static, opaque geometry of many models, merged into shared buffers.
+ *
+ *  Area tiles and rooms consist of hundreds of models with dozens of nodes
+ *  each, most of which never move. Drawing them node by node costs a state
+ *  change and a draw call for every few triangles. A StaticGeometry takes
+ *  over the geometry of all nodes that are neither animated nor transparent,
+ *  transforms it into world space once, and merges it into one vertex and
+ *  index buffer per material (set of textures and vertex layout).
+ *
+ *  Within each material, the geometry is sorted into cubic cells. Each cell
+ *  is a batch with its own bounding box, culled against the view frustum.
+ *  Visible batches that are neighbors in the index buffer are drawn with a
+ *  single call.
+ *
+ *  The models stay responsible for all their other nodes, and need to be
+ *  shown and hidden together with the StaticGeometry. Since the batched
+ *  nodes are not drawn by their models anymore, the StaticGeometry should
+ *  be destroyed together with the models.
+ */
+class StaticGeometry : public Renderable {
+public:
+	/** @param cellSize The edge length of the cells the geometry is sorted into. */
+	StaticGeometry(float cellSize = 40.0f);
+	~StaticGeometry();
+
+	/** Take over the static, opaque geometry of the model's current state.
+	 *
+	 *  The model needs to be positioned already, and must not be visible.
+	 */
+	void add(Model &model);
+
+	/** Merge all geometry taken over so far into the final batches. */
+	void build();
+
+	/** Remove all geometry. */
+	void clear();
+
+	/** Return the number of model nodes merged into the batches. */
+	size_t getNodeCount() const;
+	/** Return the number of materials, each with its own shared buffers. */
+	size_t getMaterialCount() const;
+	/** Return the number of batches. */
+	size_t getBatchCount() const;
+	/** Return the number of triangles over all batches. */
+	size_t getTriangleCount() const;
+
+	/** Return the number of batches that were drawn in the last frame. */
+	uint32 getDrawnBatchCount() const;
+	/** Return the number of draw calls issued in the last frame. */
+	uint32 getDrawCallCount() const;
+	/** Return the number of nodes within the batches drawn in the last frame.
+	 *
+	 *  Without batching, each of these nodes would have been a draw call of its own.
+	 */
+	uint32 getDrawnNodeCount() const;
+
+	bool getWorldBound(float min[3], float max[3]) const;
+
+	// Renderable
+	void calculateDistance();
+	void render(RenderPass pass);
+
+private:
+	/** A node whose geometry waits to be merged. */
+	struct Source {
+		const ModelNode *node;
+
+		Common::TransformationMatrix transform; ///< The node's world space transformation.
+
+		int32 cell[3]; ///< The cell the node's center is in.
+
+		bool operator<(const Source &source) const;
+	};
+
+	/** A range within a material's index buffer, covering one cell. */
+	struct Batch {
+		uint32 firstIndex;
+		uint32 indexCount;
+
+		uint32 nodeCount; ///< The number of nodes merged into this batch.
+
+		float min[3];
+		float max[3];
+	};
+
+	/** Geometry sharing the same textures and vertex layout. */
+	struct Material {
+		std::vector<TextureHandle> textures;
+
+		VertexDecl vertexDecl; ///< The layout of the source vertices.
+
+		std::vector<Source> sources;
+
+		VertexBuffer vertexBuffer;
+		IndexBuffer  indexBuffer;
+
+		std::vector<Batch> batches;
+	};
+
+	typedef std::map<Common::UString, Material *> MaterialMap;
+
+
+	float _cellSize;
+
+	MaterialMap _materials;
+
+	size_t _nodeCount;
+	size_t _batchCount;
+	size_t _triangleCount;
+
+	float _min[3];
+	float _max[3];
+
+	boost::atomic<uint32> _drawnBatches;
+	boost::atomic<uint32> _drawCalls;
+	boost::atomic<uint32> _drawnNodes;
+
+
+	/** Can this node's geometry be merged? */
+	static bool isBatchable(const ModelNode &node);
+	/** Create the key identifying the node's material. */
+	static Common::UString getMaterialKey(const ModelNode &node);
+
+	void addSource(const ModelNode &node, const Common::TransformationMatrix &transform);
+
+	void build(Material &material);
+	/** Copy the node's geometry into the material's buffers, transforming it into world space. */
+	void copyGeometry(Material &material, const Source &source, uint32 &vertex, uint32 &index, Batch &batch);
+
+	void renderMaterial(Material &material, uint32 &drawnBatches, uint32 &drawCalls, uint32 &drawnNodes);
+};
+
+} // End of namespace Aurora
+
+} // End of namespace Graphics
+
+#endif // GRAPHICS_AURORA_STATICGEOMETRY_H
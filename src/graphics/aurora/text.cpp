@@ -22,11 +22,14 @@
  *  A text object.
  */
 
+#include <cstring>
+
 #include "src/events/requests.h"
 
 #include "src/graphics/font.h"
 
 #include "src/graphics/aurora/text.h"
+#include "src/graphics/aurora/textureman.h"
 
 namespace Graphics {
 
@@ -35,7 +38,7 @@ namespace Aurora {
 Text::Text(const FontHandle &font, const Common::UString &str,
 		float r, float g, float b, float a, float align) :
 	_r(r), _g(g), _b(b), _a(a), _font(font), _x(0.0f), _y(0.0f), _align(align),
-	_disableColorTokens(false) {
+	_disableColorTokens(false), _needLayout(true) {
 
 	set(str);
 
@@ -67,6 +70,8 @@ void Text::set(const Common::UString &str, float maxWidth, float maxHeight) {
 	_height = font.getHeight(_str, maxWidth, maxHeight);
 	_width  = font.getWidth (_str, maxWidth);
 
+	_needLayout = true;
+
 	unlockFrameIfVisible();
 }
 
@@ -85,6 +90,8 @@ void Text::setColor(float r, float g, float b, float a) {
 	_b = b;
 	_a = a;
 
+	_needLayout = true;
+
 	unlockFrameIfVisible();
 }
 
@@ -93,7 +100,13 @@ void Text::unsetColor() {
 }
 
 void Text::setAlign(float align) {
+	lockFrameIfVisible();
+
 	_align = align;
+
+	_needLayout = true;
+
+	unlockFrameIfVisible();
 }
 
 const Common::UString &Text::get() const {
@@ -142,9 +155,72 @@ void Text::render(RenderPass pass) {
 	if (pass == kRenderPassOpaque)
 		return;
 
+	if (_needLayout)
+		buildLayout();
+
 	glTranslatef(_x, _y, 0.0f);
 
-	_font.getFont().draw(_str, _colors, _r, _g, _b, _a, _align, _width, _height);
+	const VertexDecl &vertexDecl = _vertexBuffer.getVertexDecl();
+
+	for (size_t i = 0; i < vertexDecl.size(); i++)
+		vertexDecl[i].enable();
+
+	for (std::vector<Batch>::const_iterator b = _batches.begin(); b != _batches.end(); ++b) {
+		if (b->texture)
+			TextureMan.set(*b->texture);
+		else
+			TextureMan.set();
+
+		glDrawArrays(GL_QUADS, b->firstVertex, b->vertexCount);
+	}
+
+	for (size_t i = 0; i < vertexDecl.size(); i++)
+		vertexDecl[i].disable();
+
+	glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+}
+
+void Text::buildLayout() {
+	_needLayout = false;
+
+	_batches.clear();
+
+	Font::QuadBatches quads;
+	_font.getFont().buildQuads(_str, _colors, quads, _r, _g, _b, _a, _align, _width, _height);
+
+	uint32 vertexCount = 0;
+	for (Font::QuadBatches::const_iterator q = quads.begin(); q != quads.end(); ++q)
+		vertexCount += q->vertices.size() / Font::kQuadVertexSize;
+
+	VertexDecl vertexDecl;
+
+	vertexDecl.push_back(VertexAttrib(VPOSITION, 2, GL_FLOAT));
+	vertexDecl.push_back(VertexAttrib(VTCOORD  , 2, GL_FLOAT));
+	vertexDecl.push_back(VertexAttrib(VCOLOR   , 4, GL_FLOAT));
+
+	_vertexBuffer.setVertexDeclInterleave(vertexCount, vertexDecl);
+
+	float *data = reinterpret_cast<float *>(_vertexBuffer.getData());
+
+	uint32 firstVertex = 0;
+	for (Font::QuadBatches::const_iterator q = quads.begin(); q != quads.end(); ++q) {
+		const uint32 batchCount = q->vertices.size() / Font::kQuadVertexSize;
+		if (batchCount == 0)
+			continue;
+
+		memcpy(data, &q->vertices[0], q->vertices.size() * sizeof(float));
+		data += q->vertices.size();
+
+		Batch batch;
+
+		batch.texture     = q->texture;
+		batch.firstVertex = firstVertex;
+		batch.vertexCount = batchCount;
+
+		_batches.push_back(batch);
+
+		firstVertex += batchCount;
+	}
 }
 
 bool Text::isIn(float x, float y) const {
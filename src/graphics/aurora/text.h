@@ -25,11 +25,14 @@
 #ifndef GRAPHICS_AURORA_TEXT_H
 #define GRAPHICS_AURORA_TEXT_H
 
+#include <vector>
+
 #include "src/common/ustring.h"
 #include "src/common/maths.h"
 
 #include "src/graphics/types.h"
 #include "src/graphics/guifrontelement.h"
+#include "src/graphics/vertexbuffer.h"
 
 #include "src/graphics/aurora/fonthandle.h"
 
@@ -37,6 +40,8 @@ namespace Graphics {
 
 namespace Aurora {
 
+class TextureHandle;
+
 /** A text object. */
 class Text : public GUIFrontElement {
 public:
@@ -70,6 +75,14 @@ public:
 	bool isIn(float x, float y) const;
 
 private:
+	/** A run of quads in the vertex buffer that all use the same texture. */
+	struct Batch {
+		const TextureHandle *texture;
+
+		uint32 firstVertex;
+		uint32 vertexCount;
+	};
+
 	float _r, _g, _b, _a;
 	FontHandle _font;
 
@@ -88,6 +101,14 @@ private:
 
 	bool _disableColorTokens;
 
+	/** The quads of all characters, rebuilt when the text, its color or its layout changes. */
+	VertexBuffer _vertexBuffer;
+	std::vector<Batch> _batches;
+
+	bool _needLayout;
+
+	void buildLayout();
+
 	void parseColors(const Common::UString &str, Common::UString &parsed,
 	                 ColorPositions &colors);
 };
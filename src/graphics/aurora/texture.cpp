@@ -28,6 +28,7 @@
 #include "src/common/util.h"
 #include "src/common/error.h"
 #include "src/common/readstream.h"
+#include "src/common/atomic.h"
 
 #include "src/graphics/aurora/texture.h"
 #include "src/graphics/aurora/pltfile.h"
@@ -53,11 +54,19 @@ namespace Graphics {
 
 namespace Aurora {
 
-Texture::Texture() : _type(::Aurora::kFileTypeNone), _image(0), _txi(0), _width(0), _height(0) {
+/** Never drop mip levels that would leave the texture smaller than this. */
+static const int kMinMipMapSize = 32;
+
+/** The texture memory occupied by all textures. */
+static boost::atomic<uint64> residentSize(0);
+
+Texture::Texture() : _type(::Aurora::kFileTypeNone), _image(0), _txi(0), _width(0), _height(0),
+	_droppedMipMaps(0), _residentSize(0) {
 }
 
 Texture::Texture(const Common::UString &name, ImageDecoder *image, ::Aurora::FileType type, TXI *txi) :
-	_name(name), _type(type), _image(0), _txi(0), _width(0), _height(0) {
+	_name(name), _type(type), _image(0), _txi(0), _width(0), _height(0),
+	_droppedMipMaps(0), _residentSize(0) {
 
 	set(name, image, type, txi);
 	addToQueues();
@@ -69,6 +78,8 @@ Texture::~Texture() {
 	if (_textureID != 0)
 		GfxMan.abandon(&_textureID, 1);
 
+	setResidentSize(0);
+
 	delete _txi;
 	delete _image;
 }
@@ -141,6 +152,70 @@ bool Texture::dumpTGA(const Common::UString &fileName) const {
 	return _image->dumpTGA(fileName);
 }
 
+bool Texture::canDropMipMaps() const {
+	return !isDynamic() && (getMaxDroppedMipMaps() > 0);
+}
+
+size_t Texture::getMaxDroppedMipMaps() const {
+	if (!_image)
+		return 0;
+
+	size_t count = 0;
+	for (size_t i = 1; i < _image->getMipMapCount(); i++) {
+		const ImageDecoder::MipMap &mipMap = _image->getMipMap(i);
+		if (MAX(mipMap.width, mipMap.height) < kMinMipMapSize)
+			break;
+
+		count = i;
+	}
+
+	return count;
+}
+
+size_t Texture::getDroppedMipMaps() const {
+	return _droppedMipMaps;
+}
+
+void Texture::setDroppedMipMaps(size_t count) {
+	count = MIN(count, getMaxDroppedMipMaps());
+	if (count == _droppedMipMaps)
+		return;
+
+	_droppedMipMaps = count;
+
+	refresh();
+}
+
+uint32 Texture::getSize(size_t droppedMipMaps) const {
+	if (!_image)
+		return 0;
+
+	// We let OpenGL generate the mip maps, which adds another third
+	if (_image->getMipMapCount() == 1)
+		return _image->getMipMap(0).size + _image->getMipMap(0).size / 3;
+
+	uint32 size = 0;
+	for (size_t i = MIN(droppedMipMaps, getMaxDroppedMipMaps()); i < _image->getMipMapCount(); i++)
+		size += _image->getMipMap(i).size;
+
+	return size;
+}
+
+uint32 Texture::getResidentSize() const {
+	return _residentSize;
+}
+
+uint64 Texture::getTotalResidentSize() {
+	return residentSize.load();
+}
+
+void Texture::setResidentSize(uint32 size) {
+	residentSize -= _residentSize;
+	residentSize += size;
+
+	_residentSize = size;
+}
+
 void Texture::doDestroy() {
 	if (_textureID == 0)
 		return;
@@ -148,6 +223,8 @@ void Texture::doDestroy() {
 	glDeleteTextures(1, &_textureID);
 
 	_textureID = 0;
+
+	setResidentSize(0);
 }
 
 void Texture::doRebuild() {
@@ -155,6 +232,15 @@ void Texture::doRebuild() {
 		// No image
 		return;
 
+	const size_t baseLevel = MIN(_droppedMipMaps, getMaxDroppedMipMaps());
+	const uint32 size      = getSize(baseLevel);
+
+	// When the set of mip levels changes, start with a fresh texture so that the driver frees the old levels
+	if ((_textureID != 0) && (_residentSize != 0) && (_residentSize != size)) {
+		glDeleteTextures(1, &_textureID);
+		_textureID = 0;
+	}
+
 	// Generate the texture ID
 	if (_textureID == 0)
 		glGenTextures(1, &_textureID);
@@ -187,17 +273,17 @@ void Texture::doRebuild() {
 
 		glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, GL_FALSE);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, _image->getMipMapCount() - 1);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, _image->getMipMapCount() - 1 - baseLevel);
 	}
 
 	// Texture image data
 	if (_image->isCompressed()) {
 		// Compressed texture data
 
-		for (size_t i = 0; i < _image->getMipMapCount(); i++) {
+		for (size_t i = baseLevel; i < _image->getMipMapCount(); i++) {
 			const ImageDecoder::MipMap &mipMap = _image->getMipMap(i);
 
-			glCompressedTexImage2D(GL_TEXTURE_2D, i, _image->getFormatRaw(),
+			glCompressedTexImage2D(GL_TEXTURE_2D, i - baseLevel, _image->getFormatRaw(),
 			                       mipMap.width, mipMap.height, 0,
 			                       mipMap.size, mipMap.data);
 		}
@@ -205,16 +291,17 @@ void Texture::doRebuild() {
 	} else {
 		// Uncompressed texture data
 
-		for (size_t i = 0; i < _image->getMipMapCount(); i++) {
+		for (size_t i = baseLevel; i < _image->getMipMapCount(); i++) {
 			const ImageDecoder::MipMap &mipMap = _image->getMipMap(i);
 
-			glTexImage2D(GL_TEXTURE_2D, i, _image->getFormatRaw(),
+			glTexImage2D(GL_TEXTURE_2D, i - baseLevel, _image->getFormatRaw(),
 			             mipMap.width, mipMap.height, 0, _image->getFormat(),
 			             _image->getDataType(), mipMap.data);
 		}
 
 	}
 
+	setResidentSize(size);
 }
 
 Texture *Texture::createPLT(const Common::UString &name, Common::SeekableReadStream *imageStream) {
@@ -67,6 +67,27 @@ public:
 	/** Dump the texture into a TGA. */
 	bool dumpTGA(const Common::UString &fileName) const;
 
+	/** Can top mip levels of this texture be dropped to save texture memory? */
+	bool canDropMipMaps() const;
+	/** Return the maximum number of top mip levels that can be dropped. */
+	size_t getMaxDroppedMipMaps() const;
+
+	/** Return the number of top mip levels currently dropped. */
+	size_t getDroppedMipMaps() const;
+	/** Drop that many top mip levels, or restore them from the image.
+	 *
+	 *  The change takes effect with the next rebuild of the texture.
+	 */
+	void setDroppedMipMaps(size_t count);
+
+	/** Return the number of bytes the texture would occupy with that many top mip levels dropped. */
+	uint32 getSize(size_t droppedMipMaps) const;
+	/** Return the number of bytes the texture currently occupies in texture memory. */
+	uint32 getResidentSize() const;
+
+	/** Return the number of bytes all textures currently occupy in texture memory. */
+	static uint64 getTotalResidentSize();
+
 
 	/** Load an image in any of the common texture formats. */
 	static ImageDecoder *loadImage(const Common::UString &name);
@@ -89,6 +110,9 @@ protected:
 	uint32 _width;
 	uint32 _height;
 
+	size_t _droppedMipMaps; ///< Number of top mip levels not uploaded.
+	uint32 _residentSize;   ///< Number of bytes uploaded into texture memory.
+
 
 	Texture();
 	Texture(const Common::UString &name, ImageDecoder *image, ::Aurora::FileType type, TXI *txi = 0);
@@ -99,6 +123,8 @@ protected:
 	void removeFromQueues();
 	void refresh();
 
+	void setResidentSize(uint32 size);
+
 
 	// GLContainer
 	void doRebuild();
@@ -64,39 +64,26 @@ float TextureFont::getLineSpacing() const {
 	return _spaceB;
 }
 
-void TextureFont::drawMissing() const {
-	TextureMan.set();
-
-	float width = getWidth('m') - _spaceR;
-
-	glBegin(GL_QUADS);
-		glVertex2f(0.0f ,    0.0f);
-		glVertex2f(width,    0.0f);
-		glVertex2f(width, _height);
-		glVertex2f(0.0f , _height);
-	glEnd();
-
-	glTranslatef(width + _spaceR, 0.0f, 0.0f);
-}
-
-void TextureFont::draw(uint32 c) const {
+void TextureFont::getGlyph(uint32 c, Glyph &glyph) const {
 	if (c >= _chars.size()) {
-		drawMissing();
+		const float width = getWidth('m') - _spaceR;
+
+		getMissingGlyph(glyph, width, width + _spaceR);
 		return;
 	}
 
-	TextureMan.set(_texture);
-
 	const Char &cC = _chars[c];
 
-	glBegin(GL_QUADS);
+	glyph.texture = &_texture;
+
 	for (int i = 0; i < 4; i++) {
-		glTexCoord2f(cC.tX[i], cC.tY[i]);
-		glVertex2f  (cC.vX[i], cC.vY[i]);
+		glyph.tX[i] = cC.tX[i];
+		glyph.tY[i] = cC.tY[i];
+		glyph.vX[i] = cC.vX[i];
+		glyph.vY[i] = cC.vY[i];
 	}
-	glEnd();
 
-	glTranslatef(cC.width + _spaceR, 0.0f, 0.0f);
+	glyph.advance = cC.width + _spaceR;
 }
 
 void TextureFont::load() {
@@ -54,7 +54,7 @@ public:
 
 	float getLineSpacing() const;
 
-	void draw(uint32 c) const;
+	void getGlyph(uint32 c, Glyph &glyph) const;
 
 private:
 	/** A font character. */
@@ -73,8 +73,6 @@ private:
 	float _spaceB;
 
 	void load();
-
-	void drawMissing() const;
 };
 
 } // End of namespace Aurora
@@ -36,11 +36,14 @@ namespace Aurora {
 
 class Texture;
 
-/** A managed texture, storing how often it's referenced. */
+/** A managed texture, storing how often and how recently it's referenced. */
 struct ManagedTexture {
 	Texture *texture;
 	uint32 referenceCount;
 
+	uint32 lastUsed; ///< The last frame the texture was bound in.
+	float coverage;  ///< Largest screen coverage of anything it was bound for in that frame.
+
 	ManagedTexture(Texture *t);
 	~ManagedTexture();
 };
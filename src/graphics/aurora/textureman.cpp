@@ -22,12 +22,17 @@
  *  The Aurora texture manager.
  */
 
+#include <vector>
+#include <algorithm>
+
 #include "src/common/util.h"
 #include "src/common/error.h"
 #include "src/common/uuid.h"
+#include "src/common/configman.h"
 
 #include "src/graphics/aurora/textureman.h"
 #include "src/graphics/aurora/texture.h"
+#include "src/graphics/aurora/guibatchman.h"
 
 #include "src/graphics/graphics.h"
 
@@ -39,7 +44,47 @@ namespace Graphics {
 
 namespace Aurora {
 
-TextureManager::TextureManager() : _recordNewTextures(false) {
+/** Check the texture memory budget every that many frames. */
+static const uint32 kBudgetInterval = 10;
+/** Change at most that many mip levels in one budget check. */
+static const size_t kMaxBudgetChanges = 16;
+/** Only restore mip levels while that fraction of the budget isn't exceeded. */
+static const float kRestoreThreshold = 0.9f;
+
+/** A texture that might have mip levels dropped or restored. */
+struct BudgetCandidate {
+	Texture *texture;
+	float priority;
+
+	BudgetCandidate(Texture *t, float p) : texture(t), priority(p) {
+	}
+
+	bool operator<(const BudgetCandidate &right) const {
+		return priority < right.priority;
+	}
+};
+
+/** How important is it to keep this texture at full resolution?
+ *
+ *  Textures that were recently bound for things covering much of the screen
+ *  get a high priority. Textures that were never bound get no priority at all.
+ */
+static float getPriority(const ManagedTexture &texture, uint32 frame) {
+	if (texture.lastUsed == 0)
+		return 0.0f;
+
+	const float age = (frame - texture.lastUsed) / (float) kBudgetInterval;
+
+	return texture.coverage / (1.0f + age);
+}
+
+
+TextureManager::TextureManager() : _recordNewTextures(false), _frame(1), _coverage(1.0f) {
+	_budget.store(MAX(ConfigMan.getInt("texturebudget", 0), 0) * 1024ULL * 1024ULL);
+
+	_evictions.store(0);
+	_restores.store(0);
+	_reducedCount.store(0);
 }
 
 TextureManager::~TextureManager() {
@@ -57,6 +102,8 @@ void TextureManager::clear() {
 
 	_recordNewTextures = false;
 	_newTextureNames.clear();
+
+	_reducedCount.store(0);
 }
 
 void TextureManager::addBogusTexture(const Common::UString &name) {
@@ -192,21 +239,27 @@ void TextureManager::release(TextureHandle &texture) {
 }
 
 void TextureManager::reloadAll() {
-	Common::StackLock lock(_mutex);
-
-	GfxMan.lockFrame();
-
-	for (TextureMap::iterator texture = _textures.begin(); texture != _textures.end(); ++texture) {
-		try {
-			texture->second->texture->reload();
-		} catch (Common::Exception &e) {
-			e.add("Failed reloading texture \"%s\"", texture->first.c_str());
-			Common::printException(e, "WARNING: ");
+	{
+		Common::StackLock lock(_mutex);
+
+		GfxMan.lockFrame();
+
+		for (TextureMap::iterator texture = _textures.begin(); texture != _textures.end(); ++texture) {
+			try {
+				texture->second->texture->reload();
+			} catch (Common::Exception &e) {
+				e.add("Failed reloading texture \"%s\"", texture->first.c_str());
+				Common::printException(e, "WARNING: ");
+			}
 		}
+
+		RequestMan.sync();
+		GfxMan.unlockFrame();
 	}
 
-	RequestMan.sync();
-	GfxMan.unlockFrame();
+	/* The GUI atlas still holds copies of the old textures. Not under our lock,
+	 * since the atlas calls into us while holding its own. */
+	GUIBatchMan.clear();
 }
 
 void TextureManager::reset() {
@@ -225,13 +278,144 @@ void TextureManager::set(const TextureHandle &handle) {
 		return;
 	}
 
-	TextureID id = handle._it->second->texture->getID();
+	ManagedTexture &managed = *handle._it->second;
+
+	if (managed.lastUsed != _frame) {
+		managed.lastUsed = _frame;
+		managed.coverage = _coverage;
+	} else
+		managed.coverage = MAX(managed.coverage, _coverage);
+
+	TextureID id = managed.texture->getID();
 	if (id == 0)
 		warning("Empty texture ID for texture \"%s\"", handle._it->first.c_str());
 
 	glBindTexture(GL_TEXTURE_2D, id);
 }
 
+void TextureManager::setCoverage(float coverage) {
+	_coverage = CLIP(coverage, 0.0f, 1.0f);
+}
+
+void TextureManager::setBudget(uint64 budget) {
+	_budget.store(budget);
+}
+
+uint64 TextureManager::getBudget() const {
+	return _budget.load();
+}
+
+uint64 TextureManager::getResidentSize() const {
+	return Texture::getTotalResidentSize();
+}
+
+size_t TextureManager::getReducedCount() const {
+	return _reducedCount.load();
+}
+
+uint64 TextureManager::getEvictionCount() const {
+	return _evictions.load();
+}
+
+uint64 TextureManager::getRestoreCount() const {
+	return _restores.load();
+}
+
+void TextureManager::manageBudget() {
+	if ((++_frame % kBudgetInterval) != 0)
+		return;
+
+	const uint64 budget = _budget.load();
+
+	uint64 resident = Texture::getTotalResidentSize();
+
+	const bool overBudget = (budget != 0) && (resident > budget);
+	if (!overBudget && (_reducedCount.load() == 0))
+		return;
+
+	Common::StackLock lock(_mutex);
+
+	std::vector<BudgetCandidate> candidates;
+	candidates.reserve(_textures.size());
+
+	size_t reducedCount = 0;
+	for (TextureMap::iterator t = _textures.begin(); t != _textures.end(); ++t) {
+		Texture &texture = *t->second->texture;
+
+		if (texture.getDroppedMipMaps() > 0)
+			reducedCount++;
+		else if (!texture.canDropMipMaps())
+			continue;
+
+		candidates.push_back(BudgetCandidate(&texture, getPriority(*t->second, _frame)));
+	}
+
+	std::sort(candidates.begin(), candidates.end());
+
+	size_t changes = 0;
+
+	if (overBudget) {
+		// Drop a top mip level from the least important textures until we're within budget
+
+		for (std::vector<BudgetCandidate>::iterator c = candidates.begin(); c != candidates.end(); ++c) {
+			if ((resident <= budget) || (changes >= kMaxBudgetChanges))
+				break;
+
+			Texture &texture = *c->texture;
+
+			const size_t dropped = texture.getDroppedMipMaps();
+			if (dropped >= texture.getMaxDroppedMipMaps())
+				continue;
+
+			const uint32 saved = texture.getSize(dropped) - texture.getSize(dropped + 1);
+
+			if (dropped == 0)
+				reducedCount++;
+
+			texture.setDroppedMipMaps(dropped + 1);
+			resident -= MIN<uint64>(saved, resident);
+
+			_evictions++;
+			changes++;
+		}
+
+	} else {
+		// Restore a top mip level to the most important textures while there's room
+
+		const uint64 limit = (budget == 0) ? 0 : (uint64) (budget * kRestoreThreshold);
+
+		for (std::vector<BudgetCandidate>::reverse_iterator c = candidates.rbegin(); c != candidates.rend(); ++c) {
+			if (changes >= kMaxBudgetChanges)
+				break;
+
+			Texture &texture = *c->texture;
+
+			const size_t dropped = texture.getDroppedMipMaps();
+			if (dropped == 0)
+				continue;
+
+			// With a budget, only restore textures that are actually in use
+			if ((budget != 0) && (c->priority <= 0.0f))
+				break;
+
+			const uint32 cost = texture.getSize(dropped - 1) - texture.getSize(dropped);
+			if ((budget != 0) && ((resident + cost) > limit))
+				break;
+
+			if (dropped == 1)
+				reducedCount--;
+
+			texture.setDroppedMipMaps(dropped - 1);
+			resident += cost;
+
+			_restores++;
+			changes++;
+		}
+	}
+
+	_reducedCount.store(reducedCount);
+}
+
 static GLenum texture[32] = {
 	GL_TEXTURE0_ARB,
 	GL_TEXTURE1_ARB,
@@ -32,6 +32,7 @@
 #include "src/common/singleton.h"
 #include "src/common/mutex.h"
 #include "src/common/ustring.h"
+#include "src/common/atomic.h"
 
 #include "src/graphics/aurora/texturehandle.h"
 
@@ -84,6 +85,28 @@ public:
 
 	/** Set this texture unit as the current one. */
 	void activeTexture(size_t n);
+
+	/** Set how much of the screen, 0.0f to 1.0f, is covered by what the following textures are bound for. */
+	void setCoverage(float coverage);
+	// '---
+
+	// .--- Texture memory budget
+	/** Set the texture memory budget in bytes. 0 means unlimited. */
+	void setBudget(uint64 budget);
+	/** Return the texture memory budget in bytes. */
+	uint64 getBudget() const;
+
+	/** Return the number of bytes all textures currently occupy in texture memory. */
+	uint64 getResidentSize() const;
+	/** Return the number of textures with dropped mip levels, as of the last budget check. */
+	size_t getReducedCount() const;
+	/** Return the number of mip levels dropped to stay within the budget so far. */
+	uint64 getEvictionCount() const;
+	/** Return the number of dropped mip levels restored so far. */
+	uint64 getRestoreCount() const;
+
+	/** Drop or restore mip levels to stay within the budget. Called once every frame. */
+	void manageBudget();
 	// '---
 
 private:
@@ -96,6 +119,14 @@ private:
 	bool _recordNewTextures;
 	std::list<Common::UString> _newTextureNames;
 
+	uint32 _frame;    ///< The current frame, as counted by manageBudget().
+	float  _coverage; ///< The screen coverage to record for bound textures.
+
+	boost::atomic<uint64> _budget;
+	boost::atomic<uint64> _evictions;
+	boost::atomic<uint64> _restores;
+	boost::atomic<size_t> _reducedCount;
+
 	void assign(TextureHandle &texture, const TextureHandle &from);
 	void release(TextureHandle &texture);
 
@@ -151,28 +151,13 @@ float TTFFont::getHeight() const {
 	return _height;
 }
 
-void TTFFont::drawMissing() const {
-	TextureMan.set();
-
-	const float width = _missingWidth - 1.0f;
-
-	glBegin(GL_QUADS);
-		glVertex2f(0.0f ,    0.0f);
-		glVertex2f(width,    0.0f);
-		glVertex2f(width, _height);
-		glVertex2f(0.0f , _height);
-	glEnd();
-
-	glTranslatef(width + 1.0f, 0.0f, 0.0f);
-}
-
-void TTFFont::draw(uint32 c) const {
+void TTFFont::getGlyph(uint32 c, Glyph &glyph) const {
 	std::map<uint32, Char>::const_iterator cC = _chars.find(c);
 	if (cC == _chars.end()) {
 		cC = _missingChar;
 
 		if (cC == _chars.end()) {
-			drawMissing();
+			getMissingGlyph(glyph, _missingWidth - 1.0f, _missingWidth);
 			return;
 		}
 	}
@@ -180,16 +165,16 @@ void TTFFont::draw(uint32 c) const {
 	size_t page = cC->second.page;
 	assert(page < _pages.size());
 
-	TextureMan.set(_pages[page]->texture);
+	glyph.texture = &_pages[page]->texture;
 
-	glBegin(GL_QUADS);
 	for (int i = 0; i < 4; i++) {
-		glTexCoord2f(cC->second.tX[i], cC->second.tY[i]);
-		glVertex2f  (cC->second.vX[i], cC->second.vY[i]);
+		glyph.tX[i] = cC->second.tX[i];
+		glyph.tY[i] = cC->second.tY[i];
+		glyph.vX[i] = cC->second.vX[i];
+		glyph.vY[i] = cC->second.vY[i];
 	}
-	glEnd();
 
-	glTranslatef(cC->second.width, 0.0f, 0.0f);
+	glyph.advance = cC->second.width;
 }
 
 void TTFFont::buildChars(const Common::UString &str) {
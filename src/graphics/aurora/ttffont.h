@@ -54,7 +54,7 @@ public:
 	float getWidth (uint32 c) const;
 	float getHeight()         const;
 
-	void draw(uint32 c) const;
+	void getGlyph(uint32 c, Glyph &glyph) const;
 
 	void buildChars(const Common::UString &str);
 
@@ -102,7 +102,6 @@ private:
 
 	void rebuildPages();
 	void addChar(uint32 c);
-	void drawMissing() const;
 
 	void clear();
 };
@@ -44,6 +44,7 @@ class Model;
 class ModelNode;
 class Text;
 class GUIQuad;
+class StaticGeometry;
 
 } // End of namespace Aurora
 
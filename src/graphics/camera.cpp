@@ -28,7 +28,6 @@
 #include "src/common/maths.h"
 
 #include "src/graphics/camera.h"
-#include "src/graphics/graphics.h"
 
 #include "src/events/events.h"
 #include "src/events/notifications.h"
@@ -61,22 +60,23 @@ CameraManager::CameraManager() : _lastChanged(0), _needUpdate(false) {
 }
 
 void CameraManager::update() {
-	GfxMan.lockFrame();
-
-	if (!_needUpdate) {
-		GfxMan.unlockFrame();
+	if (!_needUpdate)
 		return;
-	}
 
 	_needUpdate = false;
 
 	memcpy(_positionCache   , _position   , sizeof(_positionCache));
 	memcpy(_orientationCache, _orientation, sizeof(_orientationCache));
 
-	GfxMan.recalculateObjectDistances();
-	NotificationMan.cameraMoved();
+	RenderState &state = _renderState.getBack();
+
+	memcpy(state.position   , _position   , sizeof(state.position));
+	memcpy(state.orientation, _orientation, sizeof(state.orientation));
 
-	GfxMan.unlockFrame();
+	_renderState.publish();
+
+	// The renderer recalculates the object distances when it picks up the new camera
+	NotificationMan.cameraMoved();
 }
 
 const float *CameraManager::getPosition() const {
@@ -87,6 +87,17 @@ const float *CameraManager::getOrientation() const {
 	return _orientationCache;
 }
 
+bool CameraManager::updateRenderState() {
+	return _renderState.update();
+}
+
+void CameraManager::getRenderState(float *position, float *orientation) const {
+	const RenderState &state = _renderState.getFront();
+
+	memcpy(position   , state.position   , sizeof(state.position));
+	memcpy(orientation, state.orientation, sizeof(state.orientation));
+}
+
 void CameraManager::reset() {
 	_minPosition[0] = -FLT_MAX;
 	_minPosition[1] = -FLT_MAX;
@@ -28,6 +28,7 @@
 #include "src/common/types.h"
 #include "src/common/maths.h"
 #include "src/common/singleton.h"
+#include "src/common/triplebuffer.h"
 
 namespace Graphics {
 
@@ -38,6 +39,18 @@ public:
 	const float *getPosition   () const; ///< Get the current camera position cache.
 	const float *getOrientation() const; ///< Get the current camera orientation cache.
 
+	/** Pick up the camera position and orientation most recently published by update().
+	 *
+	 *  This is meant to be called from the render thread only, once at the start
+	 *  of each frame, and never waits for the thread updating the camera.
+	 *
+	 *  @return true if the camera changed since the last frame.
+	 */
+	bool updateRenderState();
+
+	/** Get the camera position and orientation picked up for the current frame. Render thread only. */
+	void getRenderState(float *position, float *orientation) const;
+
 	void reset(); ///< Reset the current position and orientation.
 
 	/** Set limits on the camera position. */
@@ -67,6 +80,12 @@ public:
 	void update();
 
 private:
+	/** A snapshot of the camera, as handed to the render thread. */
+	struct RenderState {
+		float position[3];
+		float orientation[3];
+	};
+
 	uint32 _lastChanged;
 
 	float _minPosition[3];
@@ -78,6 +97,8 @@ private:
 	float _positionCache[3];    ///< Current position, cached.
 	float _orientationCache[3]; ///< Current orientation, cached.
 
+	Common::TripleBuffer<RenderState> _renderState;
+
 	bool _needUpdate;
 };
 
@@ -66,55 +66,94 @@ float Font::getHeight(const Common::UString &text, float maxWidth, float maxHeig
 void Font::buildChars(const Common::UString &UNUSED(str)) {
 }
 
-void Font::draw(Common::UString text, const ColorPositions &colors,
-                float r, float g, float b, float a, float align, float maxWidth, float maxHeight) const {
+void Font::getMissingGlyph(Glyph &glyph, float width, float advance) const {
+	glyph.texture = 0;
 
-	glColor4f(r, g, b, a);
+	for (int i = 0; i < 4; i++)
+		glyph.tX[i] = glyph.tY[i] = 0.0f;
+
+	glyph.vX[0] = 0.0f ; glyph.vY[0] = 0.0f;
+	glyph.vX[1] = width; glyph.vY[1] = 0.0f;
+	glyph.vX[2] = width; glyph.vY[2] = getHeight();
+	glyph.vX[3] = 0.0f ; glyph.vY[3] = getHeight();
+
+	glyph.advance = advance;
+}
+
+void Font::buildQuads(const Common::UString &text, const ColorPositions &colors, QuadBatches &batches,
+                      float r, float g, float b, float a, float align, float maxWidth, float maxHeight) const {
+
+	batches.clear();
 
 	std::vector<Common::UString> lines;
 	float maxLength = split(text, lines, maxWidth, maxHeight, false);
+	if (lines.empty())
+		return;
 
-	// Move position to the top
-	glTranslatef(0.0f, (lines.size() - 1) * (getHeight() + getLineSpacing()), 0.0f);
+	float color[4] = { r, g, b, a };
+
+	// Start at the top
+	float y = (lines.size() - 1) * (getHeight() + getLineSpacing());
 
 	size_t position = 0;
 
-	ColorPositions::const_iterator color = colors.begin();
+	ColorPositions::const_iterator colorChange = colors.begin();
 
-	// Draw lines
 	for (std::vector<Common::UString>::iterator l = lines.begin(); l != lines.end(); ++l) {
-		// Save the current position
-		glPushMatrix();
-
 		// Align
-		glTranslatef(roundf((maxLength - getLineWidth(*l)) * align), 0.0f, 0.0f);
+		float x = roundf((maxLength - getLineWidth(*l)) * align);
 
-		// Draw line
 		for (Common::UString::iterator s = l->begin(); s != l->end(); ++s, position++) {
 			// If we have color changes, apply them
-			while ((color != colors.end()) && (color->position <= position)) {
-				if (color->defaultColor)
-					glColor4f(r, g, b, a);
-				else
-					glColor4f(color->r, color->g, color->b, color->a);
+			while ((colorChange != colors.end()) && (colorChange->position <= position)) {
+				if (colorChange->defaultColor) {
+					color[0] = r;
+					color[1] = g;
+					color[2] = b;
+					color[3] = a;
+				} else {
+					color[0] = colorChange->r;
+					color[1] = colorChange->g;
+					color[2] = colorChange->b;
+					color[3] = colorChange->a;
+				}
 
-				++color;
+				++colorChange;
 			}
 
-			draw(*s);
-		}
+			Glyph glyph;
+			getGlyph(*s, glyph);
 
-		// Restore position to the start of the line
-		glPopMatrix();
+			// Find the batch for this texture. Fonts only ever have a handful of textures
+			QuadBatches::iterator batch = batches.begin();
+			while ((batch != batches.end()) && (batch->texture != glyph.texture))
+				++batch;
+
+			if (batch == batches.end()) {
+				batches.push_back(QuadBatch());
+				batch = --batches.end();
+
+				batch->texture = glyph.texture;
+			}
+
+			for (int i = 0; i < 4; i++) {
+				const float vertex[kQuadVertexSize] = {
+					x + glyph.vX[i], y + glyph.vY[i], glyph.tX[i], glyph.tY[i],
+					color[0], color[1], color[2], color[3]
+				};
+
+				batch->vertices.insert(batch->vertices.end(), vertex, vertex + kQuadVertexSize);
+			}
+
+			x += glyph.advance;
+		}
 
 		// Move to the next line
-		glTranslatef(0.0f, -(getHeight() + getLineSpacing()), 0.0f);
+		y -= getHeight() + getLineSpacing();
 
 		// \n character
 		position++;
 	}
-
-	glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
 }
 
 float Font::split(const Common::UString &line, std::vector<Common::UString> &lines,
@@ -33,9 +33,38 @@
 
 namespace Graphics {
 
+namespace Aurora {
+	class TextureHandle;
+}
+
 /** An abstract font. */
 class Font {
 public:
+	/** The textured quad drawing one character. */
+	struct Glyph {
+		/** The texture holding the character, or 0 for an untextured box. */
+		const Aurora::TextureHandle *texture;
+
+		float tX[4], tY[4]; ///< Texture coordinates of the quad's corners.
+		float vX[4], vY[4]; ///< The quad's corners, relative to the current position.
+
+		float advance; ///< How far to move the current position afterwards.
+	};
+
+	/** The number of floats in a quad vertex: x, y, u, v, r, g, b, a. */
+	static const size_t kQuadVertexSize = 8;
+
+	/** The quads of laid out text that all use the same texture. */
+	struct QuadBatch {
+		const Aurora::TextureHandle *texture;
+
+		/** Four vertices per quad, kQuadVertexSize floats each. */
+		std::vector<float> vertices;
+	};
+
+	typedef std::vector<QuadBatch> QuadBatches;
+
+
 	Font();
 	virtual ~Font();
 
@@ -58,17 +87,26 @@ public:
 	/** Build all necessary characters to display this string. */
 	virtual void buildChars(const Common::UString &str);
 
-	/** Draw this character. */
-	virtual void draw(uint32 c) const = 0;
+	/** Return the quad drawing this character. */
+	virtual void getGlyph(uint32 c, Glyph &glyph) const = 0;
 
-	void draw(Common::UString text, const ColorPositions &colors,
-		  float r, float g, float b, float a, float align = 0.0f, float maxWidth = 0.0f, float maxHeight = 0.0f) const;
+	/** Lay out this text into quads, one for each character.
+	 *
+	 *  The quads are grouped by texture, so that each batch can be drawn with a single call.
+	 *  The first line starts at the origin, with the following lines below it.
+	 */
+	void buildQuads(const Common::UString &text, const ColorPositions &colors, QuadBatches &batches,
+	                float r, float g, float b, float a, float align = 0.0f, float maxWidth = 0.0f, float maxHeight = 0.0f) const;
 
 	float split(const Common::UString &line, std::vector<Common::UString> &lines,
 	            float maxWidth = 0.0f, float maxHeight = 0.0f, bool trim = true) const;
 	float split(Common::UString &line, float maxWidth, float maxHeight = 0.0f, bool trim = true) const;
 	float split(const Common::UString &line, Common::UString &lines, float maxWidth, float maxHeight = 0.0f, bool trim = true) const;
 
+protected:
+	/** Create an untextured box glyph, for characters the font doesn't have. */
+	void getMissingGlyph(Glyph &glyph, float width, float advance) const;
+
 private:
 	float getLineWidth(const Common::UString &text) const;
 	bool addLine(std::vector<Common::UString> &lines, const Common::UString &newLine, float maxHeight) const;
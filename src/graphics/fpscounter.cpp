@@ -24,6 +24,8 @@
 
 #include <cassert>
 
+#include <SDL_timer.h>
+
 #include "src/common/util.h"
 
 #include "src/graphics/fpscounter.h"
@@ -35,12 +37,16 @@ namespace Graphics {
 FPSCounter::FPSCounter(uint32 secs) : _seconds(secs) {
 	assert(_seconds > 0);
 
-	_frames = new uint32[_seconds];
+	_frames        = new uint32[_seconds];
+	_frameTimes    = new uint64[_seconds];
+	_maxFrameTimes = new uint32[_seconds];
 
 	reset();
 }
 
 FPSCounter::~FPSCounter() {
+	delete[] _maxFrameTimes;
+	delete[] _frameTimes;
 	delete[] _frames;
 }
 
@@ -48,6 +54,14 @@ uint32 FPSCounter::getFPS() const {
 	return _fps;
 }
 
+uint32 FPSCounter::getFrameTime() const {
+	return _frameTime;
+}
+
+uint32 FPSCounter::getMaxFrameTime() const {
+	return _maxFrameTime;
+}
+
 void FPSCounter::reset() {
 	_lastSampled = 0;
 
@@ -57,8 +71,35 @@ void FPSCounter::reset() {
 
 	_fps = 0.0f;
 
-	for (uint32 i = 0; i < _seconds; i++)
-		_frames[i] = 0;
+	_frameStart = 0;
+
+	_frameTime    = 0;
+	_maxFrameTime = 0;
+
+	for (uint32 i = 0; i < _seconds; i++) {
+		_frames       [i] = 0;
+		_frameTimes   [i] = 0;
+		_maxFrameTimes[i] = 0;
+	}
+}
+
+void FPSCounter::startFrame() {
+	_frameStart = SDL_GetPerformanceCounter();
+}
+
+void FPSCounter::finishedRendering() {
+	if (_frameStart == 0)
+		return;
+
+	const uint64 ticks     = SDL_GetPerformanceCounter() - _frameStart;
+	const uint64 frequency = SDL_GetPerformanceFrequency();
+
+	const uint32 frameTime = (uint32) ((ticks * 1000000) / frequency);
+
+	_frameTimes   [_currentSecond] += frameTime;
+	_maxFrameTimes[_currentSecond]  = MAX(_maxFrameTimes[_currentSecond], frameTime);
+
+	_frameStart = 0;
 }
 
 void FPSCounter::finishedFrame() {
@@ -81,8 +122,10 @@ void FPSCounter::finishedFrame() {
 		// Calculate the new FPS value
 		calculateFPS();
 
-		// Reset the counter
-		_frames[_currentSecond] = 0;
+		// Reset the counters
+		_frames       [_currentSecond] = 0;
+		_frameTimes   [_currentSecond] = 0;
+		_maxFrameTimes[_currentSecond] = 0;
 	}
 
 	// Another frame!
@@ -92,10 +135,19 @@ void FPSCounter::finishedFrame() {
 void FPSCounter::calculateFPS() {
 	uint32 seconds = _hasFullSeconds ? _seconds : _currentSecond;
 	uint32 frames = 0;
-	for (uint32 i = 0; i < seconds; i++)
-		frames += _frames[i];
+	uint64 frameTimes = 0;
+
+	_maxFrameTime = 0;
+	for (uint32 i = 0; i < seconds; i++) {
+		frames     += _frames[i];
+		frameTimes += _frameTimes[i];
+
+		_maxFrameTime = MAX(_maxFrameTime, _maxFrameTimes[i]);
+	}
 
 	_fps = frames / seconds;
+
+	_frameTime = (frames > 0) ? (uint32) (frameTimes / frames) : 0;
 }
 
 } // End of namespace Graphics
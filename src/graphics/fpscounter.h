@@ -29,7 +29,11 @@
 
 namespace Graphics {
 
-/** A class counting frames per second. */
+/** A class counting frames per second.
+ *
+ *  Additionally, it measures the time spent on building each frame,
+ *  i.e. the time between startFrame() and finishedRendering().
+ */
 class FPSCounter  {
 public:
 	/** Average the FPS over that many seconds. */
@@ -39,9 +43,19 @@ public:
 	/** Get the current FPS value. */
 	uint32 getFPS() const;
 
+	/** Get the average time spent rendering a frame, in microseconds. */
+	uint32 getFrameTime() const;
+	/** Get the longest time spent rendering a frame, in microseconds. */
+	uint32 getMaxFrameTime() const;
+
 	/** Reset the counter. */
 	void reset();
 
+	/** Signal that we're starting to render a frame. */
+	void startFrame();
+	/** Signal that all rendering commands for the frame have been issued. */
+	void finishedRendering();
+
 	/** Signal a finished frame. */
 	void finishedFrame();
 
@@ -57,6 +71,14 @@ private:
 
 	uint32 *_frames; ///< All frame counters.
 
+	uint64 _frameStart; ///< Performance counter value at the start of the current frame.
+
+	uint64 *_frameTimes;    ///< Summed frame render times, per second, in microseconds.
+	uint32 *_maxFrameTimes; ///< Longest frame render time, per second, in microseconds.
+
+	uint32 _frameTime;    ///< The current average frame render time.
+	uint32 _maxFrameTime; ///< The current longest frame render time.
+
 	void calculateFPS(); ///< Calculate the average FPS value.
 };
 
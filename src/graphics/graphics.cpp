@@ -53,6 +53,9 @@
 #include "src/graphics/images/decoder.h"
 #include "src/graphics/images/screenshot.h"
 
+#include "src/graphics/aurora/textureman.h"
+#include "src/graphics/aurora/guibatchman.h"
+
 #include "src/graphics/shader/shader.h"
 #include "src/graphics/shader/materialman.h"
 #include "src/graphics/shader/surfaceman.h"
@@ -64,11 +67,17 @@ namespace Graphics {
 
 PFNGLCOMPRESSEDTEXIMAGE2DPROC glCompressedTexImage2D;
 
-GraphicsManager::GraphicsManager() {
+/** Margin around bounding boxes in the world object index. Objects can move this
+ *  far before they need to be moved within the index. */
+static const float kWorldIndexMargin = 1.0f;
+
+GraphicsManager::GraphicsManager() : _worldIndex(kWorldIndexMargin) {
 	_ready = false;
 
-	_needManualDeS3TC        = false;
-	_supportMultipleTextures = false;
+	_needManualDeS3TC         = false;
+	_supportMultipleTextures  = false;
+	_supportHalfFloatVertices = false;
+	_supportPackedNormals     = false;
 
 	_fullScreen = false;
 
@@ -111,6 +120,17 @@ GraphicsManager::GraphicsManager() {
 
 	_lastSampled = 0;
 
+	_cullFrame = 0;
+	memset(_frustum, 0, sizeof(_frustum));
+
+	_culledObjects.store(0);
+	_drawnObjects.store(0);
+
+	_frameDrawCalls = 0;
+	_worldDrawCalls.store(0);
+
+	_guiFrameTime.store(0);
+
 	glCompressedTexImage2D = 0;
 }
 
@@ -179,8 +199,10 @@ void GraphicsManager::deinit() {
 
 	_ready = false;
 
-	_needManualDeS3TC        = false;
-	_supportMultipleTextures = false;
+	_needManualDeS3TC         = false;
+	_supportMultipleTextures  = false;
+	_supportHalfFloatVertices = false;
+	_supportPackedNormals     = false;
 }
 
 bool GraphicsManager::ready() const {
@@ -195,6 +217,14 @@ bool GraphicsManager::supportMultipleTextures() const {
 	return _supportMultipleTextures;
 }
 
+bool GraphicsManager::supportHalfFloatVertices() const {
+	return _supportHalfFloatVertices;
+}
+
+bool GraphicsManager::supportPackedNormals() const {
+	return _supportPackedNormals;
+}
+
 int GraphicsManager::getMaxFSAA() const {
 	return _fsaaMax;
 }
@@ -207,6 +237,34 @@ uint32 GraphicsManager::getFPS() const {
 	return _fpsCounter->getFPS();
 }
 
+uint32 GraphicsManager::getFrameTime() const {
+	return _fpsCounter->getFrameTime();
+}
+
+uint32 GraphicsManager::getMaxFrameTime() const {
+	return _fpsCounter->getMaxFrameTime();
+}
+
+uint32 GraphicsManager::getGUIFrameTime() const {
+	return _guiFrameTime.load();
+}
+
+uint32 GraphicsManager::getCulledObjectCount() const {
+	return _culledObjects.load();
+}
+
+uint32 GraphicsManager::getDrawnObjectCount() const {
+	return _drawnObjects.load();
+}
+
+uint32 GraphicsManager::getWorldDrawCallCount() const {
+	return _worldDrawCalls.load();
+}
+
+void GraphicsManager::countDrawCalls(uint32 count) {
+	_frameDrawCalls += count;
+}
+
 void GraphicsManager::initSize(int width, int height, bool fullscreen) {
 	uint32 flags = SDL_WINDOW_OPENGL;
 
@@ -400,6 +458,10 @@ void GraphicsManager::checkGLExtensions() {
 		_supportMultipleTextures = false;
 	} else
 		_supportMultipleTextures = true;
+
+	// Optional compact vertex formats. Without them, we just use more memory.
+	_supportHalfFloatVertices = GLEW_ARB_half_float_vertex || GLEW_VERSION_3_0;
+	_supportPackedNormals     = GLEW_ARB_vertex_type_2_10_10_10_rev || GLEW_VERSION_3_3;
 }
 
 void GraphicsManager::setWindowTitle(const Common::UString &title) {
@@ -755,38 +817,6 @@ void GraphicsManager::unlockFrame() {
 	assert(lock != 0);
 }
 
-void GraphicsManager::recalculateObjectDistances() {
-	// World objects
-	QueueMan.lockQueue(kQueueVisibleWorldObject);
-
-	const std::list<Queueable *> &objects = QueueMan.getQueue(kQueueVisibleWorldObject);
-	for (std::list<Queueable *>::const_iterator o = objects.begin(); o != objects.end(); ++o)
-		static_cast<Renderable *>(*o)->calculateDistance();
-
-	QueueMan.sortQueue(kQueueVisibleWorldObject);
-	QueueMan.unlockQueue(kQueueVisibleWorldObject);
-
-	// GUI front objects
-	QueueMan.lockQueue(kQueueVisibleGUIFrontObject);
-
-	const std::list<Queueable *> &guiFront = QueueMan.getQueue(kQueueVisibleGUIFrontObject);
-	for (std::list<Queueable *>::const_iterator g = guiFront.begin(); g != guiFront.end(); ++g)
-		static_cast<Renderable *>(*g)->calculateDistance();
-
-	QueueMan.sortQueue(kQueueVisibleGUIFrontObject);
-	QueueMan.unlockQueue(kQueueVisibleGUIFrontObject);
-
-	// GUI back objects
-	QueueMan.lockQueue(kQueueVisibleGUIBackObject);
-
-	const std::list<Queueable *> &guiBack = QueueMan.getQueue(kQueueVisibleGUIBackObject);
-	for (std::list<Queueable *>::const_iterator g = guiBack.begin(); g != guiBack.end(); ++g)
-		static_cast<Renderable *>(*g)->calculateDistance();
-
-	QueueMan.sortQueue(kQueueVisibleGUIBackObject);
-	QueueMan.unlockQueue(kQueueVisibleGUIBackObject);
-}
-
 uint32 GraphicsManager::createRenderableID() {
 	Common::StackLock lock(_renderableIDMutex);
 
@@ -849,10 +879,12 @@ Renderable *GraphicsManager::getGUIObjectAt(float x, float y) const {
 	Renderable *object = 0;
 
 	QueueMan.lockQueue(kQueueVisibleGUIFrontObject);
-	const std::list<Queueable *> &gui = QueueMan.getQueue(kQueueVisibleGUIFrontObject);
+	QueueMan.sortQueueIfNeeded(kQueueVisibleGUIFrontObject);
+
+	const QueueList &gui = QueueMan.getQueue(kQueueVisibleGUIFrontObject);
 
 	// Go through the GUI elements, from nearest to furthest
-	for (std::list<Queueable *>::const_iterator g = gui.begin(); g != gui.end(); ++g) {
+	for (QueueList::const_iterator g = gui.begin(); g != gui.end(); ++g) {
 		Renderable &r = static_cast<Renderable &>(**g);
 
 		if (!r.isClickable())
@@ -883,21 +915,26 @@ Renderable *GraphicsManager::getWorldObjectAt(float x, float y) const {
 
 	Renderable *object = 0;
 
+	// Objects found in the index stay alive while we hold the queue lock
 	QueueMan.lockQueue(kQueueVisibleWorldObject);
-	const std::list<Queueable *> &objects = QueueMan.getQueue(kQueueVisibleWorldObject);
 
-	for (std::list<Queueable *>::const_iterator o = objects.begin(); o != objects.end(); ++o) {
-		Renderable &r = static_cast<Renderable &>(**o);
+	// Only objects with a bounding box can be hit, so let the index find the candidates
+	std::vector<void *> candidates;
+
+	_worldIndexMutex.lock();
+	_worldIndex.querySegment(x1, y1, z1, x2, y2, z2, candidates);
+	_worldIndexMutex.unlock();
+
+	for (std::vector<void *>::const_iterator c = candidates.begin(); c != candidates.end(); ++c) {
+		Renderable &r = *static_cast<Renderable *>(*c);
 
 		if (!r.isClickable())
 			// Object isn't clickable, don't check
 			continue;
 
-		// If the line intersects with the object, return it
-		if (r.isIn(x1, y1, z1, x2, y2, z2)) {
+		// Of all objects the line intersects with, return the one that's sorted first
+		if (r.isIn(x1, y1, z1, x2, y2, z2) && (!object || (r < *object)))
 			object = &r;
-			break;
-		}
 	}
 
 	QueueMan.unlockQueue(kQueueVisibleWorldObject);
@@ -916,22 +953,146 @@ Renderable *GraphicsManager::getObjectAt(float x, float y) {
 	return 0;
 }
 
+void GraphicsManager::addToWorldIndex(Renderable &renderable) {
+	Common::StackLock lock(_worldIndexMutex);
+
+	if (renderable._worldProxy >= 0)
+		return;
+
+	float min[3], max[3];
+	if (!renderable.getWorldBound(min, max))
+		return;
+
+	renderable._worldProxy = _worldIndex.insert(min, max, &renderable);
+}
+
+void GraphicsManager::removeFromWorldIndex(Renderable &renderable) {
+	Common::StackLock lock(_worldIndexMutex);
+
+	if (renderable._worldProxy < 0)
+		return;
+
+	_worldIndex.remove(renderable._worldProxy);
+	renderable._worldProxy = -1;
+}
+
+void GraphicsManager::updateInWorldIndex(Renderable &renderable) {
+	Common::StackLock lock(_worldIndexMutex);
+
+	// Objects only enter the index when they're shown
+	if (renderable._worldProxy < 0)
+		return;
+
+	float min[3], max[3];
+	if (!renderable.getRenderBound(min, max)) {
+		_worldIndex.remove(renderable._worldProxy);
+		renderable._worldProxy = -1;
+		return;
+	}
+
+	_worldIndex.update(renderable._worldProxy, min, max);
+}
+
+void GraphicsManager::updateRenderStates() {
+	const bool cameraMoved = CameraMan.updateRenderState();
+
+	updateRenderStates(kQueueVisibleWorldObject   , cameraMoved);
+	updateRenderStates(kQueueVisibleGUIFrontObject, cameraMoved);
+	updateRenderStates(kQueueVisibleGUIBackObject , cameraMoved);
+}
+
+void GraphicsManager::updateRenderStates(QueueType queue, bool cameraMoved) {
+	QueueMan.lockQueue(queue);
+
+	bool moved = false;
+
+	const QueueList &objects = QueueMan.getQueue(queue);
+	for (QueueList::const_iterator o = objects.begin(); o != objects.end(); ++o) {
+		Renderable &renderable = static_cast<Renderable &>(**o);
+
+		if (!renderable.updateRenderState() && !cameraMoved)
+			continue;
+
+		if (queue == kQueueVisibleWorldObject)
+			updateInWorldIndex(renderable);
+
+		renderable.calculateDistance();
+		moved = true;
+	}
+
+	if (moved)
+		QueueMan.sortQueue(queue);
+
+	QueueMan.unlockQueue(queue);
+}
+
+void GraphicsManager::cullWorld() {
+	// Extract the view frustum planes from the combined view and projection matrix
+	const Common::TransformationMatrix viewProjection = _projection * _modelview;
+
+	float (&planes)[6][4] = _frustum;
+	for (int i = 0; i < 4; i++) {
+		planes[0][i] = viewProjection(3, i) + viewProjection(0, i); // Left
+		planes[1][i] = viewProjection(3, i) - viewProjection(0, i); // Right
+		planes[2][i] = viewProjection(3, i) + viewProjection(1, i); // Bottom
+		planes[3][i] = viewProjection(3, i) - viewProjection(1, i); // Top
+		planes[4][i] = viewProjection(3, i) + viewProjection(2, i); // Near
+		planes[5][i] = viewProjection(3, i) - viewProjection(2, i); // Far
+	}
+
+	// Never hand out 0, which is what new objects start with
+	if (++_cullFrame == 0)
+		_cullFrame = 1;
+
+	_cullResults.clear();
+
+	_worldIndexMutex.lock();
+	_worldIndex.queryPlanes(planes, 6, _cullResults);
+	_worldIndexMutex.unlock();
+
+	for (std::vector<void *>::const_iterator o = _cullResults.begin(); o != _cullResults.end(); ++o)
+		static_cast<Renderable *>(*o)->_cullFrame = _cullFrame;
+}
+
+bool GraphicsManager::isBoxInFrustum(const float min[3], const float max[3]) const {
+	for (int i = 0; i < 6; i++) {
+		const float *plane = _frustum[i];
+
+		// The box corner farthest along the plane normal
+		float distance = plane[3];
+		for (int j = 0; j < 3; j++)
+			distance += plane[j] * ((plane[j] >= 0.0f) ? max[j] : min[j]);
+
+		if (distance < 0.0f)
+			return false;
+	}
+
+	return true;
+}
+
+bool GraphicsManager::isCulled(const Renderable &renderable) const {
+	// Objects without a bounding box are never culled
+	return (renderable._worldProxy >= 0) && (renderable._cullFrame != _cullFrame);
+}
+
 void GraphicsManager::buildNewTextures() {
 	QueueMan.lockQueue(kQueueNewTexture);
-	const std::list<Queueable *> &text = QueueMan.getQueue(kQueueNewTexture);
+	const QueueList &text = QueueMan.getQueue(kQueueNewTexture);
 	if (text.empty()) {
 		QueueMan.unlockQueue(kQueueNewTexture);
 		return;
 	}
 
-	for (std::list<Queueable *>::const_iterator t = text.begin(); t != text.end(); ++t)
-		static_cast<GLContainer *>(*t)->rebuild();
+	for (size_t i = 0; i < text.size(); i++)
+		static_cast<GLContainer *>(text[i])->rebuild();
 
 	QueueMan.clearQueue(kQueueNewTexture);
 	QueueMan.unlockQueue(kQueueNewTexture);
 }
 
 void GraphicsManager::beginScene() {
+	_fpsCounter->startFrame();
+
 	// Switch cursor on/off
 	if (_cursorState != kCursorStateStay)
 		handleCursorSwitch();
@@ -957,9 +1118,9 @@ bool GraphicsManager::playVideo() {
 	glLoadIdentity();
 
 	QueueMan.lockQueue(kQueueVisibleVideo);
-	const std::list<Queueable *> &videos = QueueMan.getQueue(kQueueVisibleVideo);
+	const QueueList &videos = QueueMan.getQueue(kQueueVisibleVideo);
 
-	for (std::list<Queueable *>::const_iterator v = videos.begin(); v != videos.end(); ++v) {
+	for (QueueList::const_iterator v = videos.begin(); v != videos.end(); ++v) {
 		glPushMatrix();
 		static_cast<Renderable *>(*v)->render(kRenderPassAll);
 		glPopMatrix();
@@ -976,8 +1137,7 @@ bool GraphicsManager::renderWorld() {
 	float cPos[3];
 	float cOrient[3];
 
-	memcpy(cPos   , CameraMan.getPosition   (), 3 * sizeof(float));
-	memcpy(cOrient, CameraMan.getOrientation(), 3 * sizeof(float));
+	CameraMan.getRenderState(cPos, cOrient);
 
 	glMatrixMode(GL_PROJECTION);
 	glLoadIdentity();
@@ -1002,7 +1162,9 @@ bool GraphicsManager::renderWorld() {
 	_modelview.translate(-cPos[0], -cPos[1], cPos[2]);
 
 	QueueMan.lockQueue(kQueueVisibleWorldObject);
-	const std::list<Queueable *> &objects = QueueMan.getQueue(kQueueVisibleWorldObject);
+	QueueMan.sortQueueIfNeeded(kQueueVisibleWorldObject);
+
+	const QueueList &objects = QueueMan.getQueue(kQueueVisibleWorldObject);
 
 	buildNewTextures();
 
@@ -1018,33 +1180,73 @@ bool GraphicsManager::renderWorld() {
 	// If game paused, skip the advanceTime loop below
 
 	// Advance time for animation queues
-	for (std::list<Queueable *>::const_reverse_iterator o = objects.rbegin();
+	for (QueueList::const_reverse_iterator o = objects.rbegin();
 	     o != objects.rend(); ++o) {
 		static_cast<Renderable *>(*o)->advanceTime(elapsedTime);
 	}
 
+	cullWorld();
+
+	uint32 culledObjects = 0;
+	_frameDrawCalls = 0;
+
 	// Draw opaque objects
-	for (std::list<Queueable *>::const_reverse_iterator o = objects.rbegin();
+	for (QueueList::const_reverse_iterator o = objects.rbegin();
 	     o != objects.rend(); ++o) {
 
+		Renderable &r = static_cast<Renderable &>(**o);
+		if (isCulled(r)) {
+			culledObjects++;
+			continue;
+		}
+
 		glPushMatrix();
-		static_cast<Renderable *>(*o)->render(kRenderPassOpaque);
+		r.render(kRenderPassOpaque);
 		glPopMatrix();
 	}
 
 	// Draw transparent objects
-	for (std::list<Queueable *>::const_reverse_iterator o = objects.rbegin();
+	for (QueueList::const_reverse_iterator o = objects.rbegin();
 	     o != objects.rend(); ++o) {
 
+		Renderable &r = static_cast<Renderable &>(**o);
+		if (isCulled(r))
+			continue;
+
 		glPushMatrix();
-		static_cast<Renderable *>(*o)->render(kRenderPassTransparent);
+		r.render(kRenderPassTransparent);
 		glPopMatrix();
 	}
 
+	_culledObjects.store(culledObjects);
+	_drawnObjects.store(objects.size() - culledObjects);
+	_worldDrawCalls.store(_frameDrawCalls);
+
 	QueueMan.unlockQueue(kQueueVisibleWorldObject);
 	return true;
 }
 
+void GraphicsManager::renderGUI(const std::vector<Queueable *> &gui) {
+	GUIBatchMan.begin();
+
+	for (QueueList::const_reverse_iterator g = gui.rbegin();
+	     g != gui.rend(); ++g) {
+
+		Renderable &renderable = *static_cast<Renderable *>(*g);
+		if (renderable.renderBatched())
+			continue;
+
+		// Keep the order intact: draw what we batched so far first
+		GUIBatchMan.flush();
+
+		glPushMatrix();
+		renderable.render(kRenderPassAll);
+		glPopMatrix();
+	}
+
+	GUIBatchMan.end();
+}
+
 bool GraphicsManager::renderGUIFront() {
 	if (QueueMan.isQueueEmpty(kQueueVisibleGUIFrontObject))
 		return false;
@@ -1059,17 +1261,13 @@ bool GraphicsManager::renderGUIFront() {
 	glLoadIdentity();
 
 	QueueMan.lockQueue(kQueueVisibleGUIFrontObject);
-	const std::list<Queueable *> &gui = QueueMan.getQueue(kQueueVisibleGUIFrontObject);
+	QueueMan.sortQueueIfNeeded(kQueueVisibleGUIFrontObject);
 
-	buildNewTextures();
+	const QueueList &gui = QueueMan.getQueue(kQueueVisibleGUIFrontObject);
 
-	for (std::list<Queueable *>::const_reverse_iterator g = gui.rbegin();
-	     g != gui.rend(); ++g) {
+	buildNewTextures();
 
-		glPushMatrix();
-		static_cast<Renderable *>(*g)->render(kRenderPassAll);
-		glPopMatrix();
-	}
+	renderGUI(gui);
 
 	QueueMan.unlockQueue(kQueueVisibleGUIFrontObject);
 
@@ -1092,17 +1290,13 @@ bool GraphicsManager::renderGUIBack() {
 	glLoadIdentity();
 
 	QueueMan.lockQueue(kQueueVisibleGUIBackObject);
-	const std::list<Queueable *> &gui = QueueMan.getQueue(kQueueVisibleGUIBackObject);
+	QueueMan.sortQueueIfNeeded(kQueueVisibleGUIBackObject);
+
+	const QueueList &gui = QueueMan.getQueue(kQueueVisibleGUIBackObject);
 
 	buildNewTextures();
 
-	for (std::list<Queueable *>::const_reverse_iterator g = gui.rbegin();
-	     g != gui.rend(); ++g) {
-
-		glPushMatrix();
-		static_cast<Renderable *>(*g)->render(kRenderPassAll);
-		glPopMatrix();
-	}
+	renderGUI(gui);
 
 	QueueMan.unlockQueue(kQueueVisibleGUIBackObject);
 
@@ -1132,6 +1326,8 @@ bool GraphicsManager::renderCursor() {
 }
 
 void GraphicsManager::endScene() {
+	_fpsCounter->finishedRendering();
+
 	SDL_GL_SwapWindow(_screen);
 
 	if (_takeScreenshot) {
@@ -1156,6 +1352,9 @@ void GraphicsManager::renderScene() {
 		return;
 	}
 
+	// Everything the game thread published so far is used for this whole frame
+	updateRenderStates();
+
 	beginScene();
 
 	if (playVideo()) {
@@ -1163,13 +1362,25 @@ void GraphicsManager::renderScene() {
 		return;
 	}
 
+	uint64 guiTicks = SDL_GetPerformanceCounter();
 	renderGUIBack();
+	guiTicks = SDL_GetPerformanceCounter() - guiTicks;
+
 	renderWorld();
+
+	const uint64 guiFrontStart = SDL_GetPerformanceCounter();
 	renderGUIFront();
+	guiTicks += SDL_GetPerformanceCounter() - guiFrontStart;
+
 	renderCursor();
 
 	endScene();
 
+	_guiFrameTime.store((uint32) ((guiTicks * 1000000) / SDL_GetPerformanceFrequency()));
+
+	GUIBatchMan.finishFrame();
+	TextureMan.manageBudget();
+
 	_frameEndSignal.store(true, boost::memory_order_release);
 }
 
@@ -1240,9 +1451,9 @@ bool GraphicsManager::isGL3() const {
 void GraphicsManager::rebuildGLContainers() {
 	QueueMan.lockQueue(kQueueGLContainer);
 
-	const std::list<Queueable *> &cont = QueueMan.getQueue(kQueueGLContainer);
-	for (std::list<Queueable *>::const_iterator c = cont.begin(); c != cont.end(); ++c)
-		static_cast<GLContainer *>(*c)->rebuild();
+	const QueueList &cont = QueueMan.getQueue(kQueueGLContainer);
+	for (size_t i = 0; i < cont.size(); i++)
+		static_cast<GLContainer *>(cont[i])->rebuild();
 
 	QueueMan.unlockQueue(kQueueGLContainer);
 }
@@ -1250,9 +1461,9 @@ void GraphicsManager::rebuildGLContainers() {
 void GraphicsManager::destroyGLContainers() {
 	QueueMan.lockQueue(kQueueGLContainer);
 
-	const std::list<Queueable *> &cont = QueueMan.getQueue(kQueueGLContainer);
-	for (std::list<Queueable *>::const_iterator c = cont.begin(); c != cont.end(); ++c)
-		static_cast<GLContainer *>(*c)->destroy();
+	const QueueList &cont = QueueMan.getQueue(kQueueGLContainer);
+	for (size_t i = 0; i < cont.size(); i++)
+		static_cast<GLContainer *>(cont[i])->destroy();
 
 	QueueMan.unlockQueue(kQueueGLContainer);
 }
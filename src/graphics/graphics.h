@@ -38,12 +38,14 @@
 #include "src/common/transmatrix.h"
 #include "src/common/vector3.h"
 #include "src/common/ustring.h"
+#include "src/common/aabbtree.h"
 
 namespace Graphics {
 
 class FPSCounter;
 class Cursor;
 class Renderable;
+class Queueable;
 
 /** The graphics manager. */
 class GraphicsManager : public Common::Singleton<GraphicsManager> {
@@ -63,6 +65,10 @@ public:
 	bool needManualDeS3TC() const;
 	/** Do we have support for multiple textures? */
 	bool supportMultipleTextures() const;
+	/** Can vertex positions and texture coordinates be stored as half floats? */
+	bool supportHalfFloatVertices() const;
+	/** Can vertex normals be stored as 10:10:10:2 integers? */
+	bool supportPackedNormals() const;
 
 	/** Set the screen size. */
 	void setScreenSize(int width, int height);
@@ -101,6 +107,23 @@ public:
 
 	/** How many frames per second to we render at the moments? */
 	uint32 getFPS() const;
+	/** How long does building a frame take on average, in microseconds? */
+	uint32 getFrameTime() const;
+	/** How long did building the slowest recent frame take, in microseconds? */
+	uint32 getMaxFrameTime() const;
+
+	/** How long did rendering the GUI take in the last frame, in microseconds? */
+	uint32 getGUIFrameTime() const;
+
+	/** How many visible world objects were culled from the last frame? */
+	uint32 getCulledObjectCount() const;
+	/** How many visible world objects were drawn in the last frame? */
+	uint32 getDrawnObjectCount() const;
+	/** How many draw calls did the world objects issue in the last frame? */
+	uint32 getWorldDrawCallCount() const;
+
+	/** Count draw calls issued by a renderable. Only call this in the render thread. */
+	void countDrawCalls(uint32 count = 1);
 
 	/** Set the window's title. */
 	void setWindowTitle(const Common::UString &title = "");
@@ -139,8 +162,16 @@ public:
 	/** Get the object at this screen position. */
 	Renderable *getObjectAt(float x, float y);
 
-	/** Recalculate all object distances to the camera and resort the objebts. */
-	void recalculateObjectDistances();
+	/** Add a visible world object to the spatial index used for culling and picking. */
+	void addToWorldIndex(Renderable &renderable);
+	/** Remove a world object from the spatial index. */
+	void removeFromWorldIndex(Renderable &renderable);
+
+	/** Is this world space box at least partially within the current frame's view frustum?
+	 *
+	 *  Only valid in the render thread, while rendering the world.
+	 */
+	bool isBoxInFrustum(const float min[3], const float max[3]) const;
 
 	/** Lock the frame mutex. */
 	void lockFrame();
@@ -187,8 +218,10 @@ private:
 	bool _ready; ///< Was the graphics subsystem successfully initialized?
 
 	// Extensions
-	bool _needManualDeS3TC;        ///< Do we need to do manual S3TC DXTn decompression?
-	bool _supportMultipleTextures; ///< Do we have support for multiple textures?
+	bool _needManualDeS3TC;         ///< Do we need to do manual S3TC DXTn decompression?
+	bool _supportMultipleTextures;  ///< Do we have support for multiple textures?
+	bool _supportHalfFloatVertices; ///< Do we have support for half float vertex attributes?
+	bool _supportPackedNormals;     ///< Do we have support for 10:10:10:2 vertex normals?
 
 	bool _fullScreen; ///< Are we currently in fullscreen mode?
 
@@ -243,6 +276,23 @@ private:
 
 	Common::Mutex _abandonMutex; ///< A mutex protecting abandoned structures.
 
+	/** Spatial index over the bounding boxes of all visible world objects. */
+	Common::AABBTree _worldIndex;
+	/** A mutex protecting the spatial index. */
+	mutable Common::Mutex _worldIndexMutex;
+
+	uint32 _cullFrame;                ///< The current frame number, for marking unculled objects.
+	float _frustum[6][4];             ///< The current frame's view frustum planes.
+	std::vector<void *> _cullResults; ///< The objects within the view frustum.
+
+	boost::atomic<uint32> _culledObjects; ///< Number of world objects culled from the last frame.
+	boost::atomic<uint32> _drawnObjects;  ///< Number of world objects drawn in the last frame.
+
+	uint32 _frameDrawCalls;                ///< Number of draw calls counted so far in this frame.
+	boost::atomic<uint32> _worldDrawCalls; ///< Number of draw calls by world objects in the last frame.
+
+	boost::atomic<uint32> _guiFrameTime; ///< Time spent rendering the GUI in the last frame, in microseconds.
+
 	void initSize(int width, int height, bool fullscreen);
 	void setupScene();
 
@@ -269,6 +319,23 @@ private:
 	Renderable *getGUIObjectAt(float x, float y) const;
 	Renderable *getWorldObjectAt(float x, float y) const;
 
+	/** Pick up the camera and object states the game thread published since the last frame.
+	 *
+	 *  Recalculates the distances of objects that moved, or of all objects if
+	 *  the camera moved, and resorts the visible queues. Called once per frame.
+	 */
+	void updateRenderStates();
+	/** Pick up the published states of all objects in one visible queue. */
+	void updateRenderStates(QueueType queue, bool cameraMoved);
+
+	/** Update a world object's bounding box within the spatial index, from its render bound. */
+	void updateInWorldIndex(Renderable &renderable);
+
+	/** Mark all visible world objects within the view frustum. */
+	void cullWorld();
+	/** Was this object outside the view frustum in the current frame? */
+	bool isCulled(const Renderable &renderable) const;
+
 	void buildNewTextures();
 
 	void beginScene();
@@ -276,6 +343,7 @@ private:
 	bool renderWorld();
 	bool renderGUIFront();
 	bool renderGUIBack();
+	void renderGUI(const std::vector<Queueable *> &gui);
 	bool renderCursor();
 	void endScene();
 };
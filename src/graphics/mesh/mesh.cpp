@@ -82,10 +82,13 @@ void Mesh::initGL() {
 			// Using intptr_t to ensure correct bit length for the architecture.
 			intptr_t offset = (intptr_t) (decl[i].pointer);
 			offset -= (intptr_t) (_vertexBuffer.getData());
+			// Packed formats always hold 4 components
+			const GLint size = (decl[i].type == GL_INT_2_10_10_10_REV) ? 4 : decl[i].size;
+
 			glVertexAttribPointer(decl[i].index,
-			                      decl[i].size,
+			                      size,
 			                      decl[i].type,
-			                      GL_FALSE,
+			                      decl[i].normalized,
 			                      decl[i].stride,
 			                      (void *)(offset) );
 			glEnableVertexAttribArray(decl[i].index);
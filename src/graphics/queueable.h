@@ -25,7 +25,7 @@
 #ifndef GRAPHICS_QUEUEABLE_H
 #define GRAPHICS_QUEUEABLE_H
 
-#include <list>
+#include "src/common/types.h"
 
 #include "src/graphics/types.h"
 
@@ -52,7 +52,7 @@ protected:
 
 private:
 	bool _isInQueue[kQueueMAX];
-	std::list<Queueable *>::iterator _queueRef[kQueueMAX];
+	size_t _queueIndex[kQueueMAX]; ///< Our index within each queue we are in.
 
 	void removeFromAll();
 	void kickedOut(QueueType queue);
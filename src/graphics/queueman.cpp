@@ -22,6 +22,9 @@
  *  The graphics queue manager.
  */
 
+#include <cassert>
+#include <algorithm>
+
 #include "src/graphics/queueman.h"
 #include "src/graphics/queueable.h"
 
@@ -29,12 +32,16 @@ DECLARE_SINGLETON(Graphics::QueueManager)
 
 namespace Graphics {
 
-static bool queueComp(Queueable *a, Queueable *b) {
-	return *a < *b;
-}
-
+/** Compare two queueables through their pointers, for std::stable_sort(). */
+struct QueueableLess {
+	bool operator()(const Queueable *a, const Queueable *b) const {
+		return *a < *b;
+	}
+};
 
 QueueManager::QueueManager() {
+	for (int i = 0; i < kQueueMAX; i++)
+		_queueSorted[i] = true;
 }
 
 QueueManager::~QueueManager() {
@@ -55,35 +62,89 @@ bool QueueManager::isQueueEmpty(QueueType queue) {
 	return _queue[queue].empty();
 }
 
-const std::list<Queueable *> &QueueManager::getQueue(QueueType queue) {
+const QueueList &QueueManager::getQueue(QueueType queue) {
 	return _queue[queue];
 }
 
 void QueueManager::sortQueue(QueueType queue) {
 	lockQueue(queue);
 
-	_queue[queue].sort(queueComp);
+	QueueList &list = _queue[queue];
+
+	/* Stable insertion sort, linear on an already sorted queue. If too many
+	 * elements are out of place, like when the camera turned around, give up
+	 * and let a merge sort finish the job instead. The insertion sort kept
+	 * equal elements in order, so the result is the same either way. */
+
+	const size_t maxMoves = 8 * list.size();
+
+	size_t moves = 0;
+	for (size_t i = 1; (i < list.size()) && (moves <= maxMoves); i++) {
+		Queueable *q = list[i];
+
+		size_t j = i;
+		for (; (j > 0) && (*q < *list[j - 1]); j--) {
+			list[j] = list[j - 1];
+			list[j]->_queueIndex[queue] = j;
+		}
+
+		if (j != i) {
+			list[j] = q;
+			q->_queueIndex[queue] = j;
+
+			moves += i - j;
+		}
+	}
+
+	if (moves > maxMoves) {
+		std::stable_sort(list.begin(), list.end(), QueueableLess());
+
+		for (size_t i = 0; i < list.size(); i++)
+			list[i]->_queueIndex[queue] = i;
+	}
+
+	_queueSorted[queue] = true;
+
+	unlockQueue(queue);
+}
+
+void QueueManager::sortQueueIfNeeded(QueueType queue) {
+	lockQueue(queue);
+
+	if (!_queueSorted[queue])
+		sortQueue(queue);
 
 	unlockQueue(queue);
 }
 
-std::list<Queueable *>::iterator QueueManager::addToQueue(QueueType queue, Queueable &q) {
+size_t QueueManager::addToQueue(QueueType queue, Queueable &q) {
 	lockQueue(queue);
 
 	_queue[queue].push_back(&q);
-	std::list<Queueable *>::iterator ref = --_queue[queue].end();
+	size_t index = _queue[queue].size() - 1;
+
+	_queueSorted[queue] = false;
 
 	unlockQueue(queue);
 
-	return ref;
+	return index;
 }
 
-void QueueManager::removeFromQueue(QueueType queue,
-		const std::list<Queueable *>::iterator &ref) {
-
+void QueueManager::removeFromQueue(QueueType queue, size_t index) {
 	lockQueue(queue);
 
-	_queue[queue].erase(ref);
+	QueueList &list = _queue[queue];
+	assert(index < list.size());
+
+	// Move the last element into the freed slot. This breaks the order
+	if (index != (list.size() - 1)) {
+		list[index] = list.back();
+		list[index]->_queueIndex[queue] = index;
+
+		_queueSorted[queue] = false;
+	}
+
+	list.pop_back();
 
 	unlockQueue(queue);
 }
@@ -91,11 +152,11 @@ void QueueManager::removeFromQueue(QueueType queue,
 void QueueManager::clearQueue(QueueType queue) {
 	lockQueue(queue);
 
-	for (std::list<Queueable *>::iterator q = _queue[queue].begin();
-	     q != _queue[queue].end(); ++q)
+	for (QueueList::iterator q = _queue[queue].begin(); q != _queue[queue].end(); ++q)
 		(*q)->kickedOut(queue);
 
 	_queue[queue].clear();
+	_queueSorted[queue] = true;
 
 	unlockQueue(queue);
 }
@@ -25,7 +25,7 @@
 #ifndef GRAPHICS_QUEUEMAN_H
 #define GRAPHICS_QUEUEMAN_H
 
-#include <list>
+#include <vector>
 
 #include "src/common/types.h"
 #include "src/common/singleton.h"
@@ -37,7 +37,21 @@ namespace Graphics {
 
 class Queueable;
 
-/** The graphics queue manager. */
+/** A queue of graphics objects. */
+typedef std::vector<Queueable *> QueueList;
+
+/** The graphics queue manager.
+ *
+ *  Every queue is a contiguous array of object pointers. Every object
+ *  remembers its own index in each queue it's in, so that it can be
+ *  removed in constant time by moving the last element into its place.
+ *
+ *  Since removal doesn't keep the order of the queue intact, the queue
+ *  is then marked as unsorted. The render paths, which rely on the order,
+ *  call sortQueueIfNeeded() to bring it back in order. Sorting is done
+ *  with an insertion sort, since the queues are nearly sorted already in
+ *  nearly all cases: only a few objects move between two sorts.
+ */
 class QueueManager : public Common::Singleton<QueueManager> {
 public:
 	QueueManager();
@@ -48,19 +62,25 @@ public:
 	void lockQueue(QueueType queue);
 	void unlockQueue(QueueType queue);
 
-	const std::list<Queueable *> &getQueue(QueueType queue);
+	const QueueList &getQueue(QueueType queue);
 
+	/** Sort the queue. */
 	void sortQueue(QueueType queue);
+	/** Sort the queue, if elements were added or removed since the last sort. */
+	void sortQueueIfNeeded(QueueType queue);
+
 	void clearQueue(QueueType queue);
 
 	void clearAllQueues();
 
 private:
 	Common::Mutex _queueMutex[kQueueMAX];
-	std::list<Queueable *> _queue[kQueueMAX];
+	QueueList _queue[kQueueMAX];
+
+	bool _queueSorted[kQueueMAX];
 
-	std::list<Queueable *>::iterator addToQueue(QueueType queue, Queueable &q);
-	void removeFromQueue(QueueType queue, const std::list<Queueable *>::iterator &ref);
+	size_t addToQueue(QueueType queue, Queueable &q);
+	void removeFromQueue(QueueType queue, size_t index);
 
 	friend class Queueable;
 };
@@ -31,7 +31,9 @@
 
 namespace Graphics {
 
-Renderable::Renderable(RenderableType type) : _clickable(false), _distance(0.0f) {
+Renderable::Renderable(RenderableType type) : _clickable(false), _distance(0.0f),
+	_worldProxy(-1), _cullFrame(0) {
+
 	switch (type) {
 		case kRenderableTypeVideo:
 			_queueExists  = kQueueVideo;
@@ -114,9 +116,16 @@ void Renderable::show() {
 	sortQueue(_queueVisible);
 
 	unlockQueue(_queueVisible);
+
+	if (_queueVisible == kQueueVisibleWorldObject)
+		GfxMan.addToWorldIndex(*this);
 }
 
 void Renderable::hide() {
+	// Leave the spatial index first, so that everything found there is still alive
+	if (_queueVisible == kQueueVisibleWorldObject)
+		GfxMan.removeFromWorldIndex(*this);
+
 	removeFromQueue(_queueVisible);
 }
 
@@ -134,6 +143,22 @@ bool Renderable::isIn(float UNUSED(x1), float UNUSED(y1), float UNUSED(z1),
 	return false;
 }
 
+bool Renderable::renderBatched() {
+	return false;
+}
+
+bool Renderable::getWorldBound(float UNUSED(min)[3], float UNUSED(max)[3]) const {
+	return false;
+}
+
+bool Renderable::getRenderBound(float min[3], float max[3]) const {
+	return getWorldBound(min, max);
+}
+
+bool Renderable::updateRenderState() {
+	return false;
+}
+
 void Renderable::lockFrame() {
 	GfxMan.lockFrame();
 }
@@ -40,6 +40,15 @@ public:
 
 	bool operator<(const Queueable &q) const;
 
+	/** Pick up the state the game thread published since the last frame.
+	 *
+	 *  Called by the graphics manager for every visible object, once at the
+	 *  start of each frame, before anything is culled, sorted or drawn.
+	 *
+	 *  @return true if the object's placement changed.
+	 */
+	virtual bool updateRenderState();
+
 	/** Calculate the object's distance. */
 	virtual void calculateDistance() = 0;
 
@@ -49,6 +58,15 @@ public:
 	/** Render the object. */
 	virtual void render(RenderPass pass) = 0;
 
+	/** Add the object to the current GUI quad batch, instead of rendering it directly.
+	 *
+	 *  Only called for GUI elements. Everything batched before is flushed
+	 *  before an object that can't be batched is rendered.
+	 *
+	 *  @return false if the object can't be batched.
+	 */
+	virtual bool renderBatched();
+
 	/** Get the distance of the object from the viewer. */
 	double getDistance() const;
 
@@ -77,6 +95,20 @@ public:
 	/** Does the line from x1.y1.z1 to x2.y2.z2 intersect with the object? */
 	virtual bool isIn(float x1, float y1, float z1, float x2, float y2, float z2) const;
 
+	/** Get the object's bounding box in world space.
+	 *
+	 *  Visible world objects with a bounding box are culled against the view
+	 *  frustum and found by picking through the graphics manager's spatial index.
+	 *
+	 *  @return false if the object has no bounding box.
+	 */
+	virtual bool getWorldBound(float min[3], float max[3]) const;
+	/** Get the object's bounding box in world space, as last picked up by the renderer.
+	 *
+	 *  By default, this is the same as getWorldBound().
+	 */
+	virtual bool getRenderBound(float min[3], float max[3]) const;
+
 protected:
 	QueueType _queueExists;
 	QueueType _queueVisible;
@@ -95,6 +127,12 @@ protected:
 
 	void lockFrameIfVisible();
 	void unlockFrameIfVisible();
+
+private:
+	int32  _worldProxy; ///< Our proxy within the graphics manager's spatial index, or -1.
+	uint32 _cullFrame;  ///< The last frame in which we were within the view frustum.
+
+	friend class GraphicsManager;
 };
 
 } // End of namespace Graphics
@@ -25,12 +25,44 @@
 #include <cstdlib>
 #include <cstring>
 #include <cassert>
+#include <cmath>
+
+#include "src/common/atomic.h"
+#include "src/common/util.h"
 
 #include "src/graphics/vertexbuffer.h"
 #include "src/graphics/indexbuffer.h"
 
 namespace Graphics {
 
+/** The memory used by all vertex buffers. */
+static boost::atomic<uint64> vertexMemory(0);
+/** The memory saved by packing vertex buffers. */
+static boost::atomic<uint64> packedSavings(0);
+
+/** Read integer components, optionally mapping them onto [-1.0, 1.0] / [0.0, 1.0]. */
+template<typename T>
+static void readComponents(const byte *data, GLint size, bool normalized, float scale, float *values) {
+	const T *components = reinterpret_cast<const T *>(data);
+
+	for (GLint i = 0; i < size; i++)
+		values[i] = normalized ? MAX(components[i] * scale, -1.0f) : components[i];
+}
+
+/** Sign-extend a component of a 10:10:10:2 integer. */
+static int32 extendPacked(uint32 value, uint32 bits) {
+	const uint32 sign = 1 << (bits - 1);
+
+	value &= (sign << 1) - 1;
+
+	return (int32) (value ^ sign) - (int32) sign;
+}
+
+/** Convert a float in [-1.0, 1.0] into a signed normalized integer with this maximum. */
+static int32 packNormalized(float value, int32 max) {
+	return (int32) floorf(CLIP(value, -1.0f, 1.0f) * max + 0.5f);
+}
+
 void VertexAttrib::enable() const {
 	switch (index) {
 		case VPOSITION:
@@ -90,6 +122,10 @@ VertexBuffer::VertexBuffer(const VertexBuffer &other) : _data(0), _vbo(0), _hint
 
 VertexBuffer::~VertexBuffer() {
 	destroyGL(); // Dangerous if GL components not already freed and we're not in the GL context thread.
+
+	if (_data)
+		vertexMemory -= _count * _size;
+
 	delete[] _data;
 }
 
@@ -116,6 +152,9 @@ VertexBuffer &VertexBuffer::operator=(const VertexBuffer &other) {
 }
 
 void VertexBuffer::setSize(uint32 vertCount, uint32 vertSize) {
+	if (_data)
+		vertexMemory -= _count * _size;
+
 	_count = vertCount;
 	_size  = vertSize;
 
@@ -124,6 +163,8 @@ void VertexBuffer::setSize(uint32 vertCount, uint32 vertSize) {
 
 	if (_count && _size) {
 		_data = new byte[_count * _size];
+
+		vertexMemory += _count * _size;
 	}
 }
 
@@ -133,10 +174,12 @@ void VertexBuffer::setVertexDecl(const VertexDecl &decl) {
 
 uint32 VertexBuffer::getTypeSize(GLenum type) {
 	switch (type) {
+		case GL_BYTE:
 		case GL_UNSIGNED_BYTE:
 			return 1;
 		case GL_SHORT:
 		case GL_UNSIGNED_SHORT:
+		case GL_HALF_FLOAT:
 		case GL_2_BYTES:
 			return 2;
 		case GL_3_BYTES:
@@ -157,10 +200,18 @@ uint32 VertexBuffer::getTypeSize(GLenum type) {
 	return 0;
 }
 
+uint32 VertexBuffer::getAttribSize(const VertexAttrib &attrib) {
+	// All components packed into one 32-bit integer
+	if ((attrib.type == GL_INT_2_10_10_10_REV) || (attrib.type == GL_UNSIGNED_INT_2_10_10_10_REV))
+		return 4;
+
+	return attrib.size * getTypeSize(attrib.type);
+}
+
 void VertexBuffer::setVertexDeclLinear(uint32 vertCount, VertexDecl &decl) {
 	uint32 vertSize = 0;
 	for (VertexDecl::iterator a = decl.begin(); a != decl.end(); ++a)
-		vertSize += a->size * getTypeSize(a->type);
+		vertSize += getAttribSize(*a);
 
 	setSize(vertCount, vertSize);
 
@@ -169,16 +220,17 @@ void VertexBuffer::setVertexDeclLinear(uint32 vertCount, VertexDecl &decl) {
 		a->stride  = 0;
 		a->pointer = data;
 
-		data += vertCount * a->size * getTypeSize(a->type);
+		data += vertCount * getAttribSize(*a);
 	}
 
 	_decl = decl;
 }
 
 void VertexBuffer::setVertexDeclInterleave(uint32 vertCount, VertexDecl &decl) {
+	// Keep every attribute aligned to 4 bytes
 	uint32 vertSize = 0;
 	for (VertexDecl::iterator a = decl.begin(); a != decl.end(); ++a)
-		vertSize += a->size * getTypeSize(a->type);
+		vertSize += (getAttribSize(*a) + 3) & ~3;
 
 	setSize(vertCount, vertSize);
 
@@ -187,7 +239,7 @@ void VertexBuffer::setVertexDeclInterleave(uint32 vertCount, VertexDecl &decl) {
 		a->stride  = vertSize;
 		a->pointer = _data + offset;
 
-		offset += a->size * getTypeSize(a->type);
+		offset += (getAttribSize(*a) + 3) & ~3;
 	}
 
 	_decl = decl;
@@ -213,6 +265,192 @@ uint32 VertexBuffer::getSize() const {
 	return _size;
 }
 
+void VertexBuffer::getAttrib(size_t attrib, uint32 vertex, float *values) const {
+	assert((attrib < _decl.size()) && (vertex < _count));
+
+	const VertexAttrib &a = _decl[attrib];
+
+	const uint32 stride = (a.stride != 0) ? a.stride : getAttribSize(a);
+	const byte  *data   = reinterpret_cast<const byte *>(a.pointer) + vertex * stride;
+
+	const bool normalized = a.normalized == GL_TRUE;
+
+	switch (a.type) {
+		case GL_FLOAT:
+			memcpy(values, data, a.size * sizeof(float));
+			break;
+
+		case GL_DOUBLE:
+			for (GLint i = 0; i < a.size; i++)
+				values[i] = reinterpret_cast<const double *>(data)[i];
+			break;
+
+		case GL_HALF_FLOAT:
+			for (GLint i = 0; i < a.size; i++)
+				values[i] = readIEEEFloat16(reinterpret_cast<const uint16 *>(data)[i]);
+			break;
+
+		case GL_BYTE:
+			readComponents<int8>  (data, a.size, normalized, 1.0f / 127.0f       , values);
+			break;
+		case GL_UNSIGNED_BYTE:
+			readComponents<uint8> (data, a.size, normalized, 1.0f / 255.0f       , values);
+			break;
+		case GL_SHORT:
+			readComponents<int16> (data, a.size, normalized, 1.0f / 32767.0f     , values);
+			break;
+		case GL_UNSIGNED_SHORT:
+			readComponents<uint16>(data, a.size, normalized, 1.0f / 65535.0f     , values);
+			break;
+		case GL_INT:
+			readComponents<int32> (data, a.size, normalized, 1.0f / 2147483647.0f, values);
+			break;
+		case GL_UNSIGNED_INT:
+			readComponents<uint32>(data, a.size, normalized, 1.0f / 4294967295.0f, values);
+			break;
+
+		case GL_INT_2_10_10_10_REV: {
+				const uint32 packed = *reinterpret_cast<const uint32 *>(data);
+
+				for (GLint i = 0; i < MIN<GLint>(a.size, 3); i++) {
+					const int32 value = extendPacked(packed >> (i * 10), 10);
+
+					values[i] = normalized ? MAX(value / 511.0f, -1.0f) : value;
+				}
+
+				if (a.size > 3) {
+					const int32 value = extendPacked(packed >> 30, 2);
+
+					values[3] = normalized ? MAX((float) value, -1.0f) : value;
+				}
+			}
+			break;
+
+		default:
+			assert(false);
+			break;
+	}
+}
+
+bool VertexBuffer::fitsHalfFloat(size_t attrib, float tolerance) const {
+	float values[4];
+
+	for (uint32 v = 0; v < _count; v++) {
+		getAttrib(attrib, v, values);
+
+		for (GLint i = 0; i < _decl[attrib].size; i++) {
+			const float packed = readIEEEFloat16(writeIEEEFloat16(values[i]));
+
+			// Also catches values that overflowed into Inf
+			if (!(ABS(packed - values[i]) <= tolerance))
+				return false;
+		}
+	}
+
+	return true;
+}
+
+uint32 VertexBuffer::pack(const VertexPacking &packing) {
+	if (!_data)
+		return 0;
+
+	// Find the formats to convert the attributes into
+
+	VertexDecl decl = _decl;
+
+	bool changed = false;
+	for (size_t a = 0; a < decl.size(); a++) {
+		VertexAttrib &attrib = decl[a];
+		if ((attrib.type != GL_FLOAT) || (attrib.size > 4))
+			continue;
+
+		if ((attrib.index == VNORMAL) && (attrib.size == 3)) {
+			attrib.type       = packing.packedNormals ? GL_INT_2_10_10_10_REV : GL_SHORT;
+			attrib.normalized = GL_TRUE;
+
+			changed = true;
+
+		} else if (packing.halfFloat && ((attrib.index == VPOSITION) || (attrib.index >= VTCOORD))) {
+			const float tolerance = (attrib.index == VPOSITION) ?
+				packing.positionTolerance : packing.texCoordTolerance;
+
+			if (fitsHalfFloat(a, tolerance)) {
+				attrib.type = GL_HALF_FLOAT;
+
+				changed = true;
+			}
+		}
+	}
+
+	if (!changed)
+		return 0;
+
+	// Convert the vertices
+
+	VertexBuffer packed;
+	packed.setVertexDeclInterleave(_count, decl);
+
+	for (uint32 v = 0; v < _count; v++) {
+		for (size_t a = 0; a < decl.size(); a++) {
+			byte *data = const_cast<byte *>(reinterpret_cast<const byte *>(decl[a].pointer)) + v * decl[a].stride;
+
+			// Attributes we don't convert are copied verbatim
+			if (decl[a].type == _decl[a].type) {
+				const uint32 size   = getAttribSize(_decl[a]);
+				const uint32 stride = (_decl[a].stride != 0) ? _decl[a].stride : size;
+
+				memcpy(data, reinterpret_cast<const byte *>(_decl[a].pointer) + v * stride, size);
+				continue;
+			}
+
+			float values[4];
+			getAttrib(a, v, values);
+
+			switch (decl[a].type) {
+				case GL_HALF_FLOAT:
+					for (GLint i = 0; i < decl[a].size; i++)
+						reinterpret_cast<uint16 *>(data)[i] = writeIEEEFloat16(values[i]);
+					break;
+
+				case GL_SHORT:
+					for (GLint i = 0; i < decl[a].size; i++)
+						reinterpret_cast<int16 *>(data)[i] = packNormalized(values[i], 32767);
+					break;
+
+				case GL_INT_2_10_10_10_REV:
+					*reinterpret_cast<uint32 *>(data) =
+						(((uint32) packNormalized(values[0], 511) & 0x3FF) <<  0) |
+						(((uint32) packNormalized(values[1], 511) & 0x3FF) << 10) |
+						(((uint32) packNormalized(values[2], 511) & 0x3FF) << 20);
+					break;
+
+				default:
+					assert(false);
+					break;
+			}
+		}
+	}
+
+	// Padding the other attributes might have eaten up what we saved
+	if ((packed._count * packed._size) >= (_count * _size))
+		return 0;
+
+	const uint32 saved = (_count * _size) - (packed._count * packed._size);
+
+	*this = packed;
+
+	packedSavings += saved;
+	return saved;
+}
+
+uint64 VertexBuffer::getTotalMemory() {
+	return vertexMemory.load();
+}
+
+uint64 VertexBuffer::getPackedSavings() {
+	return packedSavings.load();
+}
+
 void VertexBuffer::initGL(GLuint hint) {
 	if (_vbo != 0) {
 		return; // Already initialised.
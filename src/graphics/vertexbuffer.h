@@ -46,10 +46,11 @@ struct VertexAttrib {
 	GLenum type;           ///< Data type of each attribute component in the array
 	GLsizei stride;        ///< Byte offset between consecutive vertex attributes
 	const GLvoid *pointer; ///< Offset of the first component of the first generic vertex attribute
+	GLboolean normalized;  ///< Are integer components mapped onto [-1.0, 1.0] / [0.0, 1.0]?
 
-	VertexAttrib() { }
+	VertexAttrib() : normalized(GL_FALSE) { }
 	VertexAttrib(GLuint i, GLint s, GLenum t, GLsizei st = 0, const GLvoid *p = 0) :
-		index(i), size(s), type(t), stride(st), pointer(p) { }
+		index(i), size(s), type(t), stride(st), pointer(p), normalized(GL_FALSE) { }
 
 	// Render methods
 	void enable() const;
@@ -59,6 +60,22 @@ struct VertexAttrib {
 /** Vertex data layout */
 typedef std::vector<VertexAttrib> VertexDecl;
 
+/** Which compact formats VertexBuffer::pack() may convert float attributes into. */
+struct VertexPacking {
+	/** Store positions and texture coordinates as half floats, where precision allows. */
+	bool halfFloat;
+	/** Store normals as 10:10:10:2 integers. Otherwise, they're stored as 16-bit integers. */
+	bool packedNormals;
+
+	/** The largest error a half float position may have. */
+	float positionTolerance;
+	/** The largest error a half float texture coordinate may have. */
+	float texCoordTolerance;
+
+	VertexPacking() : halfFloat(false), packedNormals(false),
+		positionTolerance(0.0f), texCoordTolerance(0.0f) { }
+};
+
 class IndexBuffer;
 
 /** Buffer containing vertex data */
@@ -104,6 +121,31 @@ public:
 	/** Get vertex element size in bytes */
 	uint32 getSize() const;
 
+	/** Read one attribute of one vertex, converted into floats.
+	 *
+	 *  @param attrib The index of the attribute within the vertex declaration.
+	 *  @param vertex The index of the vertex.
+	 *  @param values Receives as many floats as the attribute has components.
+	 */
+	void getAttrib(size_t attrib, uint32 vertex, float *values) const;
+
+	/** Convert float attributes into more compact formats.
+	 *
+	 *  Normals are always converted into signed normalized integers. Positions
+	 *  and texture coordinates are only converted into half floats if the
+	 *  packing allows it, and if none of their components would lose more
+	 *  precision than the packing's tolerance. The buffer is interleaved
+	 *  afterwards.
+	 *
+	 *  @return The number of bytes saved.
+	 */
+	uint32 pack(const VertexPacking &packing);
+
+	/** Return the memory used by all vertex buffers, in bytes. */
+	static uint64 getTotalMemory();
+	/** Return the memory saved by packing vertex buffers so far, in bytes. */
+	static uint64 getPackedSavings();
+
 	/** Initialise internal buffer object for GL handling. */
 	void initGL(GLuint hint = GL_STATIC_DRAW);
 
@@ -130,6 +172,11 @@ private:
 	GLuint _hint;     ///< GL hint for static or dynamic data.
 
 	static uint32 getTypeSize(GLenum type);
+	/** Return the number of bytes an attribute takes up per vertex, without any padding. */
+	static uint32 getAttribSize(const VertexAttrib &attrib);
+
+	/** Can all components of this float attribute be stored as half floats without losing more than the tolerance? */
+	bool fitsHalfFloat(size_t attrib, float tolerance) const;
 };
 
 } // End of namespace Graphics
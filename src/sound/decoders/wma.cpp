@@ -562,7 +562,7 @@ Common::SeekableReadStream *WMACodec::decodeSuperFrame(Common::SeekableReadStrea
 	if (_blockAlign)
 		size = _blockAlign;
 
-	Common::BitStream8MSB bits(data);
+	Common::MemoryBitStream8MSB bits(data.readStream(data.size() - data.pos()), true);
 
 	int    outputDataSize = 0;
 	int16 *outputData     = 0;
@@ -621,8 +621,7 @@ Common::SeekableReadStream *WMACodec::decodeSuperFrame(Common::SeekableReadStrea
 				_lastSuperframeLen += 1;
 			}
 
-			Common::MemoryReadStream lastSuperframe(_lastSuperframe, _lastSuperframeLen);
-			Common::BitStream8MSB lastBits(lastSuperframe);
+			Common::MemoryBitStream8MSB lastBits(_lastSuperframe, _lastSuperframeLen);
 
 			lastBits.skip(_lastBitoffset);
 
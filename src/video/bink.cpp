@@ -33,6 +33,7 @@
 #include "src/common/error.h"
 #include "src/common/maths.h"
 #include "src/common/readstream.h"
+#include "src/common/memreadstream.h"
 #include "src/common/bitstream.h"
 #include "src/common/huffman.h"
 #include "src/common/rdft.h"
@@ -211,8 +212,7 @@ void Bink::processData() {
 				audio.sampleCount = _bink->readUint32LE() / (2 * audio.channels);
 
 				audio.bits =
-					new Common::BitStream32LELSB(new Common::SeekableSubReadStream(_bink,
-					    audioPacketStart + 4, audioPacketEnd), true);
+					new Common::MemoryBitStream32LELSB(_bink->readStream(audioPacketEnd - (audioPacketStart + 4)), true);
 
 				audioPacket(audio);
 
@@ -226,12 +226,7 @@ void Bink::processData() {
 		}
 	}
 
-	size_t videoPacketStart = _bink->pos();
-	size_t videoPacketEnd   = _bink->pos() + frameSize;
-
-	frame.bits =
-		new Common::BitStream32LELSB(new Common::SeekableSubReadStream(_bink,
-		    videoPacketStart, videoPacketEnd), true);
+	frame.bits = new Common::MemoryBitStream32LELSB(_bink->readStream(frameSize), true);
 
 	videoPacket(frame);
 
@@ -30,6 +30,7 @@
 #include "src/common/util.h"
 #include "src/common/error.h"
 #include "src/common/readstream.h"
+#include "src/common/memreadstream.h"
 #include "src/common/bitstream.h"
 #include "src/common/huffman.h"
 
@@ -317,8 +318,8 @@ void XMVWMV2Codec::init() {
 void XMVWMV2Codec::decodeFrame(Graphics::Surface &surface,
                                Common::SeekableReadStream &dataStream) {
 
-	Common::BitStream32LEMSB bits(dataStream);
-	DecodeContext            ctx(bits);
+	Common::MemoryBitStream32LEMSB bits(dataStream.readStream(dataStream.size() - dataStream.pos()), true);
+	DecodeContext                  ctx(bits);
 
 	initDecodeContext(ctx);
 
@@ -729,7 +730,31 @@ void XMVWMV2Codec::decodeIBlock(DecodeContext &ctx, BlockContext &block) {
 	IDCTPut(block.curPlane, acReconCoeffs, block.planePitch);
 }
 
+#define W0 2048
+#define W1 2841 /* 2048*sqrt (2)*cos (1*pi/16) */
+#define W2 2676 /* 2048*sqrt (2)*cos (2*pi/16) */
+#define W3 2408 /* 2048*sqrt (2)*cos (3*pi/16) */
+#define W4 2048 /* 2048*sqrt (2)*cos (4*pi/16) */
+#define W5 1609 /* 2048*sqrt (2)*cos (5*pi/16) */
+#define W6 1108 /* 2048*sqrt (2)*cos (6*pi/16) */
+#define W7  565 /* 2048*sqrt (2)*cos (7*pi/16) */
+
 void XMVWMV2Codec::IDCTPut(byte *dest, int32 *block, uint32 pitch) {
+	bool dcOnly = true;
+	for (uint32 i = 1; i < (kBlockSize * kBlockSize); i++)
+		dcOnly = dcOnly && (block[i] == 0);
+
+	if (dcOnly) {
+		// Only a DC coefficient: the IDCT produces a flat block
+		const int32 dc = (((((W0 * block[0]) + (1 << 7)) >> 8) * W0) >> 3) + (1 << 13);
+		const byte value = CLIP(dc >> 14, 0, 255);
+
+		for (uint32 i = 0; i < 8; i++, dest += pitch)
+			memset(dest, value, 8);
+
+		return;
+	}
+
 	IDCT(block);
 
 	for (uint32 i = 0; i < 8; i++, dest += pitch, block += 8)
@@ -737,74 +762,82 @@ void XMVWMV2Codec::IDCTPut(byte *dest, int32 *block, uint32 pitch) {
 			dest[j] = CLIP(block[j], 0, 255);
 }
 
-void XMVWMV2Codec::IDCT(int32 *block) {
-	for (int i = 0; i < 64; i += 8)
-		IDCTRow(block + i);
-
+/** Transpose an 8x8 block. */
+static void transposeBlock(int32 *dest, const int32 *src) {
 	for (int i = 0; i < 8; i++)
-		IDCTCol(block + i);
+		for (int j = 0; j < 8; j++)
+			dest[j * 8 + i] = src[i * 8 + j];
 }
 
-#define W0 2048
-#define W1 2841 /* 2048*sqrt (2)*cos (1*pi/16) */
-#define W2 2676 /* 2048*sqrt (2)*cos (2*pi/16) */
-#define W3 2408 /* 2048*sqrt (2)*cos (3*pi/16) */
-#define W4 2048 /* 2048*sqrt (2)*cos (4*pi/16) */
-#define W5 1609 /* 2048*sqrt (2)*cos (5*pi/16) */
-#define W6 1108 /* 2048*sqrt (2)*cos (6*pi/16) */
-#define W7  565 /* 2048*sqrt (2)*cos (7*pi/16) */
+void XMVWMV2Codec::IDCT(int32 *block) {
+	/* Both passes work on all 8 rows/columns at once, with each row/column
+	 * in its own lane, so that the compiler can vectorize them. For the
+	 * row pass, the block is transposed first and transposed back after. */
+
+	int32 transposed[kBlockSize * kBlockSize];
 
-void XMVWMV2Codec::IDCTRow(int32 *b) {
-	// Step 1
-	int a1 = (W1 * b[1]) + (W7 * b[7]);
-	int a7 = (W7 * b[1]) - (W1 * b[7]);
-	int a5 = (W5 * b[5]) + (W3 * b[3]);
-	int a3 = (W3 * b[5]) - (W5 * b[3]);
-	int a2 = (W2 * b[2]) + (W6 * b[6]);
-	int a6 = (W6 * b[2]) - (W2 * b[6]);
-	int a0 = (W0 * b[0]) + (W0 * b[4]);
-	int a4 = (W0 * b[0]) - (W0 * b[4]);
-
-	// Step 2
-	int s1 = (181 * (a1 - a5 + a7 - a3) + 128) >> 8; // 1, 3, 5, 7,
-	int s2 = (181 * (a1 - a5 - a7 + a3) + 128) >> 8;
-
-	// Step 3
-	b[0] = (a0 + a2 + a1 + a5 + (1 << 7)) >> 8;
-	b[1] = (a4 + a6    + s1   + (1 << 7)) >> 8;
-	b[2] = (a4 - a6    + s2   + (1 << 7)) >> 8;
-	b[3] = (a0 - a2 + a7 + a3 + (1 << 7)) >> 8;
-	b[4] = (a0 - a2 - a7 - a3 + (1 << 7)) >> 8;
-	b[5] = (a4 - a6    - s2   + (1 << 7)) >> 8;
-	b[6] = (a4 + a6    - s1   + (1 << 7)) >> 8;
-	b[7] = (a0 + a2 - a1 - a5 + (1 << 7)) >> 8;
+	transposeBlock(transposed, block);
+	IDCTRows(transposed);
+	transposeBlock(block, transposed);
+
+	IDCTCols(block);
 }
 
-void XMVWMV2Codec::IDCTCol(int32 *b) {
-	// Step 1, with extended precision
-	int a1 = ((W1 * b[8 * 1]) + (W7 * b[8 * 7]) + 4) >> 3;
-	int a7 = ((W7 * b[8 * 1]) - (W1 * b[8 * 7]) + 4) >> 3;
-	int a5 = ((W5 * b[8 * 5]) + (W3 * b[8 * 3]) + 4) >> 3;
-	int a3 = ((W3 * b[8 * 5]) - (W5 * b[8 * 3]) + 4) >> 3;
-	int a2 = ((W2 * b[8 * 2]) + (W6 * b[8 * 6]) + 4) >> 3;
-	int a6 = ((W6 * b[8 * 2]) - (W2 * b[8 * 6]) + 4) >> 3;
-	int a0 = ((W0 * b[8 * 0]) + (W0 * b[8 * 4])    ) >> 3;
-	int a4 = ((W0 * b[8 * 0]) - (W0 * b[8 * 4])    ) >> 3;
-
-	// Step 2
-	int s1 = (181 * (a1 - a5 + a7 - a3) + 128) >> 8;
-	int s2 = (181 * (a1 - a5 - a7 + a3) + 128) >> 8;
-
-	// Step 3
-	b[8 * 0] = (a0 + a2 + a1 + a5 + (1 << 13)) >> 14;
-	b[8 * 1] = (a4 + a6    + s1   + (1 << 13)) >> 14;
-	b[8 * 2] = (a4 - a6    + s2   + (1 << 13)) >> 14;
-	b[8 * 3] = (a0 - a2 + a7 + a3 + (1 << 13)) >> 14;
-
-	b[8 * 4] = (a0 - a2 - a7 - a3 + (1 << 13)) >> 14;
-	b[8 * 5] = (a4 - a6    - s2   + (1 << 13)) >> 14;
-	b[8 * 6] = (a4 + a6    - s1   + (1 << 13)) >> 14;
-	b[8 * 7] = (a0 + a2 - a1 - a5 + (1 << 13)) >> 14;
+void XMVWMV2Codec::IDCTRows(int32 *b) {
+	for (int i = 0; i < 8; i++) {
+		// Step 1
+		const int32 a1 = (W1 * b[8 * 1 + i]) + (W7 * b[8 * 7 + i]);
+		const int32 a7 = (W7 * b[8 * 1 + i]) - (W1 * b[8 * 7 + i]);
+		const int32 a5 = (W5 * b[8 * 5 + i]) + (W3 * b[8 * 3 + i]);
+		const int32 a3 = (W3 * b[8 * 5 + i]) - (W5 * b[8 * 3 + i]);
+		const int32 a2 = (W2 * b[8 * 2 + i]) + (W6 * b[8 * 6 + i]);
+		const int32 a6 = (W6 * b[8 * 2 + i]) - (W2 * b[8 * 6 + i]);
+		const int32 a0 = (W0 * b[8 * 0 + i]) + (W0 * b[8 * 4 + i]);
+		const int32 a4 = (W0 * b[8 * 0 + i]) - (W0 * b[8 * 4 + i]);
+
+		// Step 2
+		const int32 s1 = (181 * (a1 - a5 + a7 - a3) + 128) >> 8; // 1, 3, 5, 7,
+		const int32 s2 = (181 * (a1 - a5 - a7 + a3) + 128) >> 8;
+
+		// Step 3
+		b[8 * 0 + i] = (a0 + a2 + a1 + a5 + (1 << 7)) >> 8;
+		b[8 * 1 + i] = (a4 + a6    + s1   + (1 << 7)) >> 8;
+		b[8 * 2 + i] = (a4 - a6    + s2   + (1 << 7)) >> 8;
+		b[8 * 3 + i] = (a0 - a2 + a7 + a3 + (1 << 7)) >> 8;
+		b[8 * 4 + i] = (a0 - a2 - a7 - a3 + (1 << 7)) >> 8;
+		b[8 * 5 + i] = (a4 - a6    - s2   + (1 << 7)) >> 8;
+		b[8 * 6 + i] = (a4 + a6    - s1   + (1 << 7)) >> 8;
+		b[8 * 7 + i] = (a0 + a2 - a1 - a5 + (1 << 7)) >> 8;
+	}
+}
+
+void XMVWMV2Codec::IDCTCols(int32 *b) {
+	for (int i = 0; i < 8; i++) {
+		// Step 1, with extended precision
+		const int32 a1 = ((W1 * b[8 * 1 + i]) + (W7 * b[8 * 7 + i]) + 4) >> 3;
+		const int32 a7 = ((W7 * b[8 * 1 + i]) - (W1 * b[8 * 7 + i]) + 4) >> 3;
+		const int32 a5 = ((W5 * b[8 * 5 + i]) + (W3 * b[8 * 3 + i]) + 4) >> 3;
+		const int32 a3 = ((W3 * b[8 * 5 + i]) - (W5 * b[8 * 3 + i]) + 4) >> 3;
+		const int32 a2 = ((W2 * b[8 * 2 + i]) + (W6 * b[8 * 6 + i]) + 4) >> 3;
+		const int32 a6 = ((W6 * b[8 * 2 + i]) - (W2 * b[8 * 6 + i]) + 4) >> 3;
+		const int32 a0 = ((W0 * b[8 * 0 + i]) + (W0 * b[8 * 4 + i])    ) >> 3;
+		const int32 a4 = ((W0 * b[8 * 0 + i]) - (W0 * b[8 * 4 + i])    ) >> 3;
+
+		// Step 2
+		const int32 s1 = (181 * (a1 - a5 + a7 - a3) + 128) >> 8;
+		const int32 s2 = (181 * (a1 - a5 - a7 + a3) + 128) >> 8;
+
+		// Step 3
+		b[8 * 0 + i] = (a0 + a2 + a1 + a5 + (1 << 13)) >> 14;
+		b[8 * 1 + i] = (a4 + a6    + s1   + (1 << 13)) >> 14;
+		b[8 * 2 + i] = (a4 - a6    + s2   + (1 << 13)) >> 14;
+		b[8 * 3 + i] = (a0 - a2 + a7 + a3 + (1 << 13)) >> 14;
+
+		b[8 * 4 + i] = (a0 - a2 - a7 - a3 + (1 << 13)) >> 14;
+		b[8 * 5 + i] = (a4 - a6    - s2   + (1 << 13)) >> 14;
+		b[8 * 6 + i] = (a4 + a6    - s1   + (1 << 13)) >> 14;
+		b[8 * 7 + i] = (a0 + a2 - a1 - a5 + (1 << 13)) >> 14;
+	}
 }
 
 uint8 XMVWMV2Codec::getTrit(Common::BitStream &bits) {
@@ -233,8 +233,8 @@ private:
 
 	void IDCTPut(byte *dest, int32 *block, uint32 pitch);
 	void IDCT(int32 *block);
-	void IDCTRow(int32 *b);
-	void IDCTCol(int32 *b);
+	void IDCTRows(int32 *b);
+	void IDCTCols(int32 *b);
 };
 
 } // End of namespace Video
@@ -35,6 +35,7 @@
 #include "src/common/threads.h"
 #include "src/common/debugman.h"
 #include "src/common/configman.h"
+#include "src/common/workerpool.h"
 #include "src/common/xml.h"
 
 #include "src/aurora/resman.h"
@@ -58,6 +59,7 @@
 #include "src/graphics/aurora/textureman.h"
 #include "src/graphics/aurora/cursorman.h"
 #include "src/graphics/aurora/fontman.h"
+#include "src/graphics/aurora/guibatchman.h"
 
 void initConfig();
 
@@ -67,6 +69,8 @@ void deinit();
 void initDebug();
 void listDebug();
 
+int makePrefetchManifests();
+
 static bool configFileIsBroken = false;
 
 int main(int argc, char **argv) {
@@ -77,6 +81,10 @@ int main(int argc, char **argv) {
 	if (!parseCommandline(argc, argv, target, code))
 		return code;
 
+	// Only turn a resource trace into prefetch manifests
+	if (ConfigMan.hasKey("makemanifests"))
+		return makePrefetchManifests();
+
 	// Check the requested target
 	if (target.empty() || !ConfigMan.hasGame(target)) {
 		Common::UString path = ConfigMan.getString("path");
@@ -149,6 +157,12 @@ int main(int argc, char **argv) {
 		// Initialize all necessary subsystems
 		init();
 
+		// Record resource accesses and prefetch resources, if requested
+		if (ConfigMan.hasKey("resourcetrace"))
+			ResMan.startTrace(ConfigMan.getString("resourcetrace"));
+
+		ResMan.setPrefetchDirectory(ConfigMan.getString("prefetchdir"));
+
 		// Probe and create the game engine
 		gameThread->init(baseDir);
 
@@ -282,8 +296,11 @@ void deinit() {
 	Common::deinitXML();
 
 	// Destroy global singletons
+	Common::WorkerPool::destroy();
+
 	Graphics::Aurora::FontManager::destroy();
 	Graphics::Aurora::CursorManager::destroy();
+	Graphics::Aurora::GUIBatchManager::destroy();
 	Graphics::Aurora::TextureManager::destroy();
 
 	Aurora::LanguageManager::destroy();
@@ -306,3 +323,22 @@ void deinit() {
 	Common::DebugManager::destroy();
 	Common::ConfigManager::destroy();
 }
+
+int makePrefetchManifests() {
+	const Common::UString traceFile = ConfigMan.getString("makemanifests");
+	const Common::UString dir       = ConfigMan.getString("prefetchdir", ".");
+
+	try {
+		const size_t count = Aurora::ResourceManager::writePrefetchManifests(traceFile, dir);
+
+		std::printf("Wrote %u prefetch manifests into \"%s\"\n", (uint) count, dir.c_str());
+
+	} catch (Common::Exception &e) {
+		e.add("Failed turning resource trace \"%s\" into prefetch manifests", traceFile.c_str());
+
+		Common::printException(e);
+		return 1;
+	}
+
+	return 0;
+}